@@ -0,0 +1,54 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include "Fixtures.h"
+#include <PNConfigLib/Compiler/Compiler.h>
+#include <PNConfigLib/ConfigGenerator/IoAddressAllocator.h>
+#include <PNConfigLib/ConfigReader/ConfigReader.h>
+#include <benchmark/benchmark.h>
+
+using namespace PNConfigLib;
+using PNConfigBench::Fixtures;
+
+static void BM_IoAddressAllocator_Allocate(benchmark::State& state)
+{
+    const auto& project = Fixtures::project(static_cast<int>(state.range(0)));
+    Configuration config = ConfigReader::parseConfiguration(project.configPath);
+    const QHash<QString, GsdmlInfo> gsdmlData =
+        Compiler::loadGsdmlData(ConfigReader::parseListOfNodes(project.nodesPath));
+
+    IoAllocationOptions options;
+    options.policy = IoAllocationPolicy::ReservedGap;
+    for (auto _ : state) {
+        IoAllocationResult result = IoAddressAllocator::allocate(config, gsdmlData, options);
+        benchmark::DoNotOptimize(result.inputEnd);
+    }
+    state.counters["devices"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_IoAddressAllocator_Allocate)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+// One device grows after a full allocation; everything else stays in place
+static void BM_IoAddressAllocator_Reallocate(benchmark::State& state)
+{
+    const auto& project = Fixtures::project(static_cast<int>(state.range(0)));
+    Configuration config = ConfigReader::parseConfiguration(project.configPath);
+    const QHash<QString, GsdmlInfo> gsdmlData =
+        Compiler::loadGsdmlData(ConfigReader::parseListOfNodes(project.nodesPath));
+
+    IoAllocationOptions options;
+    options.policy = IoAllocationPolicy::DeviceAligned;
+    IoAddressAllocator::allocate(config, gsdmlData, options);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        Configuration edited = config;
+        edited.decentralDevices.first().modules.append(edited.decentralDevices.first().modules.first());
+        state.ResumeTiming();
+
+        IoAllocationResult result = IoAddressAllocator::reallocate(edited, gsdmlData, options);
+        benchmark::DoNotOptimize(result.keptDevices);
+    }
+    state.counters["devices"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_IoAddressAllocator_Reallocate)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,118 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include <PNConfigLib/Emulator/DeviceEmulator.h>
+#include <PNConfigLib/Network/DcpScanner.h>
+#include <benchmark/benchmark.h>
+
+using namespace PNConfigLib;
+
+namespace {
+
+// Emulated line on its own loopback segment plus a connected scanner
+struct CommissioningLine {
+    DeviceEmulator emulator;
+    DcpScanner scanner;
+    QList<DcpSetRequest> requests;
+
+    bool start(const QString& segment, int deviceCount)
+    {
+        emulator.setPacketBackend(PacketBackend::Loopback);
+        emulator.addDevices(DeviceProfile(), deviceCount, "bench");
+        if (!emulator.startEmulation(segment)) return false;
+
+        scanner.setPacketBackend(PacketBackend::Loopback);
+        if (!scanner.connectToInterface(segment)) return false;
+
+        for (int i = 0; i < deviceCount; ++i) {
+            DcpSetRequest request;
+            request.mac = emulator.device(i)->mac();
+            request.stationName = QString("line-device-%1").arg(i + 1);
+            request.ip = 0xC0A80000U + quint32(i + 10);
+            request.mask = 0xFFFF0000U;
+            request.gw = 0xC0A80001U;
+            requests.append(request);
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+// Name and IP suite for a whole line with many requests in flight
+static void BM_Commission_Batch(benchmark::State& state)
+{
+    CommissioningLine line;
+    if (!line.start("bench-commission-batch", static_cast<int>(state.range(0)))) {
+        state.SkipWithError("Cannot start emulated line");
+        return;
+    }
+
+    int failed = 0;
+    for (auto _ : state) {
+        for (const DcpSetResult& result : line.scanner.commission(line.requests)) {
+            if (!result.succeeded()) ++failed;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * line.requests.size());
+    state.counters["devices"] = static_cast<double>(line.requests.size());
+    state.counters["failed"] = failed;
+}
+BENCHMARK(BM_Commission_Batch)->Arg(1)->Arg(64)->Arg(200)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Same line with the blocking single-device setter, one device at a time
+static void BM_Commission_Sequential(benchmark::State& state)
+{
+    CommissioningLine line;
+    if (!line.start("bench-commission-sequential", static_cast<int>(state.range(0)))) {
+        state.SkipWithError("Cannot start emulated line");
+        return;
+    }
+
+    int failed = 0;
+    for (auto _ : state) {
+        for (const DcpSetRequest& request : line.requests) {
+            if (!line.scanner.setDeviceNameAndIp(NetworkIdentity::formatMac(request.mac), request.stationName,
+                                                 NetworkIdentity::formatIPv4(request.ip),
+                                                 NetworkIdentity::formatIPv4(request.mask),
+                                                 NetworkIdentity::formatIPv4(request.gw), true)) {
+                ++failed;
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * line.requests.size());
+    state.counters["devices"] = static_cast<double>(line.requests.size());
+    state.counters["failed"] = failed;
+}
+BENCHMARK(BM_Commission_Sequential)->Arg(1)->Arg(64)->Arg(200)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Locate one station among the line with a NameOfStation filter; finishes on
+// its response instead of waiting for the ResponseDelay window
+static void BM_Identify_ByName(benchmark::State& state)
+{
+    const int deviceCount = static_cast<int>(state.range(0));
+    DeviceEmulator emulator;
+    emulator.setPacketBackend(PacketBackend::Loopback);
+    emulator.addDevices(DeviceProfile(), deviceCount, "bench");
+    DcpScanner scanner;
+    scanner.setPacketBackend(PacketBackend::Loopback);
+    if (!emulator.startEmulation("bench-identify-name") || !scanner.connectToInterface("bench-identify-name")) {
+        state.SkipWithError("Cannot start emulated line");
+        return;
+    }
+
+    const DcpIdentifyFilter filter = DcpIdentifyFilter::byName(QString("bench-%1").arg(deviceCount));
+    int missed = 0;
+    for (auto _ : state) {
+        if (scanner.identify(filter).isEmpty()) ++missed;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["devices"] = static_cast<double>(deviceCount);
+    state.counters["missed"] = missed;
+    if (missed > 0) {
+        // A timing for lookups that ran into the timeout is meaningless
+        state.SkipWithError("Station not found by name");
+    }
+}
+BENCHMARK(BM_Identify_ByName)->Arg(1)->Arg(200)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,83 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include "Fixtures.h"
+#include <PNConfigLib/Compiler/Compiler.h>
+#include <PNConfigLib/ConfigReader/ConfigReader.h>
+#include <PNConfigLib/ProjectManager/ProjectLoader.h>
+#include <benchmark/benchmark.h>
+
+using namespace PNConfigLib;
+using PNConfigBench::Fixtures;
+
+namespace {
+
+// Sequential load, so the fixture does not depend on ProjectLoader's pool
+LoadedProject load(int deviceCount)
+{
+    const auto& project = Fixtures::project(deviceCount);
+    LoadedProject loaded;
+    loaded.config = ConfigReader::parseConfiguration(project.configPath);
+    loaded.nodes = ConfigReader::parseListOfNodes(project.nodesPath);
+    loaded.gsdmlData = Compiler::loadGsdmlData(loaded.nodes);
+    return loaded;
+}
+
+} // namespace
+
+// End to end in memory: GSDML lookup (warm cache), object tree and serialization
+static void BM_Compiler_GenerateOutputXml(benchmark::State& state)
+{
+    LoadedProject project = load(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        QString xml = Compiler::generateOutputXml(project.config, project.nodes);
+        benchmark::DoNotOptimize(xml.size());
+    }
+    state.counters["devices"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_Compiler_GenerateOutputXml)
+    ->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+static void BM_Compiler_BuildHardwareConfiguration(benchmark::State& state)
+{
+    LoadedProject project = load(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        XmlObject root = Compiler::buildHardwareConfiguration(project.config, project.nodes, project.gsdmlData);
+        benchmark::DoNotOptimize(root.children.size());
+    }
+    state.counters["devices"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_Compiler_BuildHardwareConfiguration)
+    ->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+// Same tree from a model built once up front: the device loop alone, without
+// flattening the Configuration structs on every iteration
+static void BM_Compiler_BuildHardwareConfigurationFromModel(benchmark::State& state)
+{
+    LoadedProject project = load(static_cast<int>(state.range(0)));
+    const ProjectModel model = ProjectModel::fromConfiguration(project.config, project.nodes);
+    for (auto _ : state) {
+        XmlObject root = Compiler::buildHardwareConfiguration(model, project.gsdmlData);
+        benchmark::DoNotOptimize(root.children.size());
+    }
+    state.counters["devices"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_Compiler_BuildHardwareConfigurationFromModel)
+    ->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+static void BM_Compiler_SerializeOutput(benchmark::State& state)
+{
+    LoadedProject project = load(static_cast<int>(state.range(0)));
+    XmlObject root = Compiler::buildHardwareConfiguration(project.config, project.nodes, project.gsdmlData);
+    qint64 bytes = 0;
+    for (auto _ : state) {
+        QByteArray xml = Compiler::serializeOutput(root);
+        bytes += xml.size();
+        benchmark::DoNotOptimize(xml.size());
+    }
+    state.SetBytesProcessed(bytes);
+    state.counters["devices"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_Compiler_SerializeOutput)
+    ->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
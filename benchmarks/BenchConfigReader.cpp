@@ -0,0 +1,50 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include "Fixtures.h"
+#include <PNConfigLib/ConfigReader/ConfigReader.h>
+#include <benchmark/benchmark.h>
+#include <QFileInfo>
+
+using namespace PNConfigLib;
+using PNConfigBench::Fixtures;
+
+static void BM_ConfigReader_ParseConfiguration(benchmark::State& state)
+{
+    const auto& project = Fixtures::project(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        Configuration config = ConfigReader::parseConfiguration(project.configPath);
+        benchmark::DoNotOptimize(config.decentralDevices.size());
+    }
+    state.SetBytesProcessed(state.iterations() * QFileInfo(project.configPath).size());
+    state.counters["devices"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_ConfigReader_ParseConfiguration)
+    ->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+static void BM_ConfigReader_ParseListOfNodes(benchmark::State& state)
+{
+    const auto& project = Fixtures::project(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        ListOfNodes nodes = ConfigReader::parseListOfNodes(project.nodesPath);
+        benchmark::DoNotOptimize(nodes.decentralDevices.size());
+    }
+    state.SetBytesProcessed(state.iterations() * QFileInfo(project.nodesPath).size());
+    state.counters["devices"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_ConfigReader_ParseListOfNodes)
+    ->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+static void BM_ConfigReader_ParseConfigurationMapped(benchmark::State& state)
+{
+    const auto& project = Fixtures::project(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        Configuration config = ConfigReader::parseConfiguration(project.configPath, ConfigReadMode::Mapped);
+        benchmark::DoNotOptimize(config.decentralDevices.size());
+    }
+    state.SetBytesProcessed(state.iterations() * QFileInfo(project.configPath).size());
+    state.counters["devices"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_ConfigReader_ParseConfigurationMapped)
+    ->Arg(1)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,191 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include "Fixtures.h"
+#include <PNConfigLib/Network/DcpBlockParser.h>
+#include <PNConfigLib/Network/DcpFrameBuilder.h>
+#include <PNConfigLib/Network/DcpScanner.h>
+#include <benchmark/benchmark.h>
+
+using namespace PNConfigLib;
+using PNConfigBench::Fixtures;
+
+// One Identify round: every device answers once into an empty result list
+static void BM_DcpScanner_ParseIdentifyRound(benchmark::State& state)
+{
+    const QList<QByteArray>& frames = Fixtures::identifyResponses(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        DiscoveredDeviceList devices;
+        for (const QByteArray& frame : frames) {
+            DcpScanner::parseDcpPacket(reinterpret_cast<const uint8_t*>(frame.constData()),
+                                       static_cast<int>(frame.size()), devices);
+        }
+        benchmark::DoNotOptimize(devices.size());
+    }
+    state.SetItemsProcessed(state.iterations() * frames.size());
+    state.counters["devices"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_DcpScanner_ParseIdentifyRound)->Arg(1)->Arg(64)->Arg(512)->Arg(2048)->Unit(benchmark::kMicrosecond);
+
+// Repeated responses merged into an already populated list (duplicate answers, rescans)
+static void BM_DcpScanner_ParseMergeIntoKnown(benchmark::State& state)
+{
+    const QList<QByteArray>& frames = Fixtures::identifyResponses(static_cast<int>(state.range(0)));
+    DiscoveredDeviceList devices;
+    for (const QByteArray& frame : frames) {
+        DcpScanner::parseDcpPacket(reinterpret_cast<const uint8_t*>(frame.constData()),
+                                   static_cast<int>(frame.size()), devices);
+    }
+
+    for (auto _ : state) {
+        for (const QByteArray& frame : frames) {
+            DcpScanner::parseDcpPacket(reinterpret_cast<const uint8_t*>(frame.constData()),
+                                       static_cast<int>(frame.size()), devices);
+        }
+        benchmark::DoNotOptimize(devices.size());
+    }
+    state.SetItemsProcessed(state.iterations() * frames.size());
+    state.counters["devices"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_DcpScanner_ParseMergeIntoKnown)->Arg(1)->Arg(64)->Arg(512)->Arg(2048)->Unit(benchmark::kMicrosecond);
+
+static qint64 corpusBytes(const QList<QByteArray>& frames)
+{
+    qint64 bytes = 0;
+    for (const QByteArray& frame : frames) {
+        bytes += frame.size();
+    }
+    return bytes;
+}
+
+// Header and block decoding alone over a capture of Identify responses
+static void BM_DcpBlockParser_Corpus(benchmark::State& state)
+{
+    const QList<QByteArray>& frames = Fixtures::identifyCapture();
+    int blockCount = 0;
+    for (auto _ : state) {
+        blockCount = 0;
+        for (const QByteArray& frame : frames) {
+            DcpFrameInfo info;
+            if (!DcpBlockParser::parseFrame(reinterpret_cast<const uint8_t*>(frame.constData()),
+                                            static_cast<int>(frame.size()), info)) {
+                continue;
+            }
+            DcpDeviceBlocks blocks;
+            blockCount += DcpBlockParser::parseResponseBlocks(info.blocks, info.blocksLength, blocks);
+            benchmark::DoNotOptimize(blocks);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * frames.size());
+    state.SetBytesProcessed(state.iterations() * corpusBytes(frames));
+    state.counters["frames"] = static_cast<double>(frames.size());
+    state.counters["blocks"] = blockCount;
+}
+BENCHMARK(BM_DcpBlockParser_Corpus)->Unit(benchmark::kMicrosecond);
+
+// Same capture through parseDcpPacket, including the merge into the device list
+static void BM_DcpScanner_ParseCorpus(benchmark::State& state)
+{
+    const QList<QByteArray>& frames = Fixtures::identifyCapture();
+    for (auto _ : state) {
+        DiscoveredDeviceList devices;
+        for (const QByteArray& frame : frames) {
+            DcpScanner::parseDcpPacket(reinterpret_cast<const uint8_t*>(frame.constData()),
+                                       static_cast<int>(frame.size()), devices);
+        }
+        benchmark::DoNotOptimize(devices.size());
+    }
+    state.SetItemsProcessed(state.iterations() * frames.size());
+    state.SetBytesProcessed(state.iterations() * corpusBytes(frames));
+    state.counters["frames"] = static_cast<double>(frames.size());
+}
+BENCHMARK(BM_DcpScanner_ParseCorpus)->Unit(benchmark::kMicrosecond);
+
+static const uint8_t BenchSourceMac[6] = {0x00, 0x1B, 0x1B, 0x00, 0x00, 0x01};
+
+// Combined NameOfStation + IP suite Set, as sent once per device during commissioning
+static void BM_DcpFrameBuilder_SetNameAndIp(benchmark::State& state)
+{
+    DcpFrameBuilder builder(BenchSourceMac);
+    const QByteArray name("line-device-0001");
+    uint32_t xid = 1;
+    for (auto _ : state) {
+        builder.beginSet(0x001B1B000100ULL + (xid & 0xFF), xid);
+        builder.appendNameOfStation(0x0000, name);
+        builder.appendIpSuite(0x0000, 0xC0A80000U + (xid & 0xFF), 0xFFFFFF00U, 0xC0A80001U);
+        benchmark::DoNotOptimize(builder.finish());
+        ++xid;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DcpFrameBuilder_SetNameAndIp);
+
+static void BM_DcpFrameBuilder_SetIpSuite(benchmark::State& state)
+{
+    DcpFrameBuilder builder(BenchSourceMac);
+    uint32_t xid = 1;
+    for (auto _ : state) {
+        builder.beginSet(0x001B1B000100ULL, xid);
+        builder.appendIpSuite(0x0001, 0xC0A80000U + (xid & 0xFF), 0xFFFFFF00U, 0xC0A80001U);
+        benchmark::DoNotOptimize(builder.finish());
+        ++xid;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DcpFrameBuilder_SetIpSuite);
+
+static void BM_DcpFrameBuilder_Signal(benchmark::State& state)
+{
+    DcpFrameBuilder builder(BenchSourceMac);
+    uint32_t xid = 1;
+    for (auto _ : state) {
+        builder.beginSet(0x001B1B000100ULL, xid++);
+        builder.appendSignal();
+        benchmark::DoNotOptimize(builder.finish());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DcpFrameBuilder_Signal);
+
+// Identify filtered by NameOfStation
+static void BM_DcpFrameBuilder_IdentifyByName(benchmark::State& state)
+{
+    DcpFrameBuilder builder(BenchSourceMac);
+    const QByteArray name("line-device-0001");
+    uint32_t xid = 1;
+    for (auto _ : state) {
+        builder.beginIdentify(xid++, 1);
+        builder.appendBlock(0x02, 0x02, reinterpret_cast<const uint8_t*>(name.constData()),
+                            static_cast<int>(name.size()));
+        benchmark::DoNotOptimize(builder.finish());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DcpFrameBuilder_IdentifyByName);
+
+// Same Set as the GUI issues it: MAC and addresses still in text form
+static void BM_DcpFrameBuilder_SetNameAndIpFromText(benchmark::State& state)
+{
+    DcpFrameBuilder builder(BenchSourceMac);
+    const QString mac("00:1B:1B:00:01:00");
+    const QString name("line-device-0001");
+    const QString ip("192.168.0.10");
+    const QString mask("255.255.255.0");
+    const QString gw("192.168.0.1");
+    uint32_t xid = 1;
+    for (auto _ : state) {
+        quint64 dest = 0;
+        quint32 ipValue = 0, maskValue = 0, gwValue = 0;
+        NetworkIdentity::parseMac(mac, dest);
+        NetworkIdentity::parseIPv4(ip, ipValue);
+        NetworkIdentity::parseIPv4(mask, maskValue);
+        NetworkIdentity::parseIPv4(gw, gwValue);
+        builder.beginSet(dest, xid++);
+        builder.appendNameOfStation(0x0000, name.toUtf8());
+        builder.appendIpSuite(0x0000, ipValue, maskValue, gwValue);
+        benchmark::DoNotOptimize(builder.finish());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DcpFrameBuilder_SetNameAndIpFromText);
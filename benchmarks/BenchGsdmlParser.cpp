@@ -0,0 +1,37 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include "Fixtures.h"
+#include <PNConfigLib/GsdmlParser/GsdmlParser.h>
+#include <benchmark/benchmark.h>
+
+using namespace PNConfigLib;
+using PNConfigBench::Fixtures;
+
+// Full parse: cache cleared before every iteration
+static void BM_GsdmlParser_ParseCold(benchmark::State& state)
+{
+    const QString path = Fixtures::gsdml(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        GsdmlParser::clearCache();
+        GsdmlInfo info = GsdmlParser::parseGSDML(path);
+        benchmark::DoNotOptimize(info.modules.size());
+    }
+    state.counters["modules"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_GsdmlParser_ParseCold)->Arg(8)->Arg(64)->Arg(512)->Unit(benchmark::kMicrosecond);
+
+// Cache hit: path normalization, timestamp check and copy of the cached info
+static void BM_GsdmlParser_ParseWarm(benchmark::State& state)
+{
+    const QString path = Fixtures::gsdml(static_cast<int>(state.range(0)));
+    GsdmlParser::clearCache();
+    GsdmlParser::parseGSDML(path);
+    for (auto _ : state) {
+        GsdmlInfo info = GsdmlParser::parseGSDML(path);
+        benchmark::DoNotOptimize(info.modules.size());
+    }
+    state.counters["modules"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_GsdmlParser_ParseWarm)->Arg(8)->Arg(64)->Arg(512)->Unit(benchmark::kMicrosecond);
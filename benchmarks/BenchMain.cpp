@@ -0,0 +1,23 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include <QCoreApplication>
+#include <QLoggingCategory>
+
+int main(int argc, char** argv)
+{
+    QCoreApplication app(argc, argv);
+
+    // The library logs per packet/record with qDebug; keep it out of the measurements
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,131 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include <PNConfigLib/Consistency/InputValidator.h>
+#include <PNConfigLib/DataModel/NetworkIdentity.h>
+#include <benchmark/benchmark.h>
+
+using namespace PNConfigLib;
+
+namespace {
+
+// Mix of valid names and the typical mistakes, like a large project's device list
+QList<QByteArray> stationNames()
+{
+    QList<QByteArray> names;
+    for (int i = 0; i < 256; ++i) {
+        switch (i % 8) {
+            case 0: names.append(QByteArray("plc-line") + QByteArray::number(i) + ".cell-a.plant"); break;
+            case 1: names.append(QByteArray("IO-Device_") + QByteArray::number(i)); break;
+            case 2: names.append(QByteArray("port-") + QByteArray::number(100 + i % 900)); break;
+            case 3: names.append(QByteArray("10.0.") + QByteArray::number(i % 256) + ".1"); break;
+            default: names.append(QByteArray("et200sp-station-") + QByteArray::number(i)); break;
+        }
+    }
+    return names;
+}
+
+QList<QByteArray> ipAddresses()
+{
+    QList<QByteArray> ips;
+    for (int i = 0; i < 256; ++i) {
+        ips.append(QByteArray("192.168.") + QByteArray::number(i % 4) + "." + QByteArray::number(i));
+    }
+    return ips;
+}
+
+qint64 totalBytes(const QList<QByteArray>& values)
+{
+    qint64 bytes = 0;
+    for (const QByteArray& value : values) {
+        bytes += value.size();
+    }
+    return bytes;
+}
+
+} // namespace
+
+// State machine directly on UTF-8 bytes (DCP payloads)
+static void BM_StationName_CheckBytes(benchmark::State& state)
+{
+    const QList<QByteArray> names = stationNames();
+    for (auto _ : state) {
+        int valid = 0;
+        for (const QByteArray& name : names) {
+            valid += NetworkIdentity::checkStationName(name.constData(), name.size()).isValid();
+        }
+        benchmark::DoNotOptimize(valid);
+    }
+    state.SetItemsProcessed(state.iterations() * names.size());
+    state.SetBytesProcessed(state.iterations() * totalBytes(names));
+}
+BENCHMARK(BM_StationName_CheckBytes);
+
+// Validator entry point used by the consistency rules (QString, message on error)
+static void BM_StationName_InputValidator(benchmark::State& state)
+{
+    QStringList names;
+    for (const QByteArray& name : stationNames()) {
+        names.append(QString::fromUtf8(name));
+    }
+    for (auto _ : state) {
+        int valid = 0;
+        for (const QString& name : names) {
+            QString error;
+            valid += InputValidator::isValidPNDeviceName(name, error);
+        }
+        benchmark::DoNotOptimize(valid);
+    }
+    state.SetItemsProcessed(state.iterations() * names.size());
+}
+BENCHMARK(BM_StationName_InputValidator);
+
+static void BM_StationName_Encode(benchmark::State& state)
+{
+    const QList<QByteArray> names = {
+        "IO-Device_1", "Förderband Süd", "Station 12.Hall B", "plc-1.cell-a"
+    };
+    for (auto _ : state) {
+        for (const QByteArray& name : names) {
+            QByteArray encoded = NetworkIdentity::encodeStationName(name);
+            benchmark::DoNotOptimize(encoded.size());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * names.size());
+}
+BENCHMARK(BM_StationName_Encode);
+
+static void BM_IPv4_ParseBytes(benchmark::State& state)
+{
+    const QList<QByteArray> ips = ipAddresses();
+    for (auto _ : state) {
+        quint32 sum = 0;
+        for (const QByteArray& ip : ips) {
+            quint32 address = 0;
+            NetworkIdentity::parseIPv4(ip.constData(), ip.size(), address);
+            sum += address;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * ips.size());
+    state.SetBytesProcessed(state.iterations() * totalBytes(ips));
+}
+BENCHMARK(BM_IPv4_ParseBytes);
+
+static void BM_IPv4_InputValidator(benchmark::State& state)
+{
+    QStringList ips;
+    for (const QByteArray& ip : ipAddresses()) {
+        ips.append(QString::fromLatin1(ip));
+    }
+    for (auto _ : state) {
+        int valid = 0;
+        for (const QString& ip : ips) {
+            valid += InputValidator::isValidIPAddress(ip);
+        }
+        benchmark::DoNotOptimize(valid);
+    }
+    state.SetItemsProcessed(state.iterations() * ips.size());
+}
+BENCHMARK(BM_IPv4_InputValidator);
@@ -0,0 +1,67 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include "Fixtures.h"
+#include <PNConfigLib/Compiler/BlobBuilder.h>
+#include <PNConfigLib/Compiler/RecordGenerators.h>
+#include <PNConfigLib/GsdmlParser/GsdmlParser.h>
+#include <PNConfigLib/ConfigReader/ConfigReader.h>
+#include <benchmark/benchmark.h>
+
+using namespace PNConfigLib;
+using PNConfigBench::Fixtures;
+
+// Typical record: header, addresses and a length-prefixed name
+static void BM_BlobBuilder_Record(benchmark::State& state)
+{
+    for (auto _ : state) {
+        BlobBuilder b;
+        b.appendUint16(0x3000);
+        b.appendUint16(0x0012);
+        b.appendUint32(0x00000001);
+        b.appendIpAddress("192.168.0.10");
+        b.appendIpAddress("255.255.255.0");
+        b.appendIpAddress("192.168.0.1");
+        b.appendMacAddress("00:1B:1B:12:34:56");
+        b.appendString("bench-device-0001");
+        QByteArray blob = b.toByteArray();
+        benchmark::DoNotOptimize(blob.size());
+    }
+}
+BENCHMARK(BM_BlobBuilder_Record);
+
+static void BM_RecordGenerators_NetworkParameters(benchmark::State& state)
+{
+    for (auto _ : state) {
+        QList<XmlField> fields = RecordGenerators::generateNetworkParameters(
+            "192.168.0.10", "255.255.255.0", "bench-device-0001");
+        benchmark::DoNotOptimize(fields.size());
+    }
+}
+BENCHMARK(BM_RecordGenerators_NetworkParameters);
+
+static void BM_RecordGenerators_DriverInterface(benchmark::State& state)
+{
+    for (auto _ : state) {
+        QList<XmlField> fields = RecordGenerators::generateDriverInterfaceRecords(
+            "192.168.0.1", "255.255.255.0", "plc-controller", "192.168.0.254");
+        benchmark::DoNotOptimize(fields.size());
+    }
+}
+BENCHMARK(BM_RecordGenerators_DriverInterface);
+
+static void BM_RecordGenerators_IODevParamConfig(benchmark::State& state)
+{
+    const auto& project = Fixtures::project(1);
+    Configuration config = ConfigReader::parseConfiguration(project.configPath);
+    GsdmlInfo gsdInfo = GsdmlParser::parseGSDML(project.gsdmlPath);
+    const DecentralDeviceType& device = config.decentralDevices.first();
+
+    for (auto _ : state) {
+        QList<XmlField> fields = RecordGenerators::generateIODevParamConfig(
+            gsdInfo, device.ethernetAddresses.deviceName, device.ethernetAddresses.ipAddress);
+        benchmark::DoNotOptimize(fields.size());
+    }
+}
+BENCHMARK(BM_RecordGenerators_IODevParamConfig);
@@ -0,0 +1,168 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include "Fixtures.h"
+#include <PNConfigLib/Network/DcpFrameBuilder.h>
+#include <PNConfigLib/Network/DcpScanner.h>
+#include <PNConfigLib/Network/LoopbackTransport.h>
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+using namespace PNConfigLib;
+using PNConfigBench::Fixtures;
+
+namespace {
+
+// Identify All request as DcpScanner sends it (multicast 01:0E:CF:00:00:00)
+QByteArray identifyRequest(const uint8_t* sourceMac)
+{
+    DcpFrameBuilder builder(sourceMac);
+    builder.beginIdentify(0x12345678, 1);
+    builder.appendBlock(0xFF, 0xFF, nullptr, 0);   // All selector
+    builder.finish();
+    return builder.toByteArray();
+}
+
+// Untagged RT frame with one byte of IO data, as ArExchangeManager sends it
+QByteArray cyclicFrame(uint16_t frameId, const uint8_t* dest, const uint8_t* source)
+{
+    QByteArray frame(60, '\0');
+    uint8_t* p = reinterpret_cast<uint8_t*>(frame.data());
+    memcpy(p, dest, 6);
+    memcpy(p + 6, source, 6);
+    p[12] = 0x88; p[13] = 0x92;
+    p[14] = frameId >> 8; p[15] = frameId & 0xFF;
+    p[16] = 0x5A; p[17] = 0x80; p[18] = 0x80;
+    p[58] = 0x35;
+    return frame;
+}
+
+const uint8_t* bytes(const QByteArray& frame)
+{
+    return reinterpret_cast<const uint8_t*>(frame.constData());
+}
+
+} // namespace
+
+// Full Identify round on the in-memory segment: request out, every simulated
+// device answers, the controller collects the batch and merges it
+static void BM_Loopback_IdentifyRound(benchmark::State& state)
+{
+    const QList<QByteArray>& responses = Fixtures::identifyResponses(static_cast<int>(state.range(0)));
+
+    LoopbackTransport controller;
+    LoopbackTransport devices;
+    controller.open("bench-identify", DcpScanner::ProfinetFilter);
+    devices.open("bench-identify", DcpScanner::ProfinetFilter);
+
+    uint8_t mac[6];
+    controller.hardwareAddress(mac);
+    const QByteArray request = identifyRequest(mac);
+
+    const uint8_t* data = nullptr;
+    int length = 0;
+    for (auto _ : state) {
+        controller.send(bytes(request), static_cast<int>(request.size()));
+        devices.next(&data, &length, 0);
+        for (const QByteArray& response : responses) {
+            devices.queue(bytes(response), static_cast<int>(response.size()));
+        }
+        devices.flush();
+
+        DiscoveredDeviceList found;
+        controller.dispatch([&found](const uint8_t* frame, int len) {
+            DcpScanner::parseDcpPacket(frame, len, found);
+        }, 0);
+        benchmark::DoNotOptimize(found.size());
+    }
+    state.SetItemsProcessed(state.iterations() * responses.size());
+    state.counters["devices"] = static_cast<double>(state.range(0));
+}
+BENCHMARK(BM_Loopback_IdentifyRound)->Arg(1)->Arg(64)->Arg(512)->Arg(2048)->Unit(benchmark::kMicrosecond);
+
+// One cycle per device: controller outputs (0x8002) and device inputs (0x8001)
+// cross the segment in batches, single-threaded and fully deterministic
+static void BM_Loopback_CyclicExchange(benchmark::State& state)
+{
+    const int deviceCount = static_cast<int>(state.range(0));
+
+    LoopbackTransport controller;
+    LoopbackTransport devices;
+    controller.open("bench-cyclic", DcpScanner::ProfinetFilter);
+    devices.open("bench-cyclic", DcpScanner::ProfinetFilter);
+
+    uint8_t controllerMac[6];
+    uint8_t deviceMac[6];
+    controller.hardwareAddress(controllerMac);
+    devices.hardwareAddress(deviceMac);
+    const QByteArray output = cyclicFrame(0x8002, deviceMac, controllerMac);
+    const QByteArray input = cyclicFrame(0x8001, controllerMac, deviceMac);
+
+    int received = 0;
+    const PacketTransport::FrameHandler onInput = [&received](const uint8_t* frame, int len) {
+        if (len >= 17 && frame[14] == 0x80 && frame[15] == 0x01) received += frame[16];
+    };
+    const PacketTransport::FrameHandler onOutput = [&devices, &input](const uint8_t*, int) {
+        devices.queue(bytes(input), static_cast<int>(input.size()));
+    };
+
+    for (auto _ : state) {
+        for (int i = 0; i < deviceCount; ++i) {
+            controller.queue(bytes(output), static_cast<int>(output.size()));
+        }
+        controller.flush();
+        devices.dispatch(onOutput, 0);
+        devices.flush();
+        controller.dispatch(onInput, 0);
+    }
+    benchmark::DoNotOptimize(received);
+    state.SetItemsProcessed(state.iterations() * deviceCount * 2);
+    state.counters["devices"] = static_cast<double>(deviceCount);
+}
+BENCHMARK(BM_Loopback_CyclicExchange)->Arg(1)->Arg(64)->Arg(512)->Unit(benchmark::kMicrosecond);
+
+// Round trip to a device running on its own thread, including the wake-up of
+// the blocked receiver on each side
+static void BM_Loopback_RoundTripThreaded(benchmark::State& state)
+{
+    LoopbackTransport controller;
+    LoopbackTransport device;
+    controller.open("bench-roundtrip");
+    device.open("bench-roundtrip");
+
+    uint8_t controllerMac[6];
+    uint8_t deviceMac[6];
+    controller.hardwareAddress(controllerMac);
+    device.hardwareAddress(deviceMac);
+    const QByteArray output = cyclicFrame(0x8002, deviceMac, controllerMac);
+
+    std::atomic<bool> running{true};
+    std::thread echo([&]() {
+        const uint8_t* data = nullptr;
+        int length = 0;
+        while (running.load(std::memory_order_relaxed)) {
+            if (device.next(&data, &length, 100) == 1) {
+                device.send(data, length);
+            }
+        }
+    });
+
+    const uint8_t* data = nullptr;
+    int length = 0;
+    for (auto _ : state) {
+        controller.send(bytes(output), static_cast<int>(output.size()));
+        if (controller.next(&data, &length, 1000) != 1) {
+            state.SkipWithError("Echo timed out");
+            break;
+        }
+    }
+
+    running = false;
+    device.interrupt();
+    echo.join();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Loopback_RoundTripThreaded)->UseRealTime()->Unit(benchmark::kMicrosecond);
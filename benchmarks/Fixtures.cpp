@@ -0,0 +1,433 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include "Fixtures.h"
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QtEndian>
+#include <map>
+#include <stdexcept>
+
+namespace PNConfigBench {
+
+static QTemporaryDir& tempDir()
+{
+    static QTemporaryDir dir;
+    if (!dir.isValid()) {
+        throw std::runtime_error("Cannot create temporary directory for benchmark fixtures");
+    }
+    return dir;
+}
+
+static void writeFile(const QString& path, const QString& content)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        throw std::runtime_error(QString("Cannot write fixture %1").arg(path).toStdString());
+    }
+    QTextStream out(&file);
+    out.setEncoding(QStringConverter::Utf8);
+    out << content;
+}
+
+static QString ipAddress(int index)
+{
+    // 10.0.x.y, skipping .0, .1 (controller) and .255
+    return QString("10.0.%1.%2").arg(index / 250).arg(index % 250 + 2);
+}
+
+static QString deviceName(int index)
+{
+    return QString("bench-device-%1").arg(index + 1, 4, 10, QChar('0'));
+}
+
+QString Fixtures::rootDirectory()
+{
+    return tempDir().path();
+}
+
+// -----------------------------------------------------------------------------
+// GSDML
+// -----------------------------------------------------------------------------
+
+QString Fixtures::gsdml(int moduleCount)
+{
+    static std::map<int, QString> cache;
+    auto it = cache.find(moduleCount);
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    static const char* const dataTypes[] = { "Unsigned8", "Unsigned16", "Unsigned32", "Float32", "Integer16" };
+
+    QString modules;
+    QString texts;
+    QTextStream m(&modules);
+    QTextStream t(&texts);
+
+    for (int i = 0; i < moduleCount; ++i) {
+        const int submoduleCount = 1 + i % 4;
+        m << QString("        <ModuleItem ID=\"IDM_%1\" ModuleIdentNumber=\"0x%2\">\n").arg(i).arg(0x100 + i, 8, 16, QChar('0'))
+          << QString("          <ModuleInfo><Name TextId=\"TOK_MOD_%1\"/><InfoText TextId=\"TOK_MOD_INFO_%1\"/></ModuleInfo>\n").arg(i)
+          << "          <VirtualSubmoduleList>\n";
+        for (int s = 0; s < submoduleCount; ++s) {
+            m << QString("            <VirtualSubmoduleItem ID=\"IDSM_%1_%2\" SubmoduleIdentNumber=\"0x%3\">\n")
+                    .arg(i).arg(s).arg(s + 1, 8, 16, QChar('0'))
+              << "              <IOData>\n";
+            if ((i + s) % 3 != 2) {
+                m << "                <Input>\n";
+                for (int d = 0; d <= (i + s) % 3; ++d) {
+                    m << QString("                  <DataItem DataType=\"%1\" TextId=\"TOK_IN\"/>\n").arg(dataTypes[(i + d) % 5]);
+                }
+                m << "                </Input>\n";
+            }
+            if ((i + s) % 3 != 0) {
+                m << "                <Output>\n";
+                for (int d = 0; d <= (i + s + 1) % 3; ++d) {
+                    m << QString("                  <DataItem DataType=\"%1\" TextId=\"TOK_OUT\"/>\n").arg(dataTypes[(s + d) % 5]);
+                }
+                m << "                </Output>\n";
+            }
+            m << "              </IOData>\n"
+              << QString("              <ModuleInfo><Name TextId=\"TOK_SUB_%1_%2\"/></ModuleInfo>\n").arg(i).arg(s)
+              << "            </VirtualSubmoduleItem>\n";
+            t << QString("        <Text TextId=\"TOK_SUB_%1_%2\" Value=\"Submodule %1.%2\"/>\n").arg(i).arg(s);
+        }
+        m << "          </VirtualSubmoduleList>\n"
+          << "        </ModuleItem>\n";
+        t << QString("        <Text TextId=\"TOK_MOD_%1\" Value=\"Module %1 DI/DO\"/>\n").arg(i)
+          << QString("        <Text TextId=\"TOK_MOD_INFO_%1\" Value=\"Synthetic benchmark module %1\"/>\n").arg(i);
+    }
+
+    QString xml;
+    QTextStream x(&xml);
+    x << "<?xml version=\"1.0\" encoding=\"iso-8859-1\"?>\n"
+      << "<ISO15745Profile xmlns=\"http://www.profibus.com/GSDML/2003/11/DeviceProfile\" "
+         "xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\">\n"
+      << "  <ProfileHeader><ProfileIdentification>PROFINET Device Profile</ProfileIdentification></ProfileHeader>\n"
+      << "  <ProfileBody>\n"
+      << "    <DeviceIdentity VendorID=\"0x0493\" DeviceID=\"0x0002\">\n"
+      << "      <InfoText TextId=\"TOK_DEVICE_INFO\"/>\n"
+      << "      <VendorName Value=\"Bench Vendor\"/>\n"
+      << "    </DeviceIdentity>\n"
+      << "    <DeviceFunction><Family MainFamily=\"I/O\" ProductFamily=\"Bench IO\"/></DeviceFunction>\n"
+      << "    <ApplicationProcess>\n"
+      << "      <DeviceAccessPointList>\n"
+      << QString("        <DeviceAccessPointItem ID=\"IDD_1\" PhysicalSlots=\"0..%1\" ModuleIdentNumber=\"0x00000001\" "
+                 "MinDeviceInterval=\"32\" DNS_CompatibleName=\"bench-io\" FixedInSlots=\"0\">\n").arg(qMax(8, moduleCount))
+      << "          <ModuleInfo><Name TextId=\"TOK_DAP\"/></ModuleInfo>\n"
+      << "        </DeviceAccessPointItem>\n"
+      << "      </DeviceAccessPointList>\n"
+      << "      <ModuleList>\n"
+      << modules
+      << "      </ModuleList>\n"
+      << "      <ExternalTextList>\n"
+      << "        <PrimaryLanguage>\n"
+      << "        <Text TextId=\"TOK_DAP\" Value=\"Bench IO Device\"/>\n"
+      << "        <Text TextId=\"TOK_DEVICE_INFO\" Value=\"Synthetic device for benchmarks\"/>\n"
+      << "        <Text TextId=\"TOK_IN\" Value=\"Input\"/>\n"
+      << "        <Text TextId=\"TOK_OUT\" Value=\"Output\"/>\n"
+      << texts
+      << "        </PrimaryLanguage>\n"
+      << "      </ExternalTextList>\n"
+      << "    </ApplicationProcess>\n"
+      << "  </ProfileBody>\n"
+      << "</ISO15745Profile>\n";
+    x.flush();
+
+    QString path = QDir(rootDirectory()).filePath(QString("GSDML-V2.35-Bench-%1-20240101.xml").arg(moduleCount));
+    writeFile(path, xml);
+    cache[moduleCount] = path;
+    return path;
+}
+
+// -----------------------------------------------------------------------------
+// Configuration.xml / ListOfNodes.xml
+// -----------------------------------------------------------------------------
+
+static QString ethernetAddresses(const QString& ip, const QString& name, int deviceNumber)
+{
+    return QString(
+        "        <EthernetAddresses>\n"
+        "          <IPProtocol><SetInTheProject IPAddress=\"%1\" SubnetMask=\"255.255.0.0\" RouterAddress=\"10.0.0.1\"/></IPProtocol>\n"
+        "          <PROFINETDeviceName DeviceNumber=\"%3\"><PNDeviceName>%2</PNDeviceName></PROFINETDeviceName>\n"
+        "        </EthernetAddresses>\n").arg(ip, name).arg(deviceNumber);
+}
+
+const ProjectFixture& Fixtures::project(int deviceCount)
+{
+    static std::map<int, ProjectFixture> cache;
+    auto it = cache.find(deviceCount);
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    ProjectFixture fixture;
+    fixture.deviceCount = deviceCount;
+    fixture.gsdmlPath = gsdml(32);
+    fixture.directory = QDir(rootDirectory()).filePath(QString("project_%1").arg(deviceCount));
+    QDir().mkpath(fixture.directory);
+    fixture.configPath = QDir(fixture.directory).filePath("Configuration.xml");
+    fixture.nodesPath = QDir(fixture.directory).filePath("ListOfNodes.xml");
+
+    QString config;
+    QTextStream c(&config);
+    c << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+      << "<Configuration ConfigurationID=\"ConfigurationID\" ConfigurationName=\"Bench\" "
+         "ListOfNodesRefID=\"ListOfNodesID\" schemaVersion=\"1.0\">\n"
+      << "  <Devices>\n"
+      << "    <CentralDevice DeviceRefID=\"PN_Driver_1\">\n"
+      << "      <CentralDeviceInterface InterfaceRefID=\"PN_Driver_1_Interface\">\n"
+      << ethernetAddresses("10.0.0.1", "plc-controller", 0)
+      << "        <AdvancedOptions><RealTimeSettings><IOCommunication SendClock=\"1\"/></RealTimeSettings></AdvancedOptions>\n"
+      << "      </CentralDeviceInterface>\n"
+      << "    </CentralDevice>\n";
+
+    QString nodes;
+    QTextStream n(&nodes);
+    n << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+      << "<ListOfNodes ListOfNodesID=\"ListOfNodesID\" schemaVersion=\"1.0\">\n"
+      << "  <PNDriver DeviceID=\"PN_Driver_1\" DeviceName=\"PROFINET Driver\" DeviceVersion=\"v3.1\">\n"
+      << "    <Interface InterfaceID=\"PN_Driver_1_Interface\" InterfaceName=\"PN_Driver_1_Interface\" InterfaceType=\"Windows\"/>\n"
+      << "  </PNDriver>\n";
+
+    int ioAddress = 0;
+    for (int d = 0; d < deviceCount; ++d) {
+        const QString deviceId = QString("PN_Device_%1").arg(d + 1);
+        c << QString("    <DecentralDevice DeviceRefID=\"%1\">\n").arg(deviceId)
+          << QString("      <DecentralDeviceInterface InterfaceRefID=\"%1_Interface\">\n").arg(deviceId)
+          << ethernetAddresses(ipAddress(d), deviceName(d), d + 1)
+          << "      </DecentralDeviceInterface>\n";
+        for (int slot = 1; slot <= 4; ++slot) {
+            c << QString("      <Module ModuleID=\"%1_Module_%2\" SlotNumber=\"%2\" GSDRefID=\"IDM_%3\">\n")
+                    .arg(deviceId).arg(slot).arg((d + slot) % 32);
+            for (int subslot = 1; subslot <= 2; ++subslot) {
+                c << QString("        <Submodule SubmoduleID=\"%1_Module_%2_Sub_%3\" SubslotNumber=\"%3\" GSDRefID=\"IDSM_%4_0\">\n")
+                        .arg(deviceId).arg(slot).arg(subslot).arg((d + slot) % 32)
+                  << "          <IOAddresses>\n"
+                  << QString("            <InputAddresses StartAddress=\"%1\" Length=\"4\"/>\n").arg(ioAddress)
+                  << QString("            <OutputAddresses StartAddress=\"%1\" Length=\"2\"/>\n").arg(ioAddress)
+                  << "          </IOAddresses>\n"
+                  << "        </Submodule>\n";
+                ioAddress += 4;
+            }
+            c << "      </Module>\n";
+        }
+        c << "    </DecentralDevice>\n";
+
+        n << QString("  <DecentralDevice DeviceID=\"%1\" DeviceName=\"%2\" GSDPath=\"%3\" GSDRefID=\"IDD_1\">\n")
+                .arg(deviceId, deviceName(d), fixture.gsdmlPath)
+          << QString("    <Interface InterfaceID=\"%1_Interface\" InterfaceName=\"%1_Interface\" InterfaceType=\"Decentral\"/>\n").arg(deviceId)
+          << "  </DecentralDevice>\n";
+    }
+
+    c << "  </Devices>\n"
+      << "</Configuration>\n";
+    n << "</ListOfNodes>\n";
+    c.flush();
+    n.flush();
+
+    writeFile(fixture.configPath, config);
+    writeFile(fixture.nodesPath, nodes);
+
+    return cache.emplace(deviceCount, fixture).first->second;
+}
+
+// -----------------------------------------------------------------------------
+// DCP frames
+// -----------------------------------------------------------------------------
+
+static void appendUint16(QByteArray& frame, uint16_t value)
+{
+    frame.append(static_cast<char>(value >> 8));
+    frame.append(static_cast<char>(value & 0xFF));
+}
+
+static void appendBlock(QByteArray& frame, uint8_t option, uint8_t suboption, const QByteArray& payload)
+{
+    // Block header, 2 bytes BlockInfo, payload, padding to an even length
+    frame.append(static_cast<char>(option));
+    frame.append(static_cast<char>(suboption));
+    appendUint16(frame, static_cast<uint16_t>(payload.size() + 2));
+    appendUint16(frame, 0x0000);
+    frame.append(payload);
+    if (payload.size() % 2 != 0) {
+        frame.append('\0');
+    }
+}
+
+static QByteArray buildIdentifyResponse(int index)
+{
+    QByteArray blocks;
+
+    QByteArray options;
+    const uint8_t supported[][2] = { {1, 1}, {1, 2}, {2, 1}, {2, 2}, {2, 3}, {2, 4}, {2, 5}, {5, 4} };
+    for (const auto& o : supported) {
+        options.append(static_cast<char>(o[0]));
+        options.append(static_cast<char>(o[1]));
+    }
+    appendBlock(blocks, 0x02, 0x05, options);
+    appendBlock(blocks, 0x02, 0x01, QByteArray("ET 200SP Bench"));
+    appendBlock(blocks, 0x02, 0x02, deviceName(index).toLatin1());
+
+    QByteArray deviceId;
+    appendUint16(deviceId, 0x0493);
+    appendUint16(deviceId, static_cast<uint16_t>(0x0002 + index % 8));
+    appendBlock(blocks, 0x02, 0x03, deviceId);
+    appendBlock(blocks, 0x02, 0x04, QByteArray("\x01\x00", 2));
+
+    QByteArray ipSuite;
+    const uint8_t ip[12] = { 10, 0, static_cast<uint8_t>(index / 250), static_cast<uint8_t>(index % 250 + 2),
+                             255, 255, 0, 0,
+                             10, 0, 0, 1 };
+    ipSuite.append(reinterpret_cast<const char*>(ip), sizeof(ip));
+    appendBlock(blocks, 0x01, 0x02, ipSuite);
+
+    QByteArray frame;
+    const uint8_t controllerMac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+    const uint8_t deviceMac[6] = { 0x02, 0x1B, 0x1B, static_cast<uint8_t>(index >> 16),
+                                   static_cast<uint8_t>(index >> 8), static_cast<uint8_t>(index) };
+    frame.append(reinterpret_cast<const char*>(controllerMac), 6);
+    frame.append(reinterpret_cast<const char*>(deviceMac), 6);
+    if (index % 4 == 3) {
+        appendUint16(frame, 0x8100);
+        appendUint16(frame, 0xC000); // PCP 6, VLAN 0
+    }
+    appendUint16(frame, 0x8892);
+
+    appendUint16(frame, 0xFEFF);           // FrameID: Identify response
+    frame.append(static_cast<char>(0x05)); // ServiceID: Identify
+    frame.append(static_cast<char>(0x01)); // ServiceType: Response success
+    appendUint16(frame, 0x1234);           // XID
+    appendUint16(frame, static_cast<uint16_t>(index));
+    appendUint16(frame, 0x0000);           // Reserved
+    appendUint16(frame, static_cast<uint16_t>(blocks.size()));
+    frame.append(blocks);
+
+    // Minimum Ethernet payload
+    if (frame.size() < 60) {
+        frame.append(QByteArray(60 - frame.size(), '\0'));
+    }
+    return frame;
+}
+
+const QList<QByteArray>& Fixtures::identifyResponses(int deviceCount)
+{
+    static std::map<int, QList<QByteArray>> cache;
+    auto it = cache.find(deviceCount);
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    QList<QByteArray> frames;
+    frames.reserve(deviceCount);
+    for (int i = 0; i < deviceCount; ++i) {
+        frames.append(buildIdentifyResponse(i));
+    }
+    return cache.emplace(deviceCount, frames).first->second;
+}
+
+// -----------------------------------------------------------------------------
+// Capture files
+// -----------------------------------------------------------------------------
+
+static const uint32_t PcapMagic = 0xA1B2C3D4;       // Microsecond timestamps
+static const uint32_t PcapMagicNanos = 0xA1B23C4D;  // Nanosecond timestamps
+static const uint32_t PcapLinkTypeEthernet = 1;
+static const int PcapFileHeaderLength = 24;
+static const int PcapRecordHeaderLength = 16;
+
+QList<QByteArray> Fixtures::readPcap(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        throw std::runtime_error(QString("Cannot read capture %1").arg(path).toStdString());
+    }
+    const QByteArray content = file.readAll();
+    const uchar* data = reinterpret_cast<const uchar*>(content.constData());
+    if (content.size() < PcapFileHeaderLength) {
+        throw std::runtime_error(QString("%1 is not a pcap capture").arg(path).toStdString());
+    }
+
+    // The writer's byte order is recognised by the magic number
+    const uint32_t magic = qFromLittleEndian<uint32_t>(data);
+    bool bigEndian = false;
+    if (magic != PcapMagic && magic != PcapMagicNanos) {
+        bigEndian = true;
+        const uint32_t swapped = qFromBigEndian<uint32_t>(data);
+        if (swapped != PcapMagic && swapped != PcapMagicNanos) {
+            throw std::runtime_error(
+                QString("%1 is not a classic pcap capture (pcapng is not supported)").arg(path).toStdString());
+        }
+    }
+    auto read32 = [&](qsizetype offset) {
+        return bigEndian ? qFromBigEndian<uint32_t>(data + offset) : qFromLittleEndian<uint32_t>(data + offset);
+    };
+    if (read32(20) != PcapLinkTypeEthernet) {
+        throw std::runtime_error(QString("%1 does not contain Ethernet frames").arg(path).toStdString());
+    }
+
+    QList<QByteArray> frames;
+    qsizetype offset = PcapFileHeaderLength;
+    while (content.size() - offset >= PcapRecordHeaderLength) {
+        const qsizetype length = read32(offset + 8);   // Captured length
+        offset += PcapRecordHeaderLength;
+        if (length > content.size() - offset) {
+            break; // Capture cut off while writing
+        }
+        frames.append(content.mid(offset, length));
+        offset += length;
+    }
+    return frames;
+}
+
+void Fixtures::writePcap(const QString& path, const QList<QByteArray>& frames)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        throw std::runtime_error(QString("Cannot write capture %1").arg(path).toStdString());
+    }
+
+    uchar header[PcapFileHeaderLength] = {};
+    qToLittleEndian<uint32_t>(PcapMagic, header);
+    qToLittleEndian<uint16_t>(2, header + 4);       // Version 2.4
+    qToLittleEndian<uint16_t>(4, header + 6);
+    qToLittleEndian<uint32_t>(65535, header + 16);  // Snapshot length
+    qToLittleEndian<uint32_t>(PcapLinkTypeEthernet, header + 20);
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    uint32_t micros = 0;
+    for (const QByteArray& frame : frames) {
+        uchar record[PcapRecordHeaderLength] = {};
+        qToLittleEndian<uint32_t>(micros, record + 4);
+        qToLittleEndian<uint32_t>(static_cast<uint32_t>(frame.size()), record + 8);
+        qToLittleEndian<uint32_t>(static_cast<uint32_t>(frame.size()), record + 12);
+        file.write(reinterpret_cast<const char*>(record), sizeof(record));
+        file.write(frame);
+        micros += 50;
+    }
+}
+
+const QList<QByteArray>& Fixtures::identifyCapture()
+{
+    static QList<QByteArray> frames;
+    if (!frames.isEmpty()) {
+        return frames;
+    }
+
+    QString path = qEnvironmentVariable("PNCONFIG_BENCH_DCP_PCAP");
+    if (path.isEmpty()) {
+        path = QDir(rootDirectory()).filePath("dcp-identify-responses.pcap");
+        writePcap(path, identifyResponses(512));
+    }
+    frames = readPcap(path);
+    if (frames.isEmpty()) {
+        throw std::runtime_error(QString("Capture %1 contains no frames").arg(path).toStdString());
+    }
+    return frames;
+}
+
+} // namespace PNConfigBench
@@ -0,0 +1,81 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#ifndef BENCHMARK_FIXTURES_H
+#define BENCHMARK_FIXTURES_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+namespace PNConfigBench {
+
+/**
+ * @brief Paths of a generated project (Configuration.xml, ListOfNodes.xml, GSDML)
+ */
+struct ProjectFixture {
+    QString directory;
+    QString configPath;
+    QString nodesPath;
+    QString gsdmlPath;
+    int deviceCount = 0;
+};
+
+/**
+ * @brief Synthetic-but-realistic inputs, generated once per size into a temporary directory
+ *
+ * All fixtures are cached for the lifetime of the benchmark process so that
+ * file generation is never part of a measured region.
+ */
+class Fixtures {
+public:
+    /**
+     * @brief GSDML file with the given number of modules
+     *
+     * Each module has 1-4 virtual submodules with mixed input/output data items
+     * and its name resolved through the ExternalTextList, like vendor GSDMLs.
+     */
+    static QString gsdml(int moduleCount);
+
+    /**
+     * @brief Project with one controller and deviceCount IO devices
+     *
+     * Every device references the same 32-module GSDML and configures
+     * 4 modules with 2 submodules each.
+     */
+    static const ProjectFixture& project(int deviceCount);
+
+    /**
+     * @brief DCP Identify response frames from distinct devices
+     *
+     * Frames carry the usual block set (DeviceOptions, Type/NameOfStation,
+     * Device ID, Role, IP suite) and every fourth frame is VLAN tagged.
+     */
+    static const QList<QByteArray>& identifyResponses(int deviceCount);
+
+    /**
+     * @brief Identify response corpus read from a capture file
+     *
+     * PNCONFIG_BENCH_DCP_PCAP may name a capture of real Identify responses
+     * (classic libpcap format, Ethernet link type, e.g. saved from Wireshark).
+     * Without it identifyResponses(512) is written to a capture and read back,
+     * so the same loading path is measured either way.
+     */
+    static const QList<QByteArray>& identifyCapture();
+
+    /**
+     * @brief Frames of a classic libpcap capture with Ethernet link type
+     */
+    static QList<QByteArray> readPcap(const QString& path);
+    static void writePcap(const QString& path, const QList<QByteArray>& frames);
+
+    /**
+     * @brief Directory all fixtures are written to
+     */
+    static QString rootDirectory();
+};
+
+} // namespace PNConfigBench
+
+#endif // BENCHMARK_FIXTURES_H
@@ -0,0 +1,59 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include <PNConfigLib/Network/DcpBlockParser.h>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace PNConfigLib;
+
+namespace {
+
+// Read every byte of a view so the sanitizers see any out-of-frame pointer
+int touch(QByteArrayView view, const uint8_t* begin, const uint8_t* end)
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(view.data());
+    if (!view.isEmpty() && (data < begin || data + view.size() > end)) {
+        abort();
+    }
+    int sum = 0;
+    for (qsizetype i = 0; i < view.size(); ++i) {
+        sum += static_cast<uint8_t>(view[i]);
+    }
+    return sum;
+}
+
+int parseBlocks(const uint8_t* data, int len, const uint8_t* begin, const uint8_t* end)
+{
+    DcpDeviceBlocks blocks;
+    DcpBlockParser::parseResponseBlocks(data, len, blocks);
+    return touch(blocks.typeOfStation, begin, end) + touch(blocks.nameOfStation, begin, end)
+        + touch(blocks.aliasName, begin, end) + touch(blocks.deviceOptions, begin, end)
+        + DcpBlockParser::setResult(data, len);
+}
+
+} // namespace
+
+// Input is one captured frame. Whatever its length fields claim, parsing must
+// stay inside it; the block parsers also get the raw bytes as a block list.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    if (size > 0xFFFF) {
+        return 0;
+    }
+    const int len = static_cast<int>(size);
+    const uint8_t* end = data + len;
+
+    volatile int sink = parseBlocks(data, len, data, end);
+
+    DcpFrameInfo frame;
+    if (DcpBlockParser::parseFrame(data, len, frame)) {
+        if (frame.blocksLength < 0 || frame.blocks < data || frame.blocks + frame.blocksLength > end) {
+            abort();
+        }
+        sink = sink + parseBlocks(frame.blocks, frame.blocksLength, data, end);
+    }
+    (void)sink;
+    return 0;
+}
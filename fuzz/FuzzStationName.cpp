@@ -0,0 +1,34 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include <PNConfigLib/DataModel/NetworkIdentity.h>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace PNConfigLib;
+
+// Station names arrive as arbitrary bytes (DCP NameOfStation, user input).
+// Checking and parsing must stay in bounds, and whatever encodeStationName
+// returns for a non-empty input must pass checkStationName. Its documented
+// failure (an empty result, e.g. for "1.2.3.4") is the only exception.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    const QByteArrayView name(reinterpret_cast<const char*>(data), static_cast<qsizetype>(size));
+
+    NetworkIdentity::checkStationName(name);
+    quint32 address = 0;
+    NetworkIdentity::parseIPv4(name, address);
+
+    if (size == 0) {
+        return 0;
+    }
+    const QByteArray encoded = NetworkIdentity::encodeStationName(name);
+    if (encoded.isEmpty()) {
+        return 0;
+    }
+    if (!NetworkIdentity::checkStationName(encoded.constData(), encoded.size()).isValid()) {
+        abort();
+    }
+    return 0;
+}
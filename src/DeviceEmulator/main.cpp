@@ -0,0 +1,214 @@
+#include <PNConfigLib/DataModel/NetworkIdentity.h>
+#include <PNConfigLib/Emulator/DeviceEmulator.h>
+#include <PNConfigLib/Network/ArExchangeManager.h>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QTimer>
+#include <functional>
+#include <memory>
+#include <vector>
+
+using PNConfigLib::ArExchangeManager;
+using PNConfigLib::ArState;
+using PNConfigLib::DeviceEmulator;
+using PNConfigLib::DeviceProfile;
+using PNConfigLib::EmulatorPhase;
+using PNConfigLib::NetworkIdentity;
+using PNConfigLib::PacketBackend;
+
+// Exit codes
+static const int ExitOk = 0;
+static const int ExitFailed = 1;   // Emulator failed or not all in-process controllers reached Running
+static const int ExitUsage = 2;    // Invalid arguments or unreadable input
+
+// Default segment name for the in-memory backend
+static const char *LoopbackSegment = "pn-emulator";
+
+static bool parseBackend(const QString& name, PacketBackend& backend)
+{
+    if (name == "pcap") backend = PacketBackend::Pcap;
+    else if (name == "mmap") backend = PacketBackend::PacketMmap;
+    else if (name == "loopback") backend = PacketBackend::Loopback;
+    else if (name == "default") backend = PacketBackend::Default;
+    else return false;
+    return true;
+}
+
+static void printSummary(QTextStream& out, const DeviceEmulator& emulator)
+{
+    out << QString("%1 device(s), %2 running\n").arg(emulator.deviceCount()).arg(emulator.runningDeviceCount());
+    out << QString("%1 %2 %3 %4 %5 %6\n")
+        .arg("phase", -32).arg("count", 8).arg("p50 ms", 10).arg("p90 ms", 10).arg("p99 ms", 10).arg("max ms", 10);
+    for (int i = 0; i < (int)EmulatorPhase::Count; ++i) {
+        const PNConfigLib::PhaseSummary s = emulator.phaseSummary(EmulatorPhase(i));
+        out << QString("%1 %2 %3 %4 %5 %6\n")
+            .arg(DeviceEmulator::phaseName(EmulatorPhase(i)), -32)
+            .arg(s.count, 8)
+            .arg(s.p50Ms, 10, 'f', 3)
+            .arg(s.p90Ms, 10, 'f', 3)
+            .arg(s.p99Ms, 10, 'f', 3)
+            .arg(s.maxMs, 10, 'f', 3);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("DeviceEmulator");
+    QCoreApplication::setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Emulates PROFINET IO devices (DCP, CM RPC, cyclic RT) for load-testing the controller side.\n"
+        "Use a veth/tap pair with the pcap or mmap backend, or the in-memory loopback backend.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption interfaceOption(QStringList() << "i" << "interface",
+        "Interface (or loopback segment) to serve the devices on.", "name");
+    QCommandLineOption backendOption(QStringList() << "b" << "backend",
+        "Packet backend: default, pcap, mmap or loopback.", "name", "default");
+    QCommandLineOption gsdmlOption(QStringList() << "g" << "gsdml",
+        "Take identity and modules of the devices from <file>.", "file");
+    QCommandLineOption countOption(QStringList() << "n" << "count",
+        "Number of devices to emulate (default: 1).", "n", "1");
+    QCommandLineOption namePrefixOption("name-prefix",
+        "Station names are <prefix>-<n> (default: pn-device).", "prefix", "pn-device");
+    QCommandLineOption ipBaseOption("ip-base",
+        "Give the devices consecutive addresses starting at <ip>; without it they start unaddressed.", "ip");
+    QCommandLineOption durationOption(QStringList() << "d" << "duration",
+        "Stop after <seconds> and print the statistics (default: run until killed).", "seconds", "0");
+    QCommandLineOption connectOption("connect",
+        "Also run <k> in-process controllers (ArExchangeManager) against the first k devices.", "k", "0");
+    QCommandLineOption reportOption("report",
+        "Write phase latencies and event counters as JSON to <file>.", "file");
+
+    parser.addOptions({ interfaceOption, backendOption, gsdmlOption, countOption, namePrefixOption,
+                        ipBaseOption, durationOption, connectOption, reportOption });
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    PacketBackend backend = PacketBackend::Default;
+    if (!parseBackend(parser.value(backendOption), backend)) {
+        err << "Invalid --backend value: " << parser.value(backendOption) << "\n";
+        return ExitUsage;
+    }
+
+    QString interfaceName = parser.value(interfaceOption);
+    if (interfaceName.isEmpty()) {
+        if (backend != PacketBackend::Loopback) {
+            err << "No interface given\n\n" << parser.helpText();
+            return ExitUsage;
+        }
+        interfaceName = LoopbackSegment;
+    }
+
+    bool ok = false;
+    const int count = parser.value(countOption).toInt(&ok);
+    if (!ok || count < 1) {
+        err << "Invalid --count value: " << parser.value(countOption) << "\n";
+        return ExitUsage;
+    }
+    const int durationS = parser.value(durationOption).toInt(&ok);
+    if (!ok || durationS < 0) {
+        err << "Invalid --duration value: " << parser.value(durationOption) << "\n";
+        return ExitUsage;
+    }
+    const int connectCount = parser.value(connectOption).toInt(&ok);
+    if (!ok || connectCount < 0 || connectCount > count) {
+        err << "Invalid --connect value: " << parser.value(connectOption) << "\n";
+        return ExitUsage;
+    }
+
+    quint32 ipBase = 0;
+    if (parser.isSet(ipBaseOption) && !NetworkIdentity::parseIPv4(parser.value(ipBaseOption), ipBase)) {
+        err << "Invalid --ip-base value: " << parser.value(ipBaseOption) << "\n";
+        return ExitUsage;
+    }
+
+    DeviceProfile profile;
+    if (parser.isSet(gsdmlOption)) {
+        const QString gsdmlPath = parser.value(gsdmlOption);
+        if (!QFileInfo::exists(gsdmlPath)) {
+            err << "Cannot read GSDML: " << gsdmlPath << "\n";
+            return ExitUsage;
+        }
+        profile = DeviceProfile::fromGsdml(gsdmlPath);
+    }
+
+    DeviceEmulator emulator;
+    emulator.setPacketBackend(backend);
+    emulator.addDevices(profile, count, parser.value(namePrefixOption), ipBase);
+    if (!emulator.startEmulation(interfaceName)) {
+        err << "Cannot start emulator on " << interfaceName << ": " << emulator.lastError() << "\n";
+        return ExitFailed;
+    }
+    out << QString("Emulating %1 device(s) \"%2\" on %3\n")
+        .arg(count).arg(profile.typeOfStation, interfaceName);
+    out.flush();
+
+    // In-process controllers, started one after another; start() commissions
+    // the device via DCP and blocks for a few seconds
+    std::vector<std::unique_ptr<ArExchangeManager>> controllers;
+    std::function<void()> startNext = [&]() {
+        const int index = (int)controllers.size();
+        if (index >= connectCount) return;
+
+        const PNConfigLib::VirtualDevice *device = emulator.device(index);
+        // ArExchangeManager talks from 192.168.0.254, so controller-side addresses stay in that subnet
+        const quint32 targetIp = ipBase != 0 ? ipBase + quint32(index) : 0xC0A8000AU + quint32(index);
+
+        auto controller = std::make_unique<ArExchangeManager>();
+        controller->setPacketBackend(backend);
+        if (!controller->start(interfaceName, NetworkIdentity::formatMac(device->mac()),
+                               NetworkIdentity::formatIPv4(targetIp), device->stationName())) {
+            qWarning() << "Controller for" << device->stationName() << "failed:" << controller->lastError();
+        }
+        controllers.push_back(std::move(controller));
+        QTimer::singleShot(0, startNext);
+    };
+    if (connectCount > 0) {
+        QTimer::singleShot(0, startNext);
+    }
+
+    if (durationS > 0) {
+        QTimer::singleShot(durationS * 1000, &app, &QCoreApplication::quit);
+    }
+    app.exec();
+
+    int connected = 0;
+    for (const auto &controller : controllers) {
+        if (controller->state() == ArState::Running) ++connected;
+        controller->stop();
+    }
+    emulator.stopEmulation();
+
+    printSummary(out, emulator);
+    if (connectCount > 0) {
+        out << QString("%1 of %2 controller(s) running\n").arg(connected).arg(connectCount);
+    }
+    out.flush();
+
+    if (parser.isSet(reportOption)) {
+        QJsonObject report = emulator.statsJson();
+        report["controllers"] = connectCount;
+        report["controllersRunning"] = connected;
+
+        QFile file(parser.value(reportOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            err << "Cannot write report: " << parser.value(reportOption) << "\n";
+            return ExitUsage;
+        }
+        file.write(QJsonDocument(report).toJson(QJsonDocument::Indented));
+    }
+
+    return connected == connectCount ? ExitOk : ExitFailed;
+}
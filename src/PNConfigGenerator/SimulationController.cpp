@@ -80,10 +80,10 @@ void SimulationController::start()
     }
 
     const auto &device = devices.first();
-    qDebug() << "Found device:" << device.deviceName << "at" << device.ipAddress << "(" << device.macAddress << ")";
+    qDebug() << "Found device:" << device.deviceName << "at" << device.ipAddress() << "(" << device.macAddress() << ")";
 
     qDebug() << "Initiating AR connection...";
-    if (m_arManager->start(m_nicName, device.macAddress, device.ipAddress, device.deviceName)) {
+    if (m_arManager->start(m_nicName, device.macAddress(), device.ipAddress(), device.deviceName)) {
         qDebug() << "AR connection process started.";
     } else {
         qCritical() << "Failed to start AR connection:" << m_arManager->lastError();
@@ -123,8 +123,17 @@ static QIcon createStopIcon() {
 
 MasterSimulationWidget::MasterSimulationWidget(QWidget *parent)
     : QWidget(parent)
+    , m_projectValidator({std::make_shared<PNConfigLib::DeviceNameRule>(),
+                          std::make_shared<PNConfigLib::IpAddressRule>(),
+                          std::make_shared<PNConfigLib::UniqueIdentityRule>()})
 {
     m_scanner = new PNConfigLib::DcpScanner(this);
+    connect(m_scanner, &PNConfigLib::DcpScanner::scanFinished, this, &MasterSimulationWidget::onScanFinished);
+    // Responses of every scan on m_scanner reach the tree through the inventory
+    m_inventory = new PNConfigLib::DcpInventory(m_scanner, this);
+    connect(m_inventory, &PNConfigLib::DcpInventory::deviceAdded, this, &MasterSimulationWidget::onScanDeviceDiscovered);
+    connect(m_inventory, &PNConfigLib::DcpInventory::deviceChanged, this, &MasterSimulationWidget::onScanDeviceUpdated);
+    connect(m_inventory, &PNConfigLib::DcpInventory::deviceLost, this, &MasterSimulationWidget::onScanDeviceLost);
     m_arManager = new PNConfigLib::ArExchangeManager(this);
     connect(m_arManager, &PNConfigLib::ArExchangeManager::stateChanged, this, &MasterSimulationWidget::onArStateChanged);
     connect(m_arManager, &PNConfigLib::ArExchangeManager::messageLogged, this, &MasterSimulationWidget::onArLogMessage);
@@ -145,6 +154,8 @@ MasterSimulationWidget::~MasterSimulationWidget()
 {
     if (m_arManager) m_arManager->stop();
     if (flashTimer) flashTimer->stop();
+    // Before m_scanner goes away with the other children; stop() cancels its own round
+    m_inventory->stop();
 }
 
 void MasterSimulationWidget::setupUi()
@@ -639,6 +650,7 @@ void MasterSimulationWidget::onRemoveFromConfiguration()
 
     QString deviceName = item->text(0);
     delete item;
+    reloadProjectValidation();
     
     // Clear slot view if the device was viewing
     // (In a more robust version, we'd check if center panel currently belongs to this device)
@@ -959,13 +971,19 @@ void MasterSimulationWidget::showBasicConfig(const PNConfigLib::GsdmlInfo &info,
     // Auto-save edited configuration to item data
     if (item) {
         // Save station name when edited
-        connect(editProjectName, &QLineEdit::textChanged, [item](const QString &text) {
-            if (item) item->setText(0, text);
+        connect(editProjectName, &QLineEdit::textChanged, this, [this, item](const QString &text) {
+            if (!item) return;
+            item->setText(0, text);
+            m_projectValidator.setDeviceName(stationsItem->indexOfChild(item), text);
+            showProjectValidation(item);
         });
         
         // Save IP configuration when edited
-        connect(editProjectIp, &QLineEdit::textChanged, [item](const QString &text) {
-            if (item) item->setData(0, RoleIpAddress, text);
+        connect(editProjectIp, &QLineEdit::textChanged, this, [this, item](const QString &text) {
+            if (!item) return;
+            item->setData(0, RoleIpAddress, text);
+            m_projectValidator.setIpAddress(stationsItem->indexOfChild(item), text);
+            showProjectValidation(item);
         });
         
         connect(editProjectMask, &QLineEdit::textChanged, [item](const QString &text) {
@@ -975,6 +993,10 @@ void MasterSimulationWidget::showBasicConfig(const PNConfigLib::GsdmlInfo &info,
         connect(editProjectGw, &QLineEdit::textChanged, [item](const QString &text) {
             if (item) item->setData(0, RoleGateway, text);
         });
+
+        // The IP shown may be the default rather than a stored one
+        m_projectValidator.setIpAddress(stationsItem->indexOfChild(item), editProjectIp->text());
+        showProjectValidation(item);
     }
 
     // 3. IO Cycle Time
@@ -1010,20 +1032,8 @@ void MasterSimulationWidget::onAddToConfiguration()
 
     QString deviceName = item->text(0);
     
-    // Check for duplicates and append a suffix if needed
-    int count = 1;
-    QString finalName = deviceName;
-    bool exists = true;
-    while (exists) {
-        exists = false;
-        for (int i = 0; i < stationsItem->childCount(); ++i) {
-            if (stationsItem->child(i)->text(0) == finalName) {
-                exists = true;
-                finalName = QString("%1-%2").arg(deviceName).arg(count++);
-                break;
-            }
-        }
-    }
+    // Append a suffix if the name is already used
+    QString finalName = uniqueStationName(deviceName);
 
     QTreeWidgetItem *newStation = new QTreeWidgetItem(stationsItem, QStringList() << finalName);
     newStation->setIcon(0, qApp->style()->standardIcon(QStyle::SP_ComputerIcon));
@@ -1033,6 +1043,7 @@ void MasterSimulationWidget::onAddToConfiguration()
     newStation->setData(0, Qt::UserRole, catalogData);
     
     stationsItem->setExpanded(true);
+    reloadProjectValidation();
     statusLabel->setText(QString(" 已将设备 %1 添加到配置").arg(finalName));
 }
 
@@ -1172,6 +1183,98 @@ void MasterSimulationWidget::clearConfigArea()
     m_outputSpinBoxes.clear();
 }
 
+void MasterSimulationWidget::reloadProjectValidation()
+{
+    // Each station is a decentral device; only names and IPs are checked here
+    PNConfigLib::Configuration config;
+    if (stationsItem) {
+        for (int i = 0; i < stationsItem->childCount(); ++i) {
+            QTreeWidgetItem *station = stationsItem->child(i);
+            PNConfigLib::DecentralDeviceType device;
+            device.deviceRefID = QString("Station_%1").arg(i + 1);
+            device.ethernetAddresses.deviceName = station->text(0);
+            device.ethernetAddresses.ipAddress = station->data(0, RoleIpAddress).toString();
+            config.decentralDevices.append(device);
+        }
+    }
+    m_projectValidator.load(config, PNConfigLib::ListOfNodes());
+}
+
+void MasterSimulationWidget::showProjectValidation(QTreeWidgetItem *item)
+{
+    if (!item || !stationsItem || item->parent() != stationsItem) return;
+
+    QStringList nameErrors;
+    QStringList ipErrors;
+    const auto messages = m_projectValidator.deviceMessages(stationsItem->indexOfChild(item));
+    for (const auto &log : messages) {
+        if (log.field == PNConfigLib::ConsistencyField::IpAddress) {
+            ipErrors.append(log.message);
+        } else {
+            nameErrors.append(log.message);
+        }
+    }
+
+    auto mark = [](QLineEdit *edit, const QStringList &errors) {
+        if (!edit) return;
+        edit->setStyleSheet(errors.isEmpty() ? QString() : QString("border: 1px solid red;"));
+        edit->setToolTip(errors.join("\n"));
+    };
+    mark(editProjectName, nameErrors);
+    mark(editProjectIp, ipErrors);
+}
+
+QString MasterSimulationWidget::uniqueStationName(const QString &baseName) const
+{
+    using PNConfigLib::NetworkIdentity;
+
+    // Catalog names ("IO-Device_1", non-ASCII text) are not valid NameOfStation values
+    QString base = QString::fromLatin1(NetworkIdentity::encodeStationName(baseName.toUtf8()));
+    if (base.isEmpty()) base = "device";
+
+    // Index once; station names compare case-insensitively like on the wire
+    PNConfigLib::UniquenessIndex names;
+    for (int i = 0; stationsItem && i < stationsItem->childCount(); ++i) {
+        names.setName(i, stationsItem->child(i)->text(0));
+    }
+
+    int count = 1;
+    QString finalName = base;
+    while (names.isNameTaken(finalName)) {
+        // Shorten the last label so the suffixed name stays within the label and name limits
+        const QString suffix = QString("-%1").arg(count++);
+        const qsizetype labelStart = base.lastIndexOf('.') + 1;
+        QString head = base.left(qMin<qsizetype>(labelStart + NetworkIdentity::MaxLabelLength - suffix.size(),
+                                                 NetworkIdentity::MaxStationNameLength - suffix.size()));
+        while (head.endsWith('-') || head.endsWith('.')) head.chop(1);
+        finalName = head + suffix;
+    }
+    return finalName;
+}
+
+bool MasterSimulationWidget::confirmOnlineIdentity(int index, const QString &name, const QString &ip)
+{
+    QStringList conflicts;
+    if (!name.isEmpty() && m_onlineIdentities.isNameTaken(name, index)) {
+        conflicts.append(QString("站名称 %1").arg(name));
+    }
+    if (!ip.isEmpty()) {
+        quint32 address = 0;
+        if (!PNConfigLib::NetworkIdentity::parseIPv4(ip, address)) {
+            QMessageBox::warning(this, "参数错误", QString("IP 地址格式无效: %1").arg(ip));
+            return false;
+        }
+        if (address != 0 && m_onlineIdentities.isIpAddressTaken(address, index)) {
+            conflicts.append(QString("IP 地址 %1").arg(ip));
+        }
+    }
+    if (conflicts.isEmpty()) return true;
+
+    return QMessageBox::question(this, "地址冲突",
+        QString("%1 已被网络中的其他设备使用，是否继续?").arg(conflicts.join("、")))
+        == QMessageBox::Yes;
+}
+
 void MasterSimulationWidget::onImportGsdml()
 {
     QString fileName = QFileDialog::getOpenFileName(this, 
@@ -1191,24 +1294,20 @@ void MasterSimulationWidget::onScanClicked()
 {
     if (!m_scanner->isConnected()) return;
 
-    statusLabel->setText(" 正在扫描网络中的 PROFINET 设备...");
-    onlineTree->clear();
-    
-    m_onlineDevices = m_scanner->scan();
-    for (int i = 0; i < m_onlineDevices.size(); ++i) {
-        const auto &device = m_onlineDevices[i];
-        QTreeWidgetItem *item = new QTreeWidgetItem(onlineTree);
-        item->setText(0, device.deviceName);
-        item->setText(1, device.ipAddress);
-        item->setData(0, Qt::UserRole, i); // Store index
-    }
-    
-    if (m_onlineDevices.isEmpty()) {
-        statusLabel->setText(" 未发现 PROFINET 设备");
-    } else {
-        statusLabel->setText(QString(" 发现 %1 个 PROFINET 设备").arg(m_onlineDevices.size()));
-        rightTabWidget->setCurrentIndex(2); // Switch to Online tab
+    m_userScanPending = true;
+    btnScan->setEnabled(false);
+    if (m_scanner->isScanning()) {
+        // Start a fresh round after the running one, so changes made just now show up
+        m_scanQueued = true;
+        statusLabel->setText(" 正在等待当前扫描结束...");
+        return;
     }
+
+    statusLabel->setText(" 正在扫描网络中的 PROFINET 设备...");
+
+    // Run an inventory round now: known stations are refreshed, new ones appended
+    // and stations that missed several rounds are removed by onScanDeviceLost
+    m_inventory->refresh();
     
     if (flashState) {
         statusLed->setStyleSheet("background-color: #00FF00; border: 2px solid #ccc; border-radius: 10px;"); // Bright green
@@ -1219,6 +1318,96 @@ void MasterSimulationWidget::onScanClicked()
     flashRemaining--;
 }
 
+void MasterSimulationWidget::onScanDeviceDiscovered(const PNConfigLib::DiscoveredDevice &device)
+{
+    if (m_onlineDevices.indexOf(device.mac) >= 0) {
+        onScanDeviceUpdated(device);
+        return;
+    }
+
+    const int index = m_onlineDevices.insert(device);
+    m_onlineIdentities.setName(index, device.deviceName);
+    m_onlineIdentities.setIpAddress(index, device.ip);
+
+    QTreeWidgetItem *item = new QTreeWidgetItem(onlineTree);
+    item->setText(0, device.deviceName);
+    item->setText(1, device.ipAddress());
+    item->setData(0, Qt::UserRole, index); // Store index
+
+    if (index == 0) {
+        rightTabWidget->setCurrentIndex(2); // Switch to Online tab
+    }
+    if (m_userScanPending) {
+        statusLabel->setText(QString(" 正在扫描... 已发现 %1 个 PROFINET 设备").arg(m_onlineDevices.size()));
+    } else {
+        statusLabel->setText(QString(" 发现新设备 %1 (%2)").arg(device.deviceName, device.macAddress()));
+    }
+}
+
+void MasterSimulationWidget::onScanDeviceUpdated(const PNConfigLib::DiscoveredDevice &device)
+{
+    const int index = m_onlineDevices.indexOf(device.mac);
+    if (index < 0) return;
+
+    m_onlineDevices.insert(device);
+    m_onlineIdentities.setName(index, device.deviceName);
+    m_onlineIdentities.setIpAddress(index, device.ip);
+
+    QTreeWidgetItem *item = onlineTree->topLevelItem(index);
+    if (item) {
+        item->setText(0, device.deviceName);
+        item->setText(1, device.ipAddress());
+        if (item == onlineTree->currentItem()) onOnlineTreeSelectionChanged();
+    }
+}
+
+void MasterSimulationWidget::onScanDeviceLost(const PNConfigLib::DiscoveredDevice &device)
+{
+    const int index = m_onlineDevices.indexOf(device.mac);
+    if (index < 0) return;
+
+    // Later stations move up by one; renumber their items and the identity
+    // owners before the item goes, so the selection change sees the new layout
+    m_onlineDevices.remove(device.mac);
+    m_onlineIdentities.clear();
+    for (int i = 0; i < m_onlineDevices.size(); ++i) {
+        m_onlineIdentities.setName(i, m_onlineDevices[i].deviceName);
+        m_onlineIdentities.setIpAddress(i, m_onlineDevices[i].ip);
+    }
+    for (int i = index + 1; i < onlineTree->topLevelItemCount(); ++i) {
+        onlineTree->topLevelItem(i)->setData(0, Qt::UserRole, i - 1);
+    }
+    delete onlineTree->takeTopLevelItem(index);
+
+    statusLabel->setText(QString(" 设备 %1 (%2) 已离线").arg(device.deviceName, device.macAddress()));
+}
+
+void MasterSimulationWidget::onScanFinished(const QList<PNConfigLib::DiscoveredDevice> &devices)
+{
+    // DcpInventory handles scanFinished after us; reuse the scanner once it has
+    if (m_pendingNameMac != 0) {
+        const quint64 mac = m_pendingNameMac;
+        m_pendingNameMac = 0;
+        QTimer::singleShot(0, this, [this, mac]() { readStationName(mac); });
+    }
+    if (m_scanQueued) {
+        m_scanQueued = false;
+        QTimer::singleShot(0, this, &MasterSimulationWidget::onScanClicked);
+        return;
+    }
+
+    // Periodic inventory rounds report through the device signals only
+    if (!m_userScanPending) return;
+    m_userScanPending = false;
+    btnScan->setEnabled(m_isConnected);
+
+    if (devices.isEmpty()) {
+        statusLabel->setText(" 未发现 PROFINET 设备");
+    } else {
+        statusLabel->setText(QString(" 发现 %1 个 PROFINET 设备").arg(devices.size()));
+    }
+}
+
 void MasterSimulationWidget::onConnectClicked()
 {
     if (!m_isConnected) {
@@ -1230,16 +1419,22 @@ void MasterSimulationWidget::onConnectClicked()
             btnScan->setEnabled(true);
             nicComboBox->setEnabled(false);
             statusLabel->setText(QString(" 已连接到: %1").arg(nicComboBox->currentText()));
+            m_inventory->start();
         } else {
             btnConnect->setChecked(false);
             btnConnect->setIcon(createConnectIcon());
             QMessageBox::critical(this, "连接错误", "无法连接到选定的网卡。");
         }
     } else {
+        m_inventory->stop();
+        m_inventory->clear();
         m_scanner->disconnectFromInterface();
         m_arManager->stop();
         m_isConnected = false;
         m_isArRunning = false;
+        m_userScanPending = false;
+        m_scanQueued = false;
+        m_pendingNameMac = 0;
         btnConnect->setChecked(false);
         btnConnect->setIcon(createConnectIcon());
         btnScan->setEnabled(false);
@@ -1251,6 +1446,7 @@ void MasterSimulationWidget::onConnectClicked()
         // Clear online list and details
         onlineTree->clear();
         m_onlineDevices.clear();
+        m_onlineIdentities.clear();
         onlinePropGroup->setVisible(false);
         onOnlineTreeSelectionChanged(); // Reset property views
     }
@@ -1310,30 +1506,19 @@ void MasterSimulationWidget::onAddOnlineToConfiguration()
     QString baseName = onlineDevice.deviceName;
     if (baseName.isEmpty()) baseName = m_cachedDevices[gsdmlIndex].deviceName;
     
-    int count = 1;
-    QString finalName = baseName;
-    bool exists = true;
-    while (exists) {
-        exists = false;
-        for (int i = 0; i < stationsItem->childCount(); ++i) {
-            if (stationsItem->child(i)->text(0) == finalName) {
-                exists = true;
-                finalName = QString("%1-%2").arg(baseName).arg(count++);
-                break;
-            }
-        }
-    }
+    QString finalName = uniqueStationName(baseName);
 
     QTreeWidgetItem *newStation = new QTreeWidgetItem(stationsItem, QStringList() << finalName);
     newStation->setIcon(0, qApp->style()->standardIcon(QStyle::SP_ComputerIcon));
     newStation->setData(0, Qt::UserRole, gsdmlIndex);
     
     // Initialize network configuration from online device
-    newStation->setData(0, RoleIpAddress, onlineDevice.ipAddress);
-    newStation->setData(0, RoleSubnetMask, onlineDevice.subnetMask);
-    newStation->setData(0, RoleGateway, onlineDevice.gateway);
+    newStation->setData(0, RoleIpAddress, onlineDevice.ipAddress());
+    newStation->setData(0, RoleSubnetMask, onlineDevice.subnetMask());
+    newStation->setData(0, RoleGateway, onlineDevice.gateway());
     
     stationsItem->setExpanded(true);
+    reloadProjectValidation();
     statusLabel->setText(QString(" 已将在线设备 %1 添加到配置").arg(finalName));
 }
 
@@ -1346,16 +1531,17 @@ void MasterSimulationWidget::onSetIp()
     if (index < 0 || index >= m_onlineDevices.size()) return;
 
     const auto &device = m_onlineDevices[index];
-    QString mac = device.macAddress;
-    QString currentIp = device.ipAddress;
-    QString currentMask = device.subnetMask;
-    QString currentGw = device.gateway;
+    QString mac = device.macAddress();
+    QString currentIp = device.ipAddress();
+    QString currentMask = device.subnetMask();
+    QString currentGw = device.gateway();
 
     bool ok;
     QString newIp = QInputDialog::getText(this, "修改 IP 地址", 
         QString("请输入设备 %1 的新 IP 地址:").arg(mac), QLineEdit::Normal, currentIp, &ok);
     
     if (ok && !newIp.isEmpty()) {
+        if (!confirmOnlineIdentity(index, QString(), newIp)) return;
         if (m_scanner->setDeviceIp(mac, newIp, currentMask, currentGw)) {
             statusLabel->setText(QString(" 已发送 IP 修改请求: %1 -> %2").arg(mac, newIp));
             // Re-scan after a delay to allow the device to apply the change
@@ -1377,17 +1563,17 @@ void MasterSimulationWidget::onOnlineTreeSelectionChanged()
             onlinePropDeviceId->setText(QString("16#%1").arg(d.deviceId, 4, 16, QChar('0')).toUpper());
             onlinePropVendorId->setText(QString("16#%1").arg(d.vendorId, 4, 16, QChar('0')).toUpper());
             onlinePropType->setText(d.deviceType);
-            onlinePropIp->setText(d.ipAddress);
-            onlinePropMask->setText(d.subnetMask);
-            onlinePropGw->setText(d.gateway);
-            onlinePropMac->setText(d.macAddress.toUpper().remove(':').remove('-'));
+            onlinePropIp->setText(d.ipAddress());
+            onlinePropMask->setText(d.subnetMask());
+            onlinePropGw->setText(d.gateway());
+            onlinePropMac->setText(d.macAddress().toUpper().remove(':').remove('-'));
             onlinePropRole->setText("设备");
             
             // Auto-populate Setup Tab fields
             editOnlineName->setText(d.deviceName);
-            editOnlineIp->setText(d.ipAddress);
-            editOnlineMask->setText(d.subnetMask);
-            editOnlineGw->setText(d.gateway);
+            editOnlineIp->setText(d.ipAddress());
+            editOnlineMask->setText(d.subnetMask());
+            editOnlineGw->setText(d.gateway());
 
             onlinePropGsdml->setText("P-Net multi-module sample app (GSDML-V2.4)");
             onlinePropGroup->setVisible(true);
@@ -1421,11 +1607,43 @@ void MasterSimulationWidget::onGetStationName()
     QTreeWidgetItem *item = onlineTree->currentItem();
     if (!item) return;
     int index = item->data(0, Qt::UserRole).toInt();
-    if (index >= 0 && index < m_onlineDevices.size()) {
-        const auto &device = m_onlineDevices[index];
-        editOnlineName->setText(device.deviceName);
-        statusLabel->setText(QString(" 已获取站名称: %1").arg(device.deviceName));
+    if (index < 0 || index >= m_onlineDevices.size()) return;
+
+    // Show the name from the last scan until the station itself answers
+    editOnlineName->setText(m_onlineDevices[index].deviceName);
+    readStationName(m_onlineDevices[index].mac);
+}
+
+void MasterSimulationWidget::readStationName(quint64 mac)
+{
+    const int index = m_onlineDevices.indexOf(mac);
+    if (index < 0 || !m_scanner->isConnected()) return;
+
+    const PNConfigLib::DiscoveredDevice device = m_onlineDevices[index];
+    if (m_scanner->isScanning()) {
+        m_pendingNameMac = mac;
+        statusLabel->setText(QString(" 正在等待当前扫描结束，随后读取 %1 的站名称...").arg(device.macAddress()));
+        return;
     }
+
+    // Ask the station itself: a filtered Identify returns as soon as it answers
+    PNConfigLib::DcpIdentifyFilter filter = device.ip != 0
+        ? PNConfigLib::DcpIdentifyFilter::byIp(device.ip, device.mask, device.gw)
+        : PNConfigLib::DcpIdentifyFilter::byDeviceId(device.vendorId, device.deviceId);
+    filter.expectedMac = device.mac;
+
+    for (const PNConfigLib::DiscoveredDevice &found : m_scanner->identify(filter)) {
+        if (found.mac != device.mac) continue;
+        onScanDeviceUpdated(found);
+        // The selection may have moved while the request was queued
+        QTreeWidgetItem *item = onlineTree->currentItem();
+        if (item && item->data(0, Qt::UserRole).toInt() == m_onlineDevices.indexOf(mac)) {
+            editOnlineName->setText(found.deviceName);
+        }
+        statusLabel->setText(QString(" 已获取站名称: %1").arg(found.deviceName));
+        return;
+    }
+    statusLabel->setText(" 设备未响应，显示上次扫描的站名称");
 }
 
 void MasterSimulationWidget::onSetStationName()
@@ -1435,7 +1653,7 @@ void MasterSimulationWidget::onSetStationName()
     int index = item->data(0, Qt::UserRole).toInt();
     if (index < 0 || index >= m_onlineDevices.size()) return;
 
-    QString mac = m_onlineDevices[index].macAddress;
+    QString mac = m_onlineDevices[index].macAddress();
     QString newName = editOnlineName->text().trimmed();
     bool permanent = chkNamePermanent->isChecked();
 
@@ -1443,6 +1661,7 @@ void MasterSimulationWidget::onSetStationName()
         QMessageBox::warning(this, "参数错误", "站名称不能为空。");
         return;
     }
+    if (!confirmOnlineIdentity(index, newName, QString())) return;
 
     if (m_scanner->setDeviceName(mac, newName, permanent)) {
         statusLabel->setText(QString(" 修改站名称成功: %1 (%2)")
@@ -1460,10 +1679,10 @@ void MasterSimulationWidget::onGetIpConfig()
     int index = item->data(0, Qt::UserRole).toInt();
     if (index >= 0 && index < m_onlineDevices.size()) {
         const auto &d = m_onlineDevices[index];
-        editOnlineIp->setText(d.ipAddress);
-        editOnlineMask->setText(d.subnetMask);
-        editOnlineGw->setText(d.gateway);
-        statusLabel->setText(QString(" 已获取 IP 配置: %1").arg(d.ipAddress));
+        editOnlineIp->setText(d.ipAddress());
+        editOnlineMask->setText(d.subnetMask());
+        editOnlineGw->setText(d.gateway());
+        statusLabel->setText(QString(" 已获取 IP 配置: %1").arg(d.ipAddress()));
     }
 }
 
@@ -1474,12 +1693,14 @@ void MasterSimulationWidget::onSetIpConfig()
     int index = item->data(0, Qt::UserRole).toInt();
     if (index < 0 || index >= m_onlineDevices.size()) return;
 
-    QString mac = m_onlineDevices[index].macAddress;
+    QString mac = m_onlineDevices[index].macAddress();
     QString ip = editOnlineIp->text();
     QString mask = editOnlineMask->text();
     QString gw = editOnlineGw->text();
     bool permanent = chkIpPermanent->isChecked();
 
+    if (!confirmOnlineIdentity(index, QString(), ip)) return;
+
     if (m_scanner->setDeviceIp(mac, ip, mask, gw, permanent)) {
         statusLabel->setText(QString(" 修改 IP 配置成功: %1 (%2)")
             .arg(ip, permanent ? "永久" : "临时"));
@@ -1496,7 +1717,7 @@ void MasterSimulationWidget::onResetToFactory()
     int index = item->data(0, Qt::UserRole).toInt();
     if (index < 0 || index >= m_onlineDevices.size()) return;
 
-    QString mac = m_onlineDevices[index].macAddress;
+    QString mac = m_onlineDevices[index].macAddress();
     
     if (QMessageBox::question(this, "工厂重置", 
         QString("确定要对设备 %1 进行工厂重置吗？").arg(mac)) != QMessageBox::Yes) 
@@ -1519,7 +1740,7 @@ void MasterSimulationWidget::onFlashLed()
     int index = item->data(0, Qt::UserRole).toInt();
     if (index < 0 || index >= m_onlineDevices.size()) return;
 
-    QString mac = m_onlineDevices[index].macAddress;
+    QString mac = m_onlineDevices[index].macAddress();
     
     // Set to yellow (waiting)
     statusLed->setStyleSheet("background-color: yellow; border: 2px solid #ccc; border-radius: 10px;");
@@ -1594,7 +1815,7 @@ void MasterSimulationWidget::onStartCommunication()
         bool found = false;
         for (const auto &device : m_onlineDevices) {
             if (device.deviceName == stationName) {
-                mac = device.macAddress;
+                mac = device.macAddress();
                 found = true;
                 break;
             }
@@ -1603,8 +1824,8 @@ void MasterSimulationWidget::onStartCommunication()
         if (!found) {
             // Fallback: match by IP
             for (const auto &device : m_onlineDevices) {
-                if (device.ipAddress == ip && !ip.isEmpty() && ip != "0.0.0.0") {
-                    mac = device.macAddress;
+                if (device.ipAddress() == ip && !ip.isEmpty() && ip != "0.0.0.0") {
+                    mac = device.macAddress();
                     found = true;
                     break;
                 }
@@ -20,7 +20,9 @@
 #include <QLineEdit>
 #include "../PNConfigLib/GsdmlParser/GsdmlParser.h"
 #include "../PNConfigLib/Network/DcpScanner.h"
+#include "../PNConfigLib/Network/DcpInventory.h"
 #include "../PNConfigLib/Network/ArExchangeManager.h"
+#include "../PNConfigLib/Consistency/IncrementalValidator.h"
 
 namespace PNConfigLib {
     class GsdmlInfo;
@@ -39,6 +41,10 @@ public:
 
 private slots:
     void onScanClicked();
+    void onScanDeviceDiscovered(const PNConfigLib::DiscoveredDevice &device);
+    void onScanDeviceUpdated(const PNConfigLib::DiscoveredDevice &device);
+    void onScanDeviceLost(const PNConfigLib::DiscoveredDevice &device);
+    void onScanFinished(const QList<PNConfigLib::DiscoveredDevice> &devices);
     void onConnectClicked();
     void onImportGsdml();
     void onCatalogSelectionChanged();
@@ -82,6 +88,11 @@ private:
     void displayDeviceSlots(const PNConfigLib::GsdmlInfo &info);
     void showBasicConfig(const PNConfigLib::GsdmlInfo &info, QTreeWidgetItem *item = nullptr);
     void clearConfigArea();
+    void reloadProjectValidation();
+    void showProjectValidation(QTreeWidgetItem *item);
+    QString uniqueStationName(const QString &baseName) const;
+    bool confirmOnlineIdentity(int index, const QString &name, const QString &ip);
+    void readStationName(quint64 mac);
 
     enum TreeItemRoles {
         RoleGsdmlIndex = Qt::UserRole,
@@ -100,12 +111,18 @@ private:
     QPushButton *btnStart;
     bool m_isConnected = false;
     bool m_isArRunning = false;
+    // DcpInventory holds m_scanner for the response window of each round;
+    // requests arriving meanwhile are run once its scanFinished is through
+    bool m_userScanPending = false;     // Scan started from the toolbar, reported by onScanFinished
+    bool m_scanQueued = false;
+    quint64 m_pendingNameMac = 0;
     
     QTreeWidget *projectTree;
     QTreeWidgetItem *stationsItem;
     
     QTreeWidget *onlineTree;
     PNConfigLib::DcpScanner *m_scanner;
+    PNConfigLib::DcpInventory *m_inventory;     // Drives onlineTree while connected
     PNConfigLib::ArExchangeManager *m_arManager;
     
     // Center panel
@@ -140,8 +157,12 @@ private:
     QComboBox *comboProjectIoCycle;
     QLineEdit *editProjectWatchdog;
 
+    // Station names/IPs, re-checked per edit
+    PNConfigLib::IncrementalValidator m_projectValidator;
+
     // Online Properties view
-    QList<PNConfigLib::DiscoveredDevice> m_onlineDevices;
+    PNConfigLib::DiscoveredDeviceList m_onlineDevices;
+    PNConfigLib::UniquenessIndex m_onlineIdentities;   // Owners are m_onlineDevices indices
     QGroupBox *onlinePropGroup;
     QLabel *onlinePropName;
     QLabel *onlinePropDeviceId;
@@ -170,8 +191,4 @@ private:
     QMap<int, class QSpinBox*> m_outputSpinBoxes;
 };
 
-#include <QMetaType>
-Q_DECLARE_METATYPE(PNConfigLib::DiscoveredDevice)
-Q_DECLARE_METATYPE(QList<PNConfigLib::DiscoveredDevice>)
-
 #endif // MASTERSIMULATIONWIDGET_H
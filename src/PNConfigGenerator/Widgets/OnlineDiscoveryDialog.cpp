@@ -11,8 +11,12 @@ OnlineDiscoveryDialog::OnlineDiscoveryDialog(PNConfigLib::DcpScanner *scanner, Q
     setupUi();
     updateInterfaceList();
     
-    m_searchTimer = new QTimer(this);
-    connect(m_searchTimer, &QTimer::timeout, this, &OnlineDiscoveryDialog::onUpdateResults);
+    // The table follows the inventory's deltas; it is never cleared while searching
+    m_inventory = new PNConfigLib::DcpInventory(m_scanner, this);
+    connect(m_inventory, &PNConfigLib::DcpInventory::deviceAdded, this, &OnlineDiscoveryDialog::onDeviceAdded);
+    connect(m_inventory, &PNConfigLib::DcpInventory::deviceChanged, this, &OnlineDiscoveryDialog::onDeviceChanged);
+    connect(m_inventory, &PNConfigLib::DcpInventory::deviceLost, this, &OnlineDiscoveryDialog::onDeviceLost);
+    connect(m_inventory, &PNConfigLib::DcpInventory::roundFinished, this, &OnlineDiscoveryDialog::onRoundFinished);
     
     setWindowTitle("可访问设备 (Online Discovery)");
     resize(800, 500);
@@ -162,6 +166,8 @@ void OnlineDiscoveryDialog::onStartSearch()
 
     startBtn->setEnabled(false);
     stopBtn->setEnabled(true);
+    m_inventory->clear();
+    m_discoveredDevices.clear();
     deviceTable->setRowCount(0);
     progressBar->setValue(0);
 
@@ -179,38 +185,63 @@ void OnlineDiscoveryDialog::onStartSearch()
     });
     pbTimer->start(100);
 
-    onUpdateResults();
+    // Keeps searching in the background until stopped
+    m_inventory->start();
 }
 
 void OnlineDiscoveryDialog::onStopSearch()
 {
+    m_inventory->stop();
     startBtn->setEnabled(true);
     stopBtn->setEnabled(false);
 }
 
-void OnlineDiscoveryDialog::onUpdateResults()
+void OnlineDiscoveryDialog::onRoundFinished(int deviceCount)
 {
-    QApplication::setOverrideCursor(Qt::WaitCursor);
-    m_discoveredDevices = m_scanner->scan();
-    QApplication::restoreOverrideCursor();
+    Q_UNUSED(deviceCount);
+    progressBar->setValue(100);
+}
 
-    deviceTable->setRowCount(0);
-    for (int i = 0; i < m_discoveredDevices.size(); ++i) {
-        const auto &device = m_discoveredDevices[i];
-        int row = deviceTable->rowCount();
-        deviceTable->insertRow(row);
-        
-        QTableWidgetItem *nameItem = new QTableWidgetItem(device.deviceName);
-        nameItem->setData(Qt::UserRole, i); // Store index
-        deviceTable->setItem(row, 0, nameItem);
-        
-        deviceTable->setItem(row, 1, new QTableWidgetItem(device.deviceType));
-        deviceTable->setItem(row, 2, new QTableWidgetItem(device.macAddress));
-        deviceTable->setItem(row, 3, new QTableWidgetItem(device.ipAddress));
-        deviceTable->setItem(row, 4, new QTableWidgetItem(device.subnetMask));
+void OnlineDiscoveryDialog::onDeviceAdded(const PNConfigLib::DiscoveredDevice &device)
+{
+    int index = m_discoveredDevices.insert(device);
+    deviceTable->insertRow(index);
+    fillRow(index, device);
+}
+
+void OnlineDiscoveryDialog::onDeviceChanged(const PNConfigLib::DiscoveredDevice &device)
+{
+    int index = m_discoveredDevices.indexOf(device.mac);
+    if (index < 0) return;
+
+    m_discoveredDevices.insert(device);
+    fillRow(index, device);
+    if (deviceTable->currentRow() == index) onTableSelectionChanged();
+}
+
+void OnlineDiscoveryDialog::onDeviceLost(const PNConfigLib::DiscoveredDevice &device)
+{
+    int index = m_discoveredDevices.indexOf(device.mac);
+    if (index < 0) return;
+
+    // Rows mirror the list, so both shift up together
+    m_discoveredDevices.remove(device.mac);
+    deviceTable->removeRow(index);
+    for (int row = index; row < deviceTable->rowCount(); ++row) {
+        deviceTable->item(row, 0)->setData(Qt::UserRole, row);
     }
+}
 
-    onStopSearch();
+void OnlineDiscoveryDialog::fillRow(int row, const PNConfigLib::DiscoveredDevice &device)
+{
+    QTableWidgetItem *nameItem = new QTableWidgetItem(device.deviceName);
+    nameItem->setData(Qt::UserRole, row); // Store index
+    deviceTable->setItem(row, 0, nameItem);
+
+    deviceTable->setItem(row, 1, new QTableWidgetItem(device.deviceType));
+    deviceTable->setItem(row, 2, new QTableWidgetItem(device.macAddress()));
+    deviceTable->setItem(row, 3, new QTableWidgetItem(device.ipAddress()));
+    deviceTable->setItem(row, 4, new QTableWidgetItem(device.subnetMask()));
 }
 
 void OnlineDiscoveryDialog::onTableSelectionChanged()
@@ -230,10 +261,10 @@ void OnlineDiscoveryDialog::onTableSelectionChanged()
             propDeviceId->setText(QString("16#%1").arg(d.deviceId, 4, 16, QChar('0')).toUpper());
             propVendorId->setText(QString("16#%1").arg(d.vendorId, 4, 16, QChar('0')).toUpper());
             propType->setText(d.deviceType);
-            propIp->setText(d.ipAddress);
-            propMask->setText(d.subnetMask);
-            propGw->setText(d.gateway);
-            propMac->setText(d.macAddress.toUpper().remove(':').remove('-'));
+            propIp->setText(d.ipAddress());
+            propMask->setText(d.subnetMask());
+            propGw->setText(d.gateway());
+            propMac->setText(d.macAddress().toUpper().remove(':').remove('-'));
         }
     } else {
         propName->setText("-");
@@ -276,7 +307,7 @@ void OnlineDiscoveryDialog::onAssignIp()
 
     if (m_scanner->setDeviceIp(mac, newIp, currentMask, currentGw)) {
         QMessageBox::information(this, "完成", "IP 修改指令已发送。");
-        onUpdateResults();
+        m_inventory->refresh();
     } else {
         QMessageBox::warning(this, "错误", "发送失败。");
     }
@@ -295,7 +326,7 @@ void OnlineDiscoveryDialog::onAssignName()
 
     if (m_scanner->setDeviceName(mac, newName)) {
         QMessageBox::information(this, "完成", "名称分配指令已发送。");
-        onUpdateResults();
+        m_inventory->refresh();
     } else {
         QMessageBox::warning(this, "错误", "发送失败。");
     }
@@ -16,6 +16,7 @@
 #include <QGroupBox>
 #include <QFormLayout>
 #include "../../PNConfigLib/Network/DcpScanner.h"
+#include "../../PNConfigLib/Network/DcpInventory.h"
 
 namespace PNConfigLib {
     class DcpScanner;
@@ -35,12 +36,16 @@ private slots:
     void onFlashLed();
     void onAssignIp();
     void onAssignName();
-    void onUpdateResults();
     void onTableSelectionChanged();
+    void onDeviceAdded(const PNConfigLib::DiscoveredDevice &device);
+    void onDeviceChanged(const PNConfigLib::DiscoveredDevice &device);
+    void onDeviceLost(const PNConfigLib::DiscoveredDevice &device);
+    void onRoundFinished(int deviceCount);
 
 private:
     void setupUi();
     void updateInterfaceList();
+    void fillRow(int row, const PNConfigLib::DiscoveredDevice &device);
 
     PNConfigLib::DcpScanner *m_scanner;
     
@@ -65,8 +70,8 @@ private:
     QLabel *propGw;
     QLabel *propMac;
     
-    QTimer *m_searchTimer;
-    QList<PNConfigLib::DiscoveredDevice> m_discoveredDevices;
+    PNConfigLib::DcpInventory *m_inventory;
+    PNConfigLib::DiscoveredDeviceList m_discoveredDevices;
 };
 
 #endif // ONLINEDISCOVERYDIALOG_H
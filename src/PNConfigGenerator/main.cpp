@@ -7,6 +7,7 @@
 #include <cstdio>
 #include "MainWindow.h"
 #include "SimulationController.h"
+#include "../PNConfigLib/Consistency/ConsistencyLogger.h"
 
 // Message handler for logging to file
 void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
@@ -41,6 +42,7 @@ int main(int argc, char *argv[])
 {
     // Install the message handler
     qInstallMessageHandler(messageHandler);
+    PNConfigLib::ConsistencyLogger::addSink(std::make_shared<PNConfigLib::DebugLogSink>());
 
     QApplication app(argc, argv);
     
@@ -7,6 +7,7 @@
 #include "RecordGenerators.h"
 #include "XmlEntities.h"
 #include "BlobBuilder.h"
+#include "../Instrumentation/Instrumentation.h"
 #include "../tinyxml2/tinyxml2.h"
 #include <QFile>
 #include <QTextStream>
@@ -22,7 +23,14 @@ bool Compiler::compile(
     const ListOfNodes& nodes,
     const QString& outputPath)
 {
-    QString xml = generateOutputXml(config, nodes);
+    XmlObject root = buildHardwareConfiguration(config, nodes, loadGsdmlData(nodes));
+    return writeOutput(serializeOutput(root), outputPath);
+}
+
+bool Compiler::writeOutput(const QByteArray& xml, const QString& outputPath)
+{
+    PN_SCOPED_TIMER("Compiler::writeOutput");
+    
     if (xml.isEmpty()) {
         return false;
     }
@@ -32,16 +40,21 @@ bool Compiler::compile(
         return false;
     }
     
-    QTextStream out(&file);
-    out.setEncoding(QStringConverter::Utf8);
-    out << xml;
+    bool ok = file.write(xml) == xml.size();
     file.close();
     
-    return true;
+    if (ok) {
+        PN_COUNTER_ADD("Compiler.bytesWritten", xml.size());
+        PN_HISTOGRAM_RECORD("Compiler.outputBytes", xml.size());
+    }
+    
+    return ok;
 }
 
 QHash<QString, GsdmlInfo> Compiler::loadGsdmlData(const ListOfNodes& nodes)
 {
+    PN_SCOPED_TIMER("Compiler::loadGsdmlData");
+    
     QHash<QString, GsdmlInfo> result;
     
     for (const DecentralDeviceNode& device : nodes.decentralDevices) {
@@ -99,8 +112,15 @@ QString Compiler::generateOutputXml(
     const Configuration& config,
     const ListOfNodes& nodes)
 {
-    // Load GSDML data
-    QHash<QString, GsdmlInfo> gsdmlData = loadGsdmlData(nodes);
+    PN_SCOPED_TIMER("Compiler::generateOutputXml");
+    
+    XmlObject root = buildHardwareConfiguration(config, nodes, loadGsdmlData(nodes));
+    return QString::fromUtf8(serializeOutput(root));
+}
+
+QByteArray Compiler::serializeOutput(const XmlObject& root)
+{
+    PN_SCOPED_TIMER("Compiler::serializeOutput");
     
     XMLDocument doc;
     
@@ -108,6 +128,27 @@ QString Compiler::generateOutputXml(
     XMLDeclaration* decl = doc.NewDeclaration("xml version=\"1.0\" encoding=\"utf-8\"");
     doc.InsertEndChild(decl);
     
+    doc.InsertEndChild(XmlEntitySerializer::serializeObject(&doc, root));
+    
+    XMLPrinter printer;
+    doc.Print(&printer);
+    return QByteArray(printer.CStr(), printer.CStrSize() - 1);
+}
+
+XmlObject Compiler::buildHardwareConfiguration(
+    const Configuration& config,
+    const ListOfNodes& nodes,
+    const QHash<QString, GsdmlInfo>& gsdmlData)
+{
+    return buildHardwareConfiguration(ProjectModel::fromConfiguration(config, nodes), gsdmlData);
+}
+
+XmlObject Compiler::buildHardwareConfiguration(
+    const ProjectModel& model,
+    const QHash<QString, GsdmlInfo>& gsdmlData)
+{
+    PN_SCOPED_TIMER("Compiler::buildHardwareConfiguration");
+    
     // Root: HWConfiguration
     XmlObject root;
     root.name = "HWConfiguration";
@@ -137,10 +178,10 @@ QString Compiler::generateOutputXml(
     
     // Interface DataRecordsConf (IP, Name, Check, etc)
     QList<XmlField> ifRecords = RecordGenerators::generateDriverInterfaceRecords(
-        config.centralDevice.ethernetAddresses.ipAddress,
-        config.centralDevice.ethernetAddresses.subnetMask,
-        config.centralDevice.ethernetAddresses.deviceName,
-        config.centralDevice.ethernetAddresses.routerAddress
+        model.str(model.central.ipAddress),
+        model.str(model.central.subnetMask),
+        model.str(model.central.deviceName),
+        model.str(model.central.routerAddress)
     );
     driverInterface.addBlobVariable("DataRecordsConf", CompilerConstants::AID_DataRecordsConf, ifRecords);
     
@@ -197,19 +238,29 @@ QString Compiler::generateOutputXml(
     // -------------------------------------------------------------------------
     int currentLaddr = 264; // Start address for devices
     
-    for (const DecentralDeviceType& dev : config.decentralDevices) {
+    // GSDML file name per interned DeviceID, resolved once instead of scanning
+    // all nodes per device; the first node with a GSDPath wins
+    QHash<StringId, QString> gsdmlFileNames;
+    gsdmlFileNames.reserve(model.nodes.size());
+    for (qsizetype n = 0; n < model.nodes.size(); ++n) {
+        const StringId gsdPath = model.nodes.gsdPath[n];
+        if (gsdPath != 0 && !gsdmlFileNames.contains(model.nodes.deviceId[n])) {
+            gsdmlFileNames.insert(model.nodes.deviceId[n], QFileInfo(model.str(gsdPath)).fileName());
+        }
+    }
+    
+    const DeviceTable& devices = model.devices;
+    for (qsizetype d = 0; d < devices.size(); ++d) {
+        const QString& deviceName = model.str(devices.deviceName[d]);
+        const QString& ipAddress = model.str(devices.ipAddress[d]);
+        
         XmlObject devObj;
         devObj.name = "PNet_Device"; // The Class name seems to be PNet_Device in ref
         
         devObj.classRid = CompilerConstants::ClassRID_DeactivatedDevice;
         
         // Set GSDML filename from nodes if available
-        for (const DecentralDeviceNode& node : nodes.decentralDevices) {
-            if (node.deviceID == dev.deviceRefID && !node.gsdPath.isEmpty()) {
-                devObj.gsdmlFile = QFileInfo(node.gsdPath).fileName();
-                break;
-            }
-        }
+        devObj.gsdmlFile = gsdmlFileNames.value(devices.deviceRefId[d]);
         
         // Key 3:1 (Device ID?)
         devObj.addScalar("Key", 3, XmlDataType::UINT32, 1); 
@@ -218,16 +269,14 @@ QString Compiler::generateOutputXml(
         devObj.addScalar("LADDR", CompilerConstants::AID_LADDR, XmlDataType::UINT16, currentLaddr++);
         
         // IODevParamConfig (PROFINET device parameter records)
-        GsdmlInfo gsdInfo;
-        if (gsdmlData.contains(dev.deviceRefID)) {
-            gsdInfo = gsdmlData[dev.deviceRefID];
-        }
+        static const GsdmlInfo noGsdml;
+        auto gsdIt = gsdmlData.constFind(model.str(devices.deviceRefId[d]));
+        const GsdmlInfo& gsdInfo = gsdIt != gsdmlData.constEnd() ? gsdIt.value() : noGsdml;
         
         QList<XmlField> ioDevRecords = RecordGenerators::generateIODevParamConfig(
-            dev,
             gsdInfo,
-            dev.ethernetAddresses.deviceName,
-            dev.ethernetAddresses.ipAddress
+            deviceName,
+            ipAddress
         );
         devObj.addBlobVariable("IODevParamConfig", CompilerConstants::AID_IODevParamConfig, ioDevRecords);
         
@@ -240,9 +289,9 @@ QString Compiler::generateOutputXml(
         netParams.classRid = CompilerConstants::ClassRID_NetworkParameters;
         
         QList<XmlField> netRecs = RecordGenerators::generateNetworkParameters(
-            dev.ethernetAddresses.ipAddress,
-            dev.ethernetAddresses.subnetMask,
-            dev.ethernetAddresses.deviceName
+            ipAddress,
+            model.str(devices.subnetMask[d]),
+            deviceName
         );
         netParams.addBlobVariable("NetworkParamConfig", CompilerConstants::AID_NetworkParamConfig, netRecs);
         devObj.children.append(netParams);
@@ -307,12 +356,7 @@ QString Compiler::generateOutputXml(
     
     root.children.append(ioSystem);
     
-    // Serialize Root
-    doc.InsertEndChild(XmlEntitySerializer::serializeObject(&doc, root));
-    
-    XMLPrinter printer;
-    doc.Print(&printer);
-    return QString::fromUtf8(printer.CStr());
+    return root;
 }
 
 // -----------------------------------------------------------------------------
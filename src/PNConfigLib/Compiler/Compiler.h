@@ -6,9 +6,11 @@
 #define COMPILER_H
 
 #include "../ConfigReader/ConfigurationSchema.h"
+#include "../DataModel/ProjectModel.h"
 #include "../GsdmlParser/GsdmlParser.h"
 #include "XmlEntities.h"
 #include <QString>
+#include <QByteArray>
 #include <QHash>
 
 namespace PNConfigLib {
@@ -41,9 +43,52 @@ public:
     static QString generateOutputXml(
         const Configuration& config,
         const ListOfNodes& nodes);
+    
+    /**
+     * @brief Parse the GSDML files referenced by ListOfNodes
+     * @param nodes ListOfNodes structure
+     * @return GSDML data keyed by device ID (devices failing to parse are skipped)
+     */
+    static QHash<QString, GsdmlInfo> loadGsdmlData(const ListOfNodes& nodes);
+    
+    /**
+     * @brief Build the HWConfiguration object tree
+     * @param config Configuration structure
+     * @param nodes ListOfNodes structure
+     * @param gsdmlData GSDML data keyed by device ID (see loadGsdmlData)
+     * @return Root object (HWConfiguration)
+     */
+    static XmlObject buildHardwareConfiguration(
+        const Configuration& config,
+        const ListOfNodes& nodes,
+        const QHash<QString, GsdmlInfo>& gsdmlData);
+    
+    /**
+     * @brief Build the HWConfiguration object tree from a flattened project
+     * @param model Project built with ProjectModel::fromConfiguration(config, nodes)
+     * @param gsdmlData GSDML data keyed by device ID (see loadGsdmlData)
+     * @return Root object (HWConfiguration)
+     */
+    static XmlObject buildHardwareConfiguration(
+        const ProjectModel& model,
+        const QHash<QString, GsdmlInfo>& gsdmlData);
+    
+    /**
+     * @brief Serialize an object tree to the output XML format
+     * @param root Root object (HWConfiguration)
+     * @return UTF-8 encoded XML document
+     */
+    static QByteArray serializeOutput(const XmlObject& root);
+    
+    /**
+     * @brief Write serialized output to a file
+     * @param xml UTF-8 encoded XML document
+     * @param outputPath Output file path
+     * @return true if successful
+     */
+    static bool writeOutput(const QByteArray& xml, const QString& outputPath);
         
 private:
-    static QHash<QString, GsdmlInfo> loadGsdmlData(const ListOfNodes& nodes);
     static QString generateDeviceSection(
         const DecentralDeviceType& device,
         const QHash<QString, GsdmlInfo>& gsdmlData);
@@ -0,0 +1,407 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include "ConfigDiff.h"
+#include <QHash>
+#include <QTextStream>
+
+namespace PNConfigLib {
+
+static QChar kindSymbol(DiffKind kind)
+{
+    switch (kind) {
+        case DiffKind::Added: return '+';
+        case DiffKind::Removed: return '-';
+        default: return '~';
+    }
+}
+
+ConfigDiffResult ConfigDiff::compare(const XmlObject& oldRoot, const XmlObject& newRoot)
+{
+    ConfigDiffResult result;
+
+    if (identityOf(oldRoot) != identityOf(newRoot)) {
+        ObjectDiff removed;
+        removed.kind = DiffKind::Removed;
+        removed.path = removed.name = oldRoot.name;
+        removed.classRid = oldRoot.classRid;
+        removed.rid = oldRoot.rid;
+        result.objects.append(removed);
+
+        ObjectDiff added;
+        added.kind = DiffKind::Added;
+        added.path = added.name = newRoot.name;
+        added.classRid = newRoot.classRid;
+        added.rid = newRoot.rid;
+        result.objects.append(added);
+        return result;
+    }
+
+    compareObject(oldRoot, newRoot, newRoot.name, result);
+    return result;
+}
+
+void ConfigDiff::compareObject(
+    const XmlObject& oldObj,
+    const XmlObject& newObj,
+    const QString& path,
+    ConfigDiffResult& result)
+{
+    QList<VariableDiff> variables = compareVariables(oldObj, newObj);
+    if (!variables.isEmpty() || oldObj.gsdmlFile != newObj.gsdmlFile) {
+        ObjectDiff diff;
+        diff.kind = DiffKind::Modified;
+        diff.path = path;
+        diff.name = newObj.name;
+        diff.classRid = newObj.classRid;
+        diff.rid = newObj.rid;
+        diff.variables = std::move(variables);
+
+        if (oldObj.gsdmlFile != newObj.gsdmlFile) {
+            VariableDiff gsdml;
+            gsdml.name = "GSDMLFile";
+            gsdml.oldValue = oldObj.gsdmlFile;
+            gsdml.newValue = newObj.gsdmlFile;
+            diff.variables.prepend(gsdml);
+        }
+        result.objects.append(diff);
+    }
+
+    compareChildren(oldObj, newObj, path, result);
+}
+
+void ConfigDiff::compareChildren(
+    const XmlObject& oldObj,
+    const XmlObject& newObj,
+    const QString& path,
+    ConfigDiffResult& result)
+{
+    if (oldObj.children.isEmpty() && newObj.children.isEmpty()) {
+        return;
+    }
+
+    // Identity of each child, made unique by its occurrence among equal siblings
+    auto buildKeys = [](const QList<XmlObject>& children, QList<QString>& ids, QList<int>& occurrence,
+                        QHash<QString, int>& counts) {
+        ids.reserve(children.size());
+        occurrence.reserve(children.size());
+        for (const XmlObject& child : children) {
+            QString id = identityOf(child);
+            int& count = counts[id];
+            occurrence.append(count++);
+            ids.append(id);
+        }
+    };
+
+    QList<QString> oldIds, newIds;
+    QList<int> oldOccurrence, newOccurrence;
+    QHash<QString, int> oldCounts, newCounts;
+    buildKeys(oldObj.children, oldIds, oldOccurrence, oldCounts);
+    buildKeys(newObj.children, newIds, newOccurrence, newCounts);
+
+    QHash<QString, int> oldIndex;
+    oldIndex.reserve(oldObj.children.size());
+    for (int i = 0; i < oldObj.children.size(); ++i) {
+        oldIndex.insert(oldIds[i] + '#' + QString::number(oldOccurrence[i]), i);
+    }
+
+    auto childPath = [&path](const XmlObject& child, int occurrence, bool repeated) {
+        QString segment = repeated ? QString("%1[%2]").arg(child.name).arg(occurrence + 1) : child.name;
+        return path + '/' + segment;
+    };
+
+    auto isRepeated = [&oldCounts, &newCounts](const QString& id) {
+        return oldCounts.value(id) > 1 || newCounts.value(id) > 1;
+    };
+
+    QList<bool> matched(oldObj.children.size(), false);
+
+    for (int i = 0; i < newObj.children.size(); ++i) {
+        const XmlObject& child = newObj.children[i];
+        const QString childKey = newIds[i] + '#' + QString::number(newOccurrence[i]);
+        const QString fullPath = childPath(child, newOccurrence[i], isRepeated(newIds[i]));
+
+        auto it = oldIndex.constFind(childKey);
+        if (it == oldIndex.constEnd()) {
+            ObjectDiff added;
+            added.kind = DiffKind::Added;
+            added.path = fullPath;
+            added.name = child.name;
+            added.classRid = child.classRid;
+            added.rid = child.rid;
+            result.objects.append(added);
+            continue;
+        }
+
+        matched[it.value()] = true;
+        compareObject(oldObj.children[it.value()], child, fullPath, result);
+    }
+
+    for (int i = 0; i < oldObj.children.size(); ++i) {
+        if (matched[i]) {
+            continue;
+        }
+        const XmlObject& child = oldObj.children[i];
+        ObjectDiff removed;
+        removed.kind = DiffKind::Removed;
+        removed.path = childPath(child, oldOccurrence[i], isRepeated(oldIds[i]));
+        removed.name = child.name;
+        removed.classRid = child.classRid;
+        removed.rid = child.rid;
+        result.objects.append(removed);
+    }
+}
+
+QList<VariableDiff> ConfigDiff::compareVariables(const XmlObject& oldObj, const XmlObject& newObj)
+{
+    QList<VariableDiff> diffs;
+
+    QHash<QString, int> oldIndex;
+    oldIndex.reserve(oldObj.variables.size());
+    for (int i = 0; i < oldObj.variables.size(); ++i) {
+        const XmlVariable& var = oldObj.variables[i];
+        oldIndex.insert(var.name + '#' + QString::number(var.aid), i);
+    }
+
+    QList<bool> matched(oldObj.variables.size(), false);
+
+    for (const XmlVariable& newVar : newObj.variables) {
+        VariableDiff diff;
+        diff.name = newVar.name;
+        diff.aid = newVar.aid;
+
+        auto it = oldIndex.constFind(newVar.name + '#' + QString::number(newVar.aid));
+        if (it == oldIndex.constEnd()) {
+            diff.kind = DiffKind::Added;
+            if (newVar.valueType == XmlValueType::Scalar) {
+                diff.newValue = scalarToString(newVar);
+            } else {
+                XmlVariable empty;
+                compareFields(empty, newVar, diff);
+            }
+            diffs.append(diff);
+            continue;
+        }
+
+        matched[it.value()] = true;
+        const XmlVariable& oldVar = oldObj.variables[it.value()];
+
+        if (oldVar.valueType != newVar.valueType) {
+            diff.oldValue = oldVar.valueType == XmlValueType::Scalar ? scalarToString(oldVar) : QString("SparseArray");
+            diff.newValue = newVar.valueType == XmlValueType::Scalar ? scalarToString(newVar) : QString("SparseArray");
+            diffs.append(diff);
+        } else if (newVar.valueType == XmlValueType::Scalar) {
+            QString oldValue = scalarToString(oldVar);
+            QString newValue = scalarToString(newVar);
+            if (oldValue != newValue || oldVar.dataType != newVar.dataType) {
+                diff.oldValue = oldValue;
+                diff.newValue = newValue;
+                diffs.append(diff);
+            }
+        } else if (compareFields(oldVar, newVar, diff)) {
+            diffs.append(diff);
+        }
+    }
+
+    for (int i = 0; i < oldObj.variables.size(); ++i) {
+        if (matched[i]) {
+            continue;
+        }
+        const XmlVariable& oldVar = oldObj.variables[i];
+        VariableDiff diff;
+        diff.kind = DiffKind::Removed;
+        diff.name = oldVar.name;
+        diff.aid = oldVar.aid;
+        if (oldVar.valueType == XmlValueType::Scalar) {
+            diff.oldValue = scalarToString(oldVar);
+        } else {
+            XmlVariable empty;
+            compareFields(oldVar, empty, diff);
+        }
+        diffs.append(diff);
+    }
+
+    return diffs;
+}
+
+bool ConfigDiff::compareFields(const XmlVariable& oldVar, const XmlVariable& newVar, VariableDiff& diff)
+{
+    // Key plus occurrence among fields with the same key, so repeated keys are
+    // matched in order instead of the last one hiding the others
+    auto occurrenceKey = [](uint32_t key, QHash<uint32_t, uint32_t>& counts) {
+        return (static_cast<quint64>(key) << 32) | counts[key]++;
+    };
+
+    QHash<quint64, int> oldIndex;
+    QHash<uint32_t, uint32_t> oldCounts;
+    oldIndex.reserve(oldVar.fields.size());
+    for (int i = 0; i < oldVar.fields.size(); ++i) {
+        oldIndex.insert(occurrenceKey(oldVar.fields[i].key, oldCounts), i);
+    }
+
+    QList<bool> matched(oldVar.fields.size(), false);
+    QHash<uint32_t, uint32_t> newCounts;
+    const int before = diff.fields.size();
+
+    for (const XmlField& newField : newVar.fields) {
+        auto it = oldIndex.constFind(occurrenceKey(newField.key, newCounts));
+        if (it == oldIndex.constEnd()) {
+            FieldDiff added;
+            added.kind = DiffKind::Added;
+            added.key = newField.key;
+            added.newLength = newField.length;
+            diff.fields.append(added);
+            continue;
+        }
+
+        matched[it.value()] = true;
+        const XmlField& oldField = oldVar.fields[it.value()];
+        if (oldField.length == newField.length && oldField.value == newField.value) {
+            continue;
+        }
+
+        FieldDiff modified;
+        modified.kind = DiffKind::Modified;
+        modified.key = newField.key;
+        modified.oldLength = oldField.length;
+        modified.newLength = newField.length;
+        modified.ranges = compareBytes(oldField.value, newField.value);
+        diff.fields.append(modified);
+    }
+
+    for (int i = 0; i < oldVar.fields.size(); ++i) {
+        if (matched[i]) {
+            continue;
+        }
+        FieldDiff removed;
+        removed.kind = DiffKind::Removed;
+        removed.key = oldVar.fields[i].key;
+        removed.oldLength = oldVar.fields[i].length;
+        diff.fields.append(removed);
+    }
+
+    return diff.fields.size() != before;
+}
+
+QList<ByteRangeDiff> ConfigDiff::compareBytes(const QByteArray& oldBytes, const QByteArray& newBytes)
+{
+    QList<ByteRangeDiff> ranges;
+    const int common = static_cast<int>(qMin(oldBytes.size(), newBytes.size()));
+    const char* a = oldBytes.constData();
+    const char* b = newBytes.constData();
+
+    int i = 0;
+    while (i < common) {
+        if (a[i] == b[i]) {
+            ++i;
+            continue;
+        }
+        int start = i;
+        while (i < common && a[i] != b[i]) {
+            ++i;
+        }
+        ByteRangeDiff range;
+        range.offset = start;
+        range.oldBytes = oldBytes.mid(start, i - start);
+        range.newBytes = newBytes.mid(start, i - start);
+        ranges.append(range);
+    }
+
+    // Length change: extend the last range if it touches the end, otherwise add a tail
+    if (oldBytes.size() != newBytes.size()) {
+        if (!ranges.isEmpty() && ranges.last().offset + ranges.last().oldBytes.size() == common) {
+            ranges.last().oldBytes.append(oldBytes.mid(common));
+            ranges.last().newBytes.append(newBytes.mid(common));
+        } else {
+            ByteRangeDiff tail;
+            tail.offset = common;
+            tail.oldBytes = oldBytes.mid(common);
+            tail.newBytes = newBytes.mid(common);
+            ranges.append(tail);
+        }
+    }
+
+    return ranges;
+}
+
+QString ConfigDiff::identityOf(const XmlObject& obj)
+{
+    QString id = obj.name + '|' + QString::number(obj.classRid) + '|' + QString::number(obj.rid);
+    for (const XmlVariable& var : obj.variables) {
+        if (var.name == "Key" || (obj.name == "Link" && var.name == "TargetRID")) {
+            id += '|' + QString::number(var.aid) + '=' + var.value.toString();
+            break;
+        }
+    }
+    return id;
+}
+
+QString ConfigDiff::scalarToString(const XmlVariable& var)
+{
+    switch (var.dataType) {
+        case XmlDataType::BOOL:
+            return var.value.toBool() ? "true" : "false";
+        case XmlDataType::BLOB: {
+            QString hex = QString::fromLatin1(var.value.toByteArray().toHex().toUpper());
+            return var.scalarBlobLength >= 0 ? QString("%1 (%2 bytes)").arg(hex).arg(var.scalarBlobLength) : hex;
+        }
+        default:
+            return var.value.toString();
+    }
+}
+
+QString ConfigDiff::formatResult(const ConfigDiffResult& result)
+{
+    QString text;
+    QTextStream out(&text);
+
+    if (result.isEmpty()) {
+        out << "No differences\n";
+        return text;
+    }
+
+    for (const ObjectDiff& obj : result.objects) {
+        out << kindSymbol(obj.kind) << ' ' << obj.path << " (ClassRID " << obj.classRid;
+        if (obj.rid != 0) {
+            out << ", RID " << obj.rid;
+        }
+        out << ")\n";
+
+        for (const VariableDiff& var : obj.variables) {
+            out << "    " << kindSymbol(var.kind) << ' ' << var.name << " (AID " << var.aid << ")";
+            if (var.fields.isEmpty()) {
+                if (var.kind == DiffKind::Modified) {
+                    out << ": " << var.oldValue << " -> " << var.newValue;
+                } else {
+                    out << ": " << (var.kind == DiffKind::Added ? var.newValue : var.oldValue);
+                }
+            }
+            out << "\n";
+
+            for (const FieldDiff& field : var.fields) {
+                out << "        " << kindSymbol(field.kind) << " Field " << field.key;
+                switch (field.kind) {
+                    case DiffKind::Added:
+                        out << " (" << field.newLength << " bytes)\n";
+                        break;
+                    case DiffKind::Removed:
+                        out << " (" << field.oldLength << " bytes)\n";
+                        break;
+                    case DiffKind::Modified:
+                        out << " (" << field.oldLength << " -> " << field.newLength << " bytes)\n";
+                        for (const ByteRangeDiff& range : field.ranges) {
+                            out << "            @" << range.offset << ": "
+                                << range.oldBytes.toHex().toUpper() << " -> "
+                                << range.newBytes.toHex().toUpper() << "\n";
+                        }
+                        break;
+                }
+            }
+        }
+    }
+
+    return text;
+}
+
+} // namespace PNConfigLib
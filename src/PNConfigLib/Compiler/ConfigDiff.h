@@ -0,0 +1,106 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#ifndef CONFIGDIFF_H
+#define CONFIGDIFF_H
+
+#include "XmlEntities.h"
+#include <QString>
+#include <QList>
+#include <QByteArray>
+
+namespace PNConfigLib {
+
+enum class DiffKind {
+    Added,
+    Removed,
+    Modified
+};
+
+/**
+ * @brief Contiguous range of differing bytes inside a field value
+ */
+struct ByteRangeDiff {
+    int offset = 0;
+    QByteArray oldBytes;
+    QByteArray newBytes;
+};
+
+struct FieldDiff {
+    DiffKind kind = DiffKind::Modified;
+    uint32_t key = 0;
+    uint32_t oldLength = 0;
+    uint32_t newLength = 0;
+    QList<ByteRangeDiff> ranges; // Only for Modified
+};
+
+struct VariableDiff {
+    DiffKind kind = DiffKind::Modified;
+    QString name;
+    uint32_t aid = 0;
+    QString oldValue; // Scalar values, formatted
+    QString newValue;
+    QList<FieldDiff> fields; // SparseArray field changes
+};
+
+struct ObjectDiff {
+    DiffKind kind = DiffKind::Modified;
+    QString path; // e.g. "HWConfiguration/PROFINET IO-System/PNet_Device[1]"
+    QString name;
+    uint32_t classRid = 0;
+    uint32_t rid = 0;
+    QList<VariableDiff> variables; // Only for Modified
+};
+
+struct ConfigDiffResult {
+    QList<ObjectDiff> objects;
+
+    bool isEmpty() const { return objects.isEmpty(); }
+};
+
+/**
+ * @brief Structural diff over compiled hardware configurations
+ *
+ * Sibling objects are matched by name, ClassRID, RID and Key value; repeated
+ * identities (e.g. several PNet_Device objects with the same Key) are matched
+ * by their order of occurrence. Variables are matched by name and AID, fields
+ * by key and, for repeated keys, by occurrence. Matching uses hash lookups, so
+ * the diff is linear in the number of objects, variables and fields.
+ */
+class ConfigDiff {
+public:
+    /**
+     * @brief Compare two object trees
+     * @param oldRoot Previous configuration root
+     * @param newRoot New configuration root
+     * @return Changes, in document order of the new tree (removals follow their siblings)
+     */
+    static ConfigDiffResult compare(const XmlObject& oldRoot, const XmlObject& newRoot);
+
+    /**
+     * @brief Format a diff result as human readable text
+     */
+    static QString formatResult(const ConfigDiffResult& result);
+
+private:
+    static void compareObject(
+        const XmlObject& oldObj,
+        const XmlObject& newObj,
+        const QString& path,
+        ConfigDiffResult& result);
+    static void compareChildren(
+        const XmlObject& oldObj,
+        const XmlObject& newObj,
+        const QString& path,
+        ConfigDiffResult& result);
+    static QList<VariableDiff> compareVariables(const XmlObject& oldObj, const XmlObject& newObj);
+    static bool compareFields(const XmlVariable& oldVar, const XmlVariable& newVar, VariableDiff& diff);
+    static QList<ByteRangeDiff> compareBytes(const QByteArray& oldBytes, const QByteArray& newBytes);
+    static QString identityOf(const XmlObject& obj);
+    static QString scalarToString(const XmlVariable& var);
+};
+
+} // namespace PNConfigLib
+
+#endif // CONFIGDIFF_H
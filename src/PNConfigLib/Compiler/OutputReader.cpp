@@ -0,0 +1,318 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include "OutputReader.h"
+#include <QFile>
+#include <QXmlStreamReader>
+#include <array>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PNCONFIGLIB_HEX_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace PNConfigLib {
+
+// -----------------------------------------------------------------------------
+// Hex decoding
+// -----------------------------------------------------------------------------
+
+// Nibble value per ASCII code, -1 for non-hex characters
+static constexpr std::array<int8_t, 256> makeHexTable()
+{
+    std::array<int8_t, 256> table{};
+    for (int i = 0; i < 256; ++i) {
+        table[i] = -1;
+    }
+    for (int i = 0; i < 10; ++i) {
+        table['0' + i] = static_cast<int8_t>(i);
+    }
+    for (int i = 0; i < 6; ++i) {
+        table['A' + i] = static_cast<int8_t>(10 + i);
+        table['a' + i] = static_cast<int8_t>(10 + i);
+    }
+    return table;
+}
+
+static constexpr std::array<int8_t, 256> s_hexTable = makeHexTable();
+
+static inline int hexNibble(char16_t c)
+{
+    return c < 256 ? s_hexTable[c] : -1;
+}
+
+#ifdef PNCONFIGLIB_HEX_SSE2
+// Decode 16 UTF-16 hex digits into 8 bytes. Returns false on any invalid digit.
+static inline bool decodeHex16(const char16_t* src, char* dst)
+{
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8));
+    // Narrow to bytes; anything outside Latin-1 saturates to 0x00/0xFF (invalid)
+    const __m128i c = _mm_packus_epi16(a, b);
+
+    const __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    const __m128i digitOk = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    const __m128i letter = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    const __m128i letterOk = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+
+    if (_mm_movemask_epi8(_mm_or_si128(digitOk, letterOk)) != 0xFFFF) {
+        return false;
+    }
+
+    const __m128i nibbles = _mm_or_si128(
+        _mm_and_si128(digitOk, digit),
+        _mm_andnot_si128(digitOk, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+
+    // Each 16-bit lane holds (high nibble, low nibble) in memory order
+    const __m128i high = _mm_and_si128(nibbles, _mm_set1_epi16(0x00FF));
+    const __m128i low = _mm_srli_epi16(nibbles, 8);
+    const __m128i bytes = _mm_or_si128(_mm_slli_epi16(high, 4), low);
+
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(bytes, bytes));
+    return true;
+}
+#endif
+
+bool OutputReader::decodeHex(QStringView hex, QByteArray& out)
+{
+    const qsizetype len = hex.size();
+    if (len % 2 != 0) {
+        out.clear();
+        return false;
+    }
+
+    out.resize(len / 2);
+    const char16_t* src = hex.utf16();
+    char* dst = out.data();
+    qsizetype i = 0;
+
+#ifdef PNCONFIGLIB_HEX_SSE2
+    for (; i + 16 <= len; i += 16) {
+        if (!decodeHex16(src + i, dst + i / 2)) {
+            out.clear();
+            return false;
+        }
+    }
+#endif
+
+    for (; i < len; i += 2) {
+        int high = hexNibble(src[i]);
+        int low = hexNibble(src[i + 1]);
+        if (high < 0 || low < 0) {
+            out.clear();
+            return false;
+        }
+        dst[i / 2] = static_cast<char>((high << 4) | low);
+    }
+
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+
+static std::runtime_error readError(const QXmlStreamReader& xml, const QString& message)
+{
+    return std::runtime_error(QString("Invalid compiled output (line %1): %2")
+        .arg(xml.lineNumber()).arg(message).toStdString());
+}
+
+static uint32_t toUInt32(const QXmlStreamReader& xml, QStringView text, const char* what)
+{
+    bool ok = false;
+    uint32_t value = text.trimmed().toUInt(&ok);
+    if (!ok) {
+        throw readError(xml, QString("Invalid %1 '%2'").arg(what).arg(text.toString()));
+    }
+    return value;
+}
+
+static XmlDataType parseDataType(QStringView text)
+{
+    if (text == QLatin1String("UINT16")) return XmlDataType::UINT16;
+    if (text == QLatin1String("UINT32")) return XmlDataType::UINT32;
+    if (text == QLatin1String("BLOB")) return XmlDataType::BLOB;
+    if (text == QLatin1String("BOOL")) return XmlDataType::BOOL;
+    return XmlDataType::STRING;
+}
+
+// -----------------------------------------------------------------------------
+// Reader
+// -----------------------------------------------------------------------------
+
+XmlObject OutputReader::readFile(const QString& outputPath)
+{
+    QFile file(outputPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        throw std::runtime_error(QString("Failed to open compiled output: %1. Error: %2")
+            .arg(outputPath).arg(file.errorString()).toStdString());
+    }
+
+    QXmlStreamReader xml(&file);
+    return readDocument(xml);
+}
+
+XmlObject OutputReader::readXml(const QByteArray& xml)
+{
+    QXmlStreamReader reader(xml);
+    return readDocument(reader);
+}
+
+XmlObject OutputReader::readDocument(QXmlStreamReader& xml)
+{
+    if (!xml.readNextStartElement()) {
+        throw readError(xml, xml.hasError() ? xml.errorString() : QString("Empty document"));
+    }
+    if (xml.name() != QLatin1String("Object")) {
+        throw readError(xml, QString("Unexpected root element '%1'").arg(xml.name().toString()));
+    }
+
+    XmlObject root;
+    readObject(xml, root);
+
+    if (xml.hasError()) {
+        throw readError(xml, xml.errorString());
+    }
+    return root;
+}
+
+void OutputReader::readObject(QXmlStreamReader& xml, XmlObject& obj)
+{
+    obj.name = xml.attributes().value(QLatin1String("Name")).toString();
+    obj.classRid = 0;
+
+    while (xml.readNextStartElement()) {
+        const QStringView tag = xml.name();
+
+        if (tag == QLatin1String("Object")) {
+            obj.children.append(XmlObject());
+            readObject(xml, obj.children.last());
+        } else if (tag == QLatin1String("Variable")) {
+            obj.variables.append(XmlVariable());
+            readVariable(xml, obj.variables.last());
+        } else if (tag == QLatin1String("Key")) {
+            obj.variables.append(XmlVariable());
+            readKey(xml, obj.variables.last());
+        } else if (tag == QLatin1String("Link")) {
+            obj.children.append(XmlObject());
+            readLink(xml, obj.children.last());
+        } else if (tag == QLatin1String("ClassRID")) {
+            obj.classRid = toUInt32(xml, xml.readElementText(), "ClassRID");
+        } else if (tag == QLatin1String("RID")) {
+            obj.rid = toUInt32(xml, xml.readElementText(), "RID");
+        } else if (tag == QLatin1String("GSDMLFile")) {
+            obj.gsdmlFile = xml.readElementText();
+        } else {
+            xml.skipCurrentElement();
+        }
+    }
+}
+
+void OutputReader::readLink(QXmlStreamReader& xml, XmlObject& link)
+{
+    // Mirrors the Link object built by the Compiler: TargetRID first, then AID
+    link.name = "Link";
+    link.classRid = 0;
+
+    XmlVariable targetRid;
+    targetRid.name = "TargetRID";
+    XmlVariable aid;
+    aid.name = "AID";
+
+    while (xml.readNextStartElement()) {
+        if (xml.name() == QLatin1String("TargetRID")) {
+            targetRid.value = static_cast<qulonglong>(toUInt32(xml, xml.readElementText(), "TargetRID"));
+        } else if (xml.name() == QLatin1String("AID")) {
+            aid.value = static_cast<int>(toUInt32(xml, xml.readElementText(), "Link AID"));
+        } else {
+            xml.skipCurrentElement();
+        }
+    }
+
+    link.variables.append(targetRid);
+    link.variables.append(aid);
+}
+
+void OutputReader::readKey(QXmlStreamReader& xml, XmlVariable& var)
+{
+    var.name = "Key";
+    var.aid = toUInt32(xml, xml.attributes().value(QLatin1String("AID")), "Key AID");
+    var.valueType = XmlValueType::Scalar;
+    var.dataType = XmlDataType::UINT32;
+    var.value = toUInt32(xml, xml.readElementText(), "Key");
+}
+
+void OutputReader::readVariable(QXmlStreamReader& xml, XmlVariable& var)
+{
+    var.name = xml.attributes().value(QLatin1String("Name")).toString();
+
+    while (xml.readNextStartElement()) {
+        if (xml.name() == QLatin1String("AID")) {
+            var.aid = toUInt32(xml, xml.readElementText(), "AID");
+        } else if (xml.name() == QLatin1String("Value")) {
+            readValue(xml, var);
+        } else {
+            xml.skipCurrentElement();
+        }
+    }
+}
+
+void OutputReader::readValue(QXmlStreamReader& xml, XmlVariable& var)
+{
+    // Note: the serializer writes the value type into "Datatype" and the
+    // data type into "Valuetype"
+    const QXmlStreamAttributes attrs = xml.attributes();
+    var.valueType = attrs.value(QLatin1String("Datatype")) == QLatin1String("SparseArray") ? XmlValueType::SparseArray : XmlValueType::Scalar;
+    var.dataType = parseDataType(attrs.value(QLatin1String("Valuetype")));
+
+    if (var.valueType == XmlValueType::SparseArray) {
+        while (xml.readNextStartElement()) {
+            if (xml.name() == QLatin1String("Field")) {
+                var.fields.append(XmlField());
+                readField(xml, var.fields.last());
+            } else {
+                xml.skipCurrentElement();
+            }
+        }
+        return;
+    }
+
+    const bool hasLength = attrs.hasAttribute(QLatin1String("Length"));
+    const uint32_t length = hasLength ? toUInt32(xml, attrs.value(QLatin1String("Length")), "Length") : 0;
+    const QString text = xml.readElementText();
+
+    switch (var.dataType) {
+        case XmlDataType::UINT16:
+        case XmlDataType::UINT32:
+            var.value = toUInt32(xml, text, "scalar value");
+            break;
+        case XmlDataType::BOOL:
+            var.value = (text == QLatin1String("true") || text == QLatin1String("1"));
+            break;
+        case XmlDataType::BLOB:
+            var.value = text.toUtf8();
+            var.scalarBlobLength = hasLength ? static_cast<int>(length) : -1;
+            break;
+        case XmlDataType::STRING:
+        default:
+            var.value = text;
+            break;
+    }
+}
+
+void OutputReader::readField(QXmlStreamReader& xml, XmlField& field)
+{
+    const QXmlStreamAttributes attrs = xml.attributes();
+    field.key = toUInt32(xml, attrs.value(QLatin1String("Key")), "Field Key");
+    field.length = toUInt32(xml, attrs.value(QLatin1String("Length")), "Field Length");
+
+    const QString text = xml.readElementText();
+    if (!decodeHex(QStringView(text).trimmed(), field.value)) {
+        throw readError(xml, QString("Invalid hex data in Field %1").arg(field.key));
+    }
+}
+
+} // namespace PNConfigLib
@@ -0,0 +1,64 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#ifndef OUTPUTREADER_H
+#define OUTPUTREADER_H
+
+#include "XmlEntities.h"
+#include <QString>
+#include <QByteArray>
+#include <QStringView>
+
+class QXmlStreamReader;
+
+namespace PNConfigLib {
+
+/**
+ * @brief Compiled output reader
+ *
+ * Reads a compiled HWConfiguration (PROFINET_Driver_Output.xml) back into the
+ * XmlObject/XmlVariable/XmlField representation produced by the Compiler.
+ * The file is read in a single streaming pass, no DOM is built.
+ */
+class OutputReader {
+public:
+    /**
+     * @brief Read a compiled output file
+     * @param outputPath Path to the compiled XML file
+     * @return Root object (HWConfiguration)
+     * @throws std::runtime_error on read or parse failure
+     */
+    static XmlObject readFile(const QString& outputPath);
+
+    /**
+     * @brief Read compiled output from memory
+     * @param xml XML document content
+     * @return Root object (HWConfiguration)
+     * @throws std::runtime_error on parse failure
+     */
+    static XmlObject readXml(const QByteArray& xml);
+
+    /**
+     * @brief Decode a hexadecimal string (upper or lower case) into bytes
+     *
+     * Uses an SSE2 path for 16 characters at a time when available.
+     * @param hex Hex text, must have an even number of digits
+     * @param out Decoded bytes (replaced)
+     * @return false if the text contains a non-hex character or has odd length
+     */
+    static bool decodeHex(QStringView hex, QByteArray& out);
+
+private:
+    static XmlObject readDocument(QXmlStreamReader& xml);
+    static void readObject(QXmlStreamReader& xml, XmlObject& obj);
+    static void readLink(QXmlStreamReader& xml, XmlObject& link);
+    static void readKey(QXmlStreamReader& xml, XmlVariable& var);
+    static void readVariable(QXmlStreamReader& xml, XmlVariable& var);
+    static void readValue(QXmlStreamReader& xml, XmlVariable& var);
+    static void readField(QXmlStreamReader& xml, XmlField& field);
+};
+
+} // namespace PNConfigLib
+
+#endif // OUTPUTREADER_H
@@ -285,7 +285,6 @@ QList<XmlField> RecordGenerators::generateNetworkParameters(
 // IODevParamConfig (PROFINET Device Parameter Records)
 // -----------------------------------------------------------------------------
 QList<XmlField> RecordGenerators::generateIODevParamConfig(
-    const DecentralDeviceType& device,
     const GsdmlInfo& gsdInfo,
     const QString& deviceName,
     const QString& ipAddress)
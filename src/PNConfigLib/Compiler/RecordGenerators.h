@@ -27,7 +27,6 @@ public:
         
     // Generate IODevParamConfig records (all required PROFINET device parameters)
     static QList<XmlField> generateIODevParamConfig(
-        const DecentralDeviceType& device, 
         const GsdmlInfo& gsdInfo,
         const QString& deviceName,
         const QString& ipAddress);
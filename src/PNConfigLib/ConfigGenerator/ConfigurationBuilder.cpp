@@ -3,6 +3,7 @@
 /*****************************************************************************/
 
 #include "ConfigurationBuilder.h"
+#include "IoAddressAllocator.h"
 #include "../GsdmlParser/GsdmlParser.h"
 #include "../tinyxml2/tinyxml2.h"
 #include <QFile>
@@ -25,6 +26,30 @@ QString ConfigurationBuilder::generateConfigurationXml(
         return QString();
     }
     
+    // Process image layout of the slave: every module/submodule of the GSDML,
+    // placed by the IO address allocator from the configured start addresses
+    Configuration layout;
+    layout.decentralDevices.emplaceBack();
+    DecentralDeviceType& slave = layout.decentralDevices.last();
+    slave.deviceRefID = slaveConfig.name + "_ID";
+    slave.ethernetAddresses.deviceName = slaveConfig.name;
+    for (const ModuleInfo& module : gsdmlInfo.modules) {
+        ModuleType& moduleLayout = slave.modules.emplaceBack();
+        moduleLayout.gsdRefID = module.id;
+        for (const SubmoduleInfo& submodule : module.submodules) {
+            moduleLayout.submodules.emplaceBack().gsdRefID = submodule.id;
+        }
+    }
+    
+    QHash<QString, GsdmlInfo> gsdmlData;
+    gsdmlData.insert(slave.deviceRefID, gsdmlInfo);
+    IoAllocationOptions ioOptions;
+    ioOptions.inputBase = slaveConfig.inputStartAddress;
+    ioOptions.outputBase = slaveConfig.outputStartAddress;
+    if (!IoAddressAllocator::allocate(layout, gsdmlData, ioOptions).success) {
+        return QString();
+    }
+    
     XMLDocument doc;
     
     // XML declaration
@@ -149,13 +174,12 @@ QString ConfigurationBuilder::generateConfigurationXml(
     slaveRealTimeSettings->InsertEndChild(synchronization);
     
     // Add modules and submodules
-    int currentInputAddress = slaveConfig.inputStartAddress;
-    int currentOutputAddress = slaveConfig.outputStartAddress;
     int moduleIndex = 48; // Starting module ID
     int submoduleIndex = 304; // Starting submodule ID
     int slotNumber = 1;
     
-    for (const ModuleInfo& module : gsdmlInfo.modules) {
+    for (int m = 0; m < gsdmlInfo.modules.size(); ++m) {
+        const ModuleInfo& module = gsdmlInfo.modules[m];
         XMLElement* moduleElem = doc.NewElement("Module");
         moduleElem->SetAttribute("ModuleID", QString("Module_%1").arg(moduleIndex++).toStdString().c_str());
         moduleElem->SetAttribute("SlotNumber", slotNumber++);
@@ -166,7 +190,9 @@ QString ConfigurationBuilder::generateConfigurationXml(
         moduleElem->InsertEndChild(moduleIOAddresses);
         
         int subslotNumber = 1;
-        for (const SubmoduleInfo& submodule : module.submodules) {
+        for (int sm = 0; sm < module.submodules.size(); ++sm) {
+            const SubmoduleInfo& submodule = module.submodules[sm];
+            const IOAddresses& addresses = slave.modules[m].submodules[sm].ioAddresses;
             XMLElement* submoduleElem = doc.NewElement("Submodule");
             submoduleElem->SetAttribute("SubmoduleID", QString("Submodule_%1").arg(submoduleIndex++).toStdString().c_str());
             submoduleElem->SetAttribute("SubslotNumber", subslotNumber++);
@@ -177,19 +203,17 @@ QString ConfigurationBuilder::generateConfigurationXml(
             submoduleElem->InsertEndChild(submoduleIOAddresses);
             
             // Add input addresses if needed
-            if (submodule.inputDataLength > 0) {
+            if (addresses.inputStartAddress >= 0) {
                 XMLElement* inputAddresses = doc.NewElement("InputAddresses");
-                inputAddresses->SetAttribute("StartAddress", currentInputAddress);
+                inputAddresses->SetAttribute("StartAddress", addresses.inputStartAddress);
                 submoduleIOAddresses->InsertEndChild(inputAddresses);
-                currentInputAddress += submodule.inputDataLength;
             }
             
             // Add output addresses if needed
-            if (submodule.outputDataLength > 0) {
+            if (addresses.outputStartAddress >= 0) {
                 XMLElement* outputAddresses = doc.NewElement("OutputAddresses");
-                outputAddresses->SetAttribute("StartAddress", currentOutputAddress);
+                outputAddresses->SetAttribute("StartAddress", addresses.outputStartAddress);
                 submoduleIOAddresses->InsertEndChild(outputAddresses);
-                currentOutputAddress += submodule.outputDataLength;
             }
         }
     }
@@ -26,10 +26,14 @@ public:
     
     /**
      * @brief Generate Configuration XML string
+     *
+     * Submodule IO addresses are assigned by IoAddressAllocator (dense, from
+     * the slave's input/output start addresses).
      * @param gsdmlPath Path to GSDML file
      * @param masterConfig Master device configuration
      * @param slaveConfig Slave device configuration
-     * @return XML string
+     * @return XML string, empty if the GSDML cannot be parsed or its IO does
+     *         not fit the address space
      */
     static QString generateConfigurationXml(
         const QString& gsdmlPath,
@@ -0,0 +1,349 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include "IoAddressAllocator.h"
+#include "../Instrumentation/Instrumentation.h"
+#include <QMap>
+#include <QPair>
+#include <QVector>
+#include <algorithm>
+
+namespace PNConfigLib {
+
+namespace {
+
+enum Direction { Input = 0, Output = 1 };
+
+struct IoLengths {
+    int input = 0;
+    int output = 0;
+};
+
+/**
+ * @brief Submodule IO lengths of one GSDML, by (module id, submodule id) and submodule id
+ */
+struct GsdmlLengths {
+    QHash<QPair<QString, QString>, IoLengths> byModuleAndSubmodule;
+    QHash<QString, IoLengths> bySubmodule;
+
+    explicit GsdmlLengths(const GsdmlInfo& info)
+    {
+        for (const ModuleInfo& module : info.modules) {
+            for (const SubmoduleInfo& submodule : module.submodules) {
+                IoLengths lengths;
+                lengths.input = submodule.inputDataLength;
+                lengths.output = submodule.outputDataLength;
+                byModuleAndSubmodule.insert(qMakePair(module.id, submodule.id), lengths);
+                if (!bySubmodule.contains(submodule.id)) {
+                    bySubmodule.insert(submodule.id, lengths);
+                }
+            }
+        }
+    }
+
+    IoLengths lookup(const ModuleType& module, const SubmoduleType& submodule) const
+    {
+        auto it = byModuleAndSubmodule.constFind(qMakePair(module.gsdRefID, submodule.gsdRefID));
+        if (it != byModuleAndSubmodule.constEnd()) {
+            return it.value();
+        }
+        auto sub = bySubmodule.constFind(submodule.gsdRefID);
+        if (sub != bySubmodule.constEnd()) {
+            return sub.value();
+        }
+
+        IoLengths stored;
+        stored.input = submodule.ioAddresses.inputLength;
+        stored.output = submodule.ioAddresses.outputLength;
+        return stored;
+    }
+};
+
+/**
+ * @brief Occupied ranges of one direction, start -> end (exclusive), non-overlapping
+ */
+class OccupiedRanges {
+public:
+    bool isFree(int start, int end) const
+    {
+        auto next = m_ranges.lowerBound(start);
+        if (next != m_ranges.constEnd() && next.key() < end) {
+            return false;
+        }
+        if (next != m_ranges.constBegin()) {
+            --next;
+            if (next.value() > start) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void insert(int start, int end) { m_ranges.insert(start, end); }
+    void remove(int start) { m_ranges.remove(start); }
+
+    /**
+     * @brief Free holes within [base, limit), in address order
+     */
+    QVector<QPair<int, int>> holes(int base, int limit) const
+    {
+        QVector<QPair<int, int>> result;
+        int cursor = base;
+        for (auto it = m_ranges.constBegin(); it != m_ranges.constEnd(); ++it) {
+            if (it.key() > cursor) {
+                result.append(qMakePair(cursor, std::min(it.key(), limit)));
+            }
+            cursor = std::max(cursor, it.value());
+            if (cursor >= limit) {
+                return result;
+            }
+        }
+        if (cursor < limit) {
+            result.append(qMakePair(cursor, limit));
+        }
+        return result;
+    }
+
+private:
+    QMap<int, int> m_ranges;
+};
+
+/**
+ * @brief First-fit over a sorted hole list
+ */
+class FreeSpace {
+public:
+    explicit FreeSpace(QVector<QPair<int, int>> holes)
+        : m_holes(std::move(holes))
+    {
+    }
+
+    /**
+     * @brief Reserve size bytes at an address that is a multiple of alignment, -1 if full
+     */
+    int take(int size, int alignment)
+    {
+        for (int i = 0; i < m_holes.size(); ++i) {
+            const int holeStart = m_holes[i].first;
+            const int holeEnd = m_holes[i].second;
+            const int start = (holeStart + alignment - 1) / alignment * alignment;
+            if (start + size > holeEnd) {
+                continue;
+            }
+
+            // Keep alignment padding before the block as its own (small) hole
+            if (start + size == holeEnd) {
+                m_holes.removeAt(i);
+            } else {
+                m_holes[i].first = start + size;
+            }
+            if (start > holeStart) {
+                m_holes.insert(i, qMakePair(holeStart, start));
+            }
+            return start;
+        }
+        return -1;
+    }
+
+private:
+    QVector<QPair<int, int>> m_holes;
+};
+
+static int alignUp(int value, int alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+IoAllocationResult IoAddressAllocator::allocate(
+    Configuration& config,
+    const QHash<QString, GsdmlInfo>& gsdmlData,
+    const IoAllocationOptions& options)
+{
+    return run(config, gsdmlData, options, false);
+}
+
+IoAllocationResult IoAddressAllocator::reallocate(
+    Configuration& config,
+    const QHash<QString, GsdmlInfo>& gsdmlData,
+    const IoAllocationOptions& options)
+{
+    return run(config, gsdmlData, options, true);
+}
+
+IoAllocationResult IoAddressAllocator::run(
+    Configuration& config,
+    const QHash<QString, GsdmlInfo>& gsdmlData,
+    const IoAllocationOptions& options,
+    bool keepExisting)
+{
+    PN_SCOPED_TIMER("IoAddressAllocator::run");
+
+    IoAllocationResult result;
+
+    const bool aligned = options.policy != IoAllocationPolicy::Dense;
+    const int alignment = aligned ? std::max(1, options.deviceAlignment) : 1;
+    const int gap = options.policy == IoAllocationPolicy::ReservedGap ? std::max(0, options.reservedGap) : 0;
+    const int base[2] = { std::max(0, options.inputBase), std::max(0, options.outputBase) };
+
+    // Length tables are built once per distinct GSDML file; the pointer map is
+    // filled only after the table hash stops growing
+    QHash<QString, GsdmlLengths> lengthTables;
+    for (auto it = gsdmlData.constBegin(); it != gsdmlData.constEnd(); ++it) {
+        if (!lengthTables.contains(it->filePath)) {
+            lengthTables.insert(it->filePath, GsdmlLengths(it.value()));
+        }
+    }
+    QHash<QString, const GsdmlLengths*> lengthsByDevice;
+    for (auto it = gsdmlData.constBegin(); it != gsdmlData.constEnd(); ++it) {
+        lengthsByDevice.insert(it.key(), &lengthTables.find(it->filePath).value());
+    }
+
+    // Resolve IO lengths and store them in the configuration
+    QVector<int> blockSize[2];
+    blockSize[Input].resize(config.decentralDevices.size());
+    blockSize[Output].resize(config.decentralDevices.size());
+
+    for (int d = 0; d < config.decentralDevices.size(); ++d) {
+        DecentralDeviceType& device = config.decentralDevices[d];
+        const GsdmlLengths* lengths = lengthsByDevice.value(device.deviceRefID, nullptr);
+        for (ModuleType& module : device.modules) {
+            for (SubmoduleType& submodule : module.submodules) {
+                IoLengths io;
+                if (lengths) {
+                    io = lengths->lookup(module, submodule);
+                } else {
+                    io.input = submodule.ioAddresses.inputLength;
+                    io.output = submodule.ioAddresses.outputLength;
+                }
+                submodule.ioAddresses.inputLength = std::max(0, io.input);
+                submodule.ioAddresses.outputLength = std::max(0, io.output);
+                blockSize[Input][d] += submodule.ioAddresses.inputLength;
+                blockSize[Output][d] += submodule.ioAddresses.outputLength;
+            }
+        }
+    }
+
+    // Keep devices whose current addresses are still complete and collision free
+    OccupiedRanges occupied[2];
+    QVector<bool> keep(config.decentralDevices.size(), false);
+
+    if (keepExisting) {
+        for (int d = 0; d < config.decentralDevices.size(); ++d) {
+            const DecentralDeviceType& device = config.decentralDevices[d];
+            QVector<int> inserted[2];
+            bool intact = true;
+
+            for (const ModuleType& module : device.modules) {
+                for (const SubmoduleType& submodule : module.submodules) {
+                    const IOAddresses& a = submodule.ioAddresses;
+                    const int start[2] = { a.inputStartAddress, a.outputStartAddress };
+                    const int length[2] = { a.inputLength, a.outputLength };
+                    for (int dir = Input; dir <= Output && intact; ++dir) {
+                        if (length[dir] == 0) {
+                            continue;
+                        }
+                        const int end = start[dir] + length[dir];
+                        if (start[dir] < base[dir] || end > options.addressLimit
+                                || !occupied[dir].isFree(start[dir], end)) {
+                            intact = false;
+                            break;
+                        }
+                        occupied[dir].insert(start[dir], end);
+                        inserted[dir].append(start[dir]);
+                    }
+                }
+            }
+
+            if (intact) {
+                keep[d] = true;
+                result.keptDevices++;
+            } else {
+                for (int dir = Input; dir <= Output; ++dir) {
+                    for (int start : inserted[dir]) {
+                        occupied[dir].remove(start);
+                    }
+                }
+            }
+        }
+    }
+
+    FreeSpace freeSpace[2] = {
+        FreeSpace(occupied[Input].holes(base[Input], options.addressLimit)),
+        FreeSpace(occupied[Output].holes(base[Output], options.addressLimit))
+    };
+
+    // Place the remaining devices as one block per direction
+    for (int d = 0; d < config.decentralDevices.size(); ++d) {
+        if (keep[d]) {
+            continue;
+        }
+
+        DecentralDeviceType& device = config.decentralDevices[d];
+        int blockStart[2] = { -1, -1 };
+        for (int dir = Input; dir <= Output; ++dir) {
+            if (blockSize[dir][d] == 0) {
+                continue;
+            }
+            const int reserve = aligned ? alignUp(blockSize[dir][d] + gap, alignment) : blockSize[dir][d];
+            blockStart[dir] = freeSpace[dir].take(reserve, alignment);
+            if (blockStart[dir] < 0 && result.success) {
+                result.success = false;
+                result.error = QString("Not enough %1 address space for device %2 (%3 bytes)")
+                    .arg(dir == Input ? "input" : "output")
+                    .arg(device.ethernetAddresses.deviceName.isEmpty()
+                         ? device.deviceRefID : device.ethernetAddresses.deviceName)
+                    .arg(blockSize[dir][d]);
+            }
+        }
+
+        int cursor[2] = { blockStart[Input], blockStart[Output] };
+        for (ModuleType& module : device.modules) {
+            for (SubmoduleType& submodule : module.submodules) {
+                IOAddresses& a = submodule.ioAddresses;
+                const bool hasIo = a.inputLength > 0 || a.outputLength > 0;
+
+                if (a.inputLength > 0 && cursor[Input] >= 0) {
+                    a.inputStartAddress = cursor[Input];
+                    cursor[Input] += a.inputLength;
+                } else {
+                    a.inputStartAddress = -1;
+                }
+                if (a.outputLength > 0 && cursor[Output] >= 0) {
+                    a.outputStartAddress = cursor[Output];
+                    cursor[Output] += a.outputLength;
+                } else {
+                    a.outputStartAddress = -1;
+                }
+
+                if (hasIo) {
+                    result.assignedSubmodules++;
+                }
+            }
+        }
+        result.placedDevices++;
+    }
+
+    // High water marks over the final layout
+    for (const DecentralDeviceType& device : config.decentralDevices) {
+        for (const ModuleType& module : device.modules) {
+            for (const SubmoduleType& submodule : module.submodules) {
+                const IOAddresses& a = submodule.ioAddresses;
+                if (a.inputStartAddress >= 0) {
+                    result.inputEnd = std::max(result.inputEnd, a.inputStartAddress + a.inputLength);
+                }
+                if (a.outputStartAddress >= 0) {
+                    result.outputEnd = std::max(result.outputEnd, a.outputStartAddress + a.outputLength);
+                }
+            }
+        }
+    }
+
+    PN_COUNTER_ADD("IoAddressAllocator.placedDevices", result.placedDevices);
+    PN_COUNTER_ADD("IoAddressAllocator.keptDevices", result.keptDevices);
+    return result;
+}
+
+} // namespace PNConfigLib
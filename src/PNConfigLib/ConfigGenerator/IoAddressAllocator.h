@@ -0,0 +1,95 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#ifndef IOADDRESSALLOCATOR_H
+#define IOADDRESSALLOCATOR_H
+
+#include "../ConfigReader/ConfigurationSchema.h"
+#include "../GsdmlParser/GsdmlParser.h"
+#include <QHash>
+#include <QString>
+
+namespace PNConfigLib {
+
+/**
+ * @brief How device IO blocks are laid out in the process image
+ */
+enum class IoAllocationPolicy {
+    Dense,          ///< Submodules back to back, no padding
+    DeviceAligned,  ///< Each device block starts on a multiple of deviceAlignment
+    ReservedGap     ///< Aligned device blocks followed by reservedGap spare bytes for growth
+};
+
+/**
+ * @brief Allocator parameters
+ */
+struct IoAllocationOptions {
+    IoAllocationPolicy policy = IoAllocationPolicy::Dense;
+    int inputBase = 0;              // First input address handed out
+    int outputBase = 0;             // First output address handed out
+    int addressLimit = 0x10000;     // End of the address space (exclusive)
+    int deviceAlignment = 16;       // DeviceAligned / ReservedGap
+    int reservedGap = 32;           // ReservedGap: spare bytes after each device block
+};
+
+/**
+ * @brief Allocation summary
+ */
+struct IoAllocationResult {
+    bool success = true;
+    QString error;                  // First device that did not fit
+    int placedDevices = 0;          // Devices that received new addresses
+    int keptDevices = 0;            // Devices left where they were (reallocate only)
+    int assignedSubmodules = 0;     // Submodules with IO in placed devices
+    int inputEnd = 0;               // Highest used input address + 1
+    int outputEnd = 0;              // Highest used output address + 1
+};
+
+/**
+ * @brief Assigns process image addresses to all submodules of a project
+ *
+ * IO lengths come from the GSDML submodule referenced by each Submodule's
+ * GSDRefID (falling back to the lengths already stored in the
+ * configuration). A device's submodules form one contiguous block per
+ * direction; input and output are independent address spaces.
+ *
+ * Placement is first-fit over the sorted list of free holes, so a full
+ * allocation is a single linear pass and incremental reallocation only
+ * searches the holes left between kept devices.
+ */
+class IoAddressAllocator {
+public:
+    /**
+     * @brief Assign addresses to every device, discarding existing ones
+     * @param config Configuration to update in place (start addresses and lengths)
+     * @param gsdmlData Parsed GSDML per DeviceID (as from Compiler::loadGsdmlData)
+     */
+    static IoAllocationResult allocate(
+        Configuration& config,
+        const QHash<QString, GsdmlInfo>& gsdmlData,
+        const IoAllocationOptions& options = IoAllocationOptions());
+
+    /**
+     * @brief Assign addresses only where needed
+     *
+     * Devices whose submodules all have addresses that fit their (possibly
+     * changed) IO lengths without colliding with earlier kept devices stay
+     * untouched. New, grown or colliding devices are placed into free space.
+     */
+    static IoAllocationResult reallocate(
+        Configuration& config,
+        const QHash<QString, GsdmlInfo>& gsdmlData,
+        const IoAllocationOptions& options = IoAllocationOptions());
+
+private:
+    static IoAllocationResult run(
+        Configuration& config,
+        const QHash<QString, GsdmlInfo>& gsdmlData,
+        const IoAllocationOptions& options,
+        bool keepExisting);
+};
+
+} // namespace PNConfigLib
+
+#endif // IOADDRESSALLOCATOR_H
@@ -3,6 +3,8 @@
 /*****************************************************************************/
 
 #include "ConfigReader.h"
+#include "MappedConfigReader.h"
+#include "../Instrumentation/Instrumentation.h"
 #include "tinyxml2/tinyxml2.h"
 #include <QFile>
 #include <stdexcept>
@@ -19,8 +21,14 @@ static QString getAttribute(XMLElement* element, const char* name, const QString
     return val ? QString(val) : defaultValue;
 }
 
-Configuration ConfigReader::parseConfiguration(const QString& configPath)
+Configuration ConfigReader::parseConfiguration(const QString& configPath, ConfigReadMode mode)
 {
+    if (mode == ConfigReadMode::Mapped) {
+        return MappedConfigReader::parseConfiguration(configPath);
+    }
+
+    PN_SCOPED_TIMER("ConfigReader::parseConfiguration");
+    
     XMLDocument doc;
     XMLError err = doc.LoadFile(configPath.toStdString().c_str());
     
@@ -56,17 +64,18 @@ Configuration ConfigReader::parseConfiguration(const QString& configPath)
     // Parse DecentralDevices
     XMLElement* decentralElem = devicesElem->FirstChildElement("DecentralDevice");
     while (decentralElem) {
-        DecentralDeviceType device;
-        parseDecentralDevice(decentralElem, device);
-        config.decentralDevices.append(device);
+        config.decentralDevices.emplaceBack();
+        parseDecentralDevice(decentralElem, config.decentralDevices.last());
         decentralElem = decentralElem->NextSiblingElement("DecentralDevice");
     }
     
     return config;
 }
 
-ListOfNodes ConfigReader::parseListOfNodes(const QString& nodesPath)
+ListOfNodes ConfigReader::parseListOfNodes(const QString& nodesPath, const DeviceNodeCallback& onDevice)
 {
+    PN_SCOPED_TIMER("ConfigReader::parseListOfNodes");
+    
     XMLDocument doc;
     XMLError err = doc.LoadFile(nodesPath.toStdString().c_str());
     
@@ -94,9 +103,11 @@ ListOfNodes ConfigReader::parseListOfNodes(const QString& nodesPath)
     // Parse DecentralDevices
     XMLElement* decentralElem = root->FirstChildElement("DecentralDevice");
     while (decentralElem) {
-        DecentralDeviceNode device;
-        parseDecentralDeviceNode(decentralElem, device);
-        nodes.decentralDevices.append(device);
+        nodes.decentralDevices.emplaceBack();
+        parseDecentralDeviceNode(decentralElem, nodes.decentralDevices.last());
+        if (onDevice) {
+            onDevice(nodes.decentralDevices.last());
+        }
         decentralElem = decentralElem->NextSiblingElement("DecentralDevice");
     }
     
@@ -147,9 +158,8 @@ void ConfigReader::parseDecentralDevice(XMLElement* element, DecentralDeviceType
     // Parse Modules
     XMLElement* moduleElem = element->FirstChildElement("Module");
     while (moduleElem) {
-        ModuleType module;
-        parseModule(moduleElem, module);
-        device.modules.append(module);
+        device.modules.emplaceBack();
+        parseModule(moduleElem, device.modules.last());
         moduleElem = moduleElem->NextSiblingElement("Module");
     }
 }
@@ -186,9 +196,8 @@ void ConfigReader::parseModule(XMLElement* element, ModuleType& module)
     // Parse Submodules
     XMLElement* submoduleElem = element->FirstChildElement("Submodule");
     while (submoduleElem) {
-        SubmoduleType submodule;
-        parseSubmodule(submoduleElem, submodule);
-        module.submodules.append(submodule);
+        module.submodules.emplaceBack();
+        parseSubmodule(submoduleElem, module.submodules.last());
         submoduleElem = submoduleElem->NextSiblingElement("Submodule");
     }
 }
@@ -232,9 +241,8 @@ void ConfigReader::parsePNDriver(XMLElement* element, PNDriverType& driver)
     
     XMLElement* interfaceElem = element->FirstChildElement("Interface");
     while (interfaceElem) {
-        InterfaceType iface;
-        parseInterface(interfaceElem, iface);
-        driver.interfaces.append(iface);
+        driver.interfaces.emplaceBack();
+        parseInterface(interfaceElem, driver.interfaces.last());
         interfaceElem = interfaceElem->NextSiblingElement("Interface");
     }
 }
@@ -248,9 +256,8 @@ void ConfigReader::parseDecentralDeviceNode(XMLElement* element, DecentralDevice
     
     XMLElement* interfaceElem = element->FirstChildElement("Interface");
     while (interfaceElem) {
-        InterfaceType iface;
-        parseInterface(interfaceElem, iface);
-        device.interfaces.append(iface);
+        device.interfaces.emplaceBack();
+        parseInterface(interfaceElem, device.interfaces.last());
         interfaceElem = interfaceElem->NextSiblingElement("Interface");
     }
 }
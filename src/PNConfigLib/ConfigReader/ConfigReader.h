@@ -7,6 +7,7 @@
 
 #include "ConfigurationSchema.h"
 #include <QString>
+#include <functional>
 
 namespace tinyxml2 {
 class XMLElement;
@@ -14,6 +15,14 @@ class XMLElement;
 
 namespace PNConfigLib {
 
+/**
+ * @brief How ConfigReader::parseConfiguration reads the file
+ */
+enum class ConfigReadMode {
+    Dom,        ///< tinyxml2 DOM (default)
+    Mapped      ///< Memory-mapped single streaming pass, see MappedConfigReader
+};
+
 /**
  * @brief Configuration file reader
  * 
@@ -24,18 +33,27 @@ public:
     /**
      * @brief Parse Configuration.xml file
      * @param configPath Path to Configuration.xml
+     * @param mode Reader implementation; Mapped is preferred for large projects
      * @return Parsed configuration structure
      * @throws std::runtime_error on parse failure
      */
-    static Configuration parseConfiguration(const QString& configPath);
+    static Configuration parseConfiguration(const QString& configPath,
+                                            ConfigReadMode mode = ConfigReadMode::Dom);
     
+    /**
+     * @brief Called for each DecentralDevice as soon as it has been read
+     */
+    using DeviceNodeCallback = std::function<void(const DecentralDeviceNode&)>;
+
     /**
      * @brief Parse ListOfNodes.xml file
      * @param nodesPath Path to ListOfNodes.xml
+     * @param onDevice Optional callback per DecentralDevice, e.g. to start loading its GSDML early
      * @return Parsed ListOfNodes structure
      * @throws std::runtime_error on parse failure
      */
-    static ListOfNodes parseListOfNodes(const QString& nodesPath);
+    static ListOfNodes parseListOfNodes(const QString& nodesPath,
+                                        const DeviceNodeCallback& onDevice = DeviceNodeCallback());
     
 private:
     static void parseCentralDevice(tinyxml2::XMLElement* element, CentralDeviceType& device);
@@ -0,0 +1,386 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include "MappedConfigReader.h"
+#include "../Instrumentation/Instrumentation.h"
+#include <QFile>
+#include <QXmlStreamReader>
+#include <cstring>
+#include <stdexcept>
+
+namespace PNConfigLib {
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+
+static std::runtime_error readError(const QXmlStreamReader& xml, const QString& sourceName, const QString& message)
+{
+    return std::runtime_error(QString("Failed to load configuration file: %1. Error: line %2: %3")
+        .arg(sourceName).arg(xml.lineNumber()).arg(message).toStdString());
+}
+
+// Attribute lookup by raw name (like tinyxml2), nullptr if absent
+static const QXmlStreamAttribute* findAttribute(const QXmlStreamAttributes& attributes, QLatin1String name)
+{
+    for (const QXmlStreamAttribute& attribute : attributes) {
+        if (attribute.qualifiedName() == name) {
+            return &attribute;
+        }
+    }
+    return nullptr;
+}
+
+static QString attributeString(const QXmlStreamAttributes& attributes, QLatin1String name,
+                               const QString& defaultValue = QString())
+{
+    const QXmlStreamAttribute* attribute = findAttribute(attributes, name);
+    return attribute ? attribute->value().toString() : defaultValue;
+}
+
+static int attributeInt(const QXmlStreamAttributes& attributes, QLatin1String name, int defaultValue = 0)
+{
+    const QXmlStreamAttribute* attribute = findAttribute(attributes, name);
+    return attribute ? attribute->value().toInt() : defaultValue;
+}
+
+// Text of the element's first child node, like tinyxml2's XMLElement::GetText():
+// comments are skipped, and the result is null if that node is an element or
+// processing instruction, or if there is none. Whitespace in front of a child
+// element is not a node to tinyxml2, so it is skipped here too. Consumes the
+// element.
+static QString firstChildText(QXmlStreamReader& xml)
+{
+    QString text;
+    bool decided = false;
+    int depth = 0;
+    while (!xml.atEnd()) {
+        const QXmlStreamReader::TokenType token = xml.readNext();
+        if (token == QXmlStreamReader::EndElement) {
+            if (depth == 0) {
+                break;
+            }
+            --depth;
+        } else if (token == QXmlStreamReader::StartElement) {
+            ++depth;
+            decided = true;
+        } else if (depth == 0 && !decided) {
+            if (token == QXmlStreamReader::Characters) {
+                if (!xml.isCDATA() && xml.isWhitespace()) {
+                    continue;
+                }
+                text = xml.text().toString();
+                decided = true;
+            } else if (token == QXmlStreamReader::ProcessingInstruction
+                       || token == QXmlStreamReader::EntityReference) {
+                decided = true;
+            }
+        }
+    }
+    return text;
+}
+
+// True if 'tag' starts at p and is followed by a delimiter, i.e. "<tag " but not "<tagSuffix"
+static inline bool tagAt(const char* p, const char* end, const char* tag, size_t length)
+{
+    if (static_cast<size_t>(end - p) <= length || std::memcmp(p, tag, length) != 0) {
+        return false;
+    }
+    const char next = p[length];
+    return next == ' ' || next == '>' || next == '/' || next == '\t' || next == '\r' || next == '\n';
+}
+
+// -----------------------------------------------------------------------------
+// Reader
+// -----------------------------------------------------------------------------
+
+Configuration MappedConfigReader::parseConfiguration(const QString& configPath)
+{
+    PN_SCOPED_TIMER("MappedConfigReader::parseConfiguration");
+
+    QFile file(configPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        throw std::runtime_error(QString("Failed to load configuration file: %1. Error: %2")
+            .arg(configPath).arg(file.errorString()).toStdString());
+    }
+
+    // The mapping stays valid until the QFile is destroyed; nothing in the
+    // returned Configuration references it.
+    const qint64 size = file.size();
+    uchar* mapped = size > 0 ? file.map(0, size) : nullptr;
+    if (mapped) {
+        return parseConfigurationData(
+            QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), static_cast<qsizetype>(size)),
+            configPath);
+    }
+
+    // File systems without mmap support (and empty files)
+    return parseConfigurationData(file.readAll(), configPath);
+}
+
+Configuration MappedConfigReader::parseConfigurationData(const QByteArray& data, const QString& sourceName)
+{
+    const CapacityHints hints = scanCapacity(data);
+    QXmlStreamReader xml(data);
+
+    if (!xml.readNextStartElement()) {
+        throw readError(xml, sourceName, xml.hasError() ? xml.errorString() : QString("Empty document"));
+    }
+    if (xml.qualifiedName() != QLatin1String("Configuration")) {
+        throw std::runtime_error("Invalid configuration file: Missing root 'Configuration' element");
+    }
+
+    Configuration config;
+    const QXmlStreamAttributes attributes = xml.attributes();
+    config.configurationID = attributeString(attributes, QLatin1String("ConfigurationID"));
+    config.configurationName = attributeString(attributes, QLatin1String("ConfigurationName"));
+    config.listOfNodesRefID = attributeString(attributes, QLatin1String("ListOfNodesRefID"));
+    config.schemaVersion = attributeString(attributes, QLatin1String("schemaVersion"), "1.0");
+
+    bool haveDevices = false;
+    while (xml.readNextStartElement()) {
+        if (!haveDevices && xml.qualifiedName() == QLatin1String("Devices")) {
+            readDevices(xml, config, hints);
+            haveDevices = true;
+        } else {
+            xml.skipCurrentElement();
+        }
+    }
+
+    if (xml.hasError()) {
+        throw readError(xml, sourceName, xml.errorString());
+    }
+    if (!haveDevices) {
+        throw std::runtime_error("Missing Devices element in Configuration");
+    }
+
+    return config;
+}
+
+MappedConfigReader::CapacityHints MappedConfigReader::scanCapacity(const QByteArray& data)
+{
+    // One memchr-driven pass over the raw bytes; only used to size containers,
+    // so commented-out elements being counted does no harm.
+    qsizetype devices = 0;
+    qsizetype modules = 0;
+    qsizetype submodules = 0;
+
+    const char* p = data.constData();
+    const char* end = p + data.size();
+    while (p < end) {
+        p = static_cast<const char*>(std::memchr(p, '<', static_cast<size_t>(end - p)));
+        if (!p) {
+            break;
+        }
+        ++p;
+        if (tagAt(p, end, "DecentralDevice", 15)) {
+            ++devices;
+        } else if (tagAt(p, end, "Module", 6)) {
+            ++modules;
+        } else if (tagAt(p, end, "Submodule", 9)) {
+            ++submodules;
+        }
+    }
+
+    CapacityHints hints;
+    hints.devices = devices;
+    hints.modulesPerDevice = devices > 0 ? (modules + devices - 1) / devices : 0;
+    hints.submodulesPerModule = modules > 0 ? (submodules + modules - 1) / modules : 0;
+    return hints;
+}
+
+void MappedConfigReader::readDevices(QXmlStreamReader& xml, Configuration& config, const CapacityHints& hints)
+{
+    config.decentralDevices.reserve(hints.devices);
+
+    bool haveCentral = false;
+    while (xml.readNextStartElement()) {
+        const QStringView tag = xml.qualifiedName();
+        if (tag == QLatin1String("DecentralDevice")) {
+            config.decentralDevices.emplaceBack();
+            readDecentralDevice(xml, config.decentralDevices.last(), hints);
+        } else if (!haveCentral && tag == QLatin1String("CentralDevice")) {
+            readCentralDevice(xml, config.centralDevice);
+            haveCentral = true;
+        } else {
+            xml.skipCurrentElement();
+        }
+    }
+}
+
+void MappedConfigReader::readCentralDevice(QXmlStreamReader& xml, CentralDeviceType& device)
+{
+    device.deviceRefID = attributeString(xml.attributes(), QLatin1String("DeviceRefID"));
+
+    // Only the first of each child counts, like FirstChildElement in ConfigReader
+    bool haveInterface = false;
+    while (xml.readNextStartElement()) {
+        if (haveInterface || xml.qualifiedName() != QLatin1String("CentralDeviceInterface")) {
+            xml.skipCurrentElement();
+            continue;
+        }
+        haveInterface = true;
+
+        device.interfaceRefID = attributeString(xml.attributes(), QLatin1String("InterfaceRefID"));
+        bool haveAddresses = false;
+        bool haveOptions = false;
+        while (xml.readNextStartElement()) {
+            const QStringView tag = xml.qualifiedName();
+            if (!haveAddresses && tag == QLatin1String("EthernetAddresses")) {
+                readEthernetAddresses(xml, device.ethernetAddresses);
+                haveAddresses = true;
+            } else if (!haveOptions && tag == QLatin1String("AdvancedOptions")) {
+                // AdvancedOptions/RealTimeSettings/IOCommunication@SendClock
+                haveOptions = true;
+                bool haveRealTime = false;
+                while (xml.readNextStartElement()) {
+                    if (haveRealTime || xml.qualifiedName() != QLatin1String("RealTimeSettings")) {
+                        xml.skipCurrentElement();
+                        continue;
+                    }
+                    haveRealTime = true;
+                    bool haveCommunication = false;
+                    while (xml.readNextStartElement()) {
+                        if (!haveCommunication && xml.qualifiedName() == QLatin1String("IOCommunication")) {
+                            device.sendClock = attributeInt(xml.attributes(), QLatin1String("SendClock"), 1);
+                            haveCommunication = true;
+                        }
+                        xml.skipCurrentElement();
+                    }
+                }
+            } else {
+                xml.skipCurrentElement();
+            }
+        }
+    }
+}
+
+void MappedConfigReader::readDecentralDevice(QXmlStreamReader& xml, DecentralDeviceType& device,
+                                             const CapacityHints& hints)
+{
+    device.deviceRefID = attributeString(xml.attributes(), QLatin1String("DeviceRefID"));
+    device.modules.reserve(hints.modulesPerDevice);
+
+    bool haveInterface = false;
+    while (xml.readNextStartElement()) {
+        const QStringView tag = xml.qualifiedName();
+        if (tag == QLatin1String("Module")) {
+            device.modules.emplaceBack();
+            readModule(xml, device.modules.last(), hints);
+        } else if (!haveInterface && tag == QLatin1String("DecentralDeviceInterface")) {
+            haveInterface = true;
+            device.interfaceRefID = attributeString(xml.attributes(), QLatin1String("InterfaceRefID"));
+            bool haveAddresses = false;
+            while (xml.readNextStartElement()) {
+                if (!haveAddresses && xml.qualifiedName() == QLatin1String("EthernetAddresses")) {
+                    readEthernetAddresses(xml, device.ethernetAddresses);
+                    haveAddresses = true;
+                } else {
+                    xml.skipCurrentElement();
+                }
+            }
+        } else {
+            xml.skipCurrentElement();
+        }
+    }
+}
+
+void MappedConfigReader::readEthernetAddresses(QXmlStreamReader& xml, EthernetAddresses& addresses)
+{
+    bool haveProtocol = false;
+    bool haveName = false;
+    while (xml.readNextStartElement()) {
+        const QStringView tag = xml.qualifiedName();
+        if (!haveProtocol && tag == QLatin1String("IPProtocol")) {
+            haveProtocol = true;
+            bool haveSetInProject = false;
+            while (xml.readNextStartElement()) {
+                if (!haveSetInProject && xml.qualifiedName() == QLatin1String("SetInTheProject")) {
+                    const QXmlStreamAttributes attributes = xml.attributes();
+                    addresses.ipAddress = attributeString(attributes, QLatin1String("IPAddress"));
+                    addresses.subnetMask = attributeString(attributes, QLatin1String("SubnetMask"), "255.255.255.0");
+                    addresses.routerAddress = attributeString(attributes, QLatin1String("RouterAddress"));
+                    haveSetInProject = true;
+                }
+                xml.skipCurrentElement();
+            }
+        } else if (!haveName && tag == QLatin1String("PROFINETDeviceName")) {
+            haveName = true;
+            addresses.deviceNumber = attributeInt(xml.attributes(), QLatin1String("DeviceNumber"));
+            bool haveText = false;
+            while (xml.readNextStartElement()) {
+                if (!haveText && xml.qualifiedName() == QLatin1String("PNDeviceName")) {
+                    haveText = true;
+                    QString name = firstChildText(xml);
+                    if (!name.isNull()) {
+                        addresses.deviceName = std::move(name);
+                    }
+                } else {
+                    xml.skipCurrentElement();
+                }
+            }
+        } else {
+            xml.skipCurrentElement();
+        }
+    }
+}
+
+void MappedConfigReader::readModule(QXmlStreamReader& xml, ModuleType& module, const CapacityHints& hints)
+{
+    const QXmlStreamAttributes attributes = xml.attributes();
+    module.moduleID = attributeString(attributes, QLatin1String("ModuleID"));
+    module.slotNumber = attributeInt(attributes, QLatin1String("SlotNumber"));
+    module.gsdRefID = attributeString(attributes, QLatin1String("GSDRefID"));
+    module.submodules.reserve(hints.submodulesPerModule);
+
+    while (xml.readNextStartElement()) {
+        if (xml.qualifiedName() == QLatin1String("Submodule")) {
+            module.submodules.emplaceBack();
+            readSubmodule(xml, module.submodules.last());
+        } else {
+            xml.skipCurrentElement();
+        }
+    }
+}
+
+void MappedConfigReader::readSubmodule(QXmlStreamReader& xml, SubmoduleType& submodule)
+{
+    const QXmlStreamAttributes attributes = xml.attributes();
+    submodule.submoduleID = attributeString(attributes, QLatin1String("SubmoduleID"));
+    submodule.subslotNumber = attributeInt(attributes, QLatin1String("SubslotNumber"));
+    submodule.gsdRefID = attributeString(attributes, QLatin1String("GSDRefID"));
+
+    bool haveAddresses = false;
+    while (xml.readNextStartElement()) {
+        if (!haveAddresses && xml.qualifiedName() == QLatin1String("IOAddresses")) {
+            readIOAddresses(xml, submodule.ioAddresses);
+            haveAddresses = true;
+        } else {
+            xml.skipCurrentElement();
+        }
+    }
+}
+
+void MappedConfigReader::readIOAddresses(QXmlStreamReader& xml, IOAddresses& addresses)
+{
+    bool haveInput = false;
+    bool haveOutput = false;
+    while (xml.readNextStartElement()) {
+        const QStringView tag = xml.qualifiedName();
+        if (!haveInput && tag == QLatin1String("InputAddresses")) {
+            haveInput = true;
+            const QXmlStreamAttributes attributes = xml.attributes();
+            addresses.inputStartAddress = attributeInt(attributes, QLatin1String("StartAddress"));
+            addresses.inputLength = attributeInt(attributes, QLatin1String("Length"), addresses.inputLength);
+        } else if (!haveOutput && tag == QLatin1String("OutputAddresses")) {
+            haveOutput = true;
+            const QXmlStreamAttributes attributes = xml.attributes();
+            addresses.outputStartAddress = attributeInt(attributes, QLatin1String("StartAddress"));
+            addresses.outputLength = attributeInt(attributes, QLatin1String("Length"), addresses.outputLength);
+        }
+        xml.skipCurrentElement();
+    }
+}
+
+} // namespace PNConfigLib
@@ -0,0 +1,65 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#ifndef MAPPEDCONFIGREADER_H
+#define MAPPEDCONFIGREADER_H
+
+#include "ConfigurationSchema.h"
+#include <QString>
+
+class QXmlStreamReader;
+
+namespace PNConfigLib {
+
+/**
+ * @brief Single-pass Configuration.xml reader for large projects
+ *
+ * Maps the file into memory and parses it with QXmlStreamReader directly
+ * from the mapping, without building a DOM. Devices, modules and submodules
+ * are constructed in place in their final containers, whose capacity is
+ * reserved from a quick scan of the mapped bytes.
+ *
+ * Produces the same Configuration as the DOM based ConfigReader: of repeated
+ * single-valued children (interfaces, addresses, IOAddresses) only the first
+ * is read, and PNDeviceName follows tinyxml2's GetText().
+ */
+class MappedConfigReader {
+public:
+    /**
+     * @brief Parse Configuration.xml file
+     * @param configPath Path to Configuration.xml
+     * @return Parsed configuration structure
+     * @throws std::runtime_error on parse failure
+     */
+    static Configuration parseConfiguration(const QString& configPath);
+
+    /**
+     * @brief Parse Configuration.xml content already in memory
+     * @param data Document bytes (may be a raw, non-owning QByteArray)
+     * @param sourceName Name used in error messages
+     * @throws std::runtime_error on parse failure
+     */
+    static Configuration parseConfigurationData(const QByteArray& data, const QString& sourceName);
+
+private:
+    struct CapacityHints {
+        qsizetype devices = 0;
+        qsizetype modulesPerDevice = 0;
+        qsizetype submodulesPerModule = 0;
+    };
+
+    static CapacityHints scanCapacity(const QByteArray& data);
+
+    static void readDevices(QXmlStreamReader& xml, Configuration& config, const CapacityHints& hints);
+    static void readCentralDevice(QXmlStreamReader& xml, CentralDeviceType& device);
+    static void readDecentralDevice(QXmlStreamReader& xml, DecentralDeviceType& device, const CapacityHints& hints);
+    static void readEthernetAddresses(QXmlStreamReader& xml, EthernetAddresses& addresses);
+    static void readModule(QXmlStreamReader& xml, ModuleType& module, const CapacityHints& hints);
+    static void readSubmodule(QXmlStreamReader& xml, SubmoduleType& submodule);
+    static void readIOAddresses(QXmlStreamReader& xml, IOAddresses& addresses);
+};
+
+} // namespace PNConfigLib
+
+#endif // MAPPEDCONFIGREADER_H
@@ -5,66 +5,412 @@
 #include "ConsistencyLogger.h"
 
 #include <QDebug>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
 
 namespace PNConfigLib {
 
-QList<ConsistencyLog> ConsistencyLogger::s_logs;
+std::atomic<int> ConsistencyLogger::s_minimumSeverity{static_cast<int>(LogSeverity::Info)};
 
-void ConsistencyLogger::reset()
+namespace {
+
+// Producers trigger a drain themselves once this many messages are pending
+constexpr qint64 DrainThreshold = 4096;
+
+struct Node {
+    std::atomic<Node*> next{nullptr};
+    ConsistencyLog log;
+};
+
+/**
+ * @brief Intrusive multi-producer single-consumer queue (Vyukov)
+ *
+ * push() is wait-free; pop() must only be called by one thread at a time.
+ */
+class MpscQueue {
+public:
+    MpscQueue()
+        : m_head(&m_stub)
+        , m_tail(&m_stub)
+    {
+    }
+
+    ~MpscQueue()
+    {
+        while (Node* node = pop()) {
+            delete node;
+        }
+    }
+
+    void push(Node* node)
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* previous = m_head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    Node* pop()
+    {
+        Node* tail = m_tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+
+        if (tail == &m_stub) {
+            if (!next) {
+                return nullptr;
+            }
+            m_tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next) {
+            m_tail = next;
+            return tail;
+        }
+
+        // A producer has swapped the head but not linked it yet
+        if (tail != m_head.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+
+        push(&m_stub);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next) {
+            m_tail = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+private:
+    std::atomic<Node*> m_head;
+    Node* m_tail;
+    Node m_stub;
+};
+
+struct LoggerState {
+    MpscQueue queue;
+    std::atomic<qint64> pending{0};
+    std::atomic<qint64> counts[3] = {{0}, {0}, {0}};
+
+    // Consumer side, guarded by consumerMutex
+    QMutex consumerMutex;
+    QVector<ConsistencyLog> ring;
+    int ringStart = 0;
+    int capacity = 100000;
+    qint64 dropped = 0;
+    QList<std::shared_ptr<ConsistencyLogSink>> sinks;
+
+    void retain(ConsistencyLog&& log)
+    {
+        if (capacity <= 0) {
+            dropped++;
+            return;
+        }
+        if (ring.size() < capacity) {
+            ring.append(std::move(log));
+            return;
+        }
+        ring[ringStart] = std::move(log);
+        ringStart = (ringStart + 1) % capacity;
+        dropped++;
+    }
+
+    // Caller holds consumerMutex
+    void drain()
+    {
+        while (Node* node = queue.pop()) {
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            for (const auto& sink : sinks) {
+                sink->write(node->log);
+            }
+            retain(std::move(node->log));
+            delete node;
+        }
+        for (const auto& sink : sinks) {
+            sink->flush();
+        }
+    }
+
+    QList<ConsistencyLog> snapshot() const
+    {
+        QList<ConsistencyLog> result;
+        result.reserve(ring.size());
+        for (int i = 0; i < ring.size(); ++i) {
+            result.append(ring[(ringStart + i) % ring.size()]);
+        }
+        return result;
+    }
+};
+
+LoggerState& state()
 {
-    s_logs.clear();
+    static LoggerState instance;
+    return instance;
 }
 
-void ConsistencyLogger::log(ConsistencyType type, LogSeverity severity, const QString& source, const QString& message)
+QString severityName(LogSeverity severity)
+{
+    switch (severity) {
+        case LogSeverity::Error: return "错误";
+        case LogSeverity::Warning: return "警告";
+        case LogSeverity::Info: return "信息";
+    }
+    return QString();
+}
+
+QString typeName(ConsistencyType type)
+{
+    switch (type) {
+        case ConsistencyType::XML: return "XML";
+        case ConsistencyType::XSD: return "XSD";
+        case ConsistencyType::PN: return "PN";
+        case ConsistencyType::GSDML: return "GSDML";
+    }
+    return QString();
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+// Sinks
+// -----------------------------------------------------------------------------
+
+TextFileLogSink::TextFileLogSink(const QString& path)
+    : m_file(new QFile(path))
+{
+    m_file->open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text);
+}
+
+TextFileLogSink::~TextFileLogSink() = default;
+
+bool TextFileLogSink::isOpen() const
+{
+    return m_file->isOpen();
+}
+
+void TextFileLogSink::write(const ConsistencyLog& log)
+{
+    if (m_file->isOpen()) {
+        m_file->write(ConsistencyLogger::formatLog(log).toUtf8());
+    }
+}
+
+void TextFileLogSink::flush()
+{
+    if (m_file->isOpen()) {
+        m_file->flush();
+    }
+}
+
+JsonLinesLogSink::JsonLinesLogSink(const QString& path)
+    : m_file(new QFile(path))
+{
+    m_file->open(QIODevice::WriteOnly | QIODevice::Truncate);
+}
+
+JsonLinesLogSink::~JsonLinesLogSink() = default;
+
+bool JsonLinesLogSink::isOpen() const
+{
+    return m_file->isOpen();
+}
+
+void JsonLinesLogSink::write(const ConsistencyLog& log)
+{
+    if (!m_file->isOpen()) {
+        return;
+    }
+
+    static const char* severities[] = { "info", "warning", "error" };
+    QJsonObject obj;
+    obj["type"] = typeName(log.type);
+    obj["severity"] = QString::fromLatin1(severities[static_cast<int>(log.severity)]);
+    obj["source"] = log.source;
+    obj["message"] = log.message;
+
+    m_file->write(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+    m_file->write("\n", 1);
+}
+
+void JsonLinesLogSink::flush()
+{
+    if (m_file->isOpen()) {
+        m_file->flush();
+    }
+}
+
+CallbackLogSink::CallbackLogSink(std::function<void(const ConsistencyLog&)> callback)
+    : m_callback(std::move(callback))
+{
+}
+
+void CallbackLogSink::write(const ConsistencyLog& log)
+{
+    if (m_callback) {
+        m_callback(log);
+    }
+}
+
+void DebugLogSink::write(const ConsistencyLog& log)
 {
-    s_logs.append(ConsistencyLog(type, severity, source, message));
-    
-    // Log to qDebug for file redirection
     QString sev;
-    switch(severity) {
+    switch(log.severity) {
         case LogSeverity::Info: sev = "INFO"; break;
         case LogSeverity::Warning: sev = "WARN"; break;
         case LogSeverity::Error: sev = "ERROR"; break;
     }
-    qDebug() << QString("[CONSISTENCY %1] %2: %3").arg(sev, source, message);
+    qDebug() << QString("[CONSISTENCY %1] %2: %3").arg(sev, log.source, log.message);
 }
 
+// -----------------------------------------------------------------------------
+// Logger
+// -----------------------------------------------------------------------------
 
-QList<ConsistencyLog>& ConsistencyLogger::logs()
+void ConsistencyLogger::reset()
 {
-    return s_logs;
+    LoggerState& s = state();
+    QMutexLocker locker(&s.consumerMutex);
+    while (Node* node = s.queue.pop()) {
+        s.pending.fetch_sub(1, std::memory_order_relaxed);
+        delete node;
+    }
+    s.ring.clear();
+    s.ringStart = 0;
+    s.dropped = 0;
+    for (auto& counter : s.counts) {
+        counter.store(0, std::memory_order_relaxed);
+    }
 }
 
-bool ConsistencyLogger::hasErrors()
+void ConsistencyLogger::log(ConsistencyType type, LogSeverity severity, const QString& source, const QString& message)
 {
-    for (const auto& log : s_logs) {
-        if (log.severity == LogSeverity::Error) {
-            return true;
-        }
+    log(ConsistencyLog(type, severity, source, message));
+}
+
+void ConsistencyLogger::log(const ConsistencyLog& entry)
+{
+    if (!isEnabled(entry.severity)) {
+        return;
+    }
+    
+    LoggerState& s = state();
+    Node* node = new Node;
+    node->log = entry;
+    s.counts[static_cast<int>(entry.severity)].fetch_add(1, std::memory_order_relaxed);
+    s.queue.push(node);
+    
+    // Keep memory bounded without a dedicated consumer thread; never block here
+    if (s.pending.fetch_add(1, std::memory_order_relaxed) + 1 >= DrainThreshold
+            && s.consumerMutex.tryLock()) {
+        s.drain();
+        s.consumerMutex.unlock();
     }
-    return false;
+}
+
+void ConsistencyLogger::setMinimumSeverity(LogSeverity severity)
+{
+    s_minimumSeverity.store(static_cast<int>(severity), std::memory_order_relaxed);
+}
+
+void ConsistencyLogger::setCapacity(int capacity)
+{
+    LoggerState& s = state();
+    QMutexLocker locker(&s.consumerMutex);
+    s.drain();
+    
+    // Re-linearize, keeping the newest messages
+    QList<ConsistencyLog> kept = s.snapshot();
+    const int keep = qMax(0, qMin(capacity, static_cast<int>(kept.size())));
+    s.dropped += kept.size() - keep;
+    s.ring = QVector<ConsistencyLog>(kept.end() - keep, kept.end());
+    s.ringStart = 0;
+    s.capacity = qMax(0, capacity);
+}
+
+int ConsistencyLogger::capacity()
+{
+    LoggerState& s = state();
+    QMutexLocker locker(&s.consumerMutex);
+    return s.capacity;
+}
+
+qint64 ConsistencyLogger::droppedCount()
+{
+    LoggerState& s = state();
+    QMutexLocker locker(&s.consumerMutex);
+    s.drain();
+    return s.dropped;
+}
+
+void ConsistencyLogger::addSink(const std::shared_ptr<ConsistencyLogSink>& sink)
+{
+    LoggerState& s = state();
+    QMutexLocker locker(&s.consumerMutex);
+    s.drain();      // Earlier messages must not reach a sink added later
+    s.sinks.append(sink);
+}
+
+void ConsistencyLogger::removeSink(const std::shared_ptr<ConsistencyLogSink>& sink)
+{
+    LoggerState& s = state();
+    QMutexLocker locker(&s.consumerMutex);
+    s.drain();
+    s.sinks.removeAll(sink);
+}
+
+void ConsistencyLogger::clearSinks()
+{
+    LoggerState& s = state();
+    QMutexLocker locker(&s.consumerMutex);
+    s.drain();
+    s.sinks.clear();
+}
+
+void ConsistencyLogger::flush()
+{
+    LoggerState& s = state();
+    QMutexLocker locker(&s.consumerMutex);
+    s.drain();
+}
+
+QList<ConsistencyLog> ConsistencyLogger::logs()
+{
+    LoggerState& s = state();
+    QMutexLocker locker(&s.consumerMutex);
+    s.drain();
+    return s.snapshot();
+}
+
+qint64 ConsistencyLogger::count(LogSeverity severity)
+{
+    return state().counts[static_cast<int>(severity)].load(std::memory_order_relaxed);
+}
+
+bool ConsistencyLogger::hasErrors()
+{
+    return count(LogSeverity::Error) > 0;
 }
 
 QString ConsistencyLogger::formatLogs()
+{
+    return formatLogs(logs());
+}
+
+QString ConsistencyLogger::formatLog(const ConsistencyLog& log)
+{
+    return QString("[%1][%2] %3: %4\n").arg(typeName(log.type), severityName(log.severity), log.source, log.message);
+}
+
+QString ConsistencyLogger::formatLogs(const QList<ConsistencyLog>& logs)
 {
     QString result;
-    for (const auto& log : s_logs) {
-        QString severityStr;
-        switch (log.severity) {
-            case LogSeverity::Error: severityStr = "错误"; break;
-            case LogSeverity::Warning: severityStr = "警告"; break;
-            case LogSeverity::Info: severityStr = "信息"; break;
-        }
-        
-        QString typeStr;
-        switch (log.type) {
-            case ConsistencyType::XML: typeStr = "XML"; break;
-            case ConsistencyType::XSD: typeStr = "XSD"; break;
-            case ConsistencyType::PN: typeStr = "PN"; break;
-            case ConsistencyType::GSDML: typeStr = "GSDML"; break;
-        }
-        
-        result += QString("[%1][%2] %3: %4\n").arg(typeStr, severityStr, log.source, log.message);
+    for (const auto& log : logs) {
+        result += formatLog(log);
     }
     return result;
 }
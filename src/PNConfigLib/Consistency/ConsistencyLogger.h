@@ -7,6 +7,11 @@
 
 #include <QString>
 #include <QList>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+class QFile;
 
 namespace PNConfigLib {
 
@@ -23,29 +28,159 @@ enum class ConsistencyType {
     GSDML
 };
 
+/**
+ * @brief Device property a message is about, for marking the input it belongs to
+ */
+enum class ConsistencyField {
+    None,
+    DeviceName,
+    IpAddress
+};
+
 struct ConsistencyLog {
     ConsistencyType type;
     LogSeverity severity;
     QString source;
     QString message;
+    ConsistencyField field = ConsistencyField::None;
     
     ConsistencyLog() = default;
-    ConsistencyLog(ConsistencyType t, LogSeverity s, const QString& src, const QString& msg)
-        : type(t), severity(s), source(src), message(msg) {}
+    ConsistencyLog(ConsistencyType t, LogSeverity s, const QString& src, const QString& msg,
+                   ConsistencyField f = ConsistencyField::None)
+        : type(t), severity(s), source(src), message(msg), field(f) {}
+};
+
+/**
+ * @brief Streaming destination for consistency messages
+ *
+ * write() is only ever called from one thread at a time (the logger's
+ * consumer), in log order.
+ */
+class ConsistencyLogSink {
+public:
+    virtual ~ConsistencyLogSink() = default;
+    virtual void write(const ConsistencyLog& log) = 0;
+    virtual void flush() {}
+};
+
+/**
+ * @brief "[PN][错误] source: message" lines, like formatLogs()
+ */
+class TextFileLogSink : public ConsistencyLogSink {
+public:
+    explicit TextFileLogSink(const QString& path);
+    ~TextFileLogSink() override;
+    bool isOpen() const;
+    void write(const ConsistencyLog& log) override;
+    void flush() override;
+
+private:
+    std::unique_ptr<QFile> m_file;
+};
+
+/**
+ * @brief One JSON object per line: {"type","severity","source","message"}
+ */
+class JsonLinesLogSink : public ConsistencyLogSink {
+public:
+    explicit JsonLinesLogSink(const QString& path);
+    ~JsonLinesLogSink() override;
+    bool isOpen() const;
+    void write(const ConsistencyLog& log) override;
+    void flush() override;
+
+private:
+    std::unique_ptr<QFile> m_file;
+};
+
+/**
+ * @brief Forwards to a callback, e.g. to append rows to a GUI model
+ *
+ * The callback runs on the draining thread; GUI code should hop to the GUI
+ * thread (QMetaObject::invokeMethod with Qt::QueuedConnection).
+ */
+class CallbackLogSink : public ConsistencyLogSink {
+public:
+    explicit CallbackLogSink(std::function<void(const ConsistencyLog&)> callback);
+    void write(const ConsistencyLog& log) override;
+
+private:
+    std::function<void(const ConsistencyLog&)> m_callback;
 };
 
+/**
+ * @brief "[CONSISTENCY ERROR] source: message" through qDebug(), for applications
+ * that redirect Qt messages to a log file
+ */
+class DebugLogSink : public ConsistencyLogSink {
+public:
+    void write(const ConsistencyLog& log) override;
+};
+
+/**
+ * @brief Process-wide consistency log
+ *
+ * log() may be called from any thread. It pushes onto a lock-free MPSC queue;
+ * whichever thread flushes (explicitly, through the accessors below, or a
+ * producer once enough messages are pending) drains the queue into the sinks
+ * and into a bounded in-memory ring of the most recent messages. Per-severity
+ * counts are exact even when old messages have been dropped from the ring.
+ */
 class ConsistencyLogger {
 public:
     static void reset();
     static void log(ConsistencyType type, LogSeverity severity, const QString& source, const QString& message);
-    static QList<ConsistencyLog>& logs();
+    static void log(const ConsistencyLog& entry);
+    
+    /**
+     * @brief Cheap check for call sites, before building the message
+     */
+    static bool isEnabled(LogSeverity severity)
+    {
+        return static_cast<int>(severity) >= s_minimumSeverity.load(std::memory_order_relaxed);
+    }
+    static void setMinimumSeverity(LogSeverity severity);
+    
+    /**
+     * @brief Number of messages kept in memory (oldest dropped first); 0 keeps none
+     */
+    static void setCapacity(int capacity);
+    static int capacity();
+    static qint64 droppedCount();
+    
+    static void addSink(const std::shared_ptr<ConsistencyLogSink>& sink);
+    static void removeSink(const std::shared_ptr<ConsistencyLogSink>& sink);
+    static void clearSinks();
+    
+    /**
+     * @brief Drain pending messages into the ring and the sinks
+     */
+    static void flush();
+    
+    /**
+     * @brief Snapshot of the retained messages
+     */
+    static QList<ConsistencyLog> logs();
+    static qint64 count(LogSeverity severity);
     static bool hasErrors();
     static QString formatLogs();
+    static QString formatLogs(const QList<ConsistencyLog>& logs);
+    static QString formatLog(const ConsistencyLog& log);
     
 private:
-    static QList<ConsistencyLog> s_logs;
+    static std::atomic<int> s_minimumSeverity;
 };
 
 } // namespace PNConfigLib
 
+/**
+ * @brief Log only if the severity passes the filter; the message expression is not evaluated otherwise
+ */
+#define PN_CONSISTENCY_LOG(type, severity, source, message) \
+    do { \
+        if (::PNConfigLib::ConsistencyLogger::isEnabled(severity)) { \
+            ::PNConfigLib::ConsistencyLogger::log((type), (severity), (source), (message)); \
+        } \
+    } while (0)
+
 #endif // CONSISTENCYLOGGER_H
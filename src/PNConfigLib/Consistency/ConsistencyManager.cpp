@@ -4,33 +4,129 @@
 
 #include "ConsistencyManager.h"
 #include "InputValidator.h"
+#include "../Instrumentation/Instrumentation.h"
+#include <QElapsedTimer>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
 
 namespace PNConfigLib {
 
+namespace {
+
+/**
+ * @brief One rule invocation: the project part (begin == end == -1) or a row partition
+ */
+struct RuleTask {
+    int rule = 0;
+    qsizetype begin = -1;
+    qsizetype end = -1;
+};
+
+/**
+ * @brief Run task(0..count-1) on the pool and the calling thread; returns when all finished
+ *
+ * Tasks are claimed from a shared counter, so helpers the pool starts late
+ * simply find nothing left; the caller never waits for a task that has not
+ * started, which keeps this safe to call from a pool thread.
+ */
+void runTasks(QThreadPool* pool, int count, const std::function<void(int)>& task)
+{
+    struct Shared {
+        std::atomic<int> next{0};
+        QSemaphore finished;
+        std::function<void(int)> task;
+        int count = 0;
+
+        void drain()
+        {
+            for (int i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+                task(i);
+                finished.release();
+            }
+        }
+    };
+
+    auto shared = std::make_shared<Shared>();
+    shared->task = task;
+    shared->count = count;
+
+    const int helpers = std::min(count, pool->maxThreadCount()) - 1;
+    for (int i = 0; i < helpers; ++i) {
+        pool->start(QRunnable::create([shared]() { shared->drain(); }));
+    }
+
+    shared->drain();
+    shared->finished.acquire(count);
+}
+
+} // namespace
+
 ConsistencyManager::ConsistencyManager()
+    : m_rules(defaultConsistencyRules())
 {
     reset();
 }
 
 void ConsistencyManager::reset()
 {
-    ConsistencyLogger::reset();
+    m_messages.clear();
+    m_timings.clear();
     m_topologyExists = false;
 }
 
+void ConsistencyManager::setRules(const QList<ConsistencyRulePtr>& rules)
+{
+    m_rules = rules;
+}
+
+void ConsistencyManager::addRule(const ConsistencyRulePtr& rule)
+{
+    m_rules.append(rule);
+}
+
+QList<ConsistencyRulePtr> ConsistencyManager::rules() const
+{
+    return m_rules;
+}
+
+void ConsistencyManager::setThreadPool(QThreadPool* pool)
+{
+    m_pool = pool;
+}
+
+void ConsistencyManager::setPartitionSize(qsizetype rows)
+{
+    m_partitionSize = std::max<qsizetype>(1, rows);
+}
+
+void ConsistencyManager::addMessage(ConsistencyType type, const QString& source, const QString& message)
+{
+    m_messages.append(ConsistencyLog(type, LogSeverity::Error, source, message));
+    ConsistencyLogger::log(m_messages.last());
+}
+
 bool ConsistencyManager::validateInputPaths(const QString& configPath,
                                             const QString& listOfNodesPath,
                                             const QString& topologyPath)
 {
     bool valid = true;
     
+    QString error;
+    
     // Check Configuration.xml
-    if (!InputValidator::isConfigurationFileExist(configPath)) {
+    if (!InputValidator::isConfigurationFileExist(configPath, error)) {
+        addMessage(ConsistencyType::XML, "Configuration", error);
         valid = false;
     }
     
     // Check ListOfNodes.xml
-    if (!InputValidator::isListOfNodesFileExist(listOfNodesPath)) {
+    if (!InputValidator::isListOfNodesFileExist(listOfNodesPath, error)) {
+        addMessage(ConsistencyType::XML, "ListOfNodes", error);
         valid = false;
     }
     
@@ -39,62 +135,113 @@ bool ConsistencyManager::validateInputPaths(const QString& configPath,
         valid = false;
     }
     
+    ConsistencyLogger::flush();
     return valid;
 }
 
 bool ConsistencyManager::validateInputs(const Configuration& config,
                                         const ListOfNodes& nodes)
 {
-    bool valid = true;
-    QStringList errors;
+    PN_SCOPED_TIMER("ConsistencyManager::validateInputs");
+    
+    // Flatten once; all rules read the same snapshot
+    const ProjectModel model = ProjectModel::fromConfiguration(config, nodes);
+    const RuleContext context{config, nodes, model};
     
-    // Validate Configuration content
-    if (!InputValidator::validateConfiguration(config, errors)) {
-        for (const QString& err : errors) {
-            ConsistencyLogger::log(ConsistencyType::XML, LogSeverity::Error,
-                "Configuration", err);
+    // One project task per rule followed by its row partitions
+    QVector<RuleTask> tasks;
+    for (int r = 0; r < m_rules.size(); ++r) {
+        RuleTask projectTask;
+        projectTask.rule = r;
+        tasks.append(projectTask);
+        
+        const qsizetype rows = m_rules[r]->rowCount(context);
+        for (qsizetype begin = 0; begin < rows; begin += m_partitionSize) {
+            RuleTask rowTask;
+            rowTask.rule = r;
+            rowTask.begin = begin;
+            rowTask.end = std::min(rows, begin + m_partitionSize);
+            tasks.append(rowTask);
         }
-        valid = false;
     }
     
-    errors.clear();
+    QVector<QList<ConsistencyLog>> buffers(tasks.size());
+    QVector<qint64> elapsed(tasks.size(), 0);
     
-    // Validate ListOfNodes content
-    if (!InputValidator::validateListOfNodes(nodes, errors)) {
-        for (const QString& err : errors) {
-            ConsistencyLogger::log(ConsistencyType::XML, LogSeverity::Error,
-                "ListOfNodes", err);
+    runTasks(m_pool ? m_pool : QThreadPool::globalInstance(), static_cast<int>(tasks.size()), [&](int i) {
+        const RuleTask& task = tasks[i];
+        const ConsistencyRule& rule = *m_rules[task.rule];
+        QElapsedTimer timer;
+        timer.start();
+        try {
+            if (task.begin < 0) {
+                rule.checkProject(context, buffers[i]);
+            } else {
+                rule.checkRows(context, task.begin, task.end, buffers[i]);
+            }
+        } catch (const std::exception& e) {
+            buffers[i].append(ConsistencyLog(rule.type(), LogSeverity::Error, rule.name(),
+                QString("规则执行失败: %1").arg(e.what())));
+        } catch (...) {
+            // Anything escaping a pool thread would terminate the process
+            buffers[i].append(ConsistencyLog(rule.type(), LogSeverity::Error, rule.name(),
+                "规则执行失败: 未知异常"));
         }
-        valid = false;
-    }
+        elapsed[i] = timer.nsecsElapsed();
+    });
     
-    errors.clear();
+    // Deterministic merge: task order is rule order, then partition order
+    m_timings.clear();
+    for (const ConsistencyRulePtr& rule : m_rules) {
+        RuleTiming timing;
+        timing.rule = rule->name();
+        m_timings.append(timing);
+    }
     
-    // Validate cross-file references
-    if (!InputValidator::validateReferences(config, nodes, errors)) {
-        for (const QString& err : errors) {
-            ConsistencyLogger::log(ConsistencyType::PN, LogSeverity::Error,
-                "References", err);
+    bool valid = true;
+    for (int i = 0; i < tasks.size(); ++i) {
+        RuleTiming& timing = m_timings[tasks[i].rule];
+        timing.elapsedNs += elapsed[i];
+        timing.tasks++;
+        timing.messages += buffers[i].size();
+        
+        for (const ConsistencyLog& log : buffers[i]) {
+            if (log.severity == LogSeverity::Error) {
+                valid = false;
+            }
+            ConsistencyLogger::log(log);
         }
-        valid = false;
+        m_messages.append(buffers[i]);
     }
     
+    // Hand the merged messages to the sinks now rather than at the next drain
+    ConsistencyLogger::flush();
     return valid;
 }
 
+QList<RuleTiming> ConsistencyManager::ruleTimings() const
+{
+    return m_timings;
+}
+
 QList<ConsistencyLog> ConsistencyManager::getMessages() const
 {
-    return ConsistencyLogger::logs();
+    return m_messages;
 }
 
 QString ConsistencyManager::getFormattedMessages() const
 {
-    return ConsistencyLogger::formatLogs();
+    return ConsistencyLogger::formatLogs(m_messages);
 }
 
 bool ConsistencyManager::hasErrors() const
 {
-    return ConsistencyLogger::hasErrors();
+    for (const ConsistencyLog& log : m_messages) {
+        if (log.severity == LogSeverity::Error) {
+            return true;
+        }
+    }
+    return false;
 }
 
 } // namespace PNConfigLib
@@ -8,10 +8,35 @@
 #include <QString>
 #include <QStringList>
 #include "ConsistencyLogger.h"
+#include "ConsistencyRules.h"
 #include "../ConfigReader/ConfigReader.h"
 
+class QThreadPool;
+
 namespace PNConfigLib {
 
+/**
+ * @brief Time spent in one rule during the last validateInputs() call
+ */
+struct RuleTiming {
+    QString rule;
+    qint64 elapsedNs = 0;   // Sum over all tasks of the rule (CPU time, not wall clock)
+    int tasks = 0;          // Project part plus row partitions
+    int messages = 0;
+};
+
+/**
+ * @brief Rule-based consistency checker
+ *
+ * validateInputs() splits every rule into a project-wide task and tasks over
+ * row partitions, runs them on a thread pool (the calling thread takes part),
+ * and merges the per-task message buffers in rule order, then partition
+ * order, so the report does not depend on scheduling.
+ *
+ * Each instance keeps its own messages; several managers may validate
+ * different projects concurrently. Every message is also passed to
+ * ConsistencyLogger, in the same order, for its sinks and retention.
+ */
 class ConsistencyManager {
 public:
     ConsistencyManager();
@@ -25,16 +50,35 @@ public:
     bool validateInputs(const Configuration& config, 
                        const ListOfNodes& nodes);
     
+    // Rule set (defaultConsistencyRules() unless replaced)
+    void setRules(const QList<ConsistencyRulePtr>& rules);
+    void addRule(const ConsistencyRulePtr& rule);
+    QList<ConsistencyRulePtr> rules() const;
+    
+    // Execution: pool (global instance if null) and rows per task
+    void setThreadPool(QThreadPool* pool);
+    void setPartitionSize(qsizetype rows);
+    
+    // Per-rule timings of the last validateInputs() call, in rule order
+    QList<RuleTiming> ruleTimings() const;
+    
     // Get validation messages
     QList<ConsistencyLog> getMessages() const;
     QString getFormattedMessages() const;
     bool hasErrors() const;
     
-    // Reset logger
+    // Clear messages and timings
     void reset();
     
 private:
+    void addMessage(ConsistencyType type, const QString& source, const QString& message);
+    
     bool m_topologyExists = false;
+    QList<ConsistencyRulePtr> m_rules;
+    QThreadPool* m_pool = nullptr;
+    qsizetype m_partitionSize = 256;
+    QList<ConsistencyLog> m_messages;
+    QList<RuleTiming> m_timings;
 };
 
 } // namespace PNConfigLib
@@ -0,0 +1,305 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Configuration Validation                   */
+/*****************************************************************************/
+
+#include "ConsistencyRules.h"
+#include "InputValidator.h"
+#include "IoAddressOverlap.h"
+#include <QFile>
+#include <QHash>
+#include <QSet>
+
+namespace PNConfigLib {
+
+static QString devicePrefix(qsizetype row)
+{
+    return QString("从站设备 %1: ").arg(row + 1);
+}
+
+static QString nodePrefix(qsizetype row)
+{
+    return QString("从站节点 %1: ").arg(row + 1);
+}
+
+// -----------------------------------------------------------------------------
+// ConsistencyRule
+// -----------------------------------------------------------------------------
+
+void ConsistencyRule::checkProject(const RuleContext&, QList<ConsistencyLog>&) const
+{
+}
+
+void ConsistencyRule::checkRows(const RuleContext&, qsizetype, qsizetype, QList<ConsistencyLog>&) const
+{
+}
+
+void ConsistencyRule::error(QList<ConsistencyLog>& out, const QString& message, ConsistencyField field) const
+{
+    out.append(ConsistencyLog(type(), LogSeverity::Error, name(), message, field));
+}
+
+// -----------------------------------------------------------------------------
+// Identifiers
+// -----------------------------------------------------------------------------
+
+void IdentifierRule::checkProject(const RuleContext& context, QList<ConsistencyLog>& out) const
+{
+    const ProjectModel& model = context.model;
+    if (model.configurationId == 0) {
+        error(out, "配置ID (ConfigurationID) 为空");
+    }
+    if (model.listOfNodesRefId == 0) {
+        error(out, "节点列表引用ID (ListOfNodesRefID) 为空");
+    }
+    if (model.central.deviceRefId == 0) {
+        error(out, "中心设备引用ID (DeviceRefID) 为空");
+    }
+}
+
+void IdentifierRule::checkRows(const RuleContext& context, qsizetype begin, qsizetype end,
+                               QList<ConsistencyLog>& out) const
+{
+    const DeviceTable& devices = context.model.devices;
+    for (qsizetype i = begin; i < end; ++i) {
+        if (devices.deviceRefId[i] == 0) {
+            error(out, devicePrefix(i) + "设备引用ID为空");
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Names
+// -----------------------------------------------------------------------------
+
+void DeviceNameRule::checkProject(const RuleContext& context, QList<ConsistencyLog>& out) const
+{
+    if (context.model.central.deviceName == 0) {
+        error(out, "中心设备名称 (PNDeviceName) 为空", ConsistencyField::DeviceName);
+    }
+}
+
+void DeviceNameRule::checkRows(const RuleContext& context, qsizetype begin, qsizetype end,
+                               QList<ConsistencyLog>& out) const
+{
+    const ProjectModel& model = context.model;
+    QHash<StringId, QString> nameErrors;
+
+    for (qsizetype i = begin; i < end; ++i) {
+        const StringId name = model.devices.deviceName[i];
+        if (name == 0) {
+            error(out, devicePrefix(i) + "设备名称为空", ConsistencyField::DeviceName);
+            continue;
+        }
+
+        auto it = nameErrors.constFind(name);
+        if (it == nameErrors.constEnd()) {
+            QString nameError;
+            InputValidator::isValidPNDeviceName(model.str(name), nameError);
+            it = nameErrors.insert(name, nameError);
+        }
+        if (!it.value().isEmpty()) {
+            error(out, devicePrefix(i) + it.value(), ConsistencyField::DeviceName);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// IP addresses
+// -----------------------------------------------------------------------------
+
+void IpAddressRule::checkProject(const RuleContext& context, QList<ConsistencyLog>& out) const
+{
+    const ProjectModel& model = context.model;
+    if (model.central.ipAddress == 0) {
+        error(out, "中心设备IP地址为空", ConsistencyField::IpAddress);
+    } else if (!InputValidator::isValidIPAddress(model.str(model.central.ipAddress))) {
+        error(out, QString("中心设备IP地址格式无效: %1").arg(model.str(model.central.ipAddress)),
+              ConsistencyField::IpAddress);
+    }
+}
+
+void IpAddressRule::checkRows(const RuleContext& context, qsizetype begin, qsizetype end,
+                              QList<ConsistencyLog>& out) const
+{
+    const ProjectModel& model = context.model;
+    QHash<StringId, bool> ipValid;
+
+    for (qsizetype i = begin; i < end; ++i) {
+        const StringId ip = model.devices.ipAddress[i];
+        if (ip == 0) {
+            error(out, devicePrefix(i) + "IP地址为空", ConsistencyField::IpAddress);
+            continue;
+        }
+
+        auto it = ipValid.constFind(ip);
+        if (it == ipValid.constEnd()) {
+            it = ipValid.insert(ip, InputValidator::isValidIPAddress(model.str(ip)));
+        }
+        if (!it.value()) {
+            error(out, devicePrefix(i) + QString("IP地址格式无效: %1").arg(model.str(ip)),
+                  ConsistencyField::IpAddress);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// GSDML files
+// -----------------------------------------------------------------------------
+
+void GsdmlFileRule::checkProject(const RuleContext& context, QList<ConsistencyLog>& out) const
+{
+    if (context.nodes.listOfNodesID.isEmpty()) {
+        error(out, "节点列表ID (ListOfNodesID) 为空");
+    }
+    if (context.nodes.pnDriver.deviceID.isEmpty()) {
+        error(out, "主站设备节点ID为空");
+    }
+}
+
+void GsdmlFileRule::checkRows(const RuleContext& context, qsizetype begin, qsizetype end,
+                              QList<ConsistencyLog>& out) const
+{
+    const ProjectModel& model = context.model;
+    QHash<StringId, bool> exists;
+
+    for (qsizetype i = begin; i < end; ++i) {
+        if (model.nodes.deviceId[i] == 0) {
+            error(out, nodePrefix(i) + "设备ID为空");
+        }
+
+        const StringId path = model.nodes.gsdPath[i];
+        if (path == 0) {
+            error(out, nodePrefix(i) + "GSDML路径为空");
+            continue;
+        }
+
+        auto it = exists.constFind(path);
+        if (it == exists.constEnd()) {
+            it = exists.insert(path, QFile::exists(model.str(path)));
+        }
+        if (!it.value()) {
+            error(out, nodePrefix(i) + QString("GSDML文件不存在: %1").arg(model.str(path)));
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// References
+// -----------------------------------------------------------------------------
+
+void ReferenceRule::checkProject(const RuleContext& context, QList<ConsistencyLog>& out) const
+{
+    const ProjectModel& model = context.model;
+    if (model.listOfNodesRefId != model.listOfNodesId) {
+        error(out, QString("配置文件引用的节点列表ID (%1) 与节点列表文件中的ID (%2) 不匹配")
+            .arg(model.str(model.listOfNodesRefId), model.str(model.listOfNodesId)));
+    }
+    if (model.devices.size() != model.nodes.size()) {
+        error(out, QString("配置文件中的从站设备数量 (%1) 与节点列表文件中的数量 (%2) 不匹配")
+            .arg(model.devices.size())
+            .arg(model.nodes.size()));
+    }
+}
+
+void ReferenceRule::checkRows(const RuleContext& context, qsizetype begin, qsizetype end,
+                              QList<ConsistencyLog>& out) const
+{
+    const ProjectModel& model = context.model;
+    for (qsizetype i = begin; i < end; ++i) {
+        if (model.devices.nodeIndex[i] < 0) {
+            error(out, QString("配置文件中的设备引用 (%1) 在节点列表中不存在")
+                .arg(model.str(model.devices.deviceRefId[i])));
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Uniqueness
+// -----------------------------------------------------------------------------
+
+void UniqueIdentityRule::checkProject(const RuleContext& context, QList<ConsistencyLog>& out) const
+{
+    QStringList nameErrors;
+    QStringList ipErrors;
+    InputValidator::validateUniqueness(context.model, nameErrors, ipErrors);
+    for (const QString& message : nameErrors) {
+        error(out, message, ConsistencyField::DeviceName);
+    }
+    for (const QString& message : ipErrors) {
+        error(out, message, ConsistencyField::IpAddress);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// IO addresses
+// -----------------------------------------------------------------------------
+
+void IoAddressRule::checkProject(const RuleContext& context, QList<ConsistencyLog>& out) const
+{
+    QStringList errors;
+    InputValidator::validateIOAddresses(context.model, errors);
+    for (const QString& message : errors) {
+        error(out, message);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Slots
+// -----------------------------------------------------------------------------
+
+void SlotRule::checkRows(const RuleContext& context, qsizetype begin, qsizetype end,
+                         QList<ConsistencyLog>& out) const
+{
+    const ProjectModel& model = context.model;
+    QSet<qint32> usedSlots;
+    QSet<qint32> usedSubslots;
+
+    for (qsizetype d = begin; d < end; ++d) {
+        usedSlots.clear();
+        const qint32 firstModule = model.devices.firstModule[d];
+        const qint32 lastModule = firstModule + model.devices.moduleCount[d];
+
+        for (qint32 m = firstModule; m < lastModule; ++m) {
+            const qint32 slot = model.modules.slotNumber[m];
+            if (slot < 0 || slot > MaxSlot) {
+                error(out, devicePrefix(d) + QString("槽号无效 (%1)").arg(slot));
+            } else if (usedSlots.contains(slot)) {
+                error(out, devicePrefix(d) + QString("槽 %1 重复").arg(slot));
+            } else {
+                usedSlots.insert(slot);
+            }
+
+            usedSubslots.clear();
+            const qint32 firstSubmodule = model.modules.firstSubmodule[m];
+            const qint32 lastSubmodule = firstSubmodule + model.modules.submoduleCount[m];
+            for (qint32 s = firstSubmodule; s < lastSubmodule; ++s) {
+                const qint32 subslot = model.submodules.subslotNumber[s];
+                if (subslot < 1 || subslot > MaxSubslot) {
+                    error(out, devicePrefix(d) + QString("槽 %1 子槽号无效 (%2)").arg(slot).arg(subslot));
+                } else if (usedSubslots.contains(subslot)) {
+                    error(out, devicePrefix(d) + QString("槽 %1 子槽 %2 重复").arg(slot).arg(subslot));
+                } else {
+                    usedSubslots.insert(subslot);
+                }
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+QList<ConsistencyRulePtr> defaultConsistencyRules()
+{
+    return {
+        std::make_shared<IdentifierRule>(),
+        std::make_shared<DeviceNameRule>(),
+        std::make_shared<IpAddressRule>(),
+        std::make_shared<UniqueIdentityRule>(),
+        std::make_shared<GsdmlFileRule>(),
+        std::make_shared<ReferenceRule>(),
+        std::make_shared<IoAddressRule>(),
+        std::make_shared<SlotRule>()
+    };
+}
+
+} // namespace PNConfigLib
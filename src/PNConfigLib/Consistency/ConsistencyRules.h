@@ -0,0 +1,218 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Configuration Validation                   */
+/*****************************************************************************/
+
+#ifndef CONSISTENCYRULES_H
+#define CONSISTENCYRULES_H
+
+#include "ConsistencyLogger.h"
+#include "../ConfigReader/ConfigurationSchema.h"
+#include "../DataModel/ProjectModel.h"
+#include <QList>
+#include <QString>
+#include <memory>
+
+namespace PNConfigLib {
+
+/**
+ * @brief Read-only inputs shared by all rules of one validation run
+ */
+struct RuleContext {
+    const Configuration& config;
+    const ListOfNodes& nodes;
+    const ProjectModel& model;
+};
+
+/**
+ * @brief Project data a rule reads, as a bit mask
+ *
+ * IncrementalValidator re-runs a rule part only when an edit touches one of
+ * its inputs. Rules that do not declare inputs read everything.
+ */
+enum RuleInput : quint32 {
+    RuleInputNone        = 0,
+    RuleInputIdentifiers = 1u << 0,    // IDs, references, device <-> node links
+    RuleInputNames       = 1u << 1,    // Device names (NameOfStation)
+    RuleInputIpAddresses = 1u << 2,    // IP, subnet mask, router
+    RuleInputGsdmlPaths  = 1u << 3,
+    RuleInputIoAddresses = 1u << 4,
+    RuleInputSlots       = 1u << 5,    // Module/submodule layout
+    RuleInputAll         = 0xFFFFFFFFu
+};
+
+/**
+ * @brief Table the rows of checkRows() refer to
+ */
+enum class RuleRows {
+    Devices,    // DeviceTable / Configuration::decentralDevices
+    Nodes       // NodeTable / ListOfNodes::decentralDevices
+};
+
+/**
+ * @brief One independent consistency check
+ *
+ * A rule has an optional project-wide part, run once, and an optional
+ * row-wise part that the ConsistencyManager splits into partitions and runs
+ * concurrently. Rules must be stateless (const) and write only into the
+ * buffer they are given.
+ */
+class ConsistencyRule {
+public:
+    virtual ~ConsistencyRule() = default;
+
+    /**
+     * @brief Name used as log source and in the timing report
+     */
+    virtual QString name() const = 0;
+
+    virtual ConsistencyType type() const = 0;
+
+    /**
+     * @brief Rows checkRows() iterates; decentral devices by default
+     */
+    virtual qsizetype rowCount(const RuleContext& context) const { return context.model.devices.size(); }
+
+    virtual RuleRows rows() const { return RuleRows::Devices; }
+
+    /**
+     * @brief RuleInput bits read by checkProject() and by checkRows()
+     *
+     * A row's result must depend only on that row's own data and the
+     * project-wide (non-row) data named here.
+     */
+    virtual quint32 projectInputs() const { return RuleInputAll; }
+    virtual quint32 rowInputs() const { return RuleInputAll; }
+
+    /**
+     * @brief Project-wide checks, run once
+     */
+    virtual void checkProject(const RuleContext& context, QList<ConsistencyLog>& out) const;
+
+    /**
+     * @brief Checks for rows [begin, end)
+     */
+    virtual void checkRows(const RuleContext& context, qsizetype begin, qsizetype end,
+                           QList<ConsistencyLog>& out) const;
+
+protected:
+    void error(QList<ConsistencyLog>& out, const QString& message,
+               ConsistencyField field = ConsistencyField::None) const;
+};
+
+using ConsistencyRulePtr = std::shared_ptr<const ConsistencyRule>;
+
+/**
+ * @brief Required IDs of Configuration, central device and decentral devices
+ */
+class IdentifierRule : public ConsistencyRule {
+public:
+    QString name() const override { return "Identifiers"; }
+    ConsistencyType type() const override { return ConsistencyType::XML; }
+    quint32 projectInputs() const override { return RuleInputIdentifiers; }
+    quint32 rowInputs() const override { return RuleInputIdentifiers; }
+    void checkProject(const RuleContext& context, QList<ConsistencyLog>& out) const override;
+    void checkRows(const RuleContext& context, qsizetype begin, qsizetype end, QList<ConsistencyLog>& out) const override;
+};
+
+/**
+ * @brief PROFINET device names (NameOfStation)
+ */
+class DeviceNameRule : public ConsistencyRule {
+public:
+    QString name() const override { return "Names"; }
+    ConsistencyType type() const override { return ConsistencyType::XML; }
+    quint32 projectInputs() const override { return RuleInputNames; }
+    quint32 rowInputs() const override { return RuleInputNames; }
+    void checkProject(const RuleContext& context, QList<ConsistencyLog>& out) const override;
+    void checkRows(const RuleContext& context, qsizetype begin, qsizetype end, QList<ConsistencyLog>& out) const override;
+};
+
+/**
+ * @brief IPv4 address format of controller and devices
+ */
+class IpAddressRule : public ConsistencyRule {
+public:
+    QString name() const override { return "IPAddresses"; }
+    ConsistencyType type() const override { return ConsistencyType::XML; }
+    quint32 projectInputs() const override { return RuleInputIpAddresses; }
+    quint32 rowInputs() const override { return RuleInputIpAddresses; }
+    void checkProject(const RuleContext& context, QList<ConsistencyLog>& out) const override;
+    void checkRows(const RuleContext& context, qsizetype begin, qsizetype end, QList<ConsistencyLog>& out) const override;
+};
+
+/**
+ * @brief ListOfNodes IDs and GSDML file existence; rows are ListOfNodes devices
+ */
+class GsdmlFileRule : public ConsistencyRule {
+public:
+    QString name() const override { return "GSDML"; }
+    ConsistencyType type() const override { return ConsistencyType::GSDML; }
+    RuleRows rows() const override { return RuleRows::Nodes; }
+    quint32 projectInputs() const override { return RuleInputIdentifiers; }
+    quint32 rowInputs() const override { return RuleInputIdentifiers | RuleInputGsdmlPaths; }
+    qsizetype rowCount(const RuleContext& context) const override { return context.model.nodes.size(); }
+    void checkProject(const RuleContext& context, QList<ConsistencyLog>& out) const override;
+    void checkRows(const RuleContext& context, qsizetype begin, qsizetype end, QList<ConsistencyLog>& out) const override;
+};
+
+/**
+ * @brief Configuration <-> ListOfNodes references
+ */
+class ReferenceRule : public ConsistencyRule {
+public:
+    QString name() const override { return "References"; }
+    ConsistencyType type() const override { return ConsistencyType::PN; }
+    quint32 projectInputs() const override { return RuleInputIdentifiers; }
+    quint32 rowInputs() const override { return RuleInputIdentifiers; }
+    void checkProject(const RuleContext& context, QList<ConsistencyLog>& out) const override;
+    void checkRows(const RuleContext& context, qsizetype begin, qsizetype end, QList<ConsistencyLog>& out) const override;
+};
+
+/**
+ * @brief Device names and IP addresses unique within the project (hash index)
+ */
+class UniqueIdentityRule : public ConsistencyRule {
+public:
+    QString name() const override { return "Uniqueness"; }
+    ConsistencyType type() const override { return ConsistencyType::PN; }
+    quint32 projectInputs() const override { return RuleInputNames | RuleInputIpAddresses; }
+    quint32 rowInputs() const override { return RuleInputNone; }
+    void checkProject(const RuleContext& context, QList<ConsistencyLog>& out) const override;
+};
+
+/**
+ * @brief IO address bounds and overlaps (project-wide sweep)
+ */
+class IoAddressRule : public ConsistencyRule {
+public:
+    QString name() const override { return "IOAddresses"; }
+    ConsistencyType type() const override { return ConsistencyType::PN; }
+    // Messages name the submodule, hence names and slots
+    quint32 projectInputs() const override { return RuleInputIoAddresses | RuleInputNames | RuleInputSlots; }
+    quint32 rowInputs() const override { return RuleInputNone; }
+    void checkProject(const RuleContext& context, QList<ConsistencyLog>& out) const override;
+};
+
+/**
+ * @brief Slot/subslot numbers in range and unique per device/module
+ */
+class SlotRule : public ConsistencyRule {
+public:
+    static constexpr int MaxSlot = 0x7FFF;
+    static constexpr int MaxSubslot = 0x9FFF;
+
+    QString name() const override { return "Slots"; }
+    ConsistencyType type() const override { return ConsistencyType::PN; }
+    quint32 projectInputs() const override { return RuleInputNone; }
+    quint32 rowInputs() const override { return RuleInputSlots; }
+    void checkRows(const RuleContext& context, qsizetype begin, qsizetype end, QList<ConsistencyLog>& out) const override;
+};
+
+/**
+ * @brief The built-in rule set, in report order
+ */
+QList<ConsistencyRulePtr> defaultConsistencyRules();
+
+} // namespace PNConfigLib
+
+#endif // CONSISTENCYRULES_H
@@ -0,0 +1,476 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Configuration Validation                   */
+/*****************************************************************************/
+
+#include "IncrementalValidator.h"
+#include "InputValidator.h"
+#include <QElapsedTimer>
+
+namespace PNConfigLib {
+
+IncrementalValidator::IncrementalValidator(const QList<ConsistencyRulePtr>& rules)
+{
+    for (const ConsistencyRulePtr& rule : rules) {
+        RuleState state;
+        state.rule = rule;
+        state.ioIndexed = dynamic_cast<const IoAddressRule*>(rule.get()) != nullptr;
+        state.uniqueIndexed = dynamic_cast<const UniqueIdentityRule*>(rule.get()) != nullptr;
+        m_rules.append(state);
+    }
+}
+
+void IncrementalValidator::load(const Configuration& config, const ListOfNodes& nodes)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    m_config = config;
+    m_nodes = nodes;
+    m_model = ProjectModel::fromConfiguration(m_config, m_nodes);
+    m_errorCount = 0;
+    m_lastEvaluations = 0;
+
+    m_ioRule = nullptr;
+    m_ioIndex.clear();
+    m_ioMessages.clear();
+    m_ioKeysOf.clear();
+
+    m_uniqueRule = nullptr;
+    m_identities.clear();
+    m_nameDuplicates.clear();
+    m_ipDuplicates.clear();
+
+    const RuleContext ctx = context();
+    for (RuleState& state : m_rules) {
+        state.project.clear();
+        state.rows.clear();
+
+        if (state.ioIndexed) {
+            loadIo(state);
+            continue;
+        }
+        if (state.uniqueIndexed) {
+            loadUniqueness(state);
+            continue;
+        }
+
+        runProject(state);
+        const qsizetype rows = state.rule->rowCount(ctx);
+        state.rows.resize(rows);
+        for (qsizetype row = 0; row < rows; ++row) {
+            runRow(state, row);
+        }
+    }
+
+    m_lastElapsedNs = timer.nsecsElapsed();
+}
+
+// -----------------------------------------------------------------------------
+// Edits
+// -----------------------------------------------------------------------------
+
+void IncrementalValidator::setCentralDeviceName(const QString& name)
+{
+    m_config.centralDevice.ethernetAddresses.deviceName = name;
+    m_model.central.deviceName = m_model.strings.intern(name);
+    update(RuleInputNames, -1, -1, -1);
+}
+
+void IncrementalValidator::setCentralIpAddress(const QString& ip)
+{
+    m_config.centralDevice.ethernetAddresses.ipAddress = ip;
+    m_model.central.ipAddress = m_model.strings.intern(ip);
+    update(RuleInputIpAddresses, -1, -1, -1);
+}
+
+void IncrementalValidator::setDeviceName(qsizetype device, const QString& name)
+{
+    if (device < 0 || device >= m_model.devices.size()) {
+        return;
+    }
+    m_config.decentralDevices[device].ethernetAddresses.deviceName = name;
+    m_model.devices.deviceName[device] = m_model.strings.intern(name);
+    update(RuleInputNames, device, -1, -1);
+}
+
+void IncrementalValidator::setIpAddress(qsizetype device, const QString& ip)
+{
+    if (device < 0 || device >= m_model.devices.size()) {
+        return;
+    }
+    m_config.decentralDevices[device].ethernetAddresses.ipAddress = ip;
+    m_model.devices.ipAddress[device] = m_model.strings.intern(ip);
+    update(RuleInputIpAddresses, device, -1, -1);
+}
+
+void IncrementalValidator::setIOAddresses(qsizetype device, qsizetype module, qsizetype submodule,
+                                          const IOAddresses& addresses)
+{
+    if (device < 0 || device >= m_model.devices.size()
+            || module < 0 || module >= m_model.devices.moduleCount[device]) {
+        return;
+    }
+    const qint32 moduleRow = m_model.devices.firstModule[device] + static_cast<qint32>(module);
+    if (submodule < 0 || submodule >= m_model.modules.submoduleCount[moduleRow]) {
+        return;
+    }
+    const qint32 submoduleRow = m_model.modules.firstSubmodule[moduleRow] + static_cast<qint32>(submodule);
+
+    m_config.decentralDevices[device].modules[module].submodules[submodule].ioAddresses = addresses;
+    m_model.submodules.io[submoduleRow] = PackedIOAddresses::fromIOAddresses(addresses);
+    if (m_ioRule) {
+        m_ioIndex.set(submoduleRow, addresses);
+    }
+    update(RuleInputIoAddresses, device, -1, submoduleRow);
+}
+
+void IncrementalValidator::setGsdmlPath(qsizetype node, const QString& path)
+{
+    if (node < 0 || node >= m_model.nodes.size()) {
+        return;
+    }
+    m_nodes.decentralDevices[node].gsdPath = path;
+    m_model.nodes.gsdPath[node] = m_model.strings.intern(path);
+    update(RuleInputGsdmlPaths, -1, node, -1);
+}
+
+// -----------------------------------------------------------------------------
+// Re-evaluation
+// -----------------------------------------------------------------------------
+
+void IncrementalValidator::update(quint32 inputs, qsizetype device, qsizetype node, qint64 submodule)
+{
+    QElapsedTimer timer;
+    timer.start();
+    m_lastEvaluations = 0;
+
+    // A device edit also concerns its ListOfNodes row and vice versa
+    if (node < 0 && device >= 0) {
+        node = m_model.devices.nodeIndex[device];
+    }
+
+    for (RuleState& state : m_rules) {
+        const ConsistencyRule& rule = *state.rule;
+
+        if (state.ioIndexed) {
+            if (!(rule.projectInputs() & inputs)) {
+                continue;
+            }
+            if (submodule >= 0) {
+                refreshIo(submodule);
+            } else if (device >= 0) {
+                // Names and slots appear in the messages of the device's submodules
+                const qint32 firstModule = m_model.devices.firstModule[device];
+                const qint32 lastModule = firstModule + m_model.devices.moduleCount[device];
+                for (qint32 m = firstModule; m < lastModule; ++m) {
+                    const qint32 first = m_model.modules.firstSubmodule[m];
+                    for (qint32 s = first; s < first + m_model.modules.submoduleCount[m]; ++s) {
+                        if (m_ioKeysOf.contains(s)) {
+                            refreshIo(s);
+                        }
+                    }
+                }
+            }
+            continue;
+        }
+
+        if (state.uniqueIndexed) {
+            if (rule.projectInputs() & inputs) {
+                // Name/IP edits without a device row come from the central device
+                refreshIdentity(device >= 0 ? device : InputValidator::CentralDeviceOwner);
+            }
+            continue;
+        }
+
+        if (rule.projectInputs() & inputs) {
+            runProject(state);
+        }
+        if (rule.rowInputs() & inputs) {
+            const qsizetype row = rule.rows() == RuleRows::Devices ? device : node;
+            if (row >= 0 && row < state.rows.size()) {
+                runRow(state, row);
+            }
+        }
+    }
+
+    m_lastElapsedNs = timer.nsecsElapsed();
+}
+
+void IncrementalValidator::runProject(RuleState& state)
+{
+    QList<ConsistencyLog> out;
+    try {
+        state.rule->checkProject(context(), out);
+    } catch (const std::exception& e) {
+        out.append(ConsistencyLog(state.rule->type(), LogSeverity::Error, state.rule->name(),
+            QString("规则执行失败: %1").arg(e.what())));
+    } catch (...) {
+        out.append(ConsistencyLog(state.rule->type(), LogSeverity::Error, state.rule->name(),
+            "规则执行失败: 未知异常"));
+    }
+    replace(state.project, std::move(out));
+    m_lastEvaluations++;
+}
+
+void IncrementalValidator::runRow(RuleState& state, qsizetype row)
+{
+    QList<ConsistencyLog> out;
+    try {
+        state.rule->checkRows(context(), row, row + 1, out);
+    } catch (const std::exception& e) {
+        out.append(ConsistencyLog(state.rule->type(), LogSeverity::Error, state.rule->name(),
+            QString("规则执行失败: %1").arg(e.what())));
+    } catch (...) {
+        out.append(ConsistencyLog(state.rule->type(), LogSeverity::Error, state.rule->name(),
+            "规则执行失败: 未知异常"));
+    }
+    replace(state.rows[row], std::move(out));
+    m_lastEvaluations++;
+}
+
+void IncrementalValidator::replace(QList<ConsistencyLog>& target, QList<ConsistencyLog>&& messages)
+{
+    m_errorCount += errorsIn(messages) - errorsIn(target);
+    target = std::move(messages);
+}
+
+int IncrementalValidator::errorsIn(const QList<ConsistencyLog>& messages)
+{
+    int count = 0;
+    for (const ConsistencyLog& log : messages) {
+        if (log.severity == LogSeverity::Error) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// -----------------------------------------------------------------------------
+// IO addresses
+// -----------------------------------------------------------------------------
+
+void IncrementalValidator::loadIo(const RuleState& state)
+{
+    m_ioRule = state.rule.get();
+    m_ioIndex = IoAddressIndex::fromModel(m_model);
+
+    for (IoDirection direction : {IoDirection::Input, IoDirection::Output}) {
+        for (const IoRange& range : IoOverlapDetector::rangesOf(m_model, direction)) {
+            if (range.end() > IoOverlapDetector::AddressSpaceEnd) {
+                insertIo(IoKey(range.owner, -1, static_cast<int>(direction)),
+                         ConsistencyLog(m_ioRule->type(), LogSeverity::Error, m_ioRule->name(),
+                                        InputValidator::ioRangeError(m_model, direction, range)));
+            }
+        }
+    }
+
+    for (const IoOverlap& overlap : m_ioIndex.allOverlaps()) {
+        insertIo(IoKey(qMin(overlap.first, overlap.second), qMax(overlap.first, overlap.second),
+                       static_cast<int>(overlap.direction)),
+                 ConsistencyLog(m_ioRule->type(), LogSeverity::Error, m_ioRule->name(),
+                                InputValidator::ioOverlapError(m_model, overlap)));
+    }
+    m_lastEvaluations++;
+}
+
+void IncrementalValidator::refreshIo(qint64 submodule)
+{
+    for (const IoKey& key : m_ioKeysOf.values(submodule)) {
+        eraseIo(key);
+    }
+
+    const PackedIOAddresses& io = m_model.submodules.io[submodule];
+    const IoRange ranges[2] = {
+        IoRange{io.inputStart, io.hasInput() ? io.inputLength : 0, submodule},
+        IoRange{io.outputStart, io.hasOutput() ? io.outputLength : 0, submodule}
+    };
+    for (IoDirection direction : {IoDirection::Input, IoDirection::Output}) {
+        const IoRange& range = ranges[static_cast<int>(direction)];
+        if (range.length > 0 && range.end() > IoOverlapDetector::AddressSpaceEnd) {
+            insertIo(IoKey(submodule, -1, static_cast<int>(direction)),
+                     ConsistencyLog(m_ioRule->type(), LogSeverity::Error, m_ioRule->name(),
+                                    InputValidator::ioRangeError(m_model, direction, range)));
+        }
+    }
+
+    for (IoOverlap overlap : m_ioIndex.overlapsOf(submodule)) {
+        // Report pairs in row order, like the full sweep
+        if (overlap.first > overlap.second) {
+            std::swap(overlap.first, overlap.second);
+        }
+        insertIo(IoKey(overlap.first, overlap.second, static_cast<int>(overlap.direction)),
+                 ConsistencyLog(m_ioRule->type(), LogSeverity::Error, m_ioRule->name(),
+                                InputValidator::ioOverlapError(m_model, overlap)));
+    }
+    m_lastEvaluations++;
+}
+
+void IncrementalValidator::insertIo(const IoKey& key, const ConsistencyLog& log)
+{
+    if (m_ioMessages.contains(key)) {
+        return;
+    }
+    m_ioMessages.insert(key, log);
+    m_ioKeysOf.insert(std::get<0>(key), key);
+    if (std::get<1>(key) >= 0) {
+        m_ioKeysOf.insert(std::get<1>(key), key);
+    }
+    m_errorCount++;
+}
+
+void IncrementalValidator::eraseIo(const IoKey& key)
+{
+    if (m_ioMessages.remove(key) == 0) {
+        return;
+    }
+    m_ioKeysOf.remove(std::get<0>(key), key);
+    if (std::get<1>(key) >= 0) {
+        m_ioKeysOf.remove(std::get<1>(key), key);
+    }
+    m_errorCount--;
+}
+
+// -----------------------------------------------------------------------------
+// Uniqueness
+// -----------------------------------------------------------------------------
+
+void IncrementalValidator::loadUniqueness(const RuleState& state)
+{
+    m_uniqueRule = state.rule.get();
+    m_identities = InputValidator::uniquenessIndex(m_model);
+
+    const auto names = m_identities.duplicateNames();
+    for (auto it = names.constBegin(); it != names.constEnd(); ++it) {
+        refreshNameGroup(it.key());
+    }
+    const auto ips = m_identities.duplicateIpAddresses();
+    for (auto it = ips.constBegin(); it != ips.constEnd(); ++it) {
+        refreshIpGroup(it.key());
+    }
+    m_lastEvaluations++;
+}
+
+void IncrementalValidator::refreshIdentity(UniquenessIndex::Owner owner)
+{
+    const bool central = owner == InputValidator::CentralDeviceOwner;
+    const StringId name = central ? m_model.central.deviceName : m_model.devices.deviceName[owner];
+    const StringId ip = central ? m_model.central.ipAddress : m_model.devices.ipAddress[owner];
+
+    const QString oldName = m_identities.nameOf(owner);
+    const quint32 oldIp = m_identities.ipAddressOf(owner);
+
+    m_identities.setName(owner, m_model.str(name));
+    m_identities.setIpAddress(owner, m_model.str(ip));
+
+    // The groups the owner left and joined are the only ones that can change
+    refreshNameGroup(oldName);
+    refreshNameGroup(m_identities.nameOf(owner));
+    refreshIpGroup(oldIp);
+    refreshIpGroup(m_identities.ipAddressOf(owner));
+    m_lastEvaluations++;
+}
+
+void IncrementalValidator::refreshNameGroup(const QString& name)
+{
+    if (name.isEmpty()) {
+        return;
+    }
+    m_errorCount -= m_nameDuplicates.remove(name);
+    const QList<UniquenessIndex::Owner> owners = m_identities.ownersOfName(name);
+    if (owners.size() > 1) {
+        m_nameDuplicates.insert(name, ConsistencyLog(m_uniqueRule->type(), LogSeverity::Error, m_uniqueRule->name(),
+                                                     InputValidator::duplicateNameError(name, owners),
+                                                     ConsistencyField::DeviceName));
+        m_errorCount++;
+    }
+}
+
+void IncrementalValidator::refreshIpGroup(quint32 address)
+{
+    if (address == 0) {
+        return;
+    }
+    m_errorCount -= m_ipDuplicates.remove(address);
+    const QList<UniquenessIndex::Owner> owners = m_identities.ownersOfIpAddress(address);
+    if (owners.size() > 1) {
+        m_ipDuplicates.insert(address, ConsistencyLog(m_uniqueRule->type(), LogSeverity::Error, m_uniqueRule->name(),
+                                                      InputValidator::duplicateIpError(address, owners),
+                                                      ConsistencyField::IpAddress));
+        m_errorCount++;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Results
+// -----------------------------------------------------------------------------
+
+QList<ConsistencyLog> IncrementalValidator::messages() const
+{
+    QList<ConsistencyLog> result;
+    for (const RuleState& state : m_rules) {
+        if (state.ioIndexed) {
+            for (auto it = m_ioMessages.constBegin(); it != m_ioMessages.constEnd(); ++it) {
+                result.append(it.value());
+            }
+            continue;
+        }
+        if (state.uniqueIndexed) {
+            for (auto it = m_nameDuplicates.constBegin(); it != m_nameDuplicates.constEnd(); ++it) {
+                result.append(it.value());
+            }
+            for (auto it = m_ipDuplicates.constBegin(); it != m_ipDuplicates.constEnd(); ++it) {
+                result.append(it.value());
+            }
+            continue;
+        }
+        result.append(state.project);
+        for (const QList<ConsistencyLog>& row : state.rows) {
+            result.append(row);
+        }
+    }
+    return result;
+}
+
+QList<ConsistencyLog> IncrementalValidator::deviceMessages(qsizetype device) const
+{
+    QList<ConsistencyLog> result;
+    if (device < 0 || device >= m_model.devices.size()) {
+        return result;
+    }
+    const qsizetype node = m_model.devices.nodeIndex[device];
+
+    for (const RuleState& state : m_rules) {
+        if (state.ioIndexed) {
+            const qint32 firstModule = m_model.devices.firstModule[device];
+            const qint32 lastModule = firstModule + m_model.devices.moduleCount[device];
+            for (qint32 m = firstModule; m < lastModule; ++m) {
+                const qint32 first = m_model.modules.firstSubmodule[m];
+                for (qint32 s = first; s < first + m_model.modules.submoduleCount[m]; ++s) {
+                    for (const IoKey& key : m_ioKeysOf.values(s)) {
+                        result.append(m_ioMessages.value(key));
+                    }
+                }
+            }
+            continue;
+        }
+        if (state.uniqueIndexed) {
+            auto name = m_nameDuplicates.constFind(m_identities.nameOf(device));
+            if (name != m_nameDuplicates.constEnd()) {
+                result.append(name.value());
+            }
+            auto ip = m_ipDuplicates.constFind(m_identities.ipAddressOf(device));
+            if (ip != m_ipDuplicates.constEnd()) {
+                result.append(ip.value());
+            }
+            continue;
+        }
+
+        const qsizetype row = state.rule->rows() == RuleRows::Devices ? device : node;
+        if (row >= 0 && row < state.rows.size()) {
+            result.append(state.rows[row]);
+        }
+    }
+    return result;
+}
+
+} // namespace PNConfigLib
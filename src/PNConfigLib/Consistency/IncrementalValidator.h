@@ -0,0 +1,133 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Configuration Validation                   */
+/*****************************************************************************/
+
+#ifndef INCREMENTALVALIDATOR_H
+#define INCREMENTALVALIDATOR_H
+
+#include "ConsistencyRules.h"
+#include "IoAddressOverlap.h"
+#include "../DataModel/UniquenessIndex.h"
+#include <QList>
+#include <QMap>
+#include <QMultiHash>
+#include <QVector>
+#include <tuple>
+
+namespace PNConfigLib {
+
+/**
+ * @brief Keeps validation results of a project up to date across small edits
+ *
+ * load() runs every rule once and caches its messages per rule part: the
+ * project-wide part and each row of checkRows(). An edit updates the project
+ * data, then re-runs only the parts whose declared RuleInput bits it touched,
+ * and of the row parts only the edited row. Renaming one device in a project
+ * of thousands therefore re-checks one name instead of the whole project.
+ *
+ * IoAddressRule is not re-run as a whole: its results are kept per submodule
+ * in an IoAddressIndex, so an IO address edit only looks at the ranges around
+ * the edited submodule. Likewise UniqueIdentityRule is backed by a
+ * UniquenessIndex and only the value groups an edit left or joined are
+ * re-reported.
+ *
+ * Not thread-safe; intended to live next to an editor (one per GUI project).
+ */
+class IncrementalValidator {
+public:
+    explicit IncrementalValidator(const QList<ConsistencyRulePtr>& rules = defaultConsistencyRules());
+
+    /**
+     * @brief Full validation; replaces the project and all cached results
+     */
+    void load(const Configuration& config, const ListOfNodes& nodes);
+
+    // Edits; indices are rows of Configuration::decentralDevices /
+    // ListOfNodes::decentralDevices. Out-of-range indices are ignored.
+    void setCentralDeviceName(const QString& name);
+    void setCentralIpAddress(const QString& ip);
+    void setDeviceName(qsizetype device, const QString& name);
+    void setIpAddress(qsizetype device, const QString& ip);
+    void setIOAddresses(qsizetype device, qsizetype module, qsizetype submodule, const IOAddresses& addresses);
+    void setGsdmlPath(qsizetype node, const QString& path);
+
+    /**
+     * @brief All current messages, in rule order (project part, then rows)
+     */
+    QList<ConsistencyLog> messages() const;
+
+    /**
+     * @brief Current messages attributed to one decentral device
+     */
+    QList<ConsistencyLog> deviceMessages(qsizetype device) const;
+
+    bool hasErrors() const { return m_errorCount > 0; }
+    int errorCount() const { return m_errorCount; }
+
+    const Configuration& configuration() const { return m_config; }
+    const ListOfNodes& listOfNodes() const { return m_nodes; }
+    const ProjectModel& model() const { return m_model; }
+
+    /**
+     * @brief Rule parts evaluated by the last load() or edit, and its duration
+     */
+    int lastEvaluations() const { return m_lastEvaluations; }
+    qint64 lastElapsedNs() const { return m_lastElapsedNs; }
+
+private:
+    struct RuleState {
+        ConsistencyRulePtr rule;
+        bool ioIndexed = false;
+        bool uniqueIndexed = false;
+        QList<ConsistencyLog> project;
+        QVector<QList<ConsistencyLog>> rows;
+    };
+
+    // (first submodule, second submodule or -1 for a bounds error, direction)
+    using IoKey = std::tuple<qint64, qint64, int>;
+
+    /**
+     * @brief Re-run what depends on inputs; device/node/submodule are the edited rows or -1
+     */
+    void update(quint32 inputs, qsizetype device, qsizetype node, qint64 submodule);
+
+    void runProject(RuleState& state);
+    void runRow(RuleState& state, qsizetype row);
+    void replace(QList<ConsistencyLog>& target, QList<ConsistencyLog>&& messages);
+
+    void loadIo(const RuleState& state);
+    void refreshIo(qint64 submodule);
+    void insertIo(const IoKey& key, const ConsistencyLog& log);
+    void eraseIo(const IoKey& key);
+
+    void loadUniqueness(const RuleState& state);
+    void refreshIdentity(UniquenessIndex::Owner owner);
+    void refreshNameGroup(const QString& name);
+    void refreshIpGroup(quint32 address);
+
+    RuleContext context() const { return RuleContext{m_config, m_nodes, m_model}; }
+    static int errorsIn(const QList<ConsistencyLog>& messages);
+
+    QVector<RuleState> m_rules;
+    Configuration m_config;
+    ListOfNodes m_nodes;
+    ProjectModel m_model;
+
+    const ConsistencyRule* m_ioRule = nullptr;
+    IoAddressIndex m_ioIndex;
+    QMap<IoKey, ConsistencyLog> m_ioMessages;
+    QMultiHash<qint64, IoKey> m_ioKeysOf;
+
+    const ConsistencyRule* m_uniqueRule = nullptr;
+    UniquenessIndex m_identities;
+    QMap<QString, ConsistencyLog> m_nameDuplicates;
+    QMap<quint32, ConsistencyLog> m_ipDuplicates;
+
+    int m_errorCount = 0;
+    int m_lastEvaluations = 0;
+    qint64 m_lastElapsedNs = 0;
+};
+
+} // namespace PNConfigLib
+
+#endif // INCREMENTALVALIDATOR_H
@@ -3,39 +3,36 @@
 /*****************************************************************************/
 
 #include "InputValidator.h"
-#include "ConsistencyLogger.h"
+#include "IoAddressOverlap.h"
 #include <QDir>
+#include <algorithm>
 
 namespace PNConfigLib {
 
-bool InputValidator::isConfigurationFileExist(const QString& configPath)
+bool InputValidator::isConfigurationFileExist(const QString& configPath, QString& error)
 {
     if (configPath.isEmpty()) {
-        ConsistencyLogger::log(ConsistencyType::XML, LogSeverity::Error,
-            "Configuration", "配置文件路径为空");
+        error = "配置文件路径为空";
         return false;
     }
     
     if (!QFile::exists(configPath)) {
-        ConsistencyLogger::log(ConsistencyType::XML, LogSeverity::Error,
-            "Configuration", QString("配置文件不存在: %1").arg(configPath));
+        error = QString("配置文件不存在: %1").arg(configPath);
         return false;
     }
     
     return true;
 }
 
-bool InputValidator::isListOfNodesFileExist(const QString& nodesPath)
+bool InputValidator::isListOfNodesFileExist(const QString& nodesPath, QString& error)
 {
     if (nodesPath.isEmpty()) {
-        ConsistencyLogger::log(ConsistencyType::XML, LogSeverity::Error,
-            "ListOfNodes", "节点列表文件路径为空");
+        error = "节点列表文件路径为空";
         return false;
     }
     
     if (!QFile::exists(nodesPath)) {
-        ConsistencyLogger::log(ConsistencyType::XML, LogSeverity::Error,
-            "ListOfNodes", QString("节点列表文件不存在: %1").arg(nodesPath));
+        error = QString("节点列表文件不存在: %1").arg(nodesPath);
         return false;
     }
     
@@ -59,70 +56,97 @@ bool InputValidator::isTopologyFileExist(const QString& topologyPath, bool& exis
 }
 
 bool InputValidator::validateConfiguration(const Configuration& config, QStringList& errors)
+{
+    return validateConfiguration(ProjectModel::fromConfiguration(config), errors);
+}
+
+bool InputValidator::validateConfiguration(const ProjectModel& model, QStringList& errors)
 {
     bool valid = true;
     
     // Check ConfigurationID
-    if (config.configurationID.isEmpty()) {
+    if (model.configurationId == 0) {
         errors.append("配置ID (ConfigurationID) 为空");
         valid = false;
     }
     
     // Check ListOfNodesRefID
-    if (config.listOfNodesRefID.isEmpty()) {
+    if (model.listOfNodesRefId == 0) {
         errors.append("节点列表引用ID (ListOfNodesRefID) 为空");
         valid = false;
     }
     
     // Check Central Device
-    if (config.centralDevice.deviceRefID.isEmpty()) {
+    if (model.central.deviceRefId == 0) {
         errors.append("中心设备引用ID (DeviceRefID) 为空");
         valid = false;
     }
     
-    if (config.centralDevice.ethernetAddresses.ipAddress.isEmpty()) {
+    if (model.central.ipAddress == 0) {
         errors.append("中心设备IP地址为空");
         valid = false;
-    } else if (!isValidIPAddress(config.centralDevice.ethernetAddresses.ipAddress)) {
-        errors.append(QString("中心设备IP地址格式无效: %1").arg(config.centralDevice.ethernetAddresses.ipAddress));
+    } else if (!isValidIPAddress(model.str(model.central.ipAddress))) {
+        errors.append(QString("中心设备IP地址格式无效: %1").arg(model.str(model.central.ipAddress)));
         valid = false;
     }
     
-    if (config.centralDevice.ethernetAddresses.deviceName.isEmpty()) {
+    if (model.central.deviceName == 0) {
         errors.append("中心设备名称 (PNDeviceName) 为空");
         valid = false;
     }
     
-    // Check Decentralized Devices
-    for (int i = 0; i < config.decentralDevices.size(); i++) {
-        const auto& dev = config.decentralDevices[i];
-        QString prefix = QString("从站设备 %1: ").arg(i + 1);
+    // Check Decentralized Devices. Interned strings repeat across devices
+    // (subnet masks, shared names in broken projects), so format checks are
+    // done once per distinct string.
+    QHash<StringId, bool> ipValid;
+    QHash<StringId, QString> nameErrors;
+    
+    const DeviceTable& devices = model.devices;
+    for (qsizetype i = 0; i < devices.size(); i++) {
+        auto prefix = [i]() { return QString("从站设备 %1: ").arg(i + 1); };
         
-        if (dev.deviceRefID.isEmpty()) {
-            errors.append(prefix + "设备引用ID为空");
+        if (devices.deviceRefId[i] == 0) {
+            errors.append(prefix() + "设备引用ID为空");
             valid = false;
         }
         
-        if (dev.ethernetAddresses.ipAddress.isEmpty()) {
-            errors.append(prefix + "IP地址为空");
-            valid = false;
-        } else if (!isValidIPAddress(dev.ethernetAddresses.ipAddress)) {
-            errors.append(prefix + QString("IP地址格式无效: %1").arg(dev.ethernetAddresses.ipAddress));
+        const StringId ip = devices.ipAddress[i];
+        if (ip == 0) {
+            errors.append(prefix() + "IP地址为空");
             valid = false;
+        } else {
+            auto it = ipValid.constFind(ip);
+            if (it == ipValid.constEnd()) {
+                it = ipValid.insert(ip, isValidIPAddress(model.str(ip)));
+            }
+            if (!it.value()) {
+                errors.append(prefix() + QString("IP地址格式无效: %1").arg(model.str(ip)));
+                valid = false;
+            }
         }
         
-        if (dev.ethernetAddresses.deviceName.isEmpty()) {
-            errors.append(prefix + "设备名称为空");
+        const StringId name = devices.deviceName[i];
+        if (name == 0) {
+            errors.append(prefix() + "设备名称为空");
             valid = false;
         } else {
-            QString nameError;
-            if (!isValidPNDeviceName(dev.ethernetAddresses.deviceName, nameError)) {
-                errors.append(prefix + nameError);
+            auto it = nameErrors.constFind(name);
+            if (it == nameErrors.constEnd()) {
+                QString nameError;
+                isValidPNDeviceName(model.str(name), nameError);
+                it = nameErrors.insert(name, nameError);
+            }
+            if (!it.value().isEmpty()) {
+                errors.append(prefix() + it.value());
                 valid = false;
             }
         }
     }
     
+    if (!validateUniqueness(model, errors)) {
+        valid = false;
+    }
+    
     return valid;
 }
 
@@ -166,36 +190,34 @@ bool InputValidator::validateListOfNodes(const ListOfNodes& nodes, QStringList&
 }
 
 bool InputValidator::validateReferences(const Configuration& config, const ListOfNodes& nodes, QStringList& errors)
+{
+    return validateReferences(ProjectModel::fromConfiguration(config, nodes), errors);
+}
+
+bool InputValidator::validateReferences(const ProjectModel& model, QStringList& errors)
 {
     bool valid = true;
     
     // Check ListOfNodesRefID matches ListOfNodesID
-    if (config.listOfNodesRefID != nodes.listOfNodesID) {
+    if (model.listOfNodesRefId != model.listOfNodesId) {
         errors.append(QString("配置文件引用的节点列表ID (%1) 与节点列表文件中的ID (%2) 不匹配")
-            .arg(config.listOfNodesRefID, nodes.listOfNodesID));
+            .arg(model.str(model.listOfNodesRefId), model.str(model.listOfNodesId)));
         valid = false;
     }
     
     // Check device count matches
-    if (config.decentralDevices.size() != nodes.decentralDevices.size()) {
+    if (model.devices.size() != model.nodes.size()) {
         errors.append(QString("配置文件中的从站设备数量 (%1) 与节点列表文件中的数量 (%2) 不匹配")
-            .arg(config.decentralDevices.size())
-            .arg(nodes.decentralDevices.size()));
+            .arg(model.devices.size())
+            .arg(model.nodes.size()));
         valid = false;
     }
     
-    // Check device references match
-    for (const auto& configDev : config.decentralDevices) {
-        bool found = false;
-        for (const auto& nodeDev : nodes.decentralDevices) {
-            if (configDev.deviceRefID == nodeDev.deviceID) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
+    // Check device references match (resolved when the model was built)
+    for (qsizetype i = 0; i < model.devices.size(); i++) {
+        if (model.devices.nodeIndex[i] < 0) {
             errors.append(QString("配置文件中的设备引用 (%1) 在节点列表中不存在")
-                .arg(configDev.deviceRefID));
+                .arg(model.str(model.devices.deviceRefId[i])));
             valid = false;
         }
     }
@@ -203,55 +225,192 @@ bool InputValidator::validateReferences(const Configuration& config, const ListO
     return valid;
 }
 
-bool InputValidator::isValidPNDeviceName(const QString& name, QString& error)
+// "从站设备 2 (io-device-2) 槽 1 子槽 1" for a SubmoduleTable row
+QString InputValidator::describeSubmodule(const ProjectModel& model, qint64 row)
 {
-    // PROFINET device name rules:
-    // - Length: 1-240 characters
-    // - Only lowercase letters, digits, hyphens, dots
-    // - Cannot start or end with hyphen or dot
-    // - Cannot contain "port-xxx" pattern at start
-    // - Cannot be an IP address format
-    
-    if (name.isEmpty()) {
-        error = "设备名称为空";
-        return false;
+    const qint32 module = model.submodules.module[row];
+    const qint32 device = model.modules.device[module];
+    const StringId name = model.devices.deviceName[device];
+    
+    QString text = QString("从站设备 %1").arg(device + 1);
+    if (name != 0) {
+        text += QString(" (%1)").arg(model.str(name));
     }
+    return text + QString(" 槽 %1 子槽 %2")
+        .arg(model.modules.slotNumber[module])
+        .arg(model.submodules.subslotNumber[row]);
+}
+
+QString InputValidator::ioRangeError(const ProjectModel& model, IoDirection direction, const IoRange& range)
+{
+    const QString kind = direction == IoDirection::Input ? "输入" : "输出";
+    return QString("%1: %2地址 %3-%4 超出地址空间 (0-%5)")
+        .arg(describeSubmodule(model, range.owner), kind)
+        .arg(range.start).arg(range.end() - 1)
+        .arg(IoOverlapDetector::AddressSpaceEnd - 1);
+}
+
+QString InputValidator::ioOverlapError(const ProjectModel& model, const IoOverlap& overlap)
+{
+    const QString kind = overlap.direction == IoDirection::Input ? "输入" : "输出";
+    return QString("%1 与 %2 的%3地址重叠 (%4-%5)")
+        .arg(describeSubmodule(model, overlap.first), describeSubmodule(model, overlap.second), kind)
+        .arg(overlap.overlapStart).arg(overlap.overlapEnd - 1);
+}
+
+bool InputValidator::validateIOAddresses(const ProjectModel& model, QStringList& errors)
+{
+    bool valid = true;
     
-    if (name.length() > 240) {
-        error = QString("设备名称过长 (%1 > 240 字符)").arg(name.length());
-        return false;
+    // Address space bounds
+    for (IoDirection direction : {IoDirection::Input, IoDirection::Output}) {
+        for (const IoRange& range : IoOverlapDetector::rangesOf(model, direction)) {
+            if (range.end() > IoOverlapDetector::AddressSpaceEnd) {
+                errors.append(ioRangeError(model, direction, range));
+                valid = false;
+            }
+        }
     }
     
-    QString lowerName = name.toLower();
+    // Overlaps, sort-and-sweep over all submodules
+    for (const IoOverlap& overlap : IoOverlapDetector::findOverlaps(model)) {
+        errors.append(ioOverlapError(model, overlap));
+        valid = false;
+    }
     
-    // Check for forbidden port pattern
-    QRegularExpression portRegex("^port-\\d{3}");
-    if (portRegex.match(lowerName).hasMatch()) {
-        error = QString("设备名称不能以 'port-xxx' 开头: %1").arg(name);
-        return false;
+    return valid;
+}
+
+UniquenessIndex InputValidator::uniquenessIndex(const ProjectModel& model)
+{
+    UniquenessIndex index;
+    
+    // Normalize and parse once per distinct interned string
+    QHash<StringId, QString> names;
+    QHash<StringId, quint32> ips;
+    auto add = [&](UniquenessIndex::Owner owner, StringId name, StringId ip) {
+        if (name != 0) {
+            auto it = names.constFind(name);
+            if (it == names.constEnd()) {
+                it = names.insert(name, NetworkIdentity::normalizeStationName(model.str(name)));
+            }
+            index.setNormalizedName(owner, it.value());
+        }
+        if (ip != 0) {
+            auto it = ips.constFind(ip);
+            if (it == ips.constEnd()) {
+                quint32 address = 0;
+                NetworkIdentity::parseIPv4(model.str(ip), address);
+                it = ips.insert(ip, address);
+            }
+            index.setIpAddress(owner, it.value());
+        }
+    };
+    
+    add(CentralDeviceOwner, model.central.deviceName, model.central.ipAddress);
+    for (qsizetype i = 0; i < model.devices.size(); i++) {
+        add(i, model.devices.deviceName[i], model.devices.ipAddress[i]);
     }
+    return index;
+}
+
+static QString describeOwners(const QList<UniquenessIndex::Owner>& owners)
+{
+    QStringList parts;
+    for (UniquenessIndex::Owner owner : owners) {
+        parts.append(owner == InputValidator::CentralDeviceOwner
+            ? QString("中心设备") : QString("从站设备 %1").arg(owner + 1));
+    }
+    return parts.join(", ");
+}
+
+QString InputValidator::duplicateNameError(const QString& name, const QList<UniquenessIndex::Owner>& owners)
+{
+    return QString("设备名称重复 (%1): %2").arg(name, describeOwners(owners));
+}
+
+QString InputValidator::duplicateIpError(quint32 address, const QList<UniquenessIndex::Owner>& owners)
+{
+    return QString("IP地址重复 (%1): %2").arg(NetworkIdentity::formatIPv4(address), describeOwners(owners));
+}
+
+bool InputValidator::validateUniqueness(const ProjectModel& model, QStringList& errors)
+{
+    return validateUniqueness(model, errors, errors);
+}
+
+bool InputValidator::validateUniqueness(const ProjectModel& model, QStringList& nameErrors, QStringList& ipErrors)
+{
+    const UniquenessIndex index = uniquenessIndex(model);
     
-    // Check for IP address format
-    QRegularExpression ipRegex("\\b\\d{1,3}\\.\\d{1,3}\\.\\d{1,3}\\.\\d{1,3}\\b");
-    if (ipRegex.match(lowerName).hasMatch()) {
-        error = QString("设备名称不能包含IP地址格式: %1").arg(name);
-        return false;
+    // Sorted by value so reports are stable
+    const auto names = index.duplicateNames();
+    QStringList nameKeys = names.keys();
+    nameKeys.sort();
+    for (const QString& name : nameKeys) {
+        nameErrors.append(duplicateNameError(name, names.value(name)));
     }
     
-    // Check valid characters (allow uppercase, lowercase, digits, hyphens, dots, underscores)
-    QRegularExpression validChars("^[a-zA-Z0-9][a-zA-Z0-9._-]*[a-zA-Z0-9]$|^[a-zA-Z0-9]$");
-    if (!validChars.match(name).hasMatch()) {
-        error = QString("设备名称包含无效字符或格式错误: %1").arg(name);
-        return false;
+    const auto ips = index.duplicateIpAddresses();
+    QList<quint32> ipKeys = ips.keys();
+    std::sort(ipKeys.begin(), ipKeys.end());
+    for (quint32 ip : ipKeys) {
+        ipErrors.append(duplicateIpError(ip, ips.value(ip)));
     }
     
-    return true;
+    return names.isEmpty() && ips.isEmpty();
+}
+
+bool InputValidator::isValidPNDeviceName(const QString& name, QString& error)
+{
+    // NameOfStation rules (IEC 61158-6-10), checked in one pass without allocating:
+    // - Length: 1-240 characters, labels separated by '.' of 1-63 characters
+    // - Only lowercase letters, digits and hyphens in labels
+    // - Labels cannot start or end with hyphen
+    // - First label cannot be "port-xyz" or "port-xyz-abcde"
+    // - Cannot be an IP address format (n.n.n.n)
+    const StationNameCheck check = NetworkIdentity::checkStationName(name);
+    
+    switch (check.error) {
+        case StationNameError::None:
+            return true;
+        case StationNameError::Empty:
+            error = "设备名称为空";
+            break;
+        case StationNameError::TooLong:
+            error = QString("设备名称过长 (%1 > %2 字符)").arg(name.length()).arg(NetworkIdentity::MaxStationNameLength);
+            break;
+        case StationNameError::EmptyLabel:
+            error = QString("设备名称包含空标签 (位置 %1): %2").arg(check.position).arg(name);
+            break;
+        case StationNameError::LabelTooLong:
+            error = QString("设备名称标签过长 (位置 %1, > %2 字符): %3")
+                .arg(check.position).arg(NetworkIdentity::MaxLabelLength).arg(name);
+            break;
+        case StationNameError::UppercaseCharacter:
+            error = QString("设备名称不能包含大写字母 (位置 %1): %2").arg(check.position).arg(name);
+            break;
+        case StationNameError::InvalidCharacter:
+            error = QString("设备名称包含无效字符 (位置 %1): %2").arg(check.position).arg(name);
+            break;
+        case StationNameError::HyphenAtLabelStart:
+        case StationNameError::HyphenAtLabelEnd:
+            error = QString("设备名称标签不能以连字符开头或结尾 (位置 %1): %2").arg(check.position).arg(name);
+            break;
+        case StationNameError::PortName:
+            error = QString("设备名称不能为 'port-xxx' 或 'port-xxx-xxxxx' 形式: %1").arg(name);
+            break;
+        case StationNameError::IpAddressForm:
+            error = QString("设备名称不能为IP地址格式: %1").arg(name);
+            break;
+    }
+    return false;
 }
 
 bool InputValidator::isValidIPAddress(const QString& ip)
 {
-    QRegularExpression ipRegex("^((25[0-5]|(2[0-4]|1\\d|[1-9]|)\\d)\\.?\\b){4}$");
-    return ipRegex.match(ip).hasMatch();
+    quint32 address = 0;
+    return NetworkIdentity::parseIPv4(ip, address);
 }
 
 } // namespace PNConfigLib
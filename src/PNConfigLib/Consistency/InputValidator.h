@@ -9,16 +9,18 @@
 #include <QStringList>
 #include <QFile>
 #include <QFileInfo>
-#include <QRegularExpression>
 #include "../ConfigReader/ConfigReader.h"
+#include "../DataModel/ProjectModel.h"
+#include "IoAddressOverlap.h"
+#include "../DataModel/UniquenessIndex.h"
 
 namespace PNConfigLib {
 
 class InputValidator {
 public:
-    // File existence checks
-    static bool isConfigurationFileExist(const QString& configPath);
-    static bool isListOfNodesFileExist(const QString& nodesPath);
+    // File existence checks; error receives the message for a missing file
+    static bool isConfigurationFileExist(const QString& configPath, QString& error);
+    static bool isListOfNodesFileExist(const QString& nodesPath, QString& error);
     static bool isTopologyFileExist(const QString& topologyPath, bool& exists);
     
     // Content validation
@@ -26,6 +28,29 @@ public:
     static bool validateListOfNodes(const ListOfNodes& nodes, QStringList& errors);
     static bool validateReferences(const Configuration& config, const ListOfNodes& nodes, QStringList& errors);
     
+    // Content validation on the flattened model (same checks and messages);
+    // validateReferences requires a model built with its ListOfNodes
+    static bool validateConfiguration(const ProjectModel& model, QStringList& errors);
+    static bool validateReferences(const ProjectModel& model, QStringList& errors);
+    
+    // IO address ranges: address space bounds and overlaps between submodules
+    static bool validateIOAddresses(const ProjectModel& model, QStringList& errors);
+    
+    // Message texts of validateIOAddresses, for callers that track ranges themselves
+    static QString describeSubmodule(const ProjectModel& model, qint64 row);
+    static QString ioRangeError(const ProjectModel& model, IoDirection direction, const IoRange& range);
+    static QString ioOverlapError(const ProjectModel& model, const IoOverlap& overlap);
+    
+    // Device names and IP addresses unique across central and decentral devices
+    static bool validateUniqueness(const ProjectModel& model, QStringList& errors);
+    static bool validateUniqueness(const ProjectModel& model, QStringList& nameErrors, QStringList& ipErrors);
+    
+    // Names and IPs of a model; owners are device rows, CentralDeviceOwner for the controller
+    static constexpr UniquenessIndex::Owner CentralDeviceOwner = -1;
+    static UniquenessIndex uniquenessIndex(const ProjectModel& model);
+    static QString duplicateNameError(const QString& name, const QList<UniquenessIndex::Owner>& owners);
+    static QString duplicateIpError(quint32 address, const QList<UniquenessIndex::Owner>& owners);
+    
     // PROFINET name validation
     static bool isValidPNDeviceName(const QString& name, QString& error);
     
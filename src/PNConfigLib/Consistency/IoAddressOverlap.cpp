@@ -0,0 +1,225 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Configuration Validation                   */
+/*****************************************************************************/
+
+#include "IoAddressOverlap.h"
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace PNConfigLib {
+
+// -----------------------------------------------------------------------------
+// IoOverlapDetector
+// -----------------------------------------------------------------------------
+
+QVector<IoOverlap> IoOverlapDetector::findOverlaps(QVector<IoRange> ranges, IoDirection direction)
+{
+    ranges.erase(std::remove_if(ranges.begin(), ranges.end(),
+                                [](const IoRange& r) { return r.start < 0 || r.length <= 0; }),
+                 ranges.end());
+    std::sort(ranges.begin(), ranges.end(), [](const IoRange& a, const IoRange& b) {
+        return a.start != b.start ? a.start < b.start : a.owner < b.owner;
+    });
+
+    QVector<IoOverlap> overlaps;
+
+    // Min-heap on end address of the ranges that may still overlap
+    auto laterEnd = [&ranges](int a, int b) { return ranges[a].end() > ranges[b].end(); };
+    std::vector<int> active;
+
+    for (int i = 0; i < ranges.size(); ++i) {
+        const IoRange& current = ranges[i];
+
+        while (!active.empty() && ranges[active.front()].end() <= current.start) {
+            std::pop_heap(active.begin(), active.end(), laterEnd);
+            active.pop_back();
+        }
+
+        // Everything still open starts at or before current.start and ends after it
+        for (int openIndex : active) {
+            const IoRange& open = ranges[openIndex];
+            IoOverlap overlap;
+            overlap.direction = direction;
+            overlap.first = open.owner;
+            overlap.second = current.owner;
+            overlap.overlapStart = current.start;
+            overlap.overlapEnd = static_cast<qint32>(std::min(open.end(), current.end()));
+            overlaps.append(overlap);
+        }
+
+        active.push_back(i);
+        std::push_heap(active.begin(), active.end(), laterEnd);
+    }
+
+    return overlaps;
+}
+
+QVector<IoRange> IoOverlapDetector::rangesOf(const ProjectModel& model, IoDirection direction)
+{
+    const QVector<PackedIOAddresses>& io = model.submodules.io;
+
+    QVector<IoRange> ranges;
+    ranges.reserve(io.size());
+    for (qsizetype row = 0; row < io.size(); ++row) {
+        const PackedIOAddresses& a = io[row];
+        if (direction == IoDirection::Input ? a.hasInput() : a.hasOutput()) {
+            IoRange range;
+            range.start = direction == IoDirection::Input ? a.inputStart : a.outputStart;
+            range.length = direction == IoDirection::Input ? a.inputLength : a.outputLength;
+            range.owner = row;
+            ranges.append(range);
+        }
+    }
+    return ranges;
+}
+
+QVector<IoOverlap> IoOverlapDetector::findOverlaps(const ProjectModel& model)
+{
+    QVector<IoOverlap> overlaps = findOverlaps(rangesOf(model, IoDirection::Input), IoDirection::Input);
+    overlaps.append(findOverlaps(rangesOf(model, IoDirection::Output), IoDirection::Output));
+    return overlaps;
+}
+
+// -----------------------------------------------------------------------------
+// IoAddressIndex
+// -----------------------------------------------------------------------------
+
+IoAddressIndex IoAddressIndex::fromModel(const ProjectModel& model)
+{
+    IoAddressIndex index;
+    for (IoDirection direction : {IoDirection::Input, IoDirection::Output}) {
+        for (const IoRange& range : IoOverlapDetector::rangesOf(model, direction)) {
+            index.set(range.owner, direction, range.start, range.length);
+        }
+    }
+    return index;
+}
+
+void IoAddressIndex::clear()
+{
+    m_spaces[0] = Space();
+    m_spaces[1] = Space();
+}
+
+void IoAddressIndex::set(qint64 owner, IoDirection direction, qint32 start, qint32 length)
+{
+    Space& s = space(direction);
+    erase(s, owner);
+
+    if (start < 0 || length <= 0) {
+        return;
+    }
+
+    Entry entry;
+    entry.owner = owner;
+    entry.length = length;
+    s.byStart.insert(start, entry);
+    s.lengthCounts[length]++;
+    s.startOf.insert(owner, start);
+}
+
+void IoAddressIndex::set(qint64 owner, const IOAddresses& addresses)
+{
+    set(owner, IoDirection::Input, addresses.inputStartAddress, addresses.inputLength);
+    set(owner, IoDirection::Output, addresses.outputStartAddress, addresses.outputLength);
+}
+
+void IoAddressIndex::remove(qint64 owner)
+{
+    erase(m_spaces[0], owner);
+    erase(m_spaces[1], owner);
+}
+
+void IoAddressIndex::erase(Space& s, qint64 owner)
+{
+    auto startIt = s.startOf.find(owner);
+    if (startIt == s.startOf.end()) {
+        return;
+    }
+
+    const qint32 start = startIt.value();
+    s.startOf.erase(startIt);
+
+    for (auto it = s.byStart.find(start); it != s.byStart.end() && it.key() == start; ++it) {
+        if (it->owner == owner) {
+            auto count = s.lengthCounts.find(it->length);
+            if (--count.value() == 0) {
+                s.lengthCounts.erase(count);
+            }
+            s.byStart.erase(it);
+            return;
+        }
+    }
+}
+
+void IoAddressIndex::collect(const Space& s, IoDirection direction, qint64 owner, QVector<IoOverlap>& result) const
+{
+    auto startIt = s.startOf.constFind(owner);
+    if (startIt == s.startOf.constEnd()) {
+        return;
+    }
+
+    const qint32 start = startIt.value();
+    qint64 end = start;
+    for (auto it = s.byStart.constFind(start); it != s.byStart.constEnd() && it.key() == start; ++it) {
+        if (it->owner == owner) {
+            end = static_cast<qint64>(start) + it->length;
+            break;
+        }
+    }
+
+    // No range longer than maxLength can reach 'start' from further left
+    const qint64 maxLength = s.lengthCounts.isEmpty() ? 0 : s.lengthCounts.lastKey();
+    const qint32 scanFrom = static_cast<qint32>(std::max<qint64>(0, start - maxLength + 1));
+
+    for (auto it = s.byStart.lowerBound(scanFrom); it != s.byStart.constEnd() && it.key() < end; ++it) {
+        const qint64 otherEnd = static_cast<qint64>(it.key()) + it->length;
+        if (it->owner == owner || otherEnd <= start) {
+            continue;
+        }
+
+        const bool otherFirst = it.key() != start ? it.key() < start : it->owner < owner;
+        IoOverlap overlap;
+        overlap.direction = direction;
+        overlap.first = otherFirst ? it->owner : owner;
+        overlap.second = otherFirst ? owner : it->owner;
+        overlap.overlapStart = std::max(start, it.key());
+        overlap.overlapEnd = static_cast<qint32>(std::min(end, otherEnd));
+        result.append(overlap);
+    }
+}
+
+QVector<IoOverlap> IoAddressIndex::overlapsOf(qint64 owner) const
+{
+    QVector<IoOverlap> result;
+    collect(space(IoDirection::Input), IoDirection::Input, owner, result);
+    collect(space(IoDirection::Output), IoDirection::Output, owner, result);
+    return result;
+}
+
+QVector<IoOverlap> IoAddressIndex::allOverlaps() const
+{
+    QVector<IoOverlap> result;
+    for (IoDirection direction : {IoDirection::Input, IoDirection::Output}) {
+        const Space& s = space(direction);
+        QVector<IoRange> ranges;
+        ranges.reserve(s.byStart.size());
+        for (auto it = s.byStart.constBegin(); it != s.byStart.constEnd(); ++it) {
+            IoRange range;
+            range.start = it.key();
+            range.length = it->length;
+            range.owner = it->owner;
+            ranges.append(range);
+        }
+        result.append(IoOverlapDetector::findOverlaps(std::move(ranges), direction));
+    }
+    return result;
+}
+
+qsizetype IoAddressIndex::size(IoDirection direction) const
+{
+    return space(direction).startOf.size();
+}
+
+} // namespace PNConfigLib
@@ -0,0 +1,144 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Configuration Validation                   */
+/*****************************************************************************/
+
+#ifndef IOADDRESSOVERLAP_H
+#define IOADDRESSOVERLAP_H
+
+#include "../DataModel/ProjectModel.h"
+#include <QHash>
+#include <QMap>
+#include <QVector>
+
+namespace PNConfigLib {
+
+/**
+ * @brief Input and output addresses are separate address spaces
+ */
+enum class IoDirection {
+    Input,
+    Output
+};
+
+/**
+ * @brief Half-open address range [start, start + length) owned by a submodule
+ */
+struct IoRange {
+    qint32 start = 0;
+    qint32 length = 0;
+    qint64 owner = 0;        // Caller-defined, e.g. a SubmoduleTable row
+
+    qint64 end() const { return static_cast<qint64>(start) + length; }
+};
+
+/**
+ * @brief Two ranges of the same direction sharing at least one address
+ */
+struct IoOverlap {
+    IoDirection direction = IoDirection::Input;
+    qint64 first = 0;        // Owner of the range that starts first
+    qint64 second = 0;
+    qint32 overlapStart = 0; // Shared addresses [overlapStart, overlapEnd)
+    qint32 overlapEnd = 0;
+};
+
+/**
+ * @brief Batch overlap detection by sort-and-sweep
+ *
+ * Ranges are sorted by start address and swept with a min-heap of the end
+ * addresses still open, so every collision is reported in O(n log n + k)
+ * for n ranges and k collisions.
+ */
+class IoOverlapDetector {
+public:
+    /**
+     * @brief End of the addressable IO space (exclusive)
+     */
+    static constexpr qint64 AddressSpaceEnd = 0x10000;
+
+    /**
+     * @brief All pairwise overlaps among ranges of one direction
+     *
+     * Ranges with a negative start or non-positive length are ignored.
+     */
+    static QVector<IoOverlap> findOverlaps(QVector<IoRange> ranges, IoDirection direction);
+
+    /**
+     * @brief Input and output overlaps of all submodules; owners are SubmoduleTable rows
+     */
+    static QVector<IoOverlap> findOverlaps(const ProjectModel& model);
+
+    /**
+     * @brief Configured ranges of one direction; owners are SubmoduleTable rows
+     */
+    static QVector<IoRange> rangesOf(const ProjectModel& model, IoDirection direction);
+};
+
+/**
+ * @brief Incrementally maintained IO address map for editors
+ *
+ * Keeps the ranges of each direction ordered by start address, so replacing
+ * the addresses of one submodule and asking for its collisions costs
+ * O(log n + w), w being the ranges within one maximal range length of it,
+ * instead of revalidating the whole project.
+ */
+class IoAddressIndex {
+public:
+    /**
+     * @brief Index of all configured submodule ranges; owners are SubmoduleTable rows
+     */
+    static IoAddressIndex fromModel(const ProjectModel& model);
+
+    void clear();
+
+    /**
+     * @brief Set (or replace) the range of an owner; start < 0 or length <= 0 removes it
+     */
+    void set(qint64 owner, IoDirection direction, qint32 start, qint32 length);
+
+    /**
+     * @brief Replace both ranges of an owner from its IOAddresses
+     */
+    void set(qint64 owner, const IOAddresses& addresses);
+
+    /**
+     * @brief Remove input and output range of an owner
+     */
+    void remove(qint64 owner);
+
+    /**
+     * @brief Collisions of the owner's ranges with any other range
+     */
+    QVector<IoOverlap> overlapsOf(qint64 owner) const;
+
+    /**
+     * @brief Every collision in the index (sweep over the current content)
+     */
+    QVector<IoOverlap> allOverlaps() const;
+
+    qsizetype size(IoDirection direction) const;
+
+private:
+    struct Entry {
+        qint64 owner = 0;
+        qint32 length = 0;
+    };
+
+    struct Space {
+        QMultiMap<qint32, Entry> byStart;
+        QMap<qint32, int> lengthCounts;     // Largest key bounds the backward search
+        QHash<qint64, qint32> startOf;
+    };
+
+    void erase(Space& space, qint64 owner);
+    void collect(const Space& space, IoDirection direction, qint64 owner, QVector<IoOverlap>& result) const;
+
+    Space& space(IoDirection direction) { return m_spaces[static_cast<int>(direction)]; }
+    const Space& space(IoDirection direction) const { return m_spaces[static_cast<int>(direction)]; }
+
+    Space m_spaces[2];
+};
+
+} // namespace PNConfigLib
+
+#endif // IOADDRESSOVERLAP_H
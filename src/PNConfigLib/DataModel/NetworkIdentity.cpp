@@ -0,0 +1,402 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include "NetworkIdentity.h"
+#include <QStringList>
+#include <QVector>
+
+namespace PNConfigLib {
+
+namespace {
+
+inline unsigned unit(char c) { return static_cast<unsigned char>(c); }
+inline unsigned unit(QChar c) { return c.unicode(); }
+
+inline bool isDigit(unsigned c) { return c >= '0' && c <= '9'; }
+inline bool isLower(unsigned c) { return c >= 'a' && c <= 'z'; }
+
+// "port-xyz" or "port-xyz-abcde"
+template<typename Char>
+bool isPortName(const Char* label, qsizetype length)
+{
+    if (length != 8 && length != 14) {
+        return false;
+    }
+    static const char prefix[] = "port-";
+    for (int i = 0; i < 5; ++i) {
+        if (unit(label[i]) != static_cast<unsigned>(prefix[i])) {
+            return false;
+        }
+    }
+    for (qsizetype i = 5; i < length; ++i) {
+        const bool hyphen = i == 8;
+        if (hyphen ? unit(label[i]) != '-' : !isDigit(unit(label[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Char>
+StationNameCheck checkStationNameImpl(const Char* data, qsizetype size)
+{
+    if (size == 0) {
+        return {StationNameError::Empty, 0};
+    }
+    if (size > NetworkIdentity::MaxStationNameLength) {
+        return {StationNameError::TooLong, NetworkIdentity::MaxStationNameLength};
+    }
+
+    enum class State { LabelStart, InLabel, AfterHyphen };
+    State state = State::LabelStart;
+    qsizetype labelStart = 0;
+    int labels = 0;
+    bool labelNumeric = true;
+    bool nameNumeric = true;    // Every label so far is 1-3 digits
+
+    auto endLabel = [&](qsizetype end) -> StationNameCheck {
+        if (labels == 0 && isPortName(data + labelStart, end - labelStart)) {
+            return {StationNameError::PortName, labelStart};
+        }
+        nameNumeric = nameNumeric && labelNumeric && end - labelStart <= 3;
+        labels++;
+        return {};
+    };
+
+    for (qsizetype i = 0; i < size; ++i) {
+        const unsigned c = unit(data[i]);
+
+        if (c == '.') {
+            if (state == State::LabelStart) {
+                return {StationNameError::EmptyLabel, i};
+            }
+            if (state == State::AfterHyphen) {
+                return {StationNameError::HyphenAtLabelEnd, i - 1};
+            }
+            const StationNameCheck label = endLabel(i);
+            if (!label.isValid()) {
+                return label;
+            }
+            state = State::LabelStart;
+            labelStart = i + 1;
+            labelNumeric = true;
+            continue;
+        }
+
+        if (i - labelStart >= NetworkIdentity::MaxLabelLength) {
+            return {StationNameError::LabelTooLong, labelStart};
+        }
+
+        if (c == '-') {
+            if (state == State::LabelStart) {
+                return {StationNameError::HyphenAtLabelStart, i};
+            }
+            state = State::AfterHyphen;
+            labelNumeric = false;
+        } else if (isDigit(c)) {
+            state = State::InLabel;
+        } else if (isLower(c)) {
+            state = State::InLabel;
+            labelNumeric = false;
+        } else if (c >= 'A' && c <= 'Z') {
+            return {StationNameError::UppercaseCharacter, i};
+        } else {
+            return {StationNameError::InvalidCharacter, i};
+        }
+    }
+
+    if (state == State::LabelStart) {
+        return {StationNameError::EmptyLabel, size};
+    }
+    if (state == State::AfterHyphen) {
+        return {StationNameError::HyphenAtLabelEnd, size - 1};
+    }
+    const StationNameCheck label = endLabel(size);
+    if (!label.isValid()) {
+        return label;
+    }
+
+    if (labels == 4 && nameNumeric) {
+        return {StationNameError::IpAddressForm, 0};
+    }
+    return {};
+}
+
+template<typename Char>
+bool parseIPv4Impl(const Char* p, const Char* end, quint32& address)
+{
+    quint32 result = 0;
+
+    for (int part = 0; part < 4; ++part) {
+        if (part > 0) {
+            if (p == end || unit(*p) != '.') {
+                return false;
+            }
+            ++p;
+        }
+
+        const Char* digits = p;
+        quint32 value = 0;
+        while (p != end && p - digits < 3 && isDigit(unit(*p))) {
+            value = value * 10 + (unit(*p) - '0');
+            ++p;
+        }
+        const qsizetype length = p - digits;
+        if (length == 0 || value > 255 || (length > 1 && unit(*digits) == '0')) {
+            return false;
+        }
+        result = (result << 8) | value;
+    }
+
+    if (p != end) {
+        return false;
+    }
+    address = result;
+    return true;
+}
+
+// RFC 3492 parameters
+constexpr quint32 PunyBase = 36;
+constexpr quint32 PunyTMin = 1;
+constexpr quint32 PunyTMax = 26;
+constexpr quint32 PunySkew = 38;
+constexpr quint32 PunyDamp = 700;
+constexpr quint32 PunyInitialBias = 72;
+constexpr quint32 PunyInitialN = 0x80;
+
+inline bool isStationBasic(uint c) { return isLower(c) || isDigit(c) || c == '-'; }
+inline bool isPunyBasic(uint c) { return c < PunyInitialN; }
+
+inline char punyDigit(quint32 d) { return static_cast<char>(d < 26 ? 'a' + d : '0' + (d - 26)); }
+
+quint32 punyAdapt(quint32 delta, quint32 points, bool first)
+{
+    delta = first ? delta / PunyDamp : delta / 2;
+    delta += delta / points;
+    quint32 k = 0;
+    while (delta > ((PunyBase - PunyTMin) * PunyTMax) / 2) {
+        delta /= PunyBase - PunyTMin;
+        k += PunyBase;
+    }
+    return k + (PunyBase - PunyTMin + 1) * delta / (delta + PunySkew);
+}
+
+// RFC 3492 section 6.3; the basic code points are all of ASCII
+bool punycode(const QVector<uint>& input, QByteArray& output)
+{
+    quint32 handled = 0;
+    for (uint c : input) {
+        if (isPunyBasic(c)) {
+            output += static_cast<char>(c);
+            handled++;
+        }
+    }
+    const quint32 basicCount = handled;
+    if (basicCount > 0) {
+        output += '-';
+    }
+
+    quint32 n = PunyInitialN;
+    quint64 delta = 0;
+    quint32 bias = PunyInitialBias;
+
+    while (handled < static_cast<quint32>(input.size())) {
+        uint m = 0xFFFFFFFFu;
+        for (uint c : input) {
+            if (c >= n && c < m) {
+                m = c;
+            }
+        }
+
+        delta += static_cast<quint64>(m - n) * (handled + 1);
+        if (delta > 0xFFFFFFFFu) {
+            return false;
+        }
+        n = m;
+
+        for (uint c : input) {
+            if (c < n) {
+                delta++;
+            } else if (c == n) {
+                quint64 q = delta;
+                for (quint32 k = PunyBase; ; k += PunyBase) {
+                    const quint32 t = k <= bias ? PunyTMin : (k >= bias + PunyTMax ? PunyTMax : k - bias);
+                    if (q < t) {
+                        break;
+                    }
+                    output += punyDigit(static_cast<quint32>(t + (q - t) % (PunyBase - t)));
+                    q = (q - t) / (PunyBase - t);
+                }
+                output += punyDigit(static_cast<quint32>(q));
+                bias = punyAdapt(static_cast<quint32>(delta), handled + 1, handled == basicCount);
+                delta = 0;
+                handled++;
+            }
+        }
+        delta++;
+        n++;
+    }
+    return true;
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+// Station names
+// -----------------------------------------------------------------------------
+
+StationNameCheck NetworkIdentity::checkStationName(const char* data, qsizetype size)
+{
+    return checkStationNameImpl(data, size);
+}
+
+StationNameCheck NetworkIdentity::checkStationName(const QString& name)
+{
+    return checkStationNameImpl(name.constData(), name.size());
+}
+
+QByteArray NetworkIdentity::encodeStationName(QByteArrayView utf8Name)
+{
+    if (checkStationName(utf8Name).isValid()) {
+        return QByteArray(utf8Name.data(), utf8Name.size());
+    }
+
+    const QStringList labels = QString::fromUtf8(utf8Name.data(), utf8Name.size())
+        .toLower().split(QChar('.'), Qt::SkipEmptyParts);
+
+    QByteArray result;
+    for (const QString& label : labels) {
+        // ASCII outside the NameOfStation alphabet becomes '-', so the
+        // Punycode basic code points below are all valid in a label
+        QVector<uint> points = label.toUcs4();
+        bool basic = true;
+        for (uint& c : points) {
+            if (isPunyBasic(c) && !isStationBasic(c)) {
+                c = '-';
+            }
+            basic = basic && isPunyBasic(c);
+        }
+        while (!points.isEmpty() && points.first() == '-') {
+            points.removeFirst();
+        }
+        while (!points.isEmpty() && points.last() == '-') {
+            points.removeLast();
+        }
+
+        QByteArray encoded;
+        if (basic) {
+            for (uint c : points) {
+                encoded += static_cast<char>(c);
+            }
+        } else {
+            encoded = "xn--";
+            if (!punycode(points, encoded)) {
+                return QByteArray();
+            }
+        }
+
+        if (encoded.isEmpty()) {
+            continue;
+        }
+        if (!result.isEmpty()) {
+            result += '.';
+        }
+        result += encoded;
+    }
+
+    if (!checkStationName(result.constData(), result.size()).isValid()) {
+        return QByteArray();
+    }
+    return result;
+}
+
+QString NetworkIdentity::normalizeStationName(const QString& name)
+{
+    return name.trimmed().toLower();
+}
+
+// -----------------------------------------------------------------------------
+// IPv4
+// -----------------------------------------------------------------------------
+
+bool NetworkIdentity::parseIPv4(const char* data, qsizetype size, quint32& address)
+{
+    return parseIPv4Impl(data, data + size, address);
+}
+
+bool NetworkIdentity::parseIPv4(const QString& text, quint32& address)
+{
+    return parseIPv4Impl(text.constData(), text.constData() + text.size(), address);
+}
+
+QString NetworkIdentity::formatIPv4(quint32 address)
+{
+    return QString("%1.%2.%3.%4")
+        .arg((address >> 24) & 0xFF)
+        .arg((address >> 16) & 0xFF)
+        .arg((address >> 8) & 0xFF)
+        .arg(address & 0xFF);
+}
+
+// -----------------------------------------------------------------------------
+// MAC
+// -----------------------------------------------------------------------------
+
+bool NetworkIdentity::parseMac(const QString& text, quint64& mac)
+{
+    quint64 result = 0;
+    int digits = 0;
+    QChar separator;
+
+    for (qsizetype i = 0; i < text.size(); ++i) {
+        const ushort c = text[i].unicode();
+        int value = -1;
+        if (c >= '0' && c <= '9') {
+            value = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            value = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            value = c - 'A' + 10;
+        }
+
+        if (value >= 0) {
+            if (++digits > 12) {
+                return false;
+            }
+            result = (result << 4) | static_cast<quint64>(value);
+            continue;
+        }
+
+        // Separators only between byte pairs, and always the same one
+        if ((c != ':' && c != '-') || digits % 2 != 0 || digits == 0 || digits == 12) {
+            return false;
+        }
+        if (separator.isNull()) {
+            separator = text[i];
+        } else if (text[i] != separator) {
+            return false;
+        }
+    }
+
+    if (digits != 12) {
+        return false;
+    }
+    mac = result;
+    return true;
+}
+
+QString NetworkIdentity::formatMac(quint64 mac)
+{
+    QString result;
+    result.reserve(17);
+    for (int shift = 40; shift >= 0; shift -= 8) {
+        if (!result.isEmpty()) {
+            result += QLatin1Char(':');
+        }
+        result += QString("%1").arg((mac >> shift) & 0xFF, 2, 16, QChar('0')).toUpper();
+    }
+    return result;
+}
+
+} // namespace PNConfigLib
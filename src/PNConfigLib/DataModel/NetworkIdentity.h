@@ -0,0 +1,90 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#ifndef NETWORKIDENTITY_H
+#define NETWORKIDENTITY_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+
+namespace PNConfigLib {
+
+/**
+ * @brief First rule a NameOfStation violates
+ */
+enum class StationNameError {
+    None,
+    Empty,
+    TooLong,                // More than 240 octets
+    EmptyLabel,             // Leading, trailing or double dot
+    LabelTooLong,           // More than 63 octets between dots
+    UppercaseCharacter,
+    InvalidCharacter,       // Anything but a-z, 0-9, '-' and '.'
+    HyphenAtLabelStart,
+    HyphenAtLabelEnd,
+    PortName,               // First label is "port-xyz" or "port-xyz-abcde"
+    IpAddressForm           // Whole name is "n.n.n.n"
+};
+
+struct StationNameCheck {
+    StationNameError error = StationNameError::None;
+    qsizetype position = 0;     // Offset of the offending code unit
+
+    bool isValid() const { return error == StationNameError::None; }
+};
+
+/**
+ * @brief Canonical forms of the identities a PROFINET device is addressed by
+ *
+ * The checks and parsers work directly on UTF-8 byte spans (DCP payloads,
+ * XML attribute bytes) or on QString storage without allocating, so they
+ * are cheap enough for every DCP response and every keystroke.
+ */
+class NetworkIdentity {
+public:
+    static constexpr int MaxStationNameLength = 240;
+    static constexpr int MaxLabelLength = 63;
+
+    /**
+     * @brief NameOfStation label rules of IEC 61158-6-10 as a single-pass state machine
+     */
+    static StationNameCheck checkStationName(const char* data, qsizetype size);
+    static StationNameCheck checkStationName(QByteArrayView name) { return checkStationName(name.data(), name.size()); }
+    static StationNameCheck checkStationName(const QString& name);
+
+    /**
+     * @brief Convert any name to a valid NameOfStation (DNS-compatible form)
+     *
+     * Letters are lowered, other ASCII outside a-z, 0-9 and '-' becomes '-'
+     * ("IO-Device_1" -> "io-device-1") and leading/trailing hyphens of a label
+     * are dropped. Labels with non-ASCII characters are then Punycode encoded
+     * (RFC 3492) with the "xn--" prefix, e.g. "bücher" -> "xn--bcher-kva".
+     * Returns an empty array if no valid name results (e.g. "1.2.3.4").
+     */
+    static QByteArray encodeStationName(QByteArrayView utf8Name);
+
+    /**
+     * @brief NameOfStation as compared by DCP: trimmed, lower case
+     */
+    static QString normalizeStationName(const QString& name);
+
+    /**
+     * @brief Strict dotted-quad IPv4 ("192.168.0.1"; no leading zeros) to host order
+     */
+    static bool parseIPv4(const char* data, qsizetype size, quint32& address);
+    static bool parseIPv4(QByteArrayView text, quint32& address) { return parseIPv4(text.data(), text.size(), address); }
+    static bool parseIPv4(const QString& text, quint32& address);
+    static QString formatIPv4(quint32 address);
+
+    /**
+     * @brief 12 hex digits, optionally separated by ':' or '-', to the low 48 bits
+     */
+    static bool parseMac(const QString& text, quint64& mac);
+    static QString formatMac(quint64 mac);
+};
+
+} // namespace PNConfigLib
+
+#endif // NETWORKIDENTITY_H
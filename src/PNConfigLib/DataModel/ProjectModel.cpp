@@ -0,0 +1,206 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include "ProjectModel.h"
+#include "../Instrumentation/Instrumentation.h"
+#include <limits>
+
+namespace PNConfigLib {
+
+// -----------------------------------------------------------------------------
+// StringPool
+// -----------------------------------------------------------------------------
+
+StringPool::StringPool()
+{
+    m_strings.append(QString());
+    m_ids.insert(QString(), 0);
+}
+
+StringId StringPool::intern(const QString& value)
+{
+    if (value.isEmpty()) {
+        return 0;
+    }
+
+    auto it = m_ids.constFind(value);
+    if (it != m_ids.constEnd()) {
+        return it.value();
+    }
+
+    const StringId id = static_cast<StringId>(m_strings.size());
+    m_strings.append(value);
+    m_ids.insert(value, id);
+    return id;
+}
+
+StringId StringPool::find(const QString& value) const
+{
+    if (value.isEmpty()) {
+        return 0;
+    }
+    return m_ids.value(value, -1);
+}
+
+// -----------------------------------------------------------------------------
+// Tables
+// -----------------------------------------------------------------------------
+
+static_assert(sizeof(PackedIOAddresses) == 12, "PackedIOAddresses should stay 12 bytes");
+
+static quint16 clampLength(int length)
+{
+    if (length <= 0) {
+        return 0;
+    }
+    return static_cast<quint16>(qMin(length, static_cast<int>(std::numeric_limits<quint16>::max())));
+}
+
+PackedIOAddresses PackedIOAddresses::fromIOAddresses(const IOAddresses& addresses)
+{
+    PackedIOAddresses packed;
+    packed.inputStart = addresses.inputStartAddress;
+    packed.outputStart = addresses.outputStartAddress;
+    packed.inputLength = clampLength(addresses.inputLength);
+    packed.outputLength = clampLength(addresses.outputLength);
+    return packed;
+}
+
+void DeviceTable::reserve(qsizetype count)
+{
+    deviceRefId.reserve(count);
+    interfaceRefId.reserve(count);
+    deviceName.reserve(count);
+    ipAddress.reserve(count);
+    subnetMask.reserve(count);
+    routerAddress.reserve(count);
+    deviceNumber.reserve(count);
+    firstModule.reserve(count);
+    moduleCount.reserve(count);
+    nodeIndex.reserve(count);
+}
+
+void ModuleTable::reserve(qsizetype count)
+{
+    device.reserve(count);
+    moduleId.reserve(count);
+    gsdRefId.reserve(count);
+    slotNumber.reserve(count);
+    firstSubmodule.reserve(count);
+    submoduleCount.reserve(count);
+}
+
+void SubmoduleTable::reserve(qsizetype count)
+{
+    module.reserve(count);
+    submoduleId.reserve(count);
+    gsdRefId.reserve(count);
+    subslotNumber.reserve(count);
+    io.reserve(count);
+}
+
+void NodeTable::reserve(qsizetype count)
+{
+    deviceId.reserve(count);
+    deviceName.reserve(count);
+    gsdPath.reserve(count);
+    gsdRefId.reserve(count);
+}
+
+// -----------------------------------------------------------------------------
+// Conversion
+// -----------------------------------------------------------------------------
+
+ProjectModel ProjectModel::fromConfiguration(const Configuration& config)
+{
+    return fromConfiguration(config, ListOfNodes());
+}
+
+ProjectModel ProjectModel::fromConfiguration(const Configuration& config, const ListOfNodes& nodes)
+{
+    PN_SCOPED_TIMER("ProjectModel::fromConfiguration");
+
+    ProjectModel model;
+    StringPool& strings = model.strings;
+
+    model.configurationId = strings.intern(config.configurationID);
+    model.listOfNodesRefId = strings.intern(config.listOfNodesRefID);
+    model.listOfNodesId = strings.intern(nodes.listOfNodesID);
+    model.hasNodes = !nodes.listOfNodesID.isEmpty() || !nodes.decentralDevices.isEmpty();
+
+    const CentralDeviceType& central = config.centralDevice;
+    model.central.deviceRefId = strings.intern(central.deviceRefID);
+    model.central.interfaceRefId = strings.intern(central.interfaceRefID);
+    model.central.deviceName = strings.intern(central.ethernetAddresses.deviceName);
+    model.central.ipAddress = strings.intern(central.ethernetAddresses.ipAddress);
+    model.central.subnetMask = strings.intern(central.ethernetAddresses.subnetMask);
+    model.central.routerAddress = strings.intern(central.ethernetAddresses.routerAddress);
+    model.central.sendClock = central.sendClock;
+
+    // Nodes first, so device rows can be resolved while they are appended
+    model.nodes.reserve(nodes.decentralDevices.size());
+    QHash<StringId, qint32> nodeByDeviceId;
+    nodeByDeviceId.reserve(nodes.decentralDevices.size());
+    for (const DecentralDeviceNode& node : nodes.decentralDevices) {
+        const StringId deviceId = strings.intern(node.deviceID);
+        if (!nodeByDeviceId.contains(deviceId)) {
+            nodeByDeviceId.insert(deviceId, static_cast<qint32>(model.nodes.size()));
+        }
+        model.nodes.deviceId.append(deviceId);
+        model.nodes.deviceName.append(strings.intern(node.deviceName));
+        model.nodes.gsdPath.append(strings.intern(node.gsdPath));
+        model.nodes.gsdRefId.append(strings.intern(node.gsdRefID));
+    }
+
+    qsizetype moduleTotal = 0;
+    qsizetype submoduleTotal = 0;
+    for (const DecentralDeviceType& device : config.decentralDevices) {
+        moduleTotal += device.modules.size();
+        for (const ModuleType& module : device.modules) {
+            submoduleTotal += module.submodules.size();
+        }
+    }
+    model.devices.reserve(config.decentralDevices.size());
+    model.modules.reserve(moduleTotal);
+    model.submodules.reserve(submoduleTotal);
+
+    for (const DecentralDeviceType& device : config.decentralDevices) {
+        const qint32 deviceRow = static_cast<qint32>(model.devices.size());
+        const StringId refId = strings.intern(device.deviceRefID);
+
+        model.devices.deviceRefId.append(refId);
+        model.devices.interfaceRefId.append(strings.intern(device.interfaceRefID));
+        model.devices.deviceName.append(strings.intern(device.ethernetAddresses.deviceName));
+        model.devices.ipAddress.append(strings.intern(device.ethernetAddresses.ipAddress));
+        model.devices.subnetMask.append(strings.intern(device.ethernetAddresses.subnetMask));
+        model.devices.routerAddress.append(strings.intern(device.ethernetAddresses.routerAddress));
+        model.devices.deviceNumber.append(device.ethernetAddresses.deviceNumber);
+        model.devices.firstModule.append(static_cast<qint32>(model.modules.size()));
+        model.devices.moduleCount.append(static_cast<qint32>(device.modules.size()));
+        model.devices.nodeIndex.append(nodeByDeviceId.value(refId, -1));
+
+        for (const ModuleType& module : device.modules) {
+            const qint32 moduleRow = static_cast<qint32>(model.modules.size());
+
+            model.modules.device.append(deviceRow);
+            model.modules.moduleId.append(strings.intern(module.moduleID));
+            model.modules.gsdRefId.append(strings.intern(module.gsdRefID));
+            model.modules.slotNumber.append(module.slotNumber);
+            model.modules.firstSubmodule.append(static_cast<qint32>(model.submodules.size()));
+            model.modules.submoduleCount.append(static_cast<qint32>(module.submodules.size()));
+
+            for (const SubmoduleType& submodule : module.submodules) {
+                model.submodules.module.append(moduleRow);
+                model.submodules.submoduleId.append(strings.intern(submodule.submoduleID));
+                model.submodules.gsdRefId.append(strings.intern(submodule.gsdRefID));
+                model.submodules.subslotNumber.append(submodule.subslotNumber);
+                model.submodules.io.append(PackedIOAddresses::fromIOAddresses(submodule.ioAddresses));
+            }
+        }
+    }
+
+    return model;
+}
+
+} // namespace PNConfigLib
@@ -0,0 +1,175 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#ifndef PROJECTMODEL_H
+#define PROJECTMODEL_H
+
+#include "../ConfigReader/ConfigurationSchema.h"
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+namespace PNConfigLib {
+
+/**
+ * @brief Index into a StringPool. Equal strings have equal ids.
+ */
+using StringId = qint32;
+
+/**
+ * @brief Interned strings of a ProjectModel; id 0 is always the empty string
+ */
+class StringPool {
+public:
+    StringPool();
+
+    StringId intern(const QString& value);
+
+    /**
+     * @brief Id of an already interned string, -1 if unknown
+     */
+    StringId find(const QString& value) const;
+
+    const QString& at(StringId id) const { return m_strings[id]; }
+    qsizetype size() const { return m_strings.size(); }
+
+private:
+    QVector<QString> m_strings;
+    QHash<QString, StringId> m_ids;
+};
+
+/**
+ * @brief IOAddresses in 12 bytes (start -1 = not configured)
+ *
+ * Lengths are stored as 16 bit; PROFINET IO data of a submodule is far below that.
+ */
+struct PackedIOAddresses {
+    qint32 inputStart = -1;
+    qint32 outputStart = -1;
+    quint16 inputLength = 0;
+    quint16 outputLength = 0;
+
+    bool hasInput() const { return inputStart >= 0 && inputLength > 0; }
+    bool hasOutput() const { return outputStart >= 0 && outputLength > 0; }
+
+    static PackedIOAddresses fromIOAddresses(const IOAddresses& addresses);
+};
+
+/**
+ * @brief Central device (controller) with interned strings
+ */
+struct CentralDeviceRow {
+    StringId deviceRefId = 0;
+    StringId interfaceRefId = 0;
+    StringId deviceName = 0;
+    StringId ipAddress = 0;
+    StringId subnetMask = 0;
+    StringId routerAddress = 0;
+    qint32 sendClock = 1;
+};
+
+/**
+ * @brief DecentralDevice columns; row i is Configuration::decentralDevices[i]
+ */
+struct DeviceTable {
+    QVector<StringId> deviceRefId;
+    QVector<StringId> interfaceRefId;
+    QVector<StringId> deviceName;
+    QVector<StringId> ipAddress;
+    QVector<StringId> subnetMask;
+    QVector<StringId> routerAddress;
+    QVector<qint32> deviceNumber;
+    QVector<qint32> firstModule;     // Rows [firstModule, firstModule + moduleCount) in ModuleTable
+    QVector<qint32> moduleCount;
+    QVector<qint32> nodeIndex;       // Row in NodeTable with DeviceID == deviceRefId, -1 if none
+
+    qsizetype size() const { return deviceRefId.size(); }
+    void reserve(qsizetype count);
+};
+
+/**
+ * @brief Module columns, grouped by device in device order
+ */
+struct ModuleTable {
+    QVector<qint32> device;
+    QVector<StringId> moduleId;
+    QVector<StringId> gsdRefId;
+    QVector<qint32> slotNumber;
+    QVector<qint32> firstSubmodule;  // Rows [firstSubmodule, firstSubmodule + submoduleCount) in SubmoduleTable
+    QVector<qint32> submoduleCount;
+
+    qsizetype size() const { return device.size(); }
+    void reserve(qsizetype count);
+};
+
+/**
+ * @brief Submodule columns, grouped by module in module order
+ */
+struct SubmoduleTable {
+    QVector<qint32> module;
+    QVector<StringId> submoduleId;
+    QVector<StringId> gsdRefId;
+    QVector<qint32> subslotNumber;
+    QVector<PackedIOAddresses> io;
+
+    qsizetype size() const { return module.size(); }
+    void reserve(qsizetype count);
+};
+
+/**
+ * @brief ListOfNodes DecentralDevice columns
+ */
+struct NodeTable {
+    QVector<StringId> deviceId;
+    QVector<StringId> deviceName;
+    QVector<StringId> gsdPath;
+    QVector<StringId> gsdRefId;
+
+    qsizetype size() const { return deviceId.size(); }
+    void reserve(qsizetype count);
+};
+
+/**
+ * @brief Flattened, structure-of-arrays view of a project
+ *
+ * Devices, modules and submodules live in contiguous column tables linked by
+ * parent/child row indices, all identifiers are interned into one StringPool
+ * and IO addresses are packed. Loops over every submodule of a large IO
+ * system touch a few dense arrays instead of chasing nested QVector/QString
+ * allocations, and identifier comparisons become integer comparisons.
+ *
+ * The model is a read-only snapshot built from the ConfigurationSchema
+ * structs; row order matches the source containers.
+ */
+class ProjectModel {
+public:
+    /**
+     * @brief Build from a Configuration only (node table stays empty)
+     */
+    static ProjectModel fromConfiguration(const Configuration& config);
+
+    /**
+     * @brief Build from a Configuration and its ListOfNodes, resolving device -> node rows
+     */
+    static ProjectModel fromConfiguration(const Configuration& config, const ListOfNodes& nodes);
+
+    const QString& str(StringId id) const { return strings.at(id); }
+
+    StringPool strings;
+
+    StringId configurationId = 0;
+    StringId listOfNodesRefId = 0;
+    StringId listOfNodesId = 0;     // From ListOfNodes, 0 if built without it
+    bool hasNodes = false;
+
+    CentralDeviceRow central;
+    DeviceTable devices;
+    ModuleTable modules;
+    SubmoduleTable submodules;
+    NodeTable nodes;
+};
+
+} // namespace PNConfigLib
+
+#endif // PROJECTMODEL_H
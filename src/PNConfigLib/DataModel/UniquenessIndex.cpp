@@ -0,0 +1,76 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include "UniquenessIndex.h"
+
+namespace PNConfigLib {
+
+// -----------------------------------------------------------------------------
+// UniquenessIndex
+// -----------------------------------------------------------------------------
+
+void UniquenessIndex::clear()
+{
+    m_names = Column<QString>();
+    m_ips = Column<quint32>();
+}
+
+void UniquenessIndex::setName(Owner owner, const QString& name)
+{
+    setNormalizedName(owner, NetworkIdentity::normalizeStationName(name));
+}
+
+void UniquenessIndex::setNormalizedName(Owner owner, const QString& key)
+{
+    if (key.isEmpty()) {
+        m_names.remove(owner);
+    } else {
+        m_names.set(owner, key);
+    }
+}
+
+void UniquenessIndex::setIpAddress(Owner owner, quint32 address)
+{
+    if (address == 0) {
+        m_ips.remove(owner);
+    } else {
+        m_ips.set(owner, address);
+    }
+}
+
+bool UniquenessIndex::setIpAddress(Owner owner, const QString& address)
+{
+    quint32 value = 0;
+    const bool ok = NetworkIdentity::parseIPv4(address, value);
+    setIpAddress(owner, ok ? value : 0);
+    return ok;
+}
+
+void UniquenessIndex::remove(Owner owner)
+{
+    m_names.remove(owner);
+    m_ips.remove(owner);
+}
+
+QList<UniquenessIndex::Owner> UniquenessIndex::ownersOfName(const QString& name) const
+{
+    return m_names.owners.value(NetworkIdentity::normalizeStationName(name));
+}
+
+QList<UniquenessIndex::Owner> UniquenessIndex::ownersOfIpAddress(quint32 address) const
+{
+    return m_ips.owners.value(address);
+}
+
+bool UniquenessIndex::isNameTaken(const QString& name, Owner except) const
+{
+    return m_names.taken(NetworkIdentity::normalizeStationName(name), except);
+}
+
+bool UniquenessIndex::isIpAddressTaken(quint32 address, Owner except) const
+{
+    return m_ips.taken(address, except);
+}
+
+} // namespace PNConfigLib
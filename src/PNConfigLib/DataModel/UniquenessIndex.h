@@ -0,0 +1,134 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#ifndef UNIQUENESSINDEX_H
+#define UNIQUENESSINDEX_H
+
+#include "NetworkIdentity.h"
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <algorithm>
+#include <limits>
+
+namespace PNConfigLib {
+
+/**
+ * @brief Hash index over device names and IPv4 addresses
+ *
+ * Owners are caller-defined ids (table rows, online device indices). Each
+ * owner has at most one value per column; lookups and duplicate checks are
+ * O(1) per value instead of comparing every pair of devices. Names are
+ * indexed normalized, IPs as integers; the unset values (empty name and
+ * 0.0.0.0) are not indexed.
+ */
+class UniquenessIndex {
+public:
+    using Owner = qint64;
+
+    static constexpr Owner NoOwner = std::numeric_limits<Owner>::min();
+
+    void clear();
+
+    /**
+     * @brief Set or replace an owner's value; an unset value removes it
+     */
+    void setName(Owner owner, const QString& name);
+    void setIpAddress(Owner owner, quint32 address);
+
+    /**
+     * @brief setName() for a name already passed through NetworkIdentity::normalizeStationName()
+     */
+    void setNormalizedName(Owner owner, const QString& key);
+
+    /**
+     * @brief Parse and set; returns false (and removes the owner's value) if unparsable
+     */
+    bool setIpAddress(Owner owner, const QString& address);
+
+    /**
+     * @brief Remove all values of an owner
+     */
+    void remove(Owner owner);
+
+    /**
+     * @brief Owners holding the value, ascending
+     */
+    QList<Owner> ownersOfName(const QString& name) const;
+    QList<Owner> ownersOfIpAddress(quint32 address) const;
+
+    /**
+     * @brief True if an owner other than except holds the value
+     */
+    bool isNameTaken(const QString& name, Owner except = NoOwner) const;
+    bool isIpAddressTaken(quint32 address, Owner except = NoOwner) const;
+
+    /**
+     * @brief Current values of an owner (normalized name / 0 if unset)
+     */
+    QString nameOf(Owner owner) const { return m_names.keyOf.value(owner); }
+    quint32 ipAddressOf(Owner owner) const { return m_ips.keyOf.value(owner, 0); }
+
+    /**
+     * @brief Values held by more than one owner, with their owners
+     */
+    QHash<QString, QList<Owner>> duplicateNames() const { return m_names.duplicates(); }
+    QHash<quint32, QList<Owner>> duplicateIpAddresses() const { return m_ips.duplicates(); }
+
+private:
+    template<typename K>
+    struct Column {
+        QHash<K, QList<Owner>> owners;
+        QHash<Owner, K> keyOf;
+
+        void set(Owner owner, const K& key)
+        {
+            remove(owner);
+            QList<Owner>& list = owners[key];
+            list.insert(std::lower_bound(list.begin(), list.end(), owner) - list.begin(), owner);
+            keyOf.insert(owner, key);
+        }
+
+        void remove(Owner owner)
+        {
+            auto it = keyOf.find(owner);
+            if (it == keyOf.end()) {
+                return;
+            }
+            auto listIt = owners.find(it.value());
+            listIt.value().removeOne(owner);
+            if (listIt.value().isEmpty()) {
+                owners.erase(listIt);
+            }
+            keyOf.erase(it);
+        }
+
+        bool taken(const K& key, Owner except) const
+        {
+            auto it = owners.constFind(key);
+            if (it == owners.constEnd()) {
+                return false;
+            }
+            return it.value().size() > 1 || it.value().first() != except;
+        }
+
+        QHash<K, QList<Owner>> duplicates() const
+        {
+            QHash<K, QList<Owner>> result;
+            for (auto it = owners.constBegin(); it != owners.constEnd(); ++it) {
+                if (it.value().size() > 1) {
+                    result.insert(it.key(), it.value());
+                }
+            }
+            return result;
+        }
+    };
+
+    Column<QString> m_names;
+    Column<quint32> m_ips;
+};
+
+} // namespace PNConfigLib
+
+#endif // UNIQUENESSINDEX_H
@@ -0,0 +1,237 @@
+#include "DeviceEmulator.h"
+#include "../Instrumentation/Instrumentation.h"
+#include "../Network/DcpScanner.h"
+#include <QDebug>
+#include <QMutexLocker>
+#include <algorithm>
+
+namespace PNConfigLib {
+
+// Upper bound for a single wait so stopEmulation() and new deadlines are noticed
+static const int MaxWaitMs = 50;
+
+// Locally administered OUI used for emulated devices ("PN")
+static const quint64 EmulatorMacBase = 0x02504E000000ULL;
+
+DeviceEmulator::DeviceEmulator(QObject *parent) : QThread(parent) {}
+
+DeviceEmulator::~DeviceEmulator() {
+    stopEmulation();
+}
+
+void DeviceEmulator::addDevice(std::shared_ptr<const DeviceProfile> profile, quint64 mac, const QString &stationName,
+                               quint32 ip, quint32 mask, quint32 gw) {
+    if (isRunning() || m_byMac.contains(mac)) return;
+    m_devices.push_back(std::make_unique<VirtualDevice>(this, std::move(profile), mac, stationName, ip, mask, gw));
+    m_byMac.insert(mac, m_devices.back().get());
+}
+
+int DeviceEmulator::addDevices(const DeviceProfile &profile, int count, const QString &namePrefix,
+                               quint32 firstIp, quint32 mask) {
+    auto shared = std::make_shared<const DeviceProfile>(profile);
+    const int before = deviceCount();
+    for (int i = 0; i < count; ++i) {
+        const quint64 mac = EmulatorMacBase + quint64(before + i + 1);
+        const quint32 ip = firstIp != 0 ? firstIp + quint32(i) : 0;
+        const quint32 gw = firstIp != 0 ? ((firstIp & mask) | 1) : 0;
+        addDevice(shared, mac, QString("%1-%2").arg(namePrefix).arg(before + i + 1), ip, ip != 0 ? mask : 0, gw);
+    }
+    return deviceCount() - before;
+}
+
+bool DeviceEmulator::startEmulation(const QString &interfaceName) {
+    if (isRunning()) return false;
+
+    m_transport = PacketTransport::create(m_backend);
+    if (!m_transport->open(interfaceName)) {
+        m_lastError = m_transport->lastError();
+        m_transport.reset();
+        return false;
+    }
+
+    {
+        QMutexLocker locker(&m_statsMutex);
+        for (QVector<qint64> &samples : m_samples) samples.clear();
+        m_events.clear();
+    }
+    m_framesReceived = 0;
+    m_framesSent = 0;
+    m_runningDevices = 0;
+    m_clock.start();
+
+    qDebug() << "Emulating" << deviceCount() << "PROFINET devices on" << interfaceName;
+    start();
+    return true;
+}
+
+void DeviceEmulator::stopEmulation() {
+    if (isRunning()) {
+        requestInterruption();
+        if (m_transport) m_transport->interrupt();
+        wait();
+    }
+    if (m_transport) {
+        m_transport->close();
+        m_transport.reset();
+    }
+}
+
+void DeviceEmulator::run() {
+    const PacketTransport::FrameHandler handler = [this](const uint8_t *data, int len) {
+        handleFrame(data, len);
+    };
+
+    while (!isInterruptionRequested()) {
+        // Sleep in the transport until a frame arrives or the earliest device deadline
+        qint64 now = m_clock.nsecsElapsed();
+        qint64 deadline = -1;
+        for (const auto &device : m_devices) {
+            const qint64 due = device->nextDeadlineNs();
+            if (due >= 0 && (deadline < 0 || due < deadline)) deadline = due;
+        }
+        int waitMs = MaxWaitMs;
+        if (deadline >= 0) {
+            waitMs = (int)qBound<qint64>(0, (deadline - now + 999999) / 1000000, MaxWaitMs);
+        }
+
+        if (m_transport->dispatch(handler, waitMs) < 0) {
+            qCritical() << "Emulator receive failed:" << m_transport->lastError();
+            break;
+        }
+
+        now = m_clock.nsecsElapsed();
+        for (const auto &device : m_devices) {
+            device->poll(now);
+        }
+        m_transport->flush();
+    }
+}
+
+void DeviceEmulator::handleFrame(const uint8_t *data, int len) {
+    if (len < 14) return;
+    m_framesReceived.fetch_add(1, std::memory_order_relaxed);
+
+    // Frames sent by our own devices come back on most capture backends
+    if (m_byMac.contains(DcpScanner::packMac(data + 6))) return;
+
+    const qint64 now = m_clock.nsecsElapsed();
+    if (data[0] & 0x01) {
+        for (const auto &device : m_devices) {
+            device->handleFrame(data, len, now);
+        }
+    } else if (VirtualDevice *device = m_byMac.value(DcpScanner::packMac(data), nullptr)) {
+        device->handleFrame(data, len, now);
+    }
+}
+
+void DeviceEmulator::transmit(const uint8_t *frame, int length) {
+    if (!m_transport->queue(frame, length)) {
+        countEvent("transmit.failed");
+        return;
+    }
+    m_framesSent.fetch_add(1, std::memory_order_relaxed);
+}
+
+const char *DeviceEmulator::phaseName(EmulatorPhase phase) {
+    switch (phase) {
+        case EmulatorPhase::DcpIdentify: return "emulator.dcp.identify";
+        case EmulatorPhase::DcpSet: return "emulator.dcp.set";
+        case EmulatorPhase::RpcConnect: return "emulator.rpc.connect";
+        case EmulatorPhase::ControllerParamEnd: return "emulator.controller.paramEnd";
+        case EmulatorPhase::ApplicationReady: return "emulator.rpc.applicationReady";
+        case EmulatorPhase::FirstCycle: return "emulator.cyclic.first";
+        case EmulatorPhase::Startup: return "emulator.startup";
+        case EmulatorPhase::CycleInterval: return "emulator.cyclic.interval";
+        case EmulatorPhase::Count: break;
+    }
+    return "emulator.unknown";
+}
+
+void DeviceEmulator::recordPhase(EmulatorPhase phase, qint64 durationNs) {
+    PN_HISTOGRAM_RECORD(phaseName(phase), durationNs);
+    QMutexLocker locker(&m_statsMutex);
+    QVector<qint64> &samples = m_samples[(int)phase];
+    if (samples.size() < MaxSamplesPerPhase) {
+        samples.append(durationNs);
+    } else {
+        m_events[QString("samplesDropped")]++;
+    }
+}
+
+void DeviceEmulator::countEvent(const char *name) {
+    QMutexLocker locker(&m_statsMutex);
+    m_events[QString::fromLatin1(name)]++;
+}
+
+qint64 DeviceEmulator::eventCount(const QString &name) const {
+    QMutexLocker locker(&m_statsMutex);
+    return m_events.value(name, 0);
+}
+
+void DeviceEmulator::deviceRunning(VirtualDevice *device) {
+    const int running = m_runningDevices.fetch_add(1) + 1;
+    emit deviceRunningChanged(device->stationName(), running);
+}
+
+PhaseSummary DeviceEmulator::phaseSummary(EmulatorPhase phase) const {
+    QVector<qint64> samples;
+    {
+        QMutexLocker locker(&m_statsMutex);
+        samples = m_samples[(int)phase];
+    }
+
+    PhaseSummary summary;
+    if (samples.isEmpty()) return summary;
+    std::sort(samples.begin(), samples.end());
+
+    auto percentile = [&samples](double p) {
+        const int index = qBound(0, int(p * (samples.size() - 1) + 0.5), int(samples.size()) - 1);
+        return samples[index] / 1e6;
+    };
+    double sum = 0;
+    for (qint64 value : samples) sum += value;
+
+    summary.count = samples.size();
+    summary.minMs = samples.first() / 1e6;
+    summary.maxMs = samples.last() / 1e6;
+    summary.meanMs = sum / samples.size() / 1e6;
+    summary.p50Ms = percentile(0.50);
+    summary.p90Ms = percentile(0.90);
+    summary.p99Ms = percentile(0.99);
+    return summary;
+}
+
+QJsonObject DeviceEmulator::statsJson() const {
+    QJsonObject phases;
+    for (int i = 0; i < (int)EmulatorPhase::Count; ++i) {
+        const PhaseSummary summary = phaseSummary(EmulatorPhase(i));
+        QJsonObject entry;
+        entry["count"] = summary.count;
+        entry["minMs"] = summary.minMs;
+        entry["meanMs"] = summary.meanMs;
+        entry["p50Ms"] = summary.p50Ms;
+        entry["p90Ms"] = summary.p90Ms;
+        entry["p99Ms"] = summary.p99Ms;
+        entry["maxMs"] = summary.maxMs;
+        phases[QString::fromLatin1(phaseName(EmulatorPhase(i)))] = entry;
+    }
+
+    QJsonObject events;
+    {
+        QMutexLocker locker(&m_statsMutex);
+        for (auto it = m_events.constBegin(); it != m_events.constEnd(); ++it) {
+            events[it.key()] = it.value();
+        }
+    }
+
+    QJsonObject stats;
+    stats["devices"] = deviceCount();
+    stats["runningDevices"] = runningDeviceCount();
+    stats["framesReceived"] = (qint64)m_framesReceived.load();
+    stats["framesSent"] = (qint64)m_framesSent.load();
+    stats["phases"] = phases;
+    stats["events"] = events;
+    return stats;
+}
+
+} // namespace PNConfigLib
@@ -0,0 +1,128 @@
+#ifndef DEVICEEMULATOR_H
+#define DEVICEEMULATOR_H
+
+#include <QThread>
+#include <QMutex>
+#include <QHash>
+#include <QMap>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "VirtualDevice.h"
+#include "../Network/PacketTransport.h"
+
+namespace PNConfigLib {
+
+/**
+ * @brief Latency summary of one protocol phase across all emulated devices, in milliseconds
+ */
+struct PhaseSummary {
+    int count = 0;
+    double minMs = 0;
+    double meanMs = 0;
+    double p50Ms = 0;
+    double p90Ms = 0;
+    double p99Ms = 0;
+    double maxMs = 0;
+};
+
+/**
+ * @brief Hosts many simulated IO devices on one interface for load-testing the controller side.
+ *
+ * All devices share a single PacketTransport and are served by one thread:
+ * frames are routed to devices by destination MAC (multicasts go to all of
+ * them), scheduled transmissions (delayed Identify responses,
+ * ApplicationReady, input frames) are polled between receives, and all
+ * frames sent in one pass are flushed together. Each device records the
+ * latency of the protocol phases it sees; statistics can be read while the
+ * emulator runs.
+ */
+class DeviceEmulator : public QThread {
+    Q_OBJECT
+public:
+    explicit DeviceEmulator(QObject *parent = nullptr);
+    ~DeviceEmulator() override;
+
+    void setPacketBackend(PacketBackend backend) { m_backend = backend; }
+
+    /**
+     * @brief Add one device. Only before startEmulation().
+     * @param ip IPv4 address in host byte order, 0 for a device that still has to be commissioned
+     */
+    void addDevice(std::shared_ptr<const DeviceProfile> profile, quint64 mac, const QString &stationName,
+                   quint32 ip = 0, quint32 mask = 0, quint32 gw = 0);
+
+    /**
+     * @brief Add count devices named "<namePrefix>-<n>" with consecutive locally administered MACs.
+     * @param firstIp Address of the first device, following devices count up; 0 leaves them unaddressed
+     * @return Number of devices added
+     */
+    int addDevices(const DeviceProfile &profile, int count, const QString &namePrefix,
+                   quint32 firstIp = 0, quint32 mask = 0xFFFFFF00);
+
+    int deviceCount() const { return (int)m_devices.size(); }
+    const VirtualDevice *device(int index) const { return m_devices[index].get(); }
+    int runningDeviceCount() const { return m_runningDevices.load(); }
+
+    /**
+     * @brief Open the interface and start serving the devices on the emulator thread
+     */
+    bool startEmulation(const QString &interfaceName);
+    void stopEmulation();
+    QString lastError() const { return m_lastError; }
+
+    static const char *phaseName(EmulatorPhase phase);
+    PhaseSummary phaseSummary(EmulatorPhase phase) const;
+    qint64 eventCount(const QString &name) const;
+
+    /**
+     * @brief Phase summaries, event counters and frame counts
+     */
+    QJsonObject statsJson() const;
+
+    // Called by VirtualDevice on the emulator thread
+    void transmit(const uint8_t *frame, int length);
+    void recordPhase(EmulatorPhase phase, qint64 durationNs);
+    void countEvent(const char *name);
+    void deviceRunning(VirtualDevice *device);
+    qint64 elapsedNs() const { return m_clock.nsecsElapsed(); }
+
+    /// Samples kept per phase; later samples only update the event counters
+    static constexpr int MaxSamplesPerPhase = 1000000;
+
+signals:
+    /**
+     * @brief A device received its first output frame after ApplicationReady
+     */
+    void deviceRunningChanged(const QString &stationName, int runningDevices);
+
+protected:
+    void run() override;
+
+private:
+    void handleFrame(const uint8_t *data, int len);
+
+    PacketBackend m_backend = PacketBackend::Default;
+    std::unique_ptr<PacketTransport> m_transport;
+    QString m_lastError;
+
+    std::vector<std::unique_ptr<VirtualDevice>> m_devices;
+    QHash<quint64, VirtualDevice*> m_byMac;
+    QElapsedTimer m_clock;
+
+    mutable QMutex m_statsMutex;
+    QVector<qint64> m_samples[(int)EmulatorPhase::Count];
+    QMap<QString, qint64> m_events;
+    std::atomic<quint64> m_framesReceived{0};
+    std::atomic<quint64> m_framesSent{0};
+    std::atomic<int> m_runningDevices{0};
+};
+
+} // namespace PNConfigLib
+
+#endif // DEVICEEMULATOR_H
@@ -0,0 +1,685 @@
+#include "VirtualDevice.h"
+#include "DeviceEmulator.h"
+#include "../Network/DcpScanner.h"
+#include <QDebug>
+#include <QtEndian>
+#include <cstring>
+
+namespace PNConfigLib {
+
+// A DCP Set more than this after the previous one starts a new commissioning run
+static const qint64 DcpSetSessionGapNs = 10000000000LL;
+// Devices send ApplicationReady shortly after confirming ParamEnd
+static const qint64 AppReadyDelayNs = 10000000LL;
+static const qint64 AppReadyRetryNs = 1000000000LL;
+static const int AppReadyMaxAttempts = 3;
+// Output frames arriving later than this many cycles count as late
+static const int LateOutputCycles = 3;
+
+static const char *EmulatedPortId = "port-001";
+
+static const uint16_t PnioPort = 0x8894;
+static const int RpcHeaderLength = 80;
+static const int NdrHeaderLength = 20;
+
+// CM controller interface (DEA00002-6C97-11D1-8271-00A02442DF7D), target of ApplicationReady
+static const uint8_t ControllerInterfaceUuid[16] = {
+    0xDE, 0xA0, 0x00, 0x02, 0x6C, 0x97, 0x11, 0xD1, 0x82, 0x71, 0x00, 0xA0, 0x24, 0x42, 0xDF, 0x7D
+};
+
+static inline uint16_t get16(const uint8_t *p) { return qFromBigEndian<uint16_t>(p); }
+static inline uint32_t get32(const uint8_t *p) { return qFromBigEndian<uint32_t>(p); }
+
+// RPC header and NDR fields follow the sender's data representation (drep byte 0, bit 4)
+static inline uint16_t rpc16(const uint8_t *p, bool little) {
+    return little ? qFromLittleEndian<uint16_t>(p) : qFromBigEndian<uint16_t>(p);
+}
+static inline uint32_t rpc32(const uint8_t *p, bool little) {
+    return little ? qFromLittleEndian<uint32_t>(p) : qFromBigEndian<uint32_t>(p);
+}
+static inline void putRpc16(uint8_t *p, uint16_t v, bool little) {
+    if (little) qToLittleEndian<uint16_t>(v, p); else qToBigEndian<uint16_t>(v, p);
+}
+static inline void putRpc32(uint8_t *p, uint32_t v, bool little) {
+    if (little) qToLittleEndian<uint32_t>(v, p); else qToBigEndian<uint32_t>(v, p);
+}
+
+static void append16(QByteArray &out, uint16_t v) {
+    out.append(char(v >> 8));
+    out.append(char(v & 0xFF));
+}
+
+static void append32(QByteArray &out, uint32_t v) {
+    append16(out, uint16_t(v >> 16));
+    append16(out, uint16_t(v & 0xFFFF));
+}
+
+// DCP block with BlockInfo/BlockQualifier already part of value, padded to an even length
+static void appendDcpBlock(QByteArray &out, uint8_t option, uint8_t suboption, const QByteArray &value) {
+    out.append(char(option));
+    out.append(char(suboption));
+    append16(out, uint16_t(value.size()));
+    out.append(value);
+    if (value.size() % 2 != 0) out.append('\0');
+}
+
+static uint16_t ipChecksum(const uint8_t *header, int len) {
+    uint32_t sum = 0;
+    for (int i = 0; i + 1 < len; i += 2) sum += (header[i] << 8) | header[i + 1];
+    while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+    return ~uint16_t(sum);
+}
+
+static void unpackMac(quint64 mac, uint8_t *out) {
+    for (int i = 5; i >= 0; --i) {
+        out[i] = uint8_t(mac & 0xFF);
+        mac >>= 8;
+    }
+}
+
+// Ethernet + IPv4 + UDP headers for a PNIO RPC datagram; payload follows at offset 42
+static QByteArray udpFrame(const uint8_t *destMac, const uint8_t *srcMac, quint32 srcIp, quint32 destIp,
+                           uint16_t srcPort, uint16_t destPort, uint16_t identification, int payloadLength) {
+    const int ipLength = 20 + 8 + payloadLength;
+    QByteArray frame(qMax(60, 14 + ipLength), '\0');
+    uint8_t *p = reinterpret_cast<uint8_t*>(frame.data());
+    memcpy(p, destMac, 6);
+    memcpy(p + 6, srcMac, 6);
+    p[12] = 0x08; p[13] = 0x00;
+
+    uint8_t *ip = p + 14;
+    ip[0] = 0x45;
+    qToBigEndian<uint16_t>(uint16_t(ipLength), ip + 2);
+    qToBigEndian<uint16_t>(identification, ip + 4);
+    ip[8] = 64;     // TTL
+    ip[9] = 0x11;   // UDP
+    qToBigEndian<uint32_t>(srcIp, ip + 12);
+    qToBigEndian<uint32_t>(destIp, ip + 16);
+    qToBigEndian<uint16_t>(ipChecksum(ip, 20), ip + 10);
+
+    uint8_t *udp = ip + 20;
+    qToBigEndian<uint16_t>(srcPort, udp);
+    qToBigEndian<uint16_t>(destPort, udp + 2);
+    qToBigEndian<uint16_t>(uint16_t(8 + payloadLength), udp + 4);
+    return frame;
+}
+
+DeviceProfile DeviceProfile::fromGsdml(const QString &gsdmlPath) {
+    DeviceProfile profile;
+    const GsdmlInfo info = GsdmlParser::parseGSDML(gsdmlPath);
+    if (!info.deviceName.isEmpty()) {
+        profile.typeOfStation = info.deviceName;
+    } else if (!info.productFamily.isEmpty()) {
+        profile.typeOfStation = info.productFamily;
+    }
+    if (info.vendorId != 0) profile.vendorId = uint16_t(info.vendorId);
+    if (info.deviceId != 0) profile.deviceId = uint16_t(info.deviceId);
+    profile.dapModuleId = info.dapModuleId;
+    profile.modules = info.modules;
+    return profile;
+}
+
+bool DeviceProfile::hasModule(uint32_t moduleIdentNumber) const {
+    if (modules.isEmpty() || moduleIdentNumber == dapModuleId) return true;
+    for (const ModuleInfo &module : modules) {
+        if (module.moduleIdentNumber == moduleIdentNumber) return true;
+    }
+    return false;
+}
+
+VirtualDevice::VirtualDevice(DeviceEmulator *host, std::shared_ptr<const DeviceProfile> profile, quint64 mac,
+                             const QString &stationName, quint32 ip, quint32 mask, quint32 gw)
+    : m_host(host), m_profile(std::move(profile)), m_mac(mac), m_stationName(stationName),
+      m_ip(ip), m_mask(mask), m_gw(gw) {
+    unpackMac(mac, m_macBytes);
+    memset(m_arUuid, 0, sizeof(m_arUuid));
+    memset(m_controllerMac, 0, sizeof(m_controllerMac));
+    memset(m_appReadyActivity, 0, sizeof(m_appReadyActivity));
+}
+
+void VirtualDevice::transmit(const QByteArray &frame) {
+    m_host->transmit(reinterpret_cast<const uint8_t*>(frame.constData()), frame.size());
+}
+
+void VirtualDevice::handleFrame(const uint8_t *data, int len, qint64 nowNs) {
+    if (len < 14) return;
+    uint16_t type = get16(data + 12);
+    int offset = 14;
+    if (type == 0x8100 && len >= 18) {
+        type = get16(data + 16);
+        offset = 18;
+    }
+
+    switch (type) {
+        case 0x8892: {
+            if (len < offset + 2) return;
+            const uint16_t frameId = get16(data + offset);
+            if (frameId >= 0xFEFC) {
+                handleDcp(data, len, offset, nowNs);
+            } else if (frameId == m_outputFrameId && memcmp(data, m_macBytes, 6) == 0) {
+                handleOutputFrame(data, len, offset, nowNs);
+            }
+            break;
+        }
+        case 0x0806:
+            handleArp(data, len, offset);
+            break;
+        case 0x0800:
+            handleUdp(data, len, offset, nowNs);
+            break;
+        default:
+            break;
+    }
+}
+
+void VirtualDevice::handleDcp(const uint8_t *data, int len, int offset, qint64 nowNs) {
+    if (len < offset + (int)sizeof(DcpHeader)) return;
+    const uint8_t *dcp = data + offset;
+    const uint16_t frameId = get16(dcp);
+    const uint8_t serviceId = dcp[2];
+    const uint8_t serviceType = dcp[3];
+
+    // DcpFrameBuilder marks requests with ServiceType 0x01, other controllers
+    // send 0x00; accept both. Responses use FrameID 0xFEFF and never get here.
+    if (frameId == 0xFEFE && serviceId == 0x05 && (serviceType == 0x00 || serviceType == 0x01)) {
+        handleIdentify(data + 6, dcp, len - offset, nowNs);
+    } else if (frameId == 0xFEFD && serviceId == 0x04 && memcmp(data, m_macBytes, 6) == 0) {
+        handleSet(data + 6, dcp, len - offset, nowNs);
+    }
+}
+
+void VirtualDevice::handleIdentify(const uint8_t *src, const uint8_t *dcp, int dcpLen, qint64 nowNs) {
+    const uint32_t xid = get32(dcp + 4);
+    const uint16_t responseDelay = get16(dcp + 8);
+    const int dataLen = qMin<int>(get16(dcp + 10), dcpLen - (int)sizeof(DcpHeader));
+
+    // Identify request blocks carry the filter value without BlockQualifier
+    const QByteArray name = m_stationName.toUtf8();
+    const QByteArray type = m_profile->typeOfStation.toUtf8();
+    const uint8_t *block = dcp + sizeof(DcpHeader);
+    int remaining = dataLen;
+    while (remaining >= 4) {
+        const uint8_t option = block[0];
+        const uint8_t suboption = block[1];
+        const int blockLen = get16(block + 2);
+        if (4 + blockLen > remaining) return;
+        const uint8_t *value = block + 4;
+
+        bool match = true;
+        if (option == 0xFF && suboption == 0xFF) {
+            match = true;
+        } else if (option == 0x02 && suboption == 0x02) {
+            match = blockLen == name.size() && memcmp(value, name.constData(), blockLen) == 0;
+        } else if (option == 0x02 && suboption == 0x01) {
+            match = blockLen == type.size() && memcmp(value, type.constData(), blockLen) == 0;
+        } else if (option == 0x02 && suboption == 0x03) {
+            match = blockLen == 4 && get16(value) == m_profile->vendorId && get16(value + 2) == m_profile->deviceId;
+        } else if (option == 0x02 && suboption == 0x06) {
+            // Single-port device: AliasName is "<port id>.<name of station>"
+            QByteArray alias(EmulatedPortId);
+            alias.append('.').append(name);
+            match = blockLen == alias.size() && memcmp(value, alias.constData(), blockLen) == 0;
+        } else if (option == 0x01 && suboption == 0x02) {
+            match = blockLen >= 4 && get32(value) == m_ip;
+        } else {
+            match = false;   // Filters we cannot evaluate never match
+        }
+        if (!match) return;
+
+        const int advance = 4 + blockLen + (blockLen % 2);
+        block += advance;
+        remaining -= advance;
+    }
+
+    // Spread responses over the ResponseDelay window like real stations do; the
+    // slot is derived from the MAC so repeated runs produce the same timing
+    qint64 delayNs = 0;
+    if (responseDelay > 1) {
+        const quint64 slot = (m_mac * 2654435761ULL >> 16) % responseDelay;
+        delayNs = qint64(slot) * 10000000LL;
+    }
+    m_identifyResponse = buildIdentifyResponse(src, xid);
+    m_identifyRequestNs = nowNs;
+    m_identifyDueNs = nowNs + delayNs;
+}
+
+QByteArray VirtualDevice::buildIdentifyResponse(const uint8_t *dest, uint32_t xid) const {
+    QByteArray blocks;
+    const QByteArray zeroInfo(2, '\0');
+
+    appendDcpBlock(blocks, 0x02, 0x02, zeroInfo + m_stationName.toUtf8());
+    appendDcpBlock(blocks, 0x02, 0x01, zeroInfo + m_profile->typeOfStation.toUtf8());
+
+    QByteArray deviceId = zeroInfo;
+    append16(deviceId, m_profile->vendorId);
+    append16(deviceId, m_profile->deviceId);
+    appendDcpBlock(blocks, 0x02, 0x03, deviceId);
+
+    QByteArray role = zeroInfo;
+    role.append(char(0x01));   // IO device
+    role.append('\0');
+    appendDcpBlock(blocks, 0x02, 0x04, role);
+
+    QByteArray options = zeroInfo;
+    const uint8_t supported[][2] = { {0x01, 0x02}, {0x02, 0x01}, {0x02, 0x02}, {0x02, 0x03},
+                                     {0x02, 0x04}, {0x05, 0x03}, {0x05, 0x06} };
+    for (const auto &option : supported) {
+        options.append(char(option[0]));
+        options.append(char(option[1]));
+    }
+    appendDcpBlock(blocks, 0x02, 0x05, options);
+
+    QByteArray ipSuite;
+    append16(ipSuite, m_ip != 0 ? 0x0001 : 0x0000);   // BlockInfo: IP set
+    append32(ipSuite, m_ip);
+    append32(ipSuite, m_mask);
+    append32(ipSuite, m_gw);
+    appendDcpBlock(blocks, 0x01, 0x02, ipSuite);
+
+    QByteArray frame(qMax(60, int(14 + sizeof(DcpHeader) + blocks.size())), '\0');
+    uint8_t *p = reinterpret_cast<uint8_t*>(frame.data());
+    memcpy(p, dest, 6);
+    memcpy(p + 6, m_macBytes, 6);
+    p[12] = 0x88; p[13] = 0x92;
+    DcpHeader *dcp = reinterpret_cast<DcpHeader*>(p + 14);
+    dcp->frameId = qToBigEndian<uint16_t>(0xFEFF);
+    dcp->serviceId = 0x05;
+    dcp->serviceType = 0x01;
+    dcp->xid = qToBigEndian<uint32_t>(xid);
+    dcp->responseDelay = 0;
+    dcp->dcpDataLength = qToBigEndian<uint16_t>(uint16_t(blocks.size()));
+    memcpy(p + 14 + sizeof(DcpHeader), blocks.constData(), blocks.size());
+    return frame;
+}
+
+void VirtualDevice::handleSet(const uint8_t *src, const uint8_t *dcp, int dcpLen, qint64 nowNs) {
+    const uint32_t xid = get32(dcp + 4);
+    const int dataLen = qMin<int>(get16(dcp + 10), dcpLen - (int)sizeof(DcpHeader));
+
+    if (m_lastSetNs < 0 || nowNs - m_lastSetNs > DcpSetSessionGapNs) {
+        m_firstSetNs = nowNs;
+    }
+    m_lastSetNs = nowNs;
+
+    // One Control/Response block (option, suboption, error) per Set block
+    QByteArray results;
+    const uint8_t *block = dcp + sizeof(DcpHeader);
+    int remaining = dataLen;
+    while (remaining >= 4) {
+        const uint8_t option = block[0];
+        const uint8_t suboption = block[1];
+        const int blockLen = get16(block + 2);
+        if (4 + blockLen > remaining || blockLen < 2) break;
+        const uint8_t *value = block + 4 + 2;   // Skip BlockQualifier
+        const int valueLen = blockLen - 2;
+
+        uint8_t error = 0x00;
+        if (option == 0x01 && suboption == 0x02 && valueLen >= 12) {
+            m_ip = get32(value);
+            m_mask = get32(value + 4);
+            m_gw = get32(value + 8);
+        } else if (option == 0x02 && suboption == 0x02) {
+            int nameLen = valueLen;
+            while (nameLen > 0 && value[nameLen - 1] == '\0') --nameLen;
+            m_stationName = QString::fromUtf8(reinterpret_cast<const char*>(value), nameLen);
+        } else if (option == 0x05 && suboption == 0x06) {
+            // Reset to factory: forget name, address and any AR
+            m_stationName.clear();
+            m_ip = m_mask = m_gw = 0;
+            m_arState = ArIdle;
+            m_nextInputNs = -1;
+            m_appReadyDueNs = -1;
+        } else if (option == 0x05 && (suboption == 0x01 || suboption == 0x02 || suboption == 0x03)) {
+            // Start/End transaction, Signal: nothing to emulate
+        } else {
+            error = 0x01;   // Option not supported
+        }
+
+        QByteArray result;
+        result.append(char(option));
+        result.append(char(suboption));
+        result.append(char(error));
+        appendDcpBlock(results, 0x05, 0x04, result);
+
+        const int advance = 4 + blockLen + (blockLen % 2);
+        block += advance;
+        remaining -= advance;
+    }
+    if (results.isEmpty()) return;
+
+    QByteArray frame(qMax(60, int(14 + sizeof(DcpHeader) + results.size())), '\0');
+    uint8_t *p = reinterpret_cast<uint8_t*>(frame.data());
+    memcpy(p, src, 6);
+    memcpy(p + 6, m_macBytes, 6);
+    p[12] = 0x88; p[13] = 0x92;
+    DcpHeader *header = reinterpret_cast<DcpHeader*>(p + 14);
+    header->frameId = qToBigEndian<uint16_t>(0xFEFD);
+    header->serviceId = 0x04;
+    header->serviceType = 0x01;   // Response, success
+    header->xid = qToBigEndian<uint32_t>(xid);
+    header->responseDelay = 0;
+    header->dcpDataLength = qToBigEndian<uint16_t>(uint16_t(results.size()));
+    memcpy(p + 14 + sizeof(DcpHeader), results.constData(), results.size());
+    transmit(frame);
+}
+
+void VirtualDevice::handleArp(const uint8_t *data, int len, int offset) {
+    if (m_ip == 0 || len < offset + 28) return;
+    const uint8_t *arp = data + offset;
+    if (get16(arp + 6) != 1 || get32(arp + 24) != m_ip) return;   // Request for our address only
+
+    QByteArray frame(60, '\0');
+    uint8_t *p = reinterpret_cast<uint8_t*>(frame.data());
+    memcpy(p, data + 6, 6);
+    memcpy(p + 6, m_macBytes, 6);
+    p[12] = 0x08; p[13] = 0x06;
+    uint8_t *reply = p + 14;
+    memcpy(reply, arp, 6);           // HTYPE, PTYPE, HLEN, PLEN
+    reply[6] = 0x00; reply[7] = 0x02;
+    memcpy(reply + 8, m_macBytes, 6);
+    qToBigEndian<uint32_t>(m_ip, reply + 14);
+    memcpy(reply + 18, arp + 8, 10); // Requester MAC and IP
+    transmit(frame);
+}
+
+void VirtualDevice::handleUdp(const uint8_t *data, int len, int offset, qint64 nowNs) {
+    if (m_ip == 0 || len < offset + 20) return;
+    const uint8_t *ip = data + offset;
+    const int ihl = (ip[0] & 0x0F) * 4;
+    if (ip[9] != 0x11 || ihl < 20 || get32(ip + 16) != m_ip) return;
+    if (len < offset + ihl + 8 + RpcHeaderLength) return;
+
+    const uint8_t *udp = ip + ihl;
+    if (get16(udp + 2) != PnioPort) return;
+
+    const uint8_t *rpc = udp + 8;
+    const bool little = (rpc[4] & 0x10) != 0;
+    const uint8_t pduType = rpc[1];
+    const uint16_t opnum = rpc16(rpc + 68, little);
+    const uint8_t *body = rpc + RpcHeaderLength;
+    const int bodyLen = qMin<int>(rpc16(rpc + 74, little), len - int(body - data));
+
+    if (pduType == 0x00) {
+        if (opnum == 0) {
+            handleConnect(data, ip, rpc, body, bodyLen, nowNs);
+        } else if (opnum == 4) {
+            handleControl(data, ip, rpc, body, bodyLen, nowNs);
+        }
+    } else if (pduType == 0x02 && m_arState == ArAppReadySent &&
+               memcmp(rpc + 40, m_appReadyActivity, 16) == 0) {
+        // Controller confirmed ApplicationReady; cyclic exchange starts now
+        m_arState = ArRunning;
+        m_appReadyDueNs = -1;
+        m_appReadyConfirmedNs = nowNs;
+        m_host->recordPhase(EmulatorPhase::ApplicationReady, nowNs - m_appReadySentNs);
+        m_lastOutputNs = -1;
+        m_nextInputNs = nowNs;
+    }
+}
+
+void VirtualDevice::handleConnect(const uint8_t *frame, const uint8_t *ip, const uint8_t *rpc,
+                                  const uint8_t *body, int bodyLen, qint64 nowNs) {
+    if (bodyLen < NdrHeaderLength) return;
+    const bool little = (rpc[4] & 0x10) != 0;
+    const uint32_t argsMaximum = rpc32(body, little);
+    const int argsLength = qMin<int>(rpc32(body + 4, little), bodyLen - NdrHeaderLength);
+
+    if (m_firstSetNs >= 0) {
+        m_host->recordPhase(EmulatorPhase::DcpSet, m_lastSetNs - m_firstSetNs);
+        m_firstSetNs = -1;
+    }
+
+    QByteArray arBlock;
+    QByteArray iocrBlocks;
+    bool haveAr = false;
+    const uint8_t *block = body + NdrHeaderLength;
+    int remaining = argsLength;
+    while (remaining >= 6) {
+        const uint16_t type = get16(block);
+        const int blockLen = get16(block + 2);   // Excludes type and length
+        if (4 + blockLen > remaining) break;
+
+        if (type == 0x0101 && blockLen >= 54) {
+            // ARBlockReq: ARType, ARUUID, SessionKey, CMInitiatorMac, ...
+            haveAr = true;
+            memcpy(m_arUuid, block + 8, 16);
+            m_sessionKey = get16(block + 24);
+            memcpy(m_controllerMac, block + 26, 6);
+
+            append16(arBlock, 0x8101);
+            append16(arBlock, 30);
+            append16(arBlock, 0x0100);
+            arBlock.append(reinterpret_cast<const char*>(block + 6), 2);    // ARType
+            arBlock.append(reinterpret_cast<const char*>(m_arUuid), 16);
+            append16(arBlock, m_sessionKey);
+            arBlock.append(reinterpret_cast<const char*>(m_macBytes), 6);
+            append16(arBlock, 0x8892);
+        } else if (type == 0x0102 && blockLen >= 20) {
+            // IOCRBlockReq: IOCRType, Reference, LT, Properties, DataLength, FrameID, SendClock, ReductionRatio
+            const uint16_t iocrType = get16(block + 6);
+            const uint16_t frameId = get16(block + 18);
+            if (iocrType == 0x0001) {
+                m_inputFrameId = frameId;
+                m_inputDataLength = qBound(40, int(get16(block + 16)), 1440);
+                const qint64 sendClock = qMax<qint64>(1, get16(block + 20));
+                const qint64 reduction = qMax<qint64>(1, get16(block + 22));
+                m_cycleNs = sendClock * reduction * 31250;
+            } else if (iocrType == 0x0002) {
+                m_outputFrameId = frameId;
+            }
+            append16(iocrBlocks, 0x8102);
+            append16(iocrBlocks, 8);
+            append16(iocrBlocks, 0x0100);
+            iocrBlocks.append(reinterpret_cast<const char*>(block + 6), 4);  // IOCRType, Reference
+            append16(iocrBlocks, frameId);
+        } else if (type == 0x0104 && blockLen >= 14) {
+            // ExpectedSubmoduleBlockReq: first API's slot and module ident number
+            const uint32_t moduleIdent = get32(block + 14);
+            if (!m_profile->hasModule(moduleIdent)) {
+                m_host->countEvent("connect.unknownModule");
+            }
+        }
+
+        block += 4 + blockLen;
+        remaining -= 4 + blockLen;
+    }
+    if (!haveAr) return;
+
+    m_controllerIp = get32(ip + 12);
+    m_controllerPort = get16(ip + (ip[0] & 0x0F) * 4);
+    m_arState = ArConnected;
+    m_connectNs = nowNs;
+    m_nextInputNs = -1;
+    m_lastOutputNs = -1;
+    m_appReadyDueNs = -1;
+
+    sendRpcResponse(frame, ip, rpc, argsMaximum, arBlock + iocrBlocks);
+    m_connectResponseNs = nowNs;
+    m_host->recordPhase(EmulatorPhase::RpcConnect, m_host->elapsedNs() - nowNs);
+}
+
+void VirtualDevice::handleControl(const uint8_t *frame, const uint8_t *ip, const uint8_t *rpc,
+                                  const uint8_t *body, int bodyLen, qint64 nowNs) {
+    if (bodyLen < NdrHeaderLength + 32 || m_arState == ArIdle) return;
+    const bool little = (rpc[4] & 0x10) != 0;
+    const uint32_t argsMaximum = rpc32(body, little);
+    const uint8_t *block = body + NdrHeaderLength;
+
+    // IODControlReq with ControlCommand ParamEnd for our AR
+    if (get16(block) != 0x0110 || memcmp(block + 8, m_arUuid, 16) != 0) return;
+    if (get16(block + 28) != 0x0001) return;
+
+    if (m_arState == ArConnected) {
+        m_host->recordPhase(EmulatorPhase::ControllerParamEnd, nowNs - m_connectResponseNs);
+    }
+
+    QByteArray response;
+    append16(response, 0x8110);
+    append16(response, 28);
+    append16(response, 0x0100);
+    append16(response, 0x0000);
+    response.append(reinterpret_cast<const char*>(m_arUuid), 16);
+    append16(response, m_sessionKey);
+    append16(response, 0x0000);
+    append16(response, 0x0008);   // ControlCommand: Done
+    append16(response, 0x0000);
+    sendRpcResponse(frame, ip, rpc, argsMaximum, response);
+
+    m_arState = ArParamEnd;
+    m_appReadyAttempts = 0;
+    m_appReadyDueNs = nowNs + AppReadyDelayNs;
+}
+
+void VirtualDevice::sendRpcResponse(const uint8_t *frame, const uint8_t *ip, const uint8_t *rpc,
+                                    uint32_t argsMaximum, const QByteArray &blocks) {
+    const bool little = (rpc[4] & 0x10) != 0;
+    const int bodyLength = NdrHeaderLength + blocks.size();
+    const uint8_t *udp = ip + (ip[0] & 0x0F) * 4;
+
+    QByteArray response = udpFrame(frame + 6, m_macBytes, m_ip, get32(ip + 12), PnioPort, get16(udp),
+                                   ++m_ipIdentification, RpcHeaderLength + bodyLength);
+    uint8_t *out = reinterpret_cast<uint8_t*>(response.data()) + 42;
+    memcpy(out, rpc, RpcHeaderLength);
+    out[1] = 0x02;   // Response
+    out[2] = 0x0A;   // Last fragment, no fack
+    putRpc16(out + 74, uint16_t(bodyLength), little);
+
+    // PNIOStatus OK, then the NDR array header
+    uint8_t *body = out + RpcHeaderLength;
+    putRpc32(body + 4, uint32_t(blocks.size()), little);
+    putRpc32(body + 8, qMax<uint32_t>(argsMaximum, uint32_t(blocks.size())), little);
+    putRpc32(body + 16, uint32_t(blocks.size()), little);
+    memcpy(body + NdrHeaderLength, blocks.constData(), blocks.size());
+    transmit(response);
+}
+
+void VirtualDevice::sendApplicationReady(qint64 nowNs) {
+    QByteArray block;
+    append16(block, 0x0112);   // IOXBlockReq
+    append16(block, 28);
+    append16(block, 0x0100);
+    append16(block, 0x0000);
+    block.append(reinterpret_cast<const char*>(m_arUuid), 16);
+    append16(block, m_sessionKey);
+    append16(block, 0x0000);
+    append16(block, 0x0002);   // ControlCommand: ApplicationReady
+    append16(block, 0x0000);
+
+    const int bodyLength = NdrHeaderLength + block.size();
+    QByteArray frame = udpFrame(m_controllerMac, m_macBytes, m_ip, m_controllerIp, PnioPort, m_controllerPort,
+                                ++m_ipIdentification, RpcHeaderLength + bodyLength);
+    uint8_t *rpc = reinterpret_cast<uint8_t*>(frame.data()) + 42;
+    rpc[0] = 4;        // Version
+    rpc[1] = 0x00;     // Request
+    rpc[2] = 0x23;     // Idempotent, last/first fragment
+    // Object UUID DEA00000-6C97-11D1-8271-<instance><device><vendor>
+    const uint8_t objectUuid[16] = { 0xDE, 0xA0, 0x00, 0x00, 0x6C, 0x97, 0x11, 0xD1, 0x82, 0x71, 0x00, 0x01,
+                                     uint8_t(m_profile->deviceId >> 8), uint8_t(m_profile->deviceId),
+                                     uint8_t(m_profile->vendorId >> 8), uint8_t(m_profile->vendorId) };
+    memcpy(rpc + 8, objectUuid, 16);
+    memcpy(rpc + 24, ControllerInterfaceUuid, 16);
+
+    // A fresh activity per attempt so a late confirmation of an earlier one is not mistaken
+    m_appReadyActivity[0] = uint8_t(++m_appReadyAttempts);
+    memcpy(m_appReadyActivity + 1, m_macBytes, 6);
+    memcpy(m_appReadyActivity + 7, m_arUuid, 9);
+    memcpy(rpc + 40, m_appReadyActivity, 16);
+    rpc[61] = 0x01; rpc[63] = 0x01;   // Interface version 1.1
+    qToBigEndian<uint32_t>(++m_rpcSequence, rpc + 64);
+    qToBigEndian<uint16_t>(4, rpc + 68);   // Control
+    rpc[70] = 0xFF; rpc[71] = 0xFF; rpc[72] = 0xFF; rpc[73] = 0xFF;
+    qToBigEndian<uint16_t>(uint16_t(bodyLength), rpc + 74);
+
+    uint8_t *body = rpc + RpcHeaderLength;
+    qToBigEndian<uint32_t>(512, body);
+    qToBigEndian<uint32_t>(uint32_t(block.size()), body + 4);
+    qToBigEndian<uint32_t>(uint32_t(block.size()), body + 8);
+    qToBigEndian<uint32_t>(uint32_t(block.size()), body + 16);
+    memcpy(body + NdrHeaderLength, block.constData(), block.size());
+    transmit(frame);
+
+    m_arState = ArAppReadySent;
+    m_appReadySentNs = nowNs;
+    m_appReadyDueNs = nowNs + AppReadyRetryNs;
+}
+
+void VirtualDevice::handleOutputFrame(const uint8_t *data, int len, int offset, qint64 nowNs) {
+    if (m_arState != ArRunning) return;
+    if (len > offset + 2) m_outputValue = data[offset + 2];
+
+    if (m_lastOutputNs < 0) {
+        m_host->recordPhase(EmulatorPhase::FirstCycle, nowNs - m_appReadyConfirmedNs);
+        m_host->recordPhase(EmulatorPhase::Startup, nowNs - m_connectNs);
+        m_host->deviceRunning(this);
+    } else {
+        const qint64 interval = nowNs - m_lastOutputNs;
+        m_host->recordPhase(EmulatorPhase::CycleInterval, interval);
+        if (interval > LateOutputCycles * m_cycleNs) {
+            m_host->countEvent("cyclic.lateOutput");
+        }
+    }
+    m_lastOutputNs = nowNs;
+}
+
+void VirtualDevice::sendInputFrame() {
+    QByteArray frame(14 + 2 + m_inputDataLength + 4, '\0');
+    uint8_t *p = reinterpret_cast<uint8_t*>(frame.data());
+    memcpy(p, m_controllerMac, 6);
+    memcpy(p + 6, m_macBytes, 6);
+    p[12] = 0x88; p[13] = 0x92;
+    qToBigEndian<uint16_t>(m_inputFrameId, p + 14);
+
+    // Inputs mirror the last outputs so a controller can check the round trip
+    p[16] = m_outputValue;
+    p[17] = 0x80;   // IOPS good
+    p[18] = 0x80;   // IOCS good
+
+    uint8_t *apdu = p + frame.size() - 4;
+    qToBigEndian<uint16_t>(m_cycleCounter, apdu);
+    m_cycleCounter = uint16_t(m_cycleCounter + m_cycleNs / 31250);
+    apdu[2] = 0x35;   // DataStatus: State primary, DataValid, ProviderState run, StationProblem ok
+    apdu[3] = 0x00;
+    transmit(frame);
+}
+
+qint64 VirtualDevice::nextDeadlineNs() const {
+    qint64 deadline = m_identifyDueNs;
+    auto consider = [&deadline](qint64 due) {
+        if (due >= 0 && (deadline < 0 || due < deadline)) deadline = due;
+    };
+    consider(m_appReadyDueNs);
+    if (m_arState == ArRunning) consider(m_nextInputNs);
+    return deadline;
+}
+
+void VirtualDevice::poll(qint64 nowNs) {
+    if (m_identifyDueNs >= 0 && m_identifyDueNs <= nowNs) {
+        transmit(m_identifyResponse);
+        m_host->recordPhase(EmulatorPhase::DcpIdentify, nowNs - m_identifyRequestNs);
+        m_identifyDueNs = -1;
+        m_identifyResponse.clear();
+    }
+
+    if (m_appReadyDueNs >= 0 && m_appReadyDueNs <= nowNs) {
+        if (m_appReadyAttempts >= AppReadyMaxAttempts) {
+            qWarning() << "Emulated device" << m_stationName << "got no ApplicationReady confirmation, AR dropped";
+            m_host->countEvent("applicationReady.timeout");
+            m_arState = ArIdle;
+            m_appReadyDueNs = -1;
+        } else {
+            sendApplicationReady(nowNs);
+        }
+    }
+
+    if (m_arState == ArRunning && m_nextInputNs >= 0 && m_nextInputNs <= nowNs) {
+        sendInputFrame();
+        m_nextInputNs += m_cycleNs;
+        if (m_nextInputNs <= nowNs) {
+            // Fell behind by more than a cycle; skip instead of bursting
+            m_host->countEvent("cyclic.inputOverrun");
+            m_nextInputNs = nowNs + m_cycleNs;
+        }
+    }
+}
+
+} // namespace PNConfigLib
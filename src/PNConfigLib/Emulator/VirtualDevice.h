@@ -0,0 +1,154 @@
+#ifndef VIRTUALDEVICE_H
+#define VIRTUALDEVICE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <cstdint>
+#include <memory>
+
+#include "../GsdmlParser/GsdmlParser.h"
+
+namespace PNConfigLib {
+
+class DeviceEmulator;
+
+/**
+ * @brief Identity and module set an emulated device presents, usually taken from a GSDML
+ */
+struct DeviceProfile {
+    QString typeOfStation = "PNConfig Emulated Device";
+    uint16_t vendorId = 0x002A;
+    uint16_t deviceId = 0x0001;
+    uint32_t dapModuleId = 0;
+    QVector<ModuleInfo> modules;
+
+    /**
+     * @brief Build a profile from a GSDML file; falls back to the defaults for missing fields
+     */
+    static DeviceProfile fromGsdml(const QString &gsdmlPath);
+
+    /**
+     * @brief true if the ident number belongs to the DAP or a module of the GSDML.
+     * Profiles without modules accept everything.
+     */
+    bool hasModule(uint32_t moduleIdentNumber) const;
+};
+
+/**
+ * @brief Protocol phases an emulated device measures, in startup order
+ */
+enum class EmulatorPhase {
+    DcpIdentify,        // Identify request received -> response sent (ResponseDelay)
+    DcpSet,             // First -> last DCP Set of one commissioning run
+    RpcConnect,         // Connect request received -> response sent
+    ControllerParamEnd, // Connect response sent -> ParamEnd request received
+    ApplicationReady,   // ApplicationReady request sent -> controller response received
+    FirstCycle,         // ApplicationReady confirmed -> first output frame received
+    Startup,            // Connect request received -> first output frame received
+    CycleInterval,      // Time between consecutive output frames
+    Count
+};
+
+/**
+ * @brief One simulated PROFINET IO device: DCP, the CM RPC sequence used by
+ * ArExchangeManager and cyclic RT frames.
+ *
+ * Instances are owned and driven by DeviceEmulator on its capture thread;
+ * nothing here is thread-safe.
+ */
+class VirtualDevice {
+public:
+    VirtualDevice(DeviceEmulator *host, std::shared_ptr<const DeviceProfile> profile, quint64 mac,
+                  const QString &stationName, quint32 ip, quint32 mask, quint32 gw);
+
+    quint64 mac() const { return m_mac; }
+    const QString &stationName() const { return m_stationName; }
+    quint32 ipAddress() const { return m_ip; }
+    bool isRunning() const { return m_arState == ArRunning; }
+
+    /**
+     * @brief Handle a frame addressed to this device, a multicast or a broadcast
+     */
+    void handleFrame(const uint8_t *data, int len, qint64 nowNs);
+
+    /**
+     * @brief Time of the next scheduled transmission, or -1 if none
+     */
+    qint64 nextDeadlineNs() const;
+
+    /**
+     * @brief Send everything due at nowNs (delayed Identify responses, ApplicationReady, input frames)
+     */
+    void poll(qint64 nowNs);
+
+private:
+    enum ArStateValue { ArIdle, ArConnected, ArParamEnd, ArAppReadySent, ArRunning };
+
+    void handleDcp(const uint8_t *data, int len, int offset, qint64 nowNs);
+    void handleIdentify(const uint8_t *src, const uint8_t *dcp, int dcpLen, qint64 nowNs);
+    void handleSet(const uint8_t *src, const uint8_t *dcp, int dcpLen, qint64 nowNs);
+    void handleArp(const uint8_t *data, int len, int offset);
+    void handleUdp(const uint8_t *data, int len, int offset, qint64 nowNs);
+    void handleConnect(const uint8_t *frame, const uint8_t *ip, const uint8_t *rpc, const uint8_t *body,
+                       int bodyLen, qint64 nowNs);
+    void handleControl(const uint8_t *frame, const uint8_t *ip, const uint8_t *rpc, const uint8_t *body,
+                       int bodyLen, qint64 nowNs);
+    void handleOutputFrame(const uint8_t *data, int len, int offset, qint64 nowNs);
+
+    QByteArray buildIdentifyResponse(const uint8_t *dest, uint32_t xid) const;
+    void sendRpcResponse(const uint8_t *frame, const uint8_t *ip, const uint8_t *rpc,
+                         uint32_t argsMaximum, const QByteArray &blocks);
+    void sendApplicationReady(qint64 nowNs);
+    void sendInputFrame();
+    void transmit(const QByteArray &frame);
+
+    DeviceEmulator *m_host;
+    std::shared_ptr<const DeviceProfile> m_profile;
+    quint64 m_mac;
+    uint8_t m_macBytes[6];
+    QString m_stationName;
+    quint32 m_ip;
+    quint32 m_mask;
+    quint32 m_gw;
+
+    // Pending Identify response (ResponseDelay)
+    QByteArray m_identifyResponse;
+    qint64 m_identifyDueNs = -1;
+    qint64 m_identifyRequestNs = 0;
+
+    // DCP Set timing; a gap of more than DcpSetSessionGapNs starts a new run
+    qint64 m_firstSetNs = -1;
+    qint64 m_lastSetNs = -1;
+
+    // Application relation
+    ArStateValue m_arState = ArIdle;
+    uint8_t m_arUuid[16];
+    uint16_t m_sessionKey = 0;
+    uint8_t m_controllerMac[6];
+    quint32 m_controllerIp = 0;
+    uint16_t m_controllerPort = 0x8894;
+    uint16_t m_inputFrameId = 0x8001;
+    uint16_t m_outputFrameId = 0x8002;
+    int m_inputDataLength = 40;
+    qint64 m_cycleNs = 64000000;
+    qint64 m_connectNs = 0;
+    qint64 m_connectResponseNs = 0;
+    qint64 m_appReadySentNs = 0;
+    qint64 m_appReadyConfirmedNs = 0;
+    qint64 m_appReadyDueNs = -1;
+    int m_appReadyAttempts = 0;
+    uint8_t m_appReadyActivity[16];
+    uint32_t m_rpcSequence = 0;
+    uint16_t m_ipIdentification = 0;   // IPv4 Identification of sent datagrams
+
+    // Cyclic exchange
+    qint64 m_nextInputNs = -1;
+    qint64 m_lastOutputNs = -1;
+    uint16_t m_cycleCounter = 0;
+    uint8_t m_outputValue = 0;     // Echoed back as input data
+};
+
+} // namespace PNConfigLib
+
+#endif // VIRTUALDEVICE_H
@@ -3,6 +3,7 @@
 /*****************************************************************************/
 
 #include "GsdmlParser.h"
+#include "../Instrumentation/Instrumentation.h"
 #include "tinyxml2/tinyxml2.h"
 #include <QFile>
 #include <QFileInfo>
@@ -27,6 +28,8 @@ static QString getAttribute(XMLElement* element, const char* name, const QString
 
 GsdmlInfo GsdmlParser::parseGSDML(const QString& gsdmlPath)
 {
+    PN_SCOPED_TIMER("GsdmlParser::parseGSDML");
+    
     if (gsdmlPath.isEmpty()) {
         throw std::runtime_error("GSDML path cannot be empty");
     }
@@ -43,12 +46,14 @@ GsdmlInfo GsdmlParser::parseGSDML(const QString& gsdmlPath)
     if (s_gsdmlCache.contains(fileKey)) {
         const GsdmlInfo& cached = s_gsdmlCache[fileKey];
         if (cached.lastModified == fileInfo.lastModified()) {
+            PN_COUNTER_ADD("GsdmlParser.cacheHit", 1);
             return cached;
         }
     }
     
     // Parse file
     locker.unlock();
+    PN_COUNTER_ADD("GsdmlParser.cacheMiss", 1);
     GsdmlInfo info = parseGSDMLFile(gsdmlPath);
     
     // Update cache
@@ -86,6 +91,8 @@ void GsdmlParser::clearCache()
 
 GsdmlInfo GsdmlParser::parseGSDMLFile(const QString& gsdmlPath)
 {
+    PN_SCOPED_TIMER("GsdmlParser::parseGSDMLFile");
+    
     GsdmlInfo info;
     info.filePath = gsdmlPath;
     info.lastModified = QFileInfo(gsdmlPath).lastModified();
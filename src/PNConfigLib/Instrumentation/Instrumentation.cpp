@@ -0,0 +1,343 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include "Instrumentation.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <limits>
+
+namespace PNConfigLib {
+
+namespace {
+
+// Bucket i counts values in [2^(i-1), 2^i), bucket 0 counts values <= 0
+constexpr int HistogramBuckets = 64;
+
+// Upper bound for buffered trace spans; further spans only feed histograms
+constexpr int MaxTraceEvents = 1 << 20;
+
+struct Histogram {
+    qint64 count = 0;
+    qint64 sum = 0;
+    qint64 min = std::numeric_limits<qint64>::max();
+    qint64 max = std::numeric_limits<qint64>::min();
+    qint64 buckets[HistogramBuckets] = {};
+
+    void add(qint64 value)
+    {
+        ++count;
+        sum += value;
+        min = qMin(min, value);
+        max = qMax(max, value);
+        int bucket = 0;
+        for (quint64 v = value > 0 ? static_cast<quint64>(value) : 0; v != 0; v >>= 1) {
+            ++bucket;
+        }
+        ++buckets[qMin(bucket, HistogramBuckets - 1)];
+    }
+
+    void merge(const Histogram& other)
+    {
+        count += other.count;
+        sum += other.sum;
+        min = qMin(min, other.min);
+        max = qMax(max, other.max);
+        for (int i = 0; i < HistogramBuckets; ++i) {
+            buckets[i] += other.buckets[i];
+        }
+    }
+
+    // Approximate percentile: upper bound of the bucket holding the rank, clamped to max
+    qint64 percentile(double p) const
+    {
+        if (count == 0) {
+            return 0;
+        }
+        qint64 rank = static_cast<qint64>(p * (count - 1)) + 1;
+        qint64 seen = 0;
+        for (int i = 0; i < HistogramBuckets; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                qint64 upper = i == 0 ? 0 : (i >= 63 ? max : (qint64(1) << i) - 1);
+                return qBound(min, upper, max);
+            }
+        }
+        return max;
+    }
+};
+
+struct TraceEvent {
+    const char* name;
+    qint64 startNs;
+    qint64 durationNs;
+    int threadId;
+};
+
+// Everything one thread recorded. Only the owning thread writes to it; the
+// mutex is uncontended except while a report or reset reads it.
+struct ThreadBuffer {
+    QMutex mutex;
+    int threadId = 0;
+    // Keyed by name pointer for a cheap record path; merged by name on export
+    QHash<const char*, qint64> counters;
+    QHash<const char*, Histogram> histograms;
+    QVector<TraceEvent> events;
+};
+
+struct Collector {
+    QElapsedTimer clock;
+    // Buffers of all threads that ever recorded; kept after a thread ends so
+    // its data still shows up in the report
+    QMutex registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::atomic<int> eventCount{0};
+    std::atomic<qint64> droppedEvents{0};
+
+    Collector() { clock.start(); }
+
+    ThreadBuffer* registerThread()
+    {
+        QMutexLocker locker(&registryMutex);
+        buffers.push_back(std::make_unique<ThreadBuffer>());
+        buffers.back()->threadId = static_cast<int>(buffers.size());
+        return buffers.back().get();
+    }
+};
+
+Collector& collector()
+{
+    static Collector instance;
+    return instance;
+}
+
+ThreadBuffer& threadBuffer()
+{
+    thread_local ThreadBuffer* buffer = collector().registerThread();
+    return *buffer;
+}
+
+std::atomic<bool> s_enabled{false};
+
+// Merged view of all thread buffers, taken at report time
+struct Snapshot {
+    QMap<QString, qint64> counters;
+    QMap<QString, Histogram> histograms;
+    QVector<TraceEvent> events;
+};
+
+Snapshot snapshot(bool withEvents)
+{
+    Collector& c = collector();
+    Snapshot result;
+    QMutexLocker registryLocker(&c.registryMutex);
+    for (const auto& buffer : c.buffers) {
+        QMutexLocker locker(&buffer->mutex);
+        for (auto it = buffer->counters.constBegin(); it != buffer->counters.constEnd(); ++it) {
+            result.counters[QString::fromLatin1(it.key())] += it.value();
+        }
+        for (auto it = buffer->histograms.constBegin(); it != buffer->histograms.constEnd(); ++it) {
+            result.histograms[QString::fromLatin1(it.key())].merge(it.value());
+        }
+        if (withEvents) {
+            result.events += buffer->events;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+bool Instrumentation::isCompiledIn()
+{
+#ifdef PNCONFIGLIB_ENABLE_INSTRUMENTATION
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Instrumentation::setEnabled(bool enabled)
+{
+    s_enabled.store(enabled && isCompiledIn(), std::memory_order_relaxed);
+}
+
+bool Instrumentation::isEnabled()
+{
+    return s_enabled.load(std::memory_order_relaxed);
+}
+
+void Instrumentation::reset()
+{
+    Collector& c = collector();
+    QMutexLocker registryLocker(&c.registryMutex);
+    for (const auto& buffer : c.buffers) {
+        QMutexLocker locker(&buffer->mutex);
+        buffer->counters.clear();
+        buffer->histograms.clear();
+        buffer->events.clear();
+    }
+    c.eventCount.store(0, std::memory_order_relaxed);
+    c.droppedEvents.store(0, std::memory_order_relaxed);
+}
+
+qint64 Instrumentation::nowNs()
+{
+    return collector().clock.nsecsElapsed();
+}
+
+void Instrumentation::addCounter(const char* name, qint64 delta)
+{
+    if (!isEnabled()) {
+        return;
+    }
+    ThreadBuffer& buffer = threadBuffer();
+    QMutexLocker locker(&buffer.mutex);
+    buffer.counters[name] += delta;
+}
+
+void Instrumentation::recordValue(const char* name, qint64 value)
+{
+    if (!isEnabled()) {
+        return;
+    }
+    ThreadBuffer& buffer = threadBuffer();
+    QMutexLocker locker(&buffer.mutex);
+    buffer.histograms[name].add(value);
+}
+
+void Instrumentation::recordSpan(const char* name, qint64 startNs, qint64 durationNs)
+{
+    if (!isEnabled()) {
+        return;
+    }
+    Collector& c = collector();
+    ThreadBuffer& buffer = threadBuffer();
+    const bool keepEvent = c.eventCount.fetch_add(1, std::memory_order_relaxed) < MaxTraceEvents;
+    if (!keepEvent) {
+        c.droppedEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    QMutexLocker locker(&buffer.mutex);
+    buffer.histograms[name].add(durationNs);
+    if (keepEvent) {
+        buffer.events.append({ name, startNs, durationNs, buffer.threadId });
+    }
+}
+
+qint64 Instrumentation::counter(const char* name)
+{
+    return snapshot(false).counters.value(QString::fromLatin1(name));
+}
+
+QJsonObject Instrumentation::toJson()
+{
+    const Snapshot merged = snapshot(false);
+
+    QJsonObject counters;
+    for (auto it = merged.counters.constBegin(); it != merged.counters.constEnd(); ++it) {
+        counters[it.key()] = it.value();
+    }
+
+    QJsonObject histograms;
+    for (auto it = merged.histograms.constBegin(); it != merged.histograms.constEnd(); ++it) {
+        const Histogram& h = it.value();
+        QJsonObject entry;
+        entry["count"] = h.count;
+        entry["sum"] = h.sum;
+        entry["min"] = h.count ? h.min : 0;
+        entry["max"] = h.count ? h.max : 0;
+        entry["mean"] = h.count ? static_cast<double>(h.sum) / h.count : 0.0;
+        entry["p50"] = h.percentile(0.50);
+        entry["p90"] = h.percentile(0.90);
+        entry["p99"] = h.percentile(0.99);
+        histograms[it.key()] = entry;
+    }
+
+    QJsonObject root;
+    root["compiledIn"] = isCompiledIn();
+    root["counters"] = counters;
+    root["histograms"] = histograms;
+    root["droppedTraceEvents"] = collector().droppedEvents.load(std::memory_order_relaxed);
+    return root;
+}
+
+QByteArray Instrumentation::toChromeTrace()
+{
+    const Snapshot merged = snapshot(true);
+
+    QJsonArray events;
+    qint64 endNs = 0;
+    for (const TraceEvent& e : merged.events) {
+        QJsonObject obj;
+        obj["name"] = QString::fromLatin1(e.name);
+        obj["ph"] = "X";
+        obj["ts"] = e.startNs / 1000.0;
+        obj["dur"] = e.durationNs / 1000.0;
+        obj["pid"] = 1;
+        obj["tid"] = e.threadId;
+        events.append(obj);
+        endNs = qMax(endNs, e.startNs + e.durationNs);
+    }
+
+    // Final counter values, shown as counter tracks at the end of the trace
+    for (auto it = merged.counters.constBegin(); it != merged.counters.constEnd(); ++it) {
+        QJsonObject args;
+        args["value"] = it.value();
+        QJsonObject obj;
+        obj["name"] = it.key();
+        obj["ph"] = "C";
+        obj["ts"] = endNs / 1000.0;
+        obj["pid"] = 1;
+        obj["args"] = args;
+        events.append(obj);
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = events;
+    root["displayTimeUnit"] = "ms";
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool Instrumentation::writeJson(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    return file.write(QJsonDocument(toJson()).toJson(QJsonDocument::Indented)) >= 0;
+}
+
+bool Instrumentation::writeChromeTrace(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    return file.write(toChromeTrace()) >= 0;
+}
+
+ScopedTimer::ScopedTimer(const char* name)
+    : m_name(name)
+    , m_startNs(Instrumentation::isEnabled() ? Instrumentation::nowNs() : -1)
+{
+}
+
+ScopedTimer::~ScopedTimer()
+{
+    if (m_startNs >= 0) {
+        Instrumentation::recordSpan(m_name, m_startNs, Instrumentation::nowNs() - m_startNs);
+    }
+}
+
+} // namespace PNConfigLib
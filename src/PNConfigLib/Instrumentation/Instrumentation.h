@@ -0,0 +1,116 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <QString>
+#include <QByteArray>
+#include <QJsonObject>
+#include <QtGlobal>
+
+namespace PNConfigLib {
+
+/**
+ * @brief Lightweight stage timing, counter and histogram collection
+ *
+ * Collection is compiled in only when PNCONFIGLIB_ENABLE_INSTRUMENTATION is
+ * defined (CMake option of the same name); otherwise the PN_* macros below
+ * expand to nothing. When compiled in, recording is still off until
+ * setEnabled(true) is called, so idle cost is a single atomic load.
+ *
+ * Each thread records into its own buffer, so parallel workers do not
+ * contend with each other; buffers are merged when a report is built.
+ *
+ * Names passed to the recording functions must be string literals (or
+ * otherwise outlive the collector); they are stored by pointer.
+ */
+class Instrumentation {
+public:
+    /**
+     * @brief true if the library was built with instrumentation support
+     */
+    static bool isCompiledIn();
+
+    /**
+     * @brief Enable or disable recording at runtime
+     */
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /**
+     * @brief Discard everything recorded so far
+     */
+    static void reset();
+
+    /**
+     * @brief Monotonic timestamp in nanoseconds since the collector started
+     */
+    static qint64 nowNs();
+
+    /**
+     * @brief Add to a named counter
+     */
+    static void addCounter(const char* name, qint64 delta = 1);
+
+    /**
+     * @brief Record a value into a named histogram (power-of-two buckets)
+     */
+    static void recordValue(const char* name, qint64 value);
+
+    /**
+     * @brief Record a completed span; its duration also goes to a histogram of the same name
+     */
+    static void recordSpan(const char* name, qint64 startNs, qint64 durationNs);
+
+    /**
+     * @brief Current value of a counter (0 if never recorded)
+     */
+    static qint64 counter(const char* name);
+
+    /**
+     * @brief Counters and histogram summaries (count, sum, min, max, mean, p50, p90, p99)
+     */
+    static QJsonObject toJson();
+
+    /**
+     * @brief Spans and counters in Chrome trace event format (chrome://tracing, Perfetto)
+     */
+    static QByteArray toChromeTrace();
+
+    static bool writeJson(const QString& path);
+    static bool writeChromeTrace(const QString& path);
+};
+
+/**
+ * @brief RAII span: records the time between construction and destruction
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(const char* name);
+    ~ScopedTimer();
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    const char* m_name;
+    qint64 m_startNs;
+};
+
+} // namespace PNConfigLib
+
+#ifdef PNCONFIGLIB_ENABLE_INSTRUMENTATION
+#define PN_INSTR_CONCAT_IMPL(a, b) a##b
+#define PN_INSTR_CONCAT(a, b) PN_INSTR_CONCAT_IMPL(a, b)
+#define PN_SCOPED_TIMER(name) ::PNConfigLib::ScopedTimer PN_INSTR_CONCAT(pnScopedTimer_, __LINE__)(name)
+#define PN_COUNTER_ADD(name, delta) ::PNConfigLib::Instrumentation::addCounter((name), (delta))
+#define PN_HISTOGRAM_RECORD(name, value) ::PNConfigLib::Instrumentation::recordValue((name), (value))
+#else
+#define PN_SCOPED_TIMER(name) do {} while (0)
+#define PN_COUNTER_ADD(name, delta) do {} while (0)
+#define PN_HISTOGRAM_RECORD(name, value) do {} while (0)
+#endif
+
+#endif // INSTRUMENTATION_H
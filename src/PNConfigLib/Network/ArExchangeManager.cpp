@@ -17,11 +17,13 @@
 #include <iphlpapi.h>
 #pragma comment(lib, "iphlpapi.lib")
 #endif
-#include <pcap.h>
 #include <QPointer>
 
 namespace PNConfigLib {
 
+// Upper bound for a station to answer Identify under a newly set name
+static const int NameCommitTimeoutMs = 2000;
+
 ArExchangeManager::ArExchangeManager(QObject *parent) : QObject(parent) {
     m_phaseTimer = new QTimer(this);
     connect(m_phaseTimer, &QTimer::timeout, this, &ArExchangeManager::onPhaseTimerTick);
@@ -61,6 +63,7 @@ bool ArExchangeManager::start(const QString &interfaceName, const QString &targe
 
     // Step 1: Configure device via DCP
     DcpScanner scanner;
+    scanner.setPacketBackend(m_backend);
     if (!scanner.connectToInterface(interfaceName)) {
         m_lastError = "Failed to connect DCP scanner to interface";
         setState(ArState::Error);
@@ -83,10 +86,19 @@ bool ArExchangeManager::start(const QString &interfaceName, const QString &targe
         setState(ArState::Error);
         return false;
     }
-    emit messageLogged("Station name set successfully. Waiting 2s for Slave to commit...");
-
-    // Increased delay to ensure the Slave has fully processed the name set and updated its identity
-    QThread::msleep(2000);
+    emit messageLogged("Station name set successfully. Waiting for Slave to answer under the new name...");
+
+    // The Slave needs time to commit the name and update its identity; instead of a
+    // fixed delay, poll with a filtered Identify until it answers under the new name
+    DcpIdentifyFilter byName = DcpIdentifyFilter::byName(stationName);
+    byName.expectedMac = DcpScanner::packMac(m_targetMacBytes);
+    QElapsedTimer nameTimer;
+    nameTimer.start();
+    if (scanner.waitForIdentify(byName, NameCommitTimeoutMs)) {
+        emit messageLogged(QString("Slave answered under the new name after %1 ms.").arg(nameTimer.elapsed()));
+    } else {
+        emit messageLogged("Slave did not answer under the new name, continuing anyway.");
+    }
 
     // Calculate default network parameters
     QStringList ipParts = targetIp.split('.');
@@ -102,11 +114,11 @@ bool ArExchangeManager::start(const QString &interfaceName, const QString &targe
     }
     emit messageLogged("IP address set successfully. Waiting 1s before starting AR...");
 
-    // Open local pcap handle AFTER DCP is done to avoid interference
-    char errbuf[PCAP_ERRBUF_SIZE];
-    m_pcapHandle = pcap_open_live(interfaceName.toStdString().c_str(), 65536, 1, 10, errbuf);
-    if (!m_pcapHandle) {
-        m_lastError = QString("Failed to open adapter after DCP: %1").arg(errbuf);
+    // Open local capture handle AFTER DCP is done to avoid interference
+    m_transport = PacketTransport::create(m_backend);
+    if (!m_transport->open(interfaceName)) {
+        m_lastError = QString("Failed to open adapter after DCP: %1").arg(m_transport->lastError());
+        m_transport.reset();
         setState(ArState::Error);
         return false;
     }
@@ -123,9 +135,9 @@ void ArExchangeManager::stop() {
     if (m_cyclicTimer) m_cyclicTimer->stop();
     if (m_phaseTimer) m_phaseTimer->stop();
     
-    if (m_pcapHandle) {
-        pcap_close((pcap_t*)m_pcapHandle);
-        m_pcapHandle = nullptr;
+    if (m_transport) {
+        m_transport->close();
+        m_transport.reset();
     }
     
     if (m_state != ArState::Offline) {
@@ -431,8 +443,8 @@ bool ArExchangeManager::sendRpcConnect() {
     uint16_t cksum = calculateIpChecksum(packet + 14, 20);
     packet[24] = (cksum >> 8); packet[25] = (cksum & 0xFF);
 
-    if (!m_pcapHandle) return false;
-    return pcap_sendpacket((pcap_t*)m_pcapHandle, packet, 14 + ipLen) == 0;
+    if (!m_transport) return false;
+    return m_transport->send(packet, 14 + ipLen);
 }
 
 bool ArExchangeManager::sendRecordData() {
@@ -452,8 +464,8 @@ bool ArExchangeManager::sendRecordData() {
     packet[28] = 0x00; packet[29] = 0x04;
     packet[32] = 0x01; // Flash
     
-    if (!m_pcapHandle) return false;
-    if (pcap_sendpacket((pcap_t*)m_pcapHandle, packet, 60) != 0) return false;
+    if (!m_transport) return false;
+    if (!m_transport->send(packet, 60)) return false;
     return true;
 }
 
@@ -537,8 +549,8 @@ bool ArExchangeManager::sendRpcControlParamEnd() {
     uint16_t cksum = calculateIpChecksum(packet + 14, 20);
     packet[24] = (cksum >> 8); packet[25] = (cksum & 0xFF);
 
-    if (!m_pcapHandle) return false;
-    return pcap_sendpacket((pcap_t*)m_pcapHandle, packet, 14 + ipLen) == 0;
+    if (!m_transport) return false;
+    return m_transport->send(packet, 14 + ipLen);
 }
 
 uint16_t ArExchangeManager::calculateIpChecksum(const uint8_t* ipHeader, int len) {
@@ -551,7 +563,7 @@ uint16_t ArExchangeManager::calculateIpChecksum(const uint8_t* ipHeader, int len
 
 
 void ArExchangeManager::sendCyclicFrame() {
-    if (!m_pcapHandle) return;
+    if (!m_transport) return;
 
     // Send Untagged RT frame (60 bytes minimum):
     // Eth(14) + ID(2) + DataBlock(3) + ... + APDU(4)
@@ -591,7 +603,7 @@ void ArExchangeManager::sendCyclicFrame() {
             .arg(m_outputData, 2, 16, QChar('0')));
     }
 
-    pcap_sendpacket((pcap_t*)m_pcapHandle, packet, 60);
+    m_transport->send(packet, 60);
 }
 
 void ArExchangeManager::startCyclicExchange() {
@@ -601,28 +613,28 @@ void ArExchangeManager::startCyclicExchange() {
 }
 
 int ArExchangeManager::waitForResponse(uint16_t frameId, uint32_t xid, int timeoutMs) {
-    if (!m_pcapHandle) return -1;
-    struct pcap_pkthdr *header;
+    if (!m_transport) return -1;
     const uint8_t *data;
+    int length = 0;
     QElapsedTimer timer;
     timer.start();
     QPointer<ArExchangeManager> safeThis(this);
     while (timer.elapsed() < timeoutMs) {
-        if (!m_pcapHandle) return -1;
-        int res = pcap_next_ex((pcap_t*)m_pcapHandle, &header, &data);
+        if (!m_transport) return -1;
+        int res = m_transport->next(&data, &length, 10);
         if (!safeThis) return -1;
         if (res == 1) {
-            if (header->caplen < 14) continue;
+            if (length < 14) continue;
             const uint8_t *dest = data;
             const uint8_t *src = data + 6;
             uint16_t type = (data[12] << 8) | data[13];
             int ethHeaderLen = 14;
-            if (type == 0x8100 && header->caplen >= 18) {
+            if (type == 0x8100 && length >= 18) {
                 type = (data[16] << 8) | data[17];
                 ethHeaderLen = 18;
             }
             if (memcmp(src, m_targetMacBytes, 6) == 0) {
-                if (type == 0x0806 && header->caplen >= ethHeaderLen + 28) { 
+                if (type == 0x0806 && length >= ethHeaderLen + 28) { 
                     const uint8_t *arp = data + ethHeaderLen;
                     if ((arp[6] << 8 | arp[7]) == 1) {
                         if (arp[24] == 192 && arp[25] == 168 && arp[26] == 0 && arp[27] == 254) sendArpResponse(src, arp + 14); 
@@ -635,22 +647,22 @@ int ArExchangeManager::waitForResponse(uint16_t frameId, uint32_t xid, int timeo
             }
             if (memcmp(dest, m_sourceMac, 6) != 0) continue;
             if (type == 0x8892 && frameId != 0xFEFD) { 
-                if (header->caplen >= ethHeaderLen + 2) {
+                if (length >= ethHeaderLen + 2) {
                     uint16_t capturedFrameId = (data[ethHeaderLen] << 8) | data[ethHeaderLen + 1];
-                    if (capturedFrameId == 0x8001 && header->caplen >= ethHeaderLen + 4) { 
+                    if (capturedFrameId == 0x8001 && length >= ethHeaderLen + 4) { 
                         uint8_t newVal = data[ethHeaderLen + 2];
                         if (newVal != m_inputData) { m_inputData = newVal; emit inputDataReceived(m_inputData); }
-                        uint8_t ds = (header->caplen >= 60) ? data[58] : 0; // End of 60-byte frame
+                        uint8_t ds = (length >= 60) ? data[58] : 0; // End of 60-byte frame
                         static int logCounterIO = 0;
                         if (logCounterIO++ % 200 == 0) {
-                             emit messageLogged(QString("  [PN Packet Captured] FrameID: 0x8001 Input: 0x%1 DS: 0x%2 Len: %3").arg(newVal, 2, 16, QChar('0')).arg(ds, 2, 16, QChar('0')).arg(header->caplen));
+                             emit messageLogged(QString("  [PN Packet Captured] FrameID: 0x8001 Input: 0x%1 DS: 0x%2 Len: %3").arg(newVal, 2, 16, QChar('0')).arg(ds, 2, 16, QChar('0')).arg(length));
                         }
                     }
                     if (capturedFrameId == frameId) return 0;
                 }
             } else if (type == 0x0800) { 
                 if (frameId == 0x0000 || frameId == 0x0001) { 
-                    if (header->caplen >= ethHeaderLen + 20 + 8 + 80) { 
+                    if (length >= ethHeaderLen + 20 + 8 + 80) { 
                         const uint8_t *ip = data + ethHeaderLen;
                         if (ip[9] == 0x11) { 
                             const uint8_t *rpc = ip + 28; 
@@ -666,7 +678,7 @@ int ArExchangeManager::waitForResponse(uint16_t frameId, uint32_t xid, int timeo
                         }
                     }
                 } else if (frameId == 0x0002) { 
-                    if (header->caplen >= ethHeaderLen + 20 + 8 + 80) {
+                    if (length >= ethHeaderLen + 20 + 8 + 80) {
                         const uint8_t *ip = data + ethHeaderLen;
                         if (ip[9] == 0x11) {
                             const uint8_t *rpc = ip + 28;
@@ -685,9 +697,9 @@ int ArExchangeManager::waitForResponse(uint16_t frameId, uint32_t xid, int timeo
                                 r_body[bodyPos++] = 0x00; r_body[bodyPos++] = 0x00; r_body[bodyPos++] = 0x00; r_body[bodyPos++] = 0x20;
                                 r_body[bodyPos++] = 0x81; r_body[bodyPos++] = 0x12; r_body[bodyPos++] = 0; r_body[bodyPos++] = 0x1C; r_body[bodyPos++] = 1; r_body[bodyPos++] = 0;
                                 r_body[bodyPos++] = 0; r_body[bodyPos++] = 0;
-                                if (header->caplen >= ethHeaderLen + 20 + 8 + 80 + 4 + 20 + 6 + 2 + 16) memcpy(r_body + bodyPos, rpc + 80 + 4 + 20 + 6 + 2, 16);
+                                if (length >= ethHeaderLen + 20 + 8 + 80 + 4 + 20 + 6 + 2 + 16) memcpy(r_body + bodyPos, rpc + 80 + 4 + 20 + 6 + 2, 16);
                                 bodyPos += 16;
-                                if (header->caplen >= ethHeaderLen + 20 + 8 + 80 + 4 + 20 + 6 + 2 + 16 + 2) memcpy(r_body + bodyPos, rpc + 80 + 4 + 20 + 6 + 2 + 16, 2);
+                                if (length >= ethHeaderLen + 20 + 8 + 80 + 4 + 20 + 6 + 2 + 16 + 2) memcpy(r_body + bodyPos, rpc + 80 + 4 + 20 + 6 + 2 + 16, 2);
                                 else { r_body[bodyPos] = 0; r_body[bodyPos+1] = 1; }
                                 bodyPos += 2;
                                 r_body[bodyPos++] = 0; r_body[bodyPos++] = 0; r_body[bodyPos++] = 0; r_body[bodyPos++] = 8; r_body[bodyPos++] = 0; r_body[bodyPos++] = 0;
@@ -696,7 +708,7 @@ int ArExchangeManager::waitForResponse(uint16_t frameId, uint32_t xid, int timeo
                                 uint16_t ipLen = 20 + udpLen; r_ip[2] = (ipLen >> 8); r_ip[3] = (ipLen & 0xFF);
                                 r_ip[10] = 0; r_ip[11] = 0; uint16_t r_cksum = calculateIpChecksum(r_ip, 20); r_ip[10] = (r_cksum >> 8); r_ip[11] = (r_cksum & 0xFF);
                                 emit messageLogged(QString("  [Sending CControl Response] Total: %1 bytes").arg(14 + ipLen));
-                                if (m_pcapHandle) pcap_sendpacket((pcap_t*)m_pcapHandle, resp, 14 + ipLen);
+                                if (m_transport) m_transport->send(resp, 14 + ipLen);
                                 return 0;
                             }
                         }
@@ -716,13 +728,13 @@ QString ArExchangeManager::macToString(const uint8_t *mac) {
 }
 
 bool ArExchangeManager::sendArpResponse(const uint8_t* targetMac, const uint8_t* targetIp) {
-    if (!m_pcapHandle) return false;
+    if (!m_transport) return false;
     uint8_t packet[64]; memset(packet, 0, sizeof(packet));
     memcpy(packet, targetMac, 6); memcpy(packet + 6, m_sourceMac, 6); packet[12] = 0x08; packet[13] = 0x06;
     packet[14] = 0; packet[15] = 1; packet[16] = 8; packet[17] = 0; packet[18] = 6; packet[19] = 4; packet[20] = 0; packet[21] = 2;
     memcpy(packet + 22, m_sourceMac, 6); packet[28] = 192; packet[29] = 168; packet[30] = 0; packet[31] = 254;
     memcpy(packet + 32, targetMac, 6); memcpy(packet + 38, targetIp, 4);
-    if (pcap_sendpacket((pcap_t*)m_pcapHandle, packet, 64) != 0) return false;
+    if (!m_transport->send(packet, 64)) return false;
     emit messageLogged(QString("  [ARP Reply Out] To Slave for 192.168.0.254 (Untagged)"));
     return true;
 }
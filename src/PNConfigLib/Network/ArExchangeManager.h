@@ -6,8 +6,10 @@
 #include <QTimer>
 #include <vector>
 #include <cstdint>
+#include <memory>
 
 #include "DcpScanner.h"
+#include "PacketTransport.h"
 
 namespace PNConfigLib {
 
@@ -29,6 +31,12 @@ public:
     bool start(const QString &interfaceName, const QString &targetMac, const QString &targetIp, const QString &stationName);
     void stop();
 
+    /**
+     * @brief Backend for DCP and IO frames, e.g. PacketBackend::Loopback for simulated devices.
+     */
+    void setPacketBackend(PacketBackend backend) { m_backend = backend; }
+    PacketBackend packetBackend() const { return m_backend; }
+
     ArState state() const { return m_state; }
     QString lastError() const { return m_lastError; }
 
@@ -74,7 +82,8 @@ private:
     uint8_t m_inputData = 0;
     uint8_t m_outputData = 0;
     uint8_t m_targetMacBytes[6];
-    void* m_pcapHandle = nullptr;
+    PacketBackend m_backend = PacketBackend::Default;
+    std::unique_ptr<PacketTransport> m_transport;
     
     QTimer *m_phaseTimer;
     QTimer *m_cyclicTimer;
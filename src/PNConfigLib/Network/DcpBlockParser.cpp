@@ -0,0 +1,173 @@
+#include "DcpBlockParser.h"
+#include <QtEndian>
+
+namespace PNConfigLib {
+
+static const int EthernetHeaderLength = 14;
+static const int VlanTagLength = 4;
+static const int DcpHeaderLength = 12;
+static const int BlockHeaderLength = 4;
+static const int BlockInfoLength = 2;
+
+static inline uint16_t get16(const uint8_t *p) { return qFromBigEndian<uint16_t>(p); }
+static inline uint32_t get32(const uint8_t *p) { return qFromBigEndian<uint32_t>(p); }
+
+static inline quint64 getMac(const uint8_t *p) {
+    return (quint64(get16(p)) << 32) | get32(p + 2);
+}
+
+static inline bool isSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// Station names are padded by some stacks; a value starting with NUL counts as unset
+static QByteArrayView trimmedText(const uint8_t *data, int len) {
+    const char *begin = (const char*)data;
+    const char *end = begin + len;
+    if (begin == end || *begin == '\0') return QByteArrayView();
+    while (begin < end && isSpace(*begin)) ++begin;
+    while (end > begin && isSpace(end[-1])) --end;
+    return QByteArrayView(begin, end - begin);
+}
+
+bool DcpBlockParser::parseFrame(const uint8_t *data, int len, DcpFrameInfo &frame) {
+    if (!data || len < EthernetHeaderLength + DcpHeaderLength) return false;
+
+    int offset = EthernetHeaderLength;
+    uint16_t type = get16(data + 12);
+    if (type == 0x8100) {
+        if (len < EthernetHeaderLength + VlanTagLength + DcpHeaderLength) return false;
+        type = get16(data + 16);
+        offset += VlanTagLength;
+    }
+    if (type != 0x8892) return false;
+
+    const uint8_t *dcp = data + offset;
+    frame.destination = getMac(data);
+    frame.source = getMac(data + 6);
+    frame.frameId = get16(dcp);
+    frame.serviceId = dcp[2];
+    frame.serviceType = dcp[3];
+    frame.xid = get32(dcp + 4);
+    frame.responseDelay = get16(dcp + 8);
+
+    const int dataLength = get16(dcp + 10);
+    const int captured = len - offset - DcpHeaderLength;
+    frame.blocks = dcp + DcpHeaderLength;
+    frame.blocksLength = qMin(dataLength, captured);
+    frame.truncated = dataLength > captured;
+    return true;
+}
+
+int DcpBlockParser::parseResponseBlocks(const uint8_t *data, int len, DcpDeviceBlocks &blocks) {
+    int offset = 0;
+    int parsed = 0;
+    while (len - offset >= BlockHeaderLength) {
+        const uint8_t *block = data + offset;
+        const uint16_t key = get16(block);  // Option in the high byte, suboption in the low byte
+        const int length = get16(block + 2);
+        if (length > len - offset - BlockHeaderLength) {
+            ++blocks.malformedBlocks;
+            break;
+        }
+        // Blocks are padded to an even length; the pad of the last block may be missing
+        offset += BlockHeaderLength + length + (length & 1);
+
+        if (length < BlockInfoLength) {
+            ++blocks.malformedBlocks;
+            continue;
+        }
+        const uint8_t *value = block + BlockHeaderLength + BlockInfoLength;
+        const int valueLength = length - BlockInfoLength;
+
+        // Minimum value length per decoded option; anything else is skipped unread
+        int needed = 0;
+        switch (key) {
+            case 0x0102:    // IP suite
+            case 0x0103:    // Full IP suite, IP suite followed by DNS servers
+                needed = 12;
+                break;
+            case 0x0203:    // Device ID
+                needed = 4;
+                break;
+            case 0x0204:    // Device role
+                needed = 1;
+                break;
+            case 0x0207:    // Device instance
+                needed = 2;
+                break;
+            default:
+                break;
+        }
+        if (valueLength < needed) {
+            ++blocks.malformedBlocks;
+            continue;
+        }
+        ++parsed;
+
+        switch (key) {
+            case 0x0102:
+            case 0x0103:
+                blocks.ipBlockInfo = get16(block + BlockHeaderLength);
+                blocks.ip = get32(value);
+                blocks.mask = get32(value + 4);
+                blocks.gw = get32(value + 8);
+                blocks.present |= DcpDeviceBlocks::IpSuite;
+                break;
+            case 0x0201:
+                blocks.typeOfStation = trimmedText(value, valueLength);
+                if (!blocks.typeOfStation.isEmpty()) blocks.present |= DcpDeviceBlocks::TypeOfStation;
+                break;
+            case 0x0202:
+                blocks.nameOfStation = trimmedText(value, valueLength);
+                if (!blocks.nameOfStation.isEmpty()) blocks.present |= DcpDeviceBlocks::NameOfStation;
+                break;
+            case 0x0203:
+                blocks.vendorId = get16(value);
+                blocks.deviceId = get16(value + 2);
+                blocks.present |= DcpDeviceBlocks::DeviceId;
+                break;
+            case 0x0204:
+                blocks.deviceRole = value[0];
+                blocks.present |= DcpDeviceBlocks::DeviceRole;
+                break;
+            case 0x0205:
+                blocks.deviceOptions = QByteArrayView((const char*)value, valueLength & ~1);
+                blocks.present |= DcpDeviceBlocks::DeviceOptions;
+                break;
+            case 0x0206:
+                blocks.aliasName = trimmedText(value, valueLength);
+                if (!blocks.aliasName.isEmpty()) blocks.present |= DcpDeviceBlocks::AliasName;
+                break;
+            case 0x0207:
+                blocks.instanceHigh = value[0];
+                blocks.instanceLow = value[1];
+                blocks.present |= DcpDeviceBlocks::DeviceInstance;
+                break;
+            default:
+                break;
+        }
+    }
+    blocks.blockCount += parsed;
+    return parsed;
+}
+
+int DcpBlockParser::setResult(const uint8_t *data, int len) {
+    int result = -1;
+    int offset = 0;
+    while (len - offset >= BlockHeaderLength) {
+        const uint8_t *block = data + offset;
+        const int length = get16(block + 2);
+        if (length > len - offset - BlockHeaderLength) break;
+        offset += BlockHeaderLength + length + (length & 1);
+
+        // Control/Response: option and suboption of the request block, then BlockError
+        if (block[0] != 0x05 || block[1] != 0x04 || length < 3) continue;
+        const int error = block[6];
+        if (error != 0) return error;
+        result = 0;
+    }
+    return result;
+}
+
+} // namespace PNConfigLib
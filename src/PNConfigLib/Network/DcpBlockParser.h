@@ -0,0 +1,97 @@
+#ifndef DCPBLOCKPARSER_H
+#define DCPBLOCKPARSER_H
+
+#include <QByteArrayView>
+#include <QtGlobal>
+#include <cstdint>
+
+namespace PNConfigLib {
+
+/**
+ * @brief Ethernet and DCP header fields of a received frame.
+ *
+ * blocks points into the frame; blocksLength is DCPDataLength clamped to the
+ * captured bytes, so a block walk over it never leaves the buffer.
+ */
+struct DcpFrameInfo {
+    quint64 destination = 0;    // 48-bit MAC, first octet in bits 47..40
+    quint64 source = 0;
+    uint16_t frameId = 0;
+    uint8_t serviceId = 0;
+    uint8_t serviceType = 0;
+    uint32_t xid = 0;
+    uint16_t responseDelay = 0;
+    const uint8_t *blocks = nullptr;
+    int blocksLength = 0;
+    bool truncated = false;     // DCPDataLength claimed more than was captured
+};
+
+/**
+ * @brief Options decoded from the blocks of an Identify (or Get) response.
+ *
+ * Text fields are trimmed views into the frame and are only valid while the
+ * frame is. A field is meaningful only if its bit is set in present.
+ */
+struct DcpDeviceBlocks {
+    enum Field : uint16_t {
+        IpSuite = 0x0001,
+        TypeOfStation = 0x0002,
+        NameOfStation = 0x0004,
+        DeviceId = 0x0008,
+        DeviceRole = 0x0010,
+        DeviceOptions = 0x0020,
+        AliasName = 0x0040,
+        DeviceInstance = 0x0080
+    };
+
+    uint16_t present = 0;
+    uint16_t ipBlockInfo = 0;   // Bit 0-1: address set by none/DHCP/static, bit 7: address conflict
+    quint32 ip = 0;             // IPv4 suite in host byte order
+    quint32 mask = 0;
+    quint32 gw = 0;
+    uint16_t vendorId = 0;
+    uint16_t deviceId = 0;
+    uint8_t deviceRole = 0;     // Bit 0: IO device, bit 1: IO controller, bit 2: multidevice, bit 3: supervisor
+    uint8_t instanceHigh = 0;
+    uint8_t instanceLow = 0;
+    QByteArrayView typeOfStation;
+    QByteArrayView nameOfStation;
+    QByteArrayView aliasName;
+    QByteArrayView deviceOptions;   // Option/suboption pairs the device supports
+    int blockCount = 0;
+    int malformedBlocks = 0;    // Too short for their option, or running past the data
+
+    bool has(Field field) const { return (present & field) != 0; }
+};
+
+/**
+ * @brief Bounds-checked DCP frame and block parsing over captured bytes.
+ *
+ * Nothing is allocated and no field is read outside [data, data + len),
+ * whatever the length fields in the frame claim.
+ */
+class DcpBlockParser {
+public:
+    /**
+     * @brief Read the Ethernet (optionally VLAN tagged) and DCP headers.
+     * @return false if the frame is not PROFINET or too short for a DCP header
+     */
+    static bool parseFrame(const uint8_t *data, int len, DcpFrameInfo &frame);
+
+    /**
+     * @brief Decode the blocks of a response; every value starts with 2 bytes BlockInfo.
+     * Later blocks of the same option overwrite earlier ones.
+     * @return Number of well-formed blocks
+     */
+    static int parseResponseBlocks(const uint8_t *data, int len, DcpDeviceBlocks &blocks);
+
+    /**
+     * @brief First non-zero error of the Control/Response blocks of a Set response
+     * @return 0 if all blocks report success, -1 if there is no Control/Response block
+     */
+    static int setResult(const uint8_t *data, int len);
+};
+
+} // namespace PNConfigLib
+
+#endif // DCPBLOCKPARSER_H
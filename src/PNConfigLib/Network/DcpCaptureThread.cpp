@@ -0,0 +1,100 @@
+#include "DcpCaptureThread.h"
+#include "DcpBlockParser.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QtEndian>
+
+namespace PNConfigLib {
+
+// Upper bound for a single wait so cancel() is noticed even on a quiet network
+static const int MaxWaitMs = 50;
+
+DcpCaptureThread::DcpCaptureThread(const QString &interfaceName, const QByteArray &request, int windowMs,
+                                   PacketBackend backend, QObject *parent)
+    : QThread(parent), m_interfaceName(interfaceName), m_request(request), m_windowMs(windowMs),
+      m_backend(backend) {
+    if (m_request.size() >= (int)(sizeof(EthernetHeader) + sizeof(DcpHeader))) {
+        const DcpHeader *dcp = (const DcpHeader*)(m_request.constData() + sizeof(EthernetHeader));
+        m_xid = qFromBigEndian<uint32_t>(dcp->xid);
+    }
+}
+
+DcpCaptureThread::~DcpCaptureThread() {
+    cancel();
+    wait();
+}
+
+void DcpCaptureThread::cancel() {
+    requestInterruption();
+    QMutexLocker locker(&m_handleMutex);
+    if (m_transport) {
+        m_transport->interrupt();
+    }
+}
+
+void DcpCaptureThread::run() {
+    std::unique_ptr<PacketTransport> transport = PacketTransport::create(m_backend);
+    if (!transport->open(m_interfaceName, DcpScanner::ProfinetFilter)) {
+        qCritical() << "Error opening capture handle:" << transport->lastError();
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_handleMutex);
+        m_transport = transport.get();
+    }
+
+    if (!transport->send((const uint8_t*)m_request.constData(), m_request.size())) {
+        qCritical() << "Error sending DCP Identify request:" << transport->lastError();
+    } else {
+        const PacketTransport::FrameHandler handler = [this](const uint8_t *data, int len) {
+            handlePacket(data, len);
+        };
+        QElapsedTimer timer;
+        timer.start();
+        while (!isInterruptionRequested()) {
+            const qint64 remaining = m_windowMs - timer.elapsed();
+            if (remaining <= 0) break;
+            if (transport->dispatch(handler, (int)qMin<qint64>(remaining, MaxWaitMs)) < 0) {
+                qCritical() << "Error reading packet:" << transport->lastError();
+                break;
+            }
+        }
+    }
+
+    {
+        QMutexLocker locker(&m_handleMutex);
+        m_transport = nullptr;
+    }
+    transport->close();
+
+    qCDebug(lcDcp) << "Scan completed. Received" << m_capturedCount << "PROFINET packets. Total unique devices found:" << m_devices.size();
+}
+
+void DcpCaptureThread::handlePacket(const uint8_t *data, int len) {
+    m_capturedCount++;
+
+    // Responses to other requests, also when VLAN tagged
+    DcpFrameInfo frame;
+    if (!DcpBlockParser::parseFrame(data, len, frame) || frame.xid != m_xid) return;
+
+    const qsizetype before = m_devices.size();
+    bool changed = false;
+    int index = DcpScanner::parseDcpPacket(data, len, m_devices, &changed);
+    if (index < 0) return;
+
+    if (m_devices.size() > before) {
+        emit deviceDiscovered(m_devices[index]);
+    } else if (changed) {
+        emit deviceUpdated(m_devices[index]);
+    }
+
+    // Filtered requests: stop listening once the expected responders are in
+    if ((m_expectedMac != 0 && m_devices[index].mac == m_expectedMac)
+        || (m_expectedMac == 0 && m_expectedResponses > 0 && m_devices.size() >= m_expectedResponses)) {
+        requestInterruption();
+    }
+}
+
+} // namespace PNConfigLib
@@ -0,0 +1,81 @@
+#ifndef DCPCAPTURETHREAD_H
+#define DCPCAPTURETHREAD_H
+
+#include <QThread>
+#include <QMutex>
+#include <QByteArray>
+#include <QString>
+#include <QList>
+#include <memory>
+
+#include "DcpScanner.h"
+#include "PacketTransport.h"
+
+namespace PNConfigLib {
+
+/**
+ * @brief Sends one DCP Identify request and collects the responses on its own thread.
+ *
+ * The thread opens a dedicated PacketTransport, sends the request through it
+ * and then sleeps in the transport until frames arrive or the response window
+ * ends. Frames are handled in batches: whole ring blocks with the AF_PACKET
+ * backend, one pcap_dispatch() buffer with pcap.
+ * Every new or changed device is reported as soon as its frame is parsed, so
+ * receivers in other threads get queued signals while the scan is running.
+ * Responses to other requests (different XID) are ignored.
+ */
+class DcpCaptureThread : public QThread {
+    Q_OBJECT
+public:
+    DcpCaptureThread(const QString &interfaceName, const QByteArray &request, int windowMs,
+                     PacketBackend backend = PacketBackend::Default, QObject *parent = nullptr);
+    ~DcpCaptureThread() override;
+
+    /**
+     * @brief Finish once expectedResponses stations (or the station expectedMac) answered.
+     * Only before start().
+     */
+    void setCompletion(int expectedResponses, quint64 expectedMac = 0) {
+        m_expectedResponses = expectedResponses;
+        m_expectedMac = expectedMac;
+    }
+
+    /**
+     * @brief Stop capturing before the window ends. Safe to call from any thread.
+     */
+    void cancel();
+
+    /**
+     * @brief Devices merged so far. Only read after the thread has finished.
+     */
+    const QList<DiscoveredDevice> &devices() const { return m_devices.toList(); }
+    int capturedCount() const { return m_capturedCount; }
+
+signals:
+    void deviceDiscovered(const PNConfigLib::DiscoveredDevice &device);
+    void deviceUpdated(const PNConfigLib::DiscoveredDevice &device);
+
+protected:
+    void run() override;
+
+private:
+    void handlePacket(const uint8_t *data, int len);
+
+    QString m_interfaceName;
+    QByteArray m_request;
+    int m_windowMs;
+    PacketBackend m_backend;
+    uint32_t m_xid = 0;
+    int m_expectedResponses = 0;
+    quint64 m_expectedMac = 0;
+
+    QMutex m_handleMutex;
+    PacketTransport *m_transport = nullptr;
+
+    DiscoveredDeviceList m_devices;
+    int m_capturedCount = 0;
+};
+
+} // namespace PNConfigLib
+
+#endif // DCPCAPTURETHREAD_H
@@ -0,0 +1,120 @@
+#include "DcpFrameBuilder.h"
+#include <QtEndian>
+#include <cstring>
+
+namespace PNConfigLib {
+
+// DCP identify multicast address
+static const uint8_t IdentifyMulticast[6] = {0x01, 0x0E, 0xCF, 0x00, 0x00, 0x00};
+
+// Reserved for Set requests, kept at the value the devices in use were tested with
+static const uint16_t SetResponseDelay = 0x00FF;
+
+static void writeHeader(uint8_t *header, const uint8_t *sourceMac, uint16_t frameId, uint8_t serviceId) {
+    memset(header, 0, DcpFrameBuilder::HeaderLength);
+    memcpy(header + 6, sourceMac, 6);
+    header[12] = 0x88; header[13] = 0x92;
+    qToBigEndian<uint16_t>(frameId, header + 14);
+    header[16] = serviceId;
+    header[17] = 0x01; // Request
+}
+
+DcpFrameBuilder::DcpFrameBuilder() {
+    const uint8_t none[6] = {0, 0, 0, 0, 0, 0};
+    setSourceMac(none);
+}
+
+DcpFrameBuilder::DcpFrameBuilder(const uint8_t *sourceMac) {
+    setSourceMac(sourceMac);
+}
+
+void DcpFrameBuilder::setSourceMac(const uint8_t *sourceMac) {
+    writeHeader(m_setTemplate, sourceMac, 0xFEFD, 0x04);
+    qToBigEndian<uint16_t>(SetResponseDelay, m_setTemplate + 22);
+
+    writeHeader(m_identifyTemplate, sourceMac, 0xFEFE, 0x05);
+    memcpy(m_identifyTemplate, IdentifyMulticast, 6);
+
+    memset(m_buffer, 0, sizeof(m_buffer));
+    m_length = 0;
+}
+
+void DcpFrameBuilder::beginSet(quint64 dest, uint32_t xid) {
+    memcpy(m_buffer, m_setTemplate, HeaderLength);
+    for (int i = 0; i < 6; ++i) m_buffer[i] = uint8_t(dest >> (40 - 8 * i));
+    qToBigEndian<uint32_t>(xid, m_buffer + 18);
+    m_length = HeaderLength;
+}
+
+void DcpFrameBuilder::beginIdentify(uint32_t xid, uint16_t responseDelayFactor) {
+    memcpy(m_buffer, m_identifyTemplate, HeaderLength);
+    qToBigEndian<uint32_t>(xid, m_buffer + 18);
+    qToBigEndian<uint16_t>(responseDelayFactor, m_buffer + 22);
+    m_length = HeaderLength;
+}
+
+uint8_t *DcpFrameBuilder::reserveBlock(uint8_t option, uint8_t suboption, int length) {
+    const int padded = 4 + length + (length & 1);
+    if (length < 0 || length > 0xFFFF || m_length + padded > MaxFrameLength) return nullptr;
+
+    uint8_t *block = m_buffer + m_length;
+    block[0] = option;
+    block[1] = suboption;
+    qToBigEndian<uint16_t>(uint16_t(length), block + 2);
+    if (length & 1) block[4 + length] = 0;
+    m_length += padded;
+    return block + 4;
+}
+
+bool DcpFrameBuilder::appendBlock(uint8_t option, uint8_t suboption, const uint8_t *value, int length) {
+    uint8_t *out = reserveBlock(option, suboption, length);
+    if (!out) return false;
+    if (length > 0) memcpy(out, value, length);
+    return true;
+}
+
+bool DcpFrameBuilder::appendQualifiedBlock(uint8_t option, uint8_t suboption, uint16_t qualifier,
+                                           const uint8_t *value, int length) {
+    uint8_t *out = reserveBlock(option, suboption, 2 + length);
+    if (!out) return false;
+    qToBigEndian<uint16_t>(qualifier, out);
+    if (length > 0) memcpy(out + 2, value, length);
+    return true;
+}
+
+bool DcpFrameBuilder::appendIpSuite(uint16_t qualifier, quint32 ip, quint32 mask, quint32 gw) {
+    uint8_t *out = reserveBlock(0x01, 0x02, 14);
+    if (!out) return false;
+    qToBigEndian<uint16_t>(qualifier, out);
+    qToBigEndian<uint32_t>(ip, out + 2);
+    qToBigEndian<uint32_t>(mask, out + 6);
+    qToBigEndian<uint32_t>(gw, out + 10);
+    return true;
+}
+
+bool DcpFrameBuilder::appendNameOfStation(uint16_t qualifier, QByteArrayView name) {
+    return appendQualifiedBlock(0x02, 0x02, qualifier, reinterpret_cast<const uint8_t*>(name.data()),
+                                int(name.size()));
+}
+
+bool DcpFrameBuilder::appendSignal(uint16_t value) {
+    uint8_t *out = reserveBlock(0x05, 0x03, 4);
+    if (!out) return false;
+    out[0] = 0x00; out[1] = 0x00; // BlockQualifier
+    qToBigEndian<uint16_t>(value, out + 2);
+    return true;
+}
+
+bool DcpFrameBuilder::appendResetToFactory(uint16_t qualifier) {
+    return appendQualifiedBlock(0x05, 0x06, qualifier, nullptr, 0);
+}
+
+const uint8_t *DcpFrameBuilder::finish() {
+    qToBigEndian<uint16_t>(uint16_t(m_length - HeaderLength), m_buffer + 24);
+    if (m_length < MinFrameLength) {
+        memset(m_buffer + m_length, 0, MinFrameLength - m_length);
+    }
+    return m_buffer;
+}
+
+} // namespace PNConfigLib
@@ -0,0 +1,81 @@
+#ifndef DCPFRAMEBUILDER_H
+#define DCPFRAMEBUILDER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <cstdint>
+
+namespace PNConfigLib {
+
+/**
+ * @brief Builds DCP request frames from binary addresses into a reusable buffer.
+ *
+ * The Ethernet and DCP headers for the local interface are prepared once per
+ * source MAC. A request copies the matching template, patches destination and
+ * XID, and appends blocks; nothing is allocated. The frame returned by
+ * finish() stays valid until the next begin call.
+ *
+ * Typical use:
+ * @code
+ * builder.beginSet(mac, xid);
+ * builder.appendNameOfStation(qualifier, name);
+ * builder.appendIpSuite(qualifier, ip, mask, gw);
+ * transport->send(builder.finish(), builder.size());
+ * @endcode
+ */
+class DcpFrameBuilder {
+public:
+    static constexpr int HeaderLength = 14 + 12;    // Ethernet + DCP header
+    static constexpr int MinFrameLength = 60;
+    static constexpr int MaxFrameLength = 1514;
+
+    DcpFrameBuilder();
+    explicit DcpFrameBuilder(const uint8_t *sourceMac);
+
+    /**
+     * @brief Rebuild the header templates for a new local MAC
+     */
+    void setSourceMac(const uint8_t *sourceMac);
+
+    /// Unicast Set request (FrameID 0xFEFD) to dest
+    void beginSet(quint64 dest, uint32_t xid);
+    /// Multicast Identify request (FrameID 0xFEFE)
+    void beginIdentify(uint32_t xid, uint16_t responseDelayFactor);
+
+    /**
+     * @brief Append a block whose value is written as-is (Identify filters)
+     * @return false if the frame would exceed MaxFrameLength; the frame is then left unchanged
+     */
+    bool appendBlock(uint8_t option, uint8_t suboption, const uint8_t *value, int length);
+
+    /// Append a Set block: BlockQualifier followed by value
+    bool appendQualifiedBlock(uint8_t option, uint8_t suboption, uint16_t qualifier,
+                              const uint8_t *value, int length);
+
+    bool appendIpSuite(uint16_t qualifier, quint32 ip, quint32 mask, quint32 gw);
+    bool appendNameOfStation(uint16_t qualifier, QByteArrayView name);
+    /// Control/Signal; 0x0100 flashes the LED once
+    bool appendSignal(uint16_t value = 0x0100);
+    bool appendResetToFactory(uint16_t qualifier = 0);
+
+    /**
+     * @brief Write DCPDataLength and pad to the Ethernet minimum
+     */
+    const uint8_t *finish();
+
+    const uint8_t *data() const { return m_buffer; }
+    int size() const { return m_length < MinFrameLength ? MinFrameLength : m_length; }
+    QByteArray toByteArray() const { return QByteArray(reinterpret_cast<const char*>(m_buffer), size()); }
+
+private:
+    uint8_t *reserveBlock(uint8_t option, uint8_t suboption, int length);
+
+    uint8_t m_setTemplate[HeaderLength];
+    uint8_t m_identifyTemplate[HeaderLength];
+    uint8_t m_buffer[MaxFrameLength];
+    int m_length = 0;
+};
+
+} // namespace PNConfigLib
+
+#endif // DCPFRAMEBUILDER_H
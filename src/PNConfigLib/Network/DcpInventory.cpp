@@ -0,0 +1,146 @@
+#include "DcpInventory.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QRandomGenerator>
+
+namespace PNConfigLib {
+
+// Retry delay while the scanner is busy with another scan
+static const int BusyRetryMs = 1000;
+
+DcpInventory::DcpInventory(DcpScanner *scanner, QObject *parent)
+    : QObject(parent), m_scanner(scanner) {
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &DcpInventory::onTimer);
+
+    connect(m_scanner, &DcpScanner::deviceDiscovered, this, &DcpInventory::onDeviceSeen);
+    connect(m_scanner, &DcpScanner::deviceUpdated, this, &DcpInventory::onDeviceSeen);
+    connect(m_scanner, &DcpScanner::scanFinished, this, &DcpInventory::onScanFinished);
+}
+
+DcpInventory::~DcpInventory() {
+    stop();
+}
+
+void DcpInventory::setInterval(int intervalMs, int jitterPercent) {
+    m_intervalMs = qMax(1, intervalMs);
+    m_jitterPercent = qBound(0, jitterPercent, 100);
+}
+
+void DcpInventory::start() {
+    if (m_active) return;
+    m_active = true;
+    scheduleNext(0);
+}
+
+void DcpInventory::stop() {
+    if (!m_active) return;
+    m_active = false;
+    m_timer->stop();
+    if (m_ownScan) {
+        m_ownScan = false;
+        m_scanner->cancelScan();
+    }
+}
+
+void DcpInventory::refresh() {
+    if (!m_active || m_ownScan) return;
+    scheduleNext(0);
+}
+
+void DcpInventory::clear() {
+    m_entries.clear();
+    m_seenThisRound.clear();
+}
+
+void DcpInventory::scheduleNext(int delayMs) {
+    m_timer->start(delayMs);
+}
+
+void DcpInventory::onTimer() {
+    if (!m_active) return;
+
+    if (m_ownScan) {
+        if (m_scanner->isScanning()) {
+            scheduleNext(BusyRetryMs);
+            return;
+        }
+        // Our round was cancelled through the scanner, scanFinished will not come
+        m_ownScan = false;
+    }
+
+    if (!m_scanner->startScan(m_responseDelayFactor)) {
+        // Another scan is running (or the interface went away); try again shortly
+        scheduleNext(BusyRetryMs);
+        return;
+    }
+    m_ownScan = true;
+    m_seenThisRound.clear();
+
+    // Watchdog; onScanFinished replaces it with the regular schedule
+    scheduleNext(DcpScanner::responseWindowMs(m_responseDelayFactor) + BusyRetryMs);
+}
+
+void DcpInventory::onDeviceSeen(const DiscoveredDevice &device) {
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    m_seenThisRound.insert(device.mac);
+
+    auto it = m_entries.find(device.mac);
+    if (it == m_entries.end()) {
+        InventoryEntry entry;
+        entry.device = device;
+        entry.firstSeenMs = now;
+        entry.lastSeenMs = now;
+        m_entries.insert(device.mac, entry);
+        emit deviceAdded(device);
+        return;
+    }
+
+    it->lastSeenMs = now;
+    it->missedScans = 0;
+    const int changes = changesBetween(it->device, device);
+    if (changes != 0) {
+        it->device = device;
+        emit deviceChanged(device, changes);
+    }
+}
+
+void DcpInventory::onScanFinished(const QList<DiscoveredDevice> &devices) {
+    Q_UNUSED(devices);
+    if (!m_ownScan) return;
+    m_ownScan = false;
+
+    QList<DiscoveredDevice> lost;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (!m_seenThisRound.contains(it.key()) && ++it->missedScans >= m_lostAfter) {
+            lost.append(it->device);
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (const DiscoveredDevice &device : lost) {
+        emit deviceLost(device);
+    }
+    emit roundFinished(m_entries.size());
+
+    if (m_active) {
+        const int jitter = m_intervalMs * m_jitterPercent / 100;
+        const int delay = m_intervalMs + (jitter > 0 ? QRandomGenerator::global()->bounded(-jitter, jitter + 1) : 0);
+        scheduleNext(qMax(0, delay));
+    }
+}
+
+int DcpInventory::changesBetween(const DiscoveredDevice &before, const DiscoveredDevice &after) {
+    int changes = 0;
+    if (before.deviceName != after.deviceName) changes |= NameChanged;
+    if (before.ip != after.ip || before.mask != after.mask || before.gw != after.gw) changes |= AddressChanged;
+    if (before.deviceType != after.deviceType || before.vendorId != after.vendorId
+        || before.deviceId != after.deviceId) {
+        changes |= TypeChanged;
+    }
+    return changes;
+}
+
+} // namespace PNConfigLib
@@ -0,0 +1,109 @@
+#ifndef DCPINVENTORY_H
+#define DCPINVENTORY_H
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QTimer>
+#include <cstdint>
+
+#include "DcpScanner.h"
+
+namespace PNConfigLib {
+
+/**
+ * @brief One station of the live inventory
+ */
+struct InventoryEntry {
+    DiscoveredDevice device;
+    qint64 firstSeenMs = 0;     // Milliseconds since epoch
+    qint64 lastSeenMs = 0;
+    int missedScans = 0;        // Consecutive inventory rounds without a response
+};
+
+/**
+ * @brief Background network inventory on top of a connected DcpScanner.
+ *
+ * Runs Identify All periodically with a jittered interval, so several
+ * engineering stations on one plant network do not scan in lockstep, and
+ * keeps a MAC-keyed table of the stations seen. Only differences are
+ * reported: new stations, changed name/address/type, and stations that
+ * missed several rounds in a row. Responses to scans started by others on
+ * the same scanner (manual scans, filtered Identify) are merged as well but
+ * do not count as rounds.
+ */
+class DcpInventory : public QObject {
+    Q_OBJECT
+public:
+    enum Change {
+        NameChanged = 0x1,
+        AddressChanged = 0x2,   // IP, mask or gateway
+        TypeChanged = 0x4       // Type of station, vendor or device ID
+    };
+
+    explicit DcpInventory(DcpScanner *scanner, QObject *parent = nullptr);
+    ~DcpInventory() override;
+
+    /// Mean time between rounds; each wait is drawn from interval +/- jitterPercent
+    void setInterval(int intervalMs, int jitterPercent = 20);
+    int interval() const { return m_intervalMs; }
+
+    /// Rounds a station may miss before deviceLost is emitted
+    void setLostAfterMissedScans(int rounds) { m_lostAfter = qMax(1, rounds); }
+    void setResponseDelayFactor(uint16_t factor) { m_responseDelayFactor = factor; }
+
+    /**
+     * @brief Start monitoring; the first round runs immediately. The scanner must be connected.
+     */
+    void start();
+    void stop();
+    bool isActive() const { return m_active; }
+
+    /**
+     * @brief Run a round now, e.g. after changing a station's name or address
+     */
+    void refresh();
+
+    /**
+     * @brief Forget all stations without emitting deviceLost
+     */
+    void clear();
+
+    int size() const { return m_entries.size(); }
+    bool contains(quint64 mac) const { return m_entries.contains(mac); }
+    InventoryEntry entry(quint64 mac) const { return m_entries.value(mac); }
+    QList<InventoryEntry> entries() const { return m_entries.values(); }
+
+signals:
+    void deviceAdded(const PNConfigLib::DiscoveredDevice &device);
+    void deviceChanged(const PNConfigLib::DiscoveredDevice &device, int changes);
+    void deviceLost(const PNConfigLib::DiscoveredDevice &device);
+    void roundFinished(int deviceCount);
+
+private slots:
+    void onTimer();
+    void onDeviceSeen(const PNConfigLib::DiscoveredDevice &device);
+    void onScanFinished(const QList<PNConfigLib::DiscoveredDevice> &devices);
+
+private:
+    void scheduleNext(int delayMs);
+    static int changesBetween(const DiscoveredDevice &before, const DiscoveredDevice &after);
+
+    DcpScanner *m_scanner;
+    QTimer *m_timer;
+    bool m_active = false;
+    bool m_ownScan = false;
+
+    int m_intervalMs = 10000;
+    int m_jitterPercent = 20;
+    int m_lostAfter = 3;
+    uint16_t m_responseDelayFactor = DcpScanner::DefaultResponseDelayFactor;
+
+    QHash<quint64, InventoryEntry> m_entries;
+    QSet<quint64> m_seenThisRound;
+};
+
+} // namespace PNConfigLib
+
+#endif // DCPINVENTORY_H
@@ -12,11 +12,48 @@
 #pragma comment(lib, "iphlpapi.lib")
 #endif
 #include <QMap>
+#include <QRandomGenerator>
+#include <pcap.h>
 #include "DcpScanner.h"
+#include "DcpCaptureThread.h"
+#include "DcpBlockParser.h"
 
 namespace PNConfigLib {
 
-DcpScanner::DcpScanner(QObject *parent) : QObject(parent) {}
+Q_LOGGING_CATEGORY(lcDcp, "pnconfig.dcp")
+
+int DiscoveredDeviceList::insert(const DiscoveredDevice &device) {
+    auto it = m_index.constFind(device.mac);
+    if (it != m_index.constEnd()) {
+        m_devices[it.value()] = device;
+        return it.value();
+    }
+    const int index = m_devices.size();
+    m_devices.append(device);
+    m_index.insert(device.mac, index);
+    return index;
+}
+
+bool DiscoveredDeviceList::remove(quint64 mac) {
+    const int index = m_index.value(mac, -1);
+    if (index < 0) return false;
+    m_devices.removeAt(index);
+    m_index.remove(mac);
+    for (int i = index; i < m_devices.size(); ++i) {
+        m_index[m_devices[i].mac] = i;
+    }
+    return true;
+}
+
+void DiscoveredDeviceList::clear() {
+    m_devices.clear();
+    m_index.clear();
+}
+
+DcpScanner::DcpScanner(QObject *parent)
+    : QObject(parent),
+      // Random start so several scanners (or restarts) on one segment do not reuse XIDs
+      m_nextXid(QRandomGenerator::global()->generate()) {}
 
 DcpScanner::~DcpScanner() {
     disconnectFromInterface();
@@ -103,15 +140,19 @@ bool DcpScanner::connectToInterface(const QString &interfaceName) {
         disconnectFromInterface();
     }
     
-    char errbuf[PCAP_ERRBUF_SIZE];
-    m_pcapHandle = pcap_open_live(interfaceName.toStdString().c_str(), 65536, 1, 10, errbuf);
-    if (!m_pcapHandle) {
-        qCritical() << "Error opening adapter:" << errbuf << "for interface:" << interfaceName;
+    // Only PROFINET (0x8892) frames are of interest on this handle
+    m_transport = PacketTransport::create(m_backend);
+    if (!m_transport->open(interfaceName, ProfinetFilter)) {
+        qCritical() << "Error opening adapter:" << m_transport->lastError() << "for interface:" << interfaceName;
+        m_transport.reset();
         return false;
     }
 
-    // Resolve source MAC address using Windows API (most reliable for GUID matching)
+    // Simulated backends know their own address; otherwise ask the OS below
     memset(m_sourceMac, 0, 6);
+    const bool macFromTransport = m_transport->hardwareAddress(m_sourceMac);
+
+    // Resolve source MAC address using Windows API (most reliable for GUID matching)
     QString targetGuid = interfaceName;
     QString targetDescription;
     int bStart = targetGuid.indexOf('{');
@@ -144,7 +185,7 @@ bool DcpScanner::connectToInterface(const QString &interfaceName) {
         ret = GetAdaptersAddresses(AF_UNSPEC, GAA_FLAG_INCLUDE_PREFIX, NULL, addresses, &bufLen);
     }
     
-    if (ret == NO_ERROR) {
+    if (!macFromTransport && ret == NO_ERROR) {
         for (PIP_ADAPTER_ADDRESSES curr = addresses; curr; curr = curr->Next) {
             QString adapterName = QString::fromLocal8Bit(curr->AdapterName).toUpper();
             QString adapterDesc = QString::fromWCharArray(curr->Description).toUpper();
@@ -165,7 +206,7 @@ bool DcpScanner::connectToInterface(const QString &interfaceName) {
 #endif
 
     // Fallback to Qt matching
-    if (m_sourceMac[0] == 0 && m_sourceMac[1] == 0 && m_sourceMac[2] == 0 &&
+    if (!macFromTransport && m_sourceMac[0] == 0 && m_sourceMac[1] == 0 && m_sourceMac[2] == 0 &&
         m_sourceMac[3] == 0 && m_sourceMac[4] == 0 && m_sourceMac[5] == 0) {
         
         QList<QNetworkInterface> interfaces = QNetworkInterface::allInterfaces();
@@ -197,27 +238,18 @@ bool DcpScanner::connectToInterface(const QString &interfaceName) {
                    << ". Please select a PHYSICAL adapter (not WAN Miniport) for PROFINET.";
     }
 
-    // Set BPF filter to capture PROFINET (0x8892)
-    struct bpf_program fcode;
-    if (pcap_compile(m_pcapHandle, &fcode, "ether proto 0x8892", 1, PCAP_NETMASK_UNKNOWN) == -1) {
-        qWarning() << "Error compiling BPF filter:" << pcap_geterr(m_pcapHandle);
-    } else {
-        if (pcap_setfilter(m_pcapHandle, &fcode) == -1) {
-            qWarning() << "Error setting BPF filter:" << pcap_geterr(m_pcapHandle);
-        }
-        pcap_freecode(&fcode);
-    }
-
     m_interfaceName = interfaceName;
     m_isConnected = true;
+    m_frameBuilder.setSourceMac(m_sourceMac);
     qDebug() << "Connected to interface:" << interfaceName;
     return true;
 }
 
 void DcpScanner::disconnectFromInterface() {
-    if (m_isConnected && m_pcapHandle) {
-        pcap_close(m_pcapHandle);
-        m_pcapHandle = nullptr;
+    cancelScan();
+    if (m_isConnected && m_transport) {
+        m_transport->close();
+        m_transport.reset();
         m_isConnected = false;
         qDebug() << "Disconnected from interface:" << m_interfaceName;
         m_interfaceName.clear();
@@ -225,507 +257,575 @@ void DcpScanner::disconnectFromInterface() {
     }
 }
 
-QList<DiscoveredDevice> DcpScanner::scan() {
-    QList<DiscoveredDevice> devices;
-    if (!m_isConnected || !m_pcapHandle) {
-        return devices;
-    }
-
-    uint8_t packet[60];
-    memset(packet, 0, sizeof(packet));
+int DcpScanner::responseWindowMs(uint16_t responseDelayFactor, bool filtered) {
+    return responseDelayFactor * 10 + (filtered ? FilteredResponseWindowMarginMs : ResponseWindowMarginMs);
+}
 
-    EthernetHeader *eth = (EthernetHeader*)packet;
-    memcpy(eth->dest, "\x01\x0e\xcf\x00\x00\x00", 6);
-    memcpy(eth->src, m_sourceMac, 6);
-    eth->type = qToBigEndian<uint16_t>(0x8892);
+DcpIdentifyFilter DcpIdentifyFilter::byName(const QString &name) {
+    DcpIdentifyFilter filter;
+    filter.kind = NameOfStation;
+    filter.text = name;
+    filter.expectedResponses = 1;
+    return filter;
+}
 
-    DcpHeader *dcp = (DcpHeader*)(packet + sizeof(EthernetHeader));
-    dcp->frameId = qToBigEndian<uint16_t>(0xFEFE);
-    dcp->serviceId = 0x05;
-    dcp->serviceType = 0x01;
-    dcp->xid = qToBigEndian<uint32_t>(0x12345678);
-    dcp->responseDelay = qToBigEndian<uint16_t>(0x00FF);
-    dcp->dcpDataLength = qToBigEndian<uint16_t>(4);
+DcpIdentifyFilter DcpIdentifyFilter::byAlias(const QString &alias) {
+    DcpIdentifyFilter filter;
+    filter.kind = AliasName;
+    filter.text = alias;
+    filter.expectedResponses = 1;
+    return filter;
+}
 
-    DcpBlockHeader *block = (DcpBlockHeader*)(packet + sizeof(EthernetHeader) + sizeof(DcpHeader));
-    block->option = 0xFF; // All
-    block->suboption = 0xFF; // All
-    block->length = 0x0000;
+DcpIdentifyFilter DcpIdentifyFilter::byIp(quint32 ip, quint32 mask, quint32 gw) {
+    DcpIdentifyFilter filter;
+    filter.kind = IpSuite;
+    filter.ip = ip;
+    filter.mask = mask;
+    filter.gw = gw;
+    filter.expectedResponses = 1;
+    return filter;
+}
 
-    qDebug() << "Sending DCP Identify multicast request (Source MAC:" << macToString(m_sourceMac) << ")...";
+DcpIdentifyFilter DcpIdentifyFilter::byDeviceId(uint16_t vendorId, uint16_t deviceId) {
+    DcpIdentifyFilter filter;
+    filter.kind = DeviceId;
+    filter.vendorId = vendorId;
+    filter.deviceId = deviceId;
+    return filter;
+}
 
-    if (pcap_sendpacket(m_pcapHandle, packet, sizeof(packet)) != 0) {
-        qCritical() << "Error sending DCP Identify request:" << pcap_geterr(m_pcapHandle);
-        return devices;
-    }
+QByteArray DcpScanner::identifyRequest(const DcpIdentifyFilter &filter, uint16_t responseDelayFactor, uint32_t xid) {
+    m_frameBuilder.beginIdentify(xid, responseDelayFactor);
 
-    struct pcap_pkthdr *header;
-    const uint8_t *data;
-    int res;
-    
-    QElapsedTimer timer;
-    timer.start();
-    
-    int capturedCount = 0;
-    QPointer<DcpScanner> safeThis(this);
-    // Capture for 5 seconds (to allow for ResponseDelay)
-    while (timer.elapsed() < 5000) {
-        if (!m_pcapHandle) break;
-        res = pcap_next_ex(m_pcapHandle, &header, &data);
-        if (!safeThis) return devices;
-        if (!m_pcapHandle) break;
-        if (res == 1) {
-            capturedCount++;
-            parseDcpPacket(data, header->caplen, devices);
-        } else if (res == -1) {
-            qCritical() << "Error reading packet:" << pcap_geterr(m_pcapHandle);
+    // Filter value without BlockQualifier, as Identify requests carry it
+    bool appended = false;
+    switch (filter.kind) {
+        case DcpIdentifyFilter::All:
+            appended = m_frameBuilder.appendBlock(0xFF, 0xFF, nullptr, 0);
+            break;
+        case DcpIdentifyFilter::NameOfStation:
+        case DcpIdentifyFilter::AliasName: {
+            const QByteArray text = filter.text.toUtf8();
+            appended = m_frameBuilder.appendBlock(0x02, filter.kind == DcpIdentifyFilter::NameOfStation ? 0x02 : 0x06,
+                                                  (const uint8_t*)text.constData(), text.size());
             break;
-        } else if (res == 0) {
-            // Timeout - this is expected if no packets arrive
         }
-        
-        QCoreApplication::processEvents(); 
-        if (!safeThis) return devices;
+        case DcpIdentifyFilter::IpSuite: {
+            uint8_t value[12];
+            qToBigEndian<uint32_t>(filter.ip, value);
+            qToBigEndian<uint32_t>(filter.mask, value + 4);
+            qToBigEndian<uint32_t>(filter.gw, value + 8);
+            appended = m_frameBuilder.appendBlock(0x01, 0x02, value, sizeof(value));
+            break;
+        }
+        case DcpIdentifyFilter::DeviceId: {
+            uint8_t value[4];
+            qToBigEndian<uint16_t>(filter.vendorId, value);
+            qToBigEndian<uint16_t>(filter.deviceId, value + 2);
+            appended = m_frameBuilder.appendBlock(0x02, 0x03, value, sizeof(value));
+            break;
+        }
+    }
+    if (!appended) {
+        // Without its filter block the request would address every station
+        qWarning() << "DCP Identify filter does not fit into one frame";
+        return QByteArray();
     }
 
-    qDebug() << "Scan completed. Received" << capturedCount << "PROFINET packets. Total unique devices found:" << devices.size();
-    return devices;
+    m_frameBuilder.finish();
+    return m_frameBuilder.toByteArray();
 }
 
-void DcpScanner::parseDcpPacket(const uint8_t *data, int len, QList<DiscoveredDevice> &devices) {
-    if (len < 14) return;
+DcpCaptureThread *DcpScanner::createIdentifyThread(const DcpIdentifyFilter &filter, uint16_t responseDelayFactor,
+                                                   QObject *parent) {
+    const QByteArray request = identifyRequest(filter, responseDelayFactor, nextXid());
+    if (request.isEmpty()) return nullptr;
 
-    EthernetHeader *eth = (EthernetHeader*)data;
-    uint16_t type = qFromBigEndian<uint16_t>(eth->type);
-    int offset = sizeof(EthernetHeader);
+    qCDebug(lcDcp) << "Sending DCP Identify multicast request (Source MAC:" << macToString(m_sourceMac)
+                   << ", filter:" << filter.kind << ")...";
 
-    // Handle VLAN tag
-    if (type == 0x8100 && len >= 18) {
-        type = (data[16] << 8) | data[17];
-        offset = 18;
-    }
+    DcpCaptureThread *thread = new DcpCaptureThread(m_interfaceName, request,
+                                                    responseWindowMs(responseDelayFactor, filter.kind != DcpIdentifyFilter::All),
+                                                    m_backend, parent);
+    thread->setCompletion(filter.expectedResponses, filter.expectedMac);
+    return thread;
+}
 
-    if (len < offset + (int)sizeof(DcpHeader)) return;
-    
-    DcpHeader *dcp = (DcpHeader*)(data + offset);
-    uint16_t frameId = qFromBigEndian<uint16_t>(dcp->frameId);
-    
-    // 0xFEFF is Identify Response
-    if (frameId != 0xFEFF) {
-        return;
+bool DcpScanner::startScan(uint16_t responseDelayFactor) {
+    return startIdentify(DcpIdentifyFilter(), responseDelayFactor);
+}
+
+bool DcpScanner::startIdentify(const DcpIdentifyFilter &filter, uint16_t responseDelayFactor) {
+    if (!m_isConnected || m_captureThread) {
+        return false;
     }
 
+    const quint64 generation = ++m_scanGeneration;
+    DcpCaptureThread *thread = createIdentifyThread(filter, responseDelayFactor, this);
+    if (!thread) return false;
+    m_captureThread = thread;
+
+    // The thread emits from its own context, so these arrive queued on this object's thread.
+    // Signals of a cancelled scan may still be pending; the generation check drops them.
+    connect(thread, &DcpCaptureThread::deviceDiscovered, this, [this, generation](const DiscoveredDevice &device) {
+        if (generation == m_scanGeneration) emit deviceDiscovered(device);
+    });
+    connect(thread, &DcpCaptureThread::deviceUpdated, this, [this, generation](const DiscoveredDevice &device) {
+        if (generation == m_scanGeneration) emit deviceUpdated(device);
+    });
+    connect(thread, &QThread::finished, this, [this, thread, generation]() {
+        if (generation != m_scanGeneration) return;
+        m_captureThread = nullptr;
+        const QList<DiscoveredDevice> devices = thread->devices();
+        thread->deleteLater();
+        emit scanFinished(devices);
+    });
+
+    thread->start();
+    return true;
+}
 
-    // Some devices use ServiceType 0x01 (Success) instead of 0x02 (Response)
-    if (dcp->serviceId != 0x05) {
-        return;
-    }
+void DcpScanner::cancelScan() {
+    if (!m_captureThread) return;
 
-    DiscoveredDevice device;
-    device.macAddress = macToString(eth->src);
-    qDebug() << "Parsing DCP Identify Response from MAC:" << device.macAddress;
-
-    // Check if we already have this device to merge info
-    int deviceIndex = -1;
-    for (int i = 0; i < devices.size(); ++i) {
-        if (devices[i].macAddress == device.macAddress) {
-            deviceIndex = i;
-            break;
-        }
+    DcpCaptureThread *thread = m_captureThread;
+    m_captureThread = nullptr;
+    ++m_scanGeneration;
+    thread->cancel();
+    thread->wait();
+    thread->deleteLater();
+}
+
+QList<DiscoveredDevice> DcpScanner::scan() {
+    return identify(DcpIdentifyFilter(), DefaultResponseDelayFactor);
+}
+
+QList<DiscoveredDevice> DcpScanner::identify(const DcpIdentifyFilter &filter, uint16_t responseDelayFactor) {
+    if (!m_isConnected || m_captureThread) {
+        return {};
     }
 
-    offset += sizeof(DcpHeader);
-    int dcpDataLen = qFromBigEndian<uint16_t>(dcp->dcpDataLength);
+    std::unique_ptr<DcpCaptureThread> thread(createIdentifyThread(filter, responseDelayFactor, nullptr));
+    if (!thread) return {};
+    thread->start();
+    thread->wait();
+    return thread->devices();
+}
 
-    int remaining = dcpDataLen;
+bool DcpScanner::waitForIdentify(const DcpIdentifyFilter &filter, int timeoutMs) {
+    if (!m_isConnected || !m_transport || m_captureThread || filter.expectedMac == 0) {
+        return false;
+    }
 
-    while (remaining >= 4) {
-        DcpBlockHeader *block = (DcpBlockHeader*)(data + offset);
-        int blockLen = qFromBigEndian<uint16_t>(block->length);
-        
-        // Ensure we don't read past the packet
-        if (offset + 4 + blockLen > len) break;
+    uint32_t xid = 0;
+    bool answered = false;
+    const PacketTransport::FrameHandler handler = [&](const uint8_t *data, int len) {
+        DcpFrameInfo frame;
+        if (DcpBlockParser::parseFrame(data, len, frame) && frame.frameId == 0xFEFF && frame.serviceId == 0x05
+            && frame.xid == xid && frame.source == filter.expectedMac) {
+            answered = true;
+        }
+    };
 
-        // Pointer to data after Block Header (Option/Suboption/Length)
-        const uint8_t *val = data + offset + 4;
-        
-        // PROFINET DCP Blocks always start with 2 bytes of BlockInfo (Status), skip them
-        const uint8_t *payload = val + 2;
-        int payloadLen = blockLen - 2;
-
-        if (block->option == 0x01) { // IP Parameters
-            // Suboption 1 (standard) or 2 (suite) both can contain IP if length >= 14
-            if ((block->suboption == 0x01 || block->suboption == 0x02) && blockLen >= 14) {
-                device.ipAddress = QString("%1.%2.%3.%4").arg(payload[0]).arg(payload[1]).arg(payload[2]).arg(payload[3]);
-                device.subnetMask = QString("%1.%2.%3.%4").arg(payload[4]).arg(payload[5]).arg(payload[6]).arg(payload[7]);
-                device.gateway = QString("%1.%2.%3.%4").arg(payload[8]).arg(payload[9]).arg(payload[10]).arg(payload[11]);
-            }
-        } else if (block->option == 0x02) { // Device Properties
-            if (block->suboption == 0x01 && payloadLen > 0) { // Type of Station
-                QString type = QString::fromUtf8((const char*)payload, payloadLen).trimmed();
-                if (!type.isEmpty() && type[0] != '\0') device.deviceType = type;
-            } else if (block->suboption == 0x02 && payloadLen > 0) { // Name of Station
-                QString name = QString::fromUtf8((const char*)payload, payloadLen).trimmed();
-                if (!name.isEmpty() && name[0] != '\0') device.deviceName = name;
-            } else if (block->suboption == 0x03 && blockLen == 6) { // Vendor/Device ID
-                device.vendorId = (payload[0] << 8) | payload[1];
-                device.deviceId = (payload[2] << 8) | payload[3];
+    const int windowMs = responseWindowMs(FilteredResponseDelayFactor, true);
+    QElapsedTimer timer;
+    timer.start();
+    while (!answered && timer.elapsed() < timeoutMs) {
+        xid = nextXid();
+        const QByteArray request = identifyRequest(filter, FilteredResponseDelayFactor, xid);
+        if (request.isEmpty()) return false;
+        if (!m_transport->send((const uint8_t*)request.constData(), request.size())) {
+            qCritical() << "Error sending DCP Identify request:" << m_transport->lastError();
+            return false;
+        }
+
+        const qint64 windowEnd = timer.elapsed() + windowMs;
+        while (!answered) {
+            const qint64 remaining = qMin<qint64>(windowEnd, timeoutMs) - timer.elapsed();
+            if (remaining <= 0) break;
+            if (m_transport->dispatch(handler, (int)remaining) < 0) {
+                qCritical() << "Error reading packet:" << m_transport->lastError();
+                return false;
             }
         }
+    }
+    return answered;
+}
 
-        int advance = 4 + blockLen;
-        if (advance % 2 != 0) advance++;
-        offset += advance;
-        remaining -= advance;
+// Allocation-free for the usual ASCII station names; other text is decoded to compare
+static bool equalsUtf8(const QString &text, QByteArrayView utf8) {
+    for (char c : utf8) {
+        if ((uchar)c >= 0x80) return text == QString::fromUtf8(utf8);
     }
+    return text == QLatin1String(utf8.data(), utf8.size());
+}
+
+int DcpScanner::parseDcpPacket(const uint8_t *data, int len, DiscoveredDeviceList &devices, bool *changed) {
+    if (changed) *changed = false;
 
+    DcpFrameInfo frame;
+    if (!DcpBlockParser::parseFrame(data, len, frame)) return -1;
+
+    // 0xFEFF is Identify Response
+    // Some devices use ServiceType 0x01 (Success) instead of 0x02 (Response)
+    if (frame.frameId != 0xFEFF || frame.serviceId != 0x05) {
+        return -1;
+    }
+
+    DcpDeviceBlocks blocks;
+    DcpBlockParser::parseResponseBlocks(frame.blocks, frame.blocksLength, blocks);
+
+    // Start from the known record so only fields carried by this frame change
+    const int deviceIndex = devices.indexOf(frame.source);
+    DiscoveredDevice device;
     if (deviceIndex >= 0) {
-        // Merge into existing device
-        auto &d = devices[deviceIndex];
-        if (!device.deviceName.isEmpty()) d.deviceName = device.deviceName;
-        if (!device.deviceType.isEmpty()) d.deviceType = device.deviceType;
-        
-        // Always update IP parameters if they were found in this block
-        if (!device.ipAddress.isEmpty()) d.ipAddress = device.ipAddress;
-        if (!device.subnetMask.isEmpty()) d.subnetMask = device.subnetMask;
-        if (!device.gateway.isEmpty()) d.gateway = device.gateway;
-        
-        if (device.vendorId != 0) d.vendorId = device.vendorId;
-        if (device.deviceId != 0) d.deviceId = device.deviceId;
+        device = devices[deviceIndex];
     } else {
-        devices.append(device);
+        device.mac = frame.source;
+    }
+    bool modified = deviceIndex < 0;
+
+    if (blocks.has(DcpDeviceBlocks::IpSuite)
+        && (blocks.ip != device.ip || blocks.mask != device.mask || blocks.gw != device.gw)) {
+        device.ip = blocks.ip;
+        device.mask = blocks.mask;
+        device.gw = blocks.gw;
+        modified = true;
+    }
+    // Type of Station / Name of Station; decoded only when the bytes differ
+    if (blocks.has(DcpDeviceBlocks::TypeOfStation) && !equalsUtf8(device.deviceType, blocks.typeOfStation)) {
+        device.deviceType = QString::fromUtf8(blocks.typeOfStation);
+        modified = true;
+    }
+    if (blocks.has(DcpDeviceBlocks::NameOfStation) && !equalsUtf8(device.deviceName, blocks.nameOfStation)) {
+        device.deviceName = QString::fromUtf8(blocks.nameOfStation);
+        modified = true;
     }
+    if (blocks.has(DcpDeviceBlocks::DeviceId)) {
+        if (blocks.vendorId != 0 && blocks.vendorId != device.vendorId) { device.vendorId = blocks.vendorId; modified = true; }
+        if (blocks.deviceId != 0 && blocks.deviceId != device.deviceId) { device.deviceId = blocks.deviceId; modified = true; }
+    }
+
+    if (changed) *changed = modified;
+    if (!modified) return deviceIndex;
+    return devices.insert(device);
 }
 
-bool DcpScanner::setDeviceIp(const QString &mac, const QString &ip, const QString &mask, const QString &gw, bool permanent) {
-    if (!m_isConnected || !m_pcapHandle) return false;
-
-    QStringList macParts = mac.split(':');
-    if (macParts.size() != 6) return false;
-
-    uint8_t packet[80];
-    memset(packet, 0, sizeof(packet));
-
-    EthernetHeader *eth = (EthernetHeader*)packet;
-    for (int i = 0; i < 6; ++i) eth->dest[i] = (uint8_t)macParts[i].toInt(nullptr, 16);
-    memcpy(eth->src, m_sourceMac, 6);
-    eth->type = qToBigEndian<uint16_t>(0x8892);
-
-    DcpHeader *dcp = (DcpHeader*)(packet + sizeof(EthernetHeader));
-    dcp->frameId = qToBigEndian<uint16_t>(0xFEFD);
-    dcp->serviceId = 0x04; // Set Request (was 0x03 which is Get)
-    dcp->serviceType = 0x01;
-    dcp->xid = qToBigEndian<uint32_t>(0x87654321);
-    dcp->responseDelay = qToBigEndian<uint16_t>(0x00FF);
-    dcp->dcpDataLength = qToBigEndian<uint16_t>(4 + 14); // Header + Payload
-
-    DcpBlockHeader *block = (DcpBlockHeader*)(packet + sizeof(EthernetHeader) + sizeof(DcpHeader));
-    block->option = 0x01;    // IP
-    block->suboption = 0x02; // IP suite
-    block->length = qToBigEndian<uint16_t>(14);
-
-    QStringList ipParts = ip.split('.');
-    QStringList maskParts = mask.split('.');
-    QStringList gwParts = gw.split('.');
-    
-    uint8_t *val = packet + sizeof(EthernetHeader) + sizeof(DcpHeader) + 4;
-    // BlockQualifier: Bit 0 = 0 (Temporary), Bit 0 = 1 (Permanent)
-    // Consolidating to Bit 0 for both IP and Name as per slave compatibility findings.
-    val[0] = 0x00; val[1] = permanent ? 0x01 : 0x00; 
-    
-    qDebug() << "DCP IP Set: MAC=" << mac << "IP=" << ip << "Permanent=" << permanent 
-             << "Qualifier=" << QString("0x%1%2").arg(val[0], 2, 16, QChar('0')).arg(val[1], 2, 16, QChar('0'));
-    
-    if (ipParts.size() == 4) for (int i = 0; i < 4; ++i) val[2+i] = (uint8_t)ipParts[i].toInt();
-    if (maskParts.size() == 4) for (int i = 0; i < 4; ++i) val[6+i] = (uint8_t)maskParts[i].toInt();
-    if (gwParts.size() == 4) for (int i = 0; i < 4; ++i) val[10+i] = (uint8_t)gwParts[i].toInt();
+// Text forms used by the GUI; an empty mask or gateway means 0.0.0.0 as before
+static bool parseOptionalIPv4(const QString &text, quint32 &address) {
+    address = 0;
+    return text.isEmpty() || NetworkIdentity::parseIPv4(text, address);
+}
 
-    uint32_t xid = 0x87654321;
-    dcp->xid = qToBigEndian<uint32_t>(xid);
+bool DcpScanner::sendSetRequest(const char *what, uint32_t xid) {
+    if (!m_transport->send(m_frameBuilder.finish(), m_frameBuilder.size())) {
+        qCritical() << "Error sending DCP" << what << "request:" << m_transport->lastError();
+        return false;
+    }
+    const int res = waitForSetResponse(xid);
+    return res == 0 || res == 5;
+}
+
+bool DcpScanner::setDeviceIp(const QString &mac, const QString &ip, const QString &mask, const QString &gw, bool permanent) {
+    if (!m_isConnected || !m_transport) return false;
 
-    qDebug() << "Sending DCP Set IP request (Source MAC:" << macToString(m_sourceMac) << ")...";
-    if (pcap_sendpacket(m_pcapHandle, packet, 60) != 0) {
-        qCritical() << "Error sending DCP Set IP request:" << pcap_geterr(m_pcapHandle);
+    quint64 dest = 0;
+    quint32 ipValue = 0, maskValue = 0, gwValue = 0;
+    if (!NetworkIdentity::parseMac(mac, dest) || !NetworkIdentity::parseIPv4(ip, ipValue)
+        || !parseOptionalIPv4(mask, maskValue) || !parseOptionalIPv4(gw, gwValue)) {
         return false;
     }
 
-    int res = waitForSetResponse(xid);
-    return res == 0 || res == 5;
+    // BlockQualifier: Bit 0 = 0 (Temporary), Bit 0 = 1 (Permanent)
+    // Consolidating to Bit 0 for both IP and Name as per slave compatibility findings.
+    const uint16_t qualifier = permanent ? 0x0001 : 0x0000;
+    const uint32_t xid = nextXid();
+    m_frameBuilder.beginSet(dest, xid);
+    m_frameBuilder.appendIpSuite(qualifier, ipValue, maskValue, gwValue);
+
+    qCDebug(lcDcp) << "DCP IP Set: MAC=" << mac << "IP=" << ip << "Permanent=" << permanent
+                   << "Qualifier=" << QString("0x%1").arg(qualifier, 4, 16, QChar('0'));
+    return sendSetRequest("Set IP", xid);
 }
 
 bool DcpScanner::setDeviceName(const QString &mac, const QString &name, bool permanent) {
-    if (!m_isConnected || !m_pcapHandle) return false;
-    QStringList macParts = mac.split(':');
-    if (macParts.size() != 6) return false;
-
-    QByteArray nameData = name.toUtf8();
-    int blockLen = nameData.size() + 2; // suboption + 0x00 reserved
-    if (blockLen % 2 != 0) blockLen++; // Padding
-
-    int totalLen = sizeof(EthernetHeader) + sizeof(DcpHeader) + 4 + blockLen;
-    if (totalLen < 60) totalLen = 60; // Padding for minimum Ethernet frame size
-
-    QByteArray packet(totalLen, 0);
-    uint8_t *pktData = (uint8_t*)packet.data();
-
-    EthernetHeader *eth = (EthernetHeader*)pktData;
-    for (int i = 0; i < 6; ++i) eth->dest[i] = (uint8_t)macParts[i].toInt(nullptr, 16);
-    memcpy(eth->src, m_sourceMac, 6);
-    eth->type = qToBigEndian<uint16_t>(0x8892);
-
-    DcpHeader *dcp = (DcpHeader*)(pktData + sizeof(EthernetHeader));
-    dcp->frameId = qToBigEndian<uint16_t>(0xFEFD);
-    dcp->serviceId = 0x04; // Set Request (was 0x03 which is Get)
-    dcp->serviceType = 0x01;
-    dcp->xid = qToBigEndian<uint32_t>(0x12348765);
-    dcp->responseDelay = qToBigEndian<uint16_t>(0x00FF);
-    dcp->dcpDataLength = qToBigEndian<uint16_t>(4 + blockLen);
-
-    DcpBlockHeader *block = (DcpBlockHeader*)(pktData + sizeof(EthernetHeader) + sizeof(DcpHeader));
-    block->option = 0x02;    // Device Properties
-    block->suboption = 0x02; // Name of Station
-    block->length = qToBigEndian<uint16_t>(nameData.size() + 2); 
-    
-    uint8_t *val = pktData + sizeof(EthernetHeader) + sizeof(DcpHeader) + 4;
+    if (!m_isConnected || !m_transport) return false;
+
+    quint64 dest = 0;
+    if (!NetworkIdentity::parseMac(mac, dest)) return false;
+
     // Block Qualifier for Name: Standard says bit 1 is Temp/Perm, but this slave
     // appears to use Bit 0 (0x01) for Permanent as well. Consolidation for compatibility.
-    val[0] = 0x00; val[1] = permanent ? 0x01 : 0x00; 
-    memcpy(val + 2, nameData.constData(), nameData.size());
-
-    qDebug() << "DCP Name Set: MAC=" << mac << "Name=" << name << "Permanent=" << permanent 
-             << "Qualifier=" << QString("0x%1%2").arg(val[0], 2, 16, QChar('0')).arg(val[1], 2, 16, QChar('0'));
+    const uint16_t qualifier = permanent ? 0x0001 : 0x0000;
+    const uint32_t xid = nextXid();
+    m_frameBuilder.beginSet(dest, xid);
+    if (!m_frameBuilder.appendNameOfStation(qualifier, name.toUtf8())) return false;
+
+    qCDebug(lcDcp) << "DCP Name Set: MAC=" << mac << "Name=" << name << "Permanent=" << permanent
+                   << "Qualifier=" << QString("0x%1").arg(qualifier, 4, 16, QChar('0'));
+    return sendSetRequest("Set Name", xid);
+}
 
-    uint32_t xid = 0x12348765;
-    dcp->xid = qToBigEndian<uint32_t>(xid);
+bool DcpScanner::setDeviceNameAndIp(const QString &mac, const QString &name, const QString &ip, const QString &mask, const QString &gw, bool permanent) {
+    if (!m_isConnected || !m_transport) return false;
 
-    qDebug() << "Sending DCP Set Name request (Source MAC:" << macToString(m_sourceMac) << ", Name:" << name << ", Permanent:" << permanent << ")...";
-    if (pcap_sendpacket(m_pcapHandle, (const uint8_t*)pktData, totalLen) != 0) {
-        qCritical() << "Error sending DCP Set Name request:" << pcap_geterr(m_pcapHandle);
+    quint64 dest = 0;
+    quint32 ipValue = 0, maskValue = 0, gwValue = 0;
+    if (!NetworkIdentity::parseMac(mac, dest) || !NetworkIdentity::parseIPv4(ip, ipValue)
+        || !parseOptionalIPv4(mask, maskValue) || !parseOptionalIPv4(gw, gwValue)) {
         return false;
     }
 
-    int res = waitForSetResponse(xid);
-    return res == 0 || res == 5;
-}
-
-bool DcpScanner::setDeviceNameAndIp(const QString &mac, const QString &name, const QString &ip, const QString &mask, const QString &gw, bool permanent) {
-    if (!m_isConnected || !m_pcapHandle) return false;
+    const uint32_t xid = nextXid();
+    m_frameBuilder.beginSet(dest, xid);
+    if (!m_frameBuilder.appendNameOfStation(permanent ? 0x0000 : 0x0002, name.toUtf8())) return false;
+    m_frameBuilder.appendIpSuite(permanent ? 0x0000 : 0x0001, ipValue, maskValue, gwValue);
 
-    QStringList macParts = mac.split(':');
-    if (macParts.size() != 6) return false;
+    qCDebug(lcDcp) << "Sending COMBINED DCP Set request (Name + IP) to" << mac << "- Name:" << name << "IP:" << ip << "Permanent:" << permanent;
+    return sendSetRequest("combined Set", xid);
+}
 
-    QByteArray nameData = name.toUtf8();
-    int nameBlockLen = nameData.size() + 2; // BlockInfo (2 bytes)
-    if (nameBlockLen % 2 != 0) nameBlockLen++; // Padding
+bool DcpScanner::resetFactory(const QString &mac) {
+    if (!m_isConnected || !m_transport) return false;
 
-    int ipBlockLen = 14; // BlockInfo (2 bytes) + IP Suite (12 bytes)
-    
-    int totalDataLen = 4 + nameBlockLen + 4 + ipBlockLen; // 2 blocks with headers
-    int totalLen = sizeof(EthernetHeader) + sizeof(DcpHeader) + totalDataLen;
-    if (totalLen < 60) totalLen = 60;
-
-    QByteArray packet(totalLen, 0);
-    uint8_t *pktData = (uint8_t*)packet.data();
-
-    // Ethernet Header
-    EthernetHeader *eth = (EthernetHeader*)pktData;
-    for (int i = 0; i < 6; ++i) eth->dest[i] = (uint8_t)macParts[i].toInt(nullptr, 16);
-    memcpy(eth->src, m_sourceMac, 6);
-    eth->type = qToBigEndian<uint16_t>(0x8892);
-
-    // DCP Header
-    DcpHeader *dcp = (DcpHeader*)(pktData + sizeof(EthernetHeader));
-    dcp->frameId = qToBigEndian<uint16_t>(0xFEFD);
-    dcp->serviceId = 0x04; // Set Request
-    dcp->serviceType = 0x01;
-    uint32_t xid = 0x11223344;
-    dcp->xid = qToBigEndian<uint32_t>(xid);
-    dcp->responseDelay = qToBigEndian<uint16_t>(0x00FF);
-    dcp->dcpDataLength = qToBigEndian<uint16_t>(totalDataLen);
-
-    uint8_t *payload = pktData + sizeof(EthernetHeader) + sizeof(DcpHeader);
-
-    // Block 1: NameOfStation
-    DcpBlockHeader *nameBlock = (DcpBlockHeader*)payload;
-    nameBlock->option = 0x02;    // Device Properties
-    nameBlock->suboption = 0x02; // Name of Station
-    nameBlock->length = qToBigEndian<uint16_t>(nameData.size() + 2);
-    
-    uint8_t *nameVal = payload + 4;
-    nameVal[0] = 0x00; nameVal[1] = permanent ? 0x00 : 0x02; // BlockQualifier
-    memcpy(nameVal + 2, nameData.constData(), nameData.size());
-
-    // Block 2: IP Suite  
-    int ipBlockOffset = 4 + nameBlockLen;
-    DcpBlockHeader *ipBlock = (DcpBlockHeader*)(payload + ipBlockOffset);
-    ipBlock->option = 0x01;    // IP
-    ipBlock->suboption = 0x02; // IP Suite
-    ipBlock->length = qToBigEndian<uint16_t>(14);
-
-    uint8_t *ipVal = payload + ipBlockOffset + 4;
-    ipVal[0] = 0x00; ipVal[1] = permanent ? 0x00 : 0x01; // BlockQualifier
-
-    QStringList ipParts = ip.split('.');
-    QStringList maskParts = mask.split('.');
-    QStringList gwParts = gw.split('.');
-    
-    if (ipParts.size() == 4) for (int i = 0; i < 4; ++i) ipVal[2+i] = (uint8_t)ipParts[i].toInt();
-    if (maskParts.size() == 4) for (int i = 0; i < 4; ++i) ipVal[6+i] = (uint8_t)maskParts[i].toInt();
-    if (gwParts.size() == 4) for (int i = 0; i < 4; ++i) ipVal[10+i] = (uint8_t)gwParts[i].toInt();
+    quint64 dest = 0;
+    if (!NetworkIdentity::parseMac(mac, dest)) return false;
 
-    qDebug() << "Sending COMBINED DCP Set request (Name + IP) to" << mac << "- Name:" << name << "IP:" << ip << "Permanent:" << permanent;
-    
-    if (pcap_sendpacket(m_pcapHandle, (const uint8_t*)pktData, totalLen) != 0) {
-        qCritical() << "Error sending combined DCP Set request:" << pcap_geterr(m_pcapHandle);
+    m_frameBuilder.beginSet(dest, nextXid());
+    m_frameBuilder.appendResetToFactory();
+    if (!m_transport->send(m_frameBuilder.finish(), m_frameBuilder.size())) {
+        qCritical() << "Error sending DCP Factory Reset request:" << m_transport->lastError();
         return false;
     }
 
-    int res = waitForSetResponse(xid);
-    return res == 0 || res == 5;
+    return true;
 }
 
-bool DcpScanner::resetFactory(const QString &mac) {
-    if (!m_isConnected || !m_pcapHandle) return false;
+bool DcpScanner::flashLed(const QString &mac) {
+    if (!m_isConnected || !m_transport) return false;
 
-    QStringList macParts = mac.split(':');
-    if (macParts.size() != 6) return false;
+    quint64 dest = 0;
+    if (!NetworkIdentity::parseMac(mac, dest)) return false;
 
-    uint8_t packet[64];
-    memset(packet, 0, sizeof(packet));
+    const uint32_t xid = nextXid();
+    m_frameBuilder.beginSet(dest, xid);
+    m_frameBuilder.appendSignal(0x0100); // Flash once
 
-    EthernetHeader *eth = (EthernetHeader*)packet;
-    for (int i = 0; i < 6; ++i) eth->dest[i] = (uint8_t)macParts[i].toInt(nullptr, 16);
-    memcpy(eth->src, m_sourceMac, 6);
-    eth->type = qToBigEndian<uint16_t>(0x8892);
+    // Success = 0, but some stacks return 5 for control/signal
+    return sendSetRequest("Flash LED", xid);
+}
 
-    DcpHeader *dcp = (DcpHeader*)(packet + sizeof(EthernetHeader));
-    dcp->frameId = qToBigEndian<uint16_t>(0xFEFD);
-    dcp->serviceId = 0x04; // Set Request (was 0x03 which is Get)
-    dcp->serviceType = 0x01; // Request
-    dcp->xid = qToBigEndian<uint32_t>(0x11223344);
-    dcp->responseDelay = qToBigEndian<uint16_t>(0x00FF);
-    dcp->dcpDataLength = qToBigEndian<uint16_t>(4 + 4); // Block Header + Qualifier
+QByteArray DcpScanner::setRequest(const DcpSetRequest &request, uint32_t xid) {
+    // BlockQualifier bit 0 selects permanent storage, as in the single-device setters
+    const uint16_t qualifier = request.permanent ? 0x0001 : 0x0000;
+    m_frameBuilder.beginSet(request.mac, xid);
+    if (!request.stationName.isEmpty()) {
+        m_frameBuilder.appendNameOfStation(qualifier, request.stationName.toUtf8());
+    }
+    if (request.ip != 0) {
+        m_frameBuilder.appendIpSuite(qualifier, request.ip, request.mask, request.gw);
+    }
+    m_frameBuilder.finish();
+    return m_frameBuilder.toByteArray();
+}
 
-    DcpBlockHeader *block = (DcpBlockHeader*)(packet + sizeof(EthernetHeader) + sizeof(DcpHeader));
-    block->option = 0x05; // Control Option
-    block->suboption = 0x06; // Factory Reset
-    block->length = qToBigEndian<uint16_t>(2); // Qualifier only
+QList<DcpSetResult> DcpScanner::commission(const QList<DcpSetRequest> &requests, const DcpBatchOptions &options,
+                                           const UniquenessIndex &assigned) {
+    enum EntryState { Queued, Sent, Done };
+    struct Entry {
+        QByteArray frame;
+        uint32_t xid = 0;
+        EntryState state = Queued;
+        qint64 firstSentMs = 0;
+        qint64 deadlineMs = 0;
+    };
+
+    const int count = requests.size();
+    QList<DcpSetResult> results;
+    results.reserve(count);
+    QVector<Entry> entries(count);
+    QHash<uint32_t, int> byXid;
+    QList<int> ready;
+    int done = 0;
+    int outstanding = 0;
+
+    // Identities after the batch, so two requests cannot hand out the same name or IP
+    UniquenessIndex identities = assigned;
+
+    for (int i = 0; i < count; ++i) {
+        DcpSetResult result;
+        result.mac = requests[i].mac;
+        const DcpSetRequest &request = requests[i];
+        const UniquenessIndex::Owner owner = static_cast<UniquenessIndex::Owner>(request.mac);
+        if ((request.stationName.isEmpty() && request.ip == 0) || request.stationName.toUtf8().size() > 240) {
+            result.result = DcpSetResult::InvalidRequest;
+            entries[i].state = Done;
+            ++done;
+        } else if ((!request.stationName.isEmpty() && identities.isNameTaken(request.stationName, owner))
+                   || (request.ip != 0 && identities.isIpAddressTaken(request.ip, owner))) {
+            result.result = DcpSetResult::Conflict;
+            entries[i].state = Done;
+            ++done;
+        } else if (!m_isConnected || !m_transport) {
+            result.result = DcpSetResult::SendFailed;
+            entries[i].state = Done;
+            ++done;
+        } else {
+            if (!request.stationName.isEmpty()) identities.setName(owner, request.stationName);
+            if (request.ip != 0) identities.setIpAddress(owner, request.ip);
+            entries[i].xid = nextXid();
+            entries[i].frame = setRequest(request, entries[i].xid);
+            byXid.insert(entries[i].xid, i);
+            ready.append(i);
+        }
+        results.append(result);
+    }
 
-    uint8_t *val = packet + sizeof(EthernetHeader) + sizeof(DcpHeader) + 4;
-    val[0] = 0x00; val[1] = 0x00; // Reserved/Qualifier for Factory Reset
+    const int maxOutstanding = qMax(1, options.maxOutstanding);
+    const int maxAttempts = qMax(1, options.maxAttempts);
+    QElapsedTimer clock;
+    clock.start();
+
+    const quint64 sourceMac = packMac(m_sourceMac);
+    const PacketTransport::FrameHandler onFrame = [&](const uint8_t *data, int len) {
+        DcpFrameInfo frame;
+        if (!DcpBlockParser::parseFrame(data, len, frame)) return;
+        if (frame.frameId != 0xFEFD || frame.destination != sourceMac) return;
+        if ((frame.serviceId != 0x03 && frame.serviceId != 0x04) || (frame.serviceType != 0x01 && frame.serviceType != 0x02)) return;
+
+        const int index = byXid.value(frame.xid, -1);
+        if (index < 0 || entries[index].state == Done || frame.source != requests[index].mac) return;
+
+        // One Control/Response block (option, suboption, error) per block of the request
+        const int error = qMax(0, DcpBlockParser::setResult(frame.blocks, frame.blocksLength));
+
+        DcpSetResult &result = results[index];
+        result.result = error;
+        result.elapsedMs = clock.elapsed() - entries[index].firstSentMs;
+        if (entries[index].state == Sent) --outstanding;
+        entries[index].state = Done;
+        byXid.remove(entries[index].xid);
+        ++done;
+    };
+
+    while (done < count) {
+        // Fill the window; late responses may already have completed queued retries
+        qint64 now = clock.elapsed();
+        while (outstanding < maxOutstanding && !ready.isEmpty()) {
+            const int index = ready.takeFirst();
+            Entry &entry = entries[index];
+            if (entry.state == Done) continue;
+
+            DcpSetResult &result = results[index];
+            if (!m_transport->queue((const uint8_t*)entry.frame.constData(), entry.frame.size())) {
+                qWarning() << "Error queueing DCP Set request:" << m_transport->lastError();
+                result.result = DcpSetResult::SendFailed;
+                entry.state = Done;
+                byXid.remove(entry.xid);
+                ++done;
+                continue;
+            }
+            if (result.attempts == 0) entry.firstSentMs = now;
+            entry.deadlineMs = now + (qint64(options.timeoutMs) << result.attempts);
+            ++result.attempts;
+            entry.state = Sent;
+            ++outstanding;
+        }
+        if (!m_transport->flush()) {
+            qWarning() << "Error sending DCP Set requests:" << m_transport->lastError();
+        }
+        if (done >= count) break;
 
-    if (pcap_sendpacket(m_pcapHandle, packet, 60) != 0) {
-        qCritical() << "Error sending DCP Factory Reset request:" << pcap_geterr(m_pcapHandle);
-        return false;
-    }
+        qint64 deadline = -1;
+        for (int index : std::as_const(byXid)) {
+            if (entries[index].state == Sent && (deadline < 0 || entries[index].deadlineMs < deadline)) {
+                deadline = entries[index].deadlineMs;
+            }
+        }
+        const int waitMs = deadline < 0 ? 0 : (int)qBound<qint64>(0, deadline - now, options.timeoutMs);
 
-    return true;
-}
+        const int res = m_transport->dispatch(onFrame, waitMs);
+        if (res < 0) {
+            qWarning() << "DCP batch receive failed:" << m_transport->lastError();
+            break;
+        }
 
-bool DcpScanner::flashLed(const QString &mac) {
-    if (!m_isConnected || !m_pcapHandle) return false;
-
-    QStringList macParts = mac.split(':');
-    if (macParts.size() != 6) return false;
-
-    uint8_t packet[64];
-    memset(packet, 0, sizeof(packet));
-
-    EthernetHeader *eth = (EthernetHeader*)packet;
-    for (int i = 0; i < 6; ++i) eth->dest[i] = (uint8_t)macParts[i].toInt(nullptr, 16);
-    memcpy(eth->src, m_sourceMac, 6);
-    eth->type = qToBigEndian<uint16_t>(0x8892);
-
-    DcpHeader *dcp = (DcpHeader*)(packet + sizeof(EthernetHeader));
-    dcp->frameId = qToBigEndian<uint16_t>(0xFEFD);
-    dcp->serviceId = 0x04; // Set Request (was 0x03 which is Get)
-    dcp->serviceType = 0x01;
-    dcp->xid = qToBigEndian<uint32_t>(0x55AA55AA);
-    dcp->responseDelay = qToBigEndian<uint16_t>(0x00FF);
-    dcp->dcpDataLength = qToBigEndian<uint16_t>(4 + 4); // Block header + payload
-
-    DcpBlockHeader *block = (DcpBlockHeader*)(packet + sizeof(EthernetHeader) + sizeof(DcpHeader));
-    block->option = 0x05;    // Control (Corrected from 0x03)
-    block->suboption = 0x03; // Signal
-    block->length = qToBigEndian<uint16_t>(4); 
-                                              // Payload: 2 bytes Reserved (0x0000) + 2 bytes Value
-
-    uint8_t *val = packet + sizeof(EthernetHeader) + sizeof(DcpHeader) + 4;
-    val[0] = 0x00; val[1] = 0x00; // Reserved
-    val[2] = 0x01; val[3] = 0x00; // Signal value (Flash once)
-
-    if (pcap_sendpacket(m_pcapHandle, packet, 60) != 0) { // Send at least 60 bytes
-        qCritical() << "Error sending DCP Flash LED request:" << pcap_geterr(m_pcapHandle);
-        return false;
+        // Timed out requests go back into the window until their attempts are used up
+        now = clock.elapsed();
+        for (int i = 0; i < count; ++i) {
+            Entry &entry = entries[i];
+            if (entry.state != Sent || entry.deadlineMs > now) continue;
+            --outstanding;
+            if (results[i].attempts < maxAttempts) {
+                entry.state = Queued;
+                ready.append(i);
+            } else {
+                entry.state = Done;
+                byXid.remove(entry.xid);
+                ++done;
+            }
+        }
     }
 
-    // Wait for response (Success = 0, but some stacks return 5 for control/signal)
-    int res = waitForSetResponse(0x55AA55AA);
-    return res == 0 || res == 5;
+    int failed = 0;
+    for (const DcpSetResult &result : results) {
+        if (!result.succeeded()) ++failed;
+    }
+    qDebug() << "DCP batch commissioning:" << count << "device(s)," << failed << "failed in" << clock.elapsed() << "ms";
+    return results;
 }
 
 int DcpScanner::waitForSetResponse(uint32_t xid, int timeoutMs) {
-    if (!m_pcapHandle) return -1;
+    if (!m_transport) return -1;
 
-    struct pcap_pkthdr *header;
     const uint8_t *data;
+    int length = 0;
+    const quint64 sourceMac = packMac(m_sourceMac);
     QElapsedTimer timer;
     timer.start();
 
-    // Default to 2 seconds if not specified
-    if (timeoutMs == 1000) timeoutMs = 2000;
-
-    qDebug() << "Waiting for DCP Response (XID:" << QString("0x%1").arg(xid, 8, 16, QChar('0')) << ") for" << timeoutMs << "ms...";
+    qCDebug(lcDcp) << "Waiting for DCP Response (XID:" << QString("0x%1").arg(xid, 8, 16, QChar('0')) << ") for" << timeoutMs << "ms...";
 
     QPointer<DcpScanner> safeThis(this);
     while (timer.elapsed() < timeoutMs) {
-        if (!m_pcapHandle) return -1;
-        int res = pcap_next_ex(m_pcapHandle, &header, &data);
+        if (!m_transport) return -1;
+        int res = m_transport->next(&data, &length, 10);
         if (!safeThis) return -1;
-        if (!m_pcapHandle) return -1;
+        if (!m_transport) return -1;
         if (res == 1) {
-            if (header->caplen < sizeof(EthernetHeader) + sizeof(DcpHeader)) continue;
+            DcpFrameInfo frame;
+            if (!DcpBlockParser::parseFrame(data, length, frame)) continue;
 
-            EthernetHeader *eth = (EthernetHeader*)data;
-            DcpHeader *dcp = (DcpHeader*)(data + sizeof(EthernetHeader));
-            uint16_t frameId = qFromBigEndian<uint16_t>(dcp->frameId);
-            uint32_t capturedXid = qFromBigEndian<uint32_t>(dcp->xid);
-            
             // Log ANY DCP-like frame for debugging
-            if (frameId >= 0xFE00 && frameId <= 0xFEFF) {
-                qDebug() << "  [DCP Seen] FrameID:" << QString("0x%1").arg(frameId, 4, 16, QChar('0'))
-                         << "SID:" << dcp->serviceId << "Type:" << dcp->serviceType
-                         << "XID:" << QString("0x%1").arg(capturedXid, 8, 16, QChar('0'))
-                         << "Dest:" << macToString(eth->dest);
+            if (frame.frameId >= 0xFE00 && frame.frameId <= 0xFEFF) {
+                qCDebug(lcDcp) << "  [DCP Seen] FrameID:" << QString("0x%1").arg(frame.frameId, 4, 16, QChar('0'))
+                               << "SID:" << frame.serviceId << "Type:" << frame.serviceType
+                               << "XID:" << QString("0x%1").arg(frame.xid, 8, 16, QChar('0'))
+                               << "Dest:" << macToString(data);
             }
 
             // Frame ID 0xFEFD is DCP-Get-Set, 0xFEFF is Identify Response
-            if (frameId == 0xFEFD || frameId == 0xFEFF) {
+            if (frame.frameId == 0xFEFD || frame.frameId == 0xFEFF) {
                 // Check if this is addressed to us (to avoid matching our own sent packet)
-                bool isToMe = (memcmp(eth->dest, m_sourceMac, 6) == 0);
+                bool isToMe = frame.destination == sourceMac;
                 
                 // Allow Service ID 0x03 or 0x04 in response. 
                 // Note: Some devices incorrectly use ServiceType 0x01 (Request) for responses.
                 if (isToMe && 
-                    (dcp->serviceId == 0x03 || dcp->serviceId == 0x04) && 
-                    (dcp->serviceType == 0x01 || dcp->serviceType == 0x02) && 
-                    capturedXid == xid) 
+                    (frame.serviceId == 0x03 || frame.serviceId == 0x04) && 
+                    (frame.serviceType == 0x01 || frame.serviceType == 0x02) && 
+                    frame.xid == xid) 
                 {
-                    qDebug() << "Matched DCP Response for XID:" << QString("0x%1").arg(xid, 8, 16, QChar('0'));
+                    qCDebug(lcDcp) << "Matched DCP Response for XID:" << QString("0x%1").arg(xid, 8, 16, QChar('0'));
                     
-                    uint16_t dataLen = qFromBigEndian<uint16_t>(dcp->dcpDataLength);
-                    if (dataLen >= 7) {
-                        uint8_t *payload = (uint8_t*)(data + sizeof(EthernetHeader) + sizeof(DcpHeader));
-                        // In a DCP-Set-Res ControlBlock:
-                        // payload[0..3] is BlockHeader (Option, Suboption, Length)
-                        // payload[4..5] is BlockQualifier
-                        // payload[6] is BlockResult (0=Success)
-                        int result = payload[6];
-                        qDebug() << "  DCP Block Result:" << result;
-                        return result; 
+                    const int result = DcpBlockParser::setResult(frame.blocks, frame.blocksLength);
+                    if (result >= 0) {
+                        qCDebug(lcDcp) << "  DCP Block Result:" << result;
+                        return result;
                     }
-                    
-                    // If dcpDataLength is small but we matched SID and isToMe, 
+
+                    // No Control/Response block but we matched SID and isToMe,
                     // and it's not a known error type, assume success.
                     return 0; 
                 }
@@ -734,10 +834,16 @@ int DcpScanner::waitForSetResponse(uint32_t xid, int timeoutMs) {
         QCoreApplication::processEvents();
         if (!safeThis) return -1;
     }
-    qDebug() << "DCP Response timeout for XID:" << QString("0x%1").arg(xid, 8, 16, QChar('0'));
+    qCDebug(lcDcp) << "DCP Response timeout for XID:" << QString("0x%1").arg(xid, 8, 16, QChar('0'));
     return -2; // Timeout
 }
 
+quint64 DcpScanner::packMac(const uint8_t *mac) {
+    quint64 value = 0;
+    for (int i = 0; i < 6; ++i) value = (value << 8) | mac[i];
+    return value;
+}
+
 QString DcpScanner::macToString(const uint8_t *mac) {
     return QString("%1:%2:%3:%4:%5:%6")
         .arg(mac[0], 2, 16, QChar('0'))
@@ -2,27 +2,83 @@
 #define DCPSCANNER_H
 
 #include <QString>
+#include <QByteArray>
 #include <QObject>
 #include <QList>
+#include <QHash>
+#include <QMetaType>
+#include <QLoggingCategory>
 #include <cstdint>
-#include <pcap.h>
+#include <memory>
+
+#include "../DataModel/NetworkIdentity.h"
+#include "../DataModel/UniquenessIndex.h"
+#include "PacketTransport.h"
+#include "DcpFrameBuilder.h"
 
 namespace PNConfigLib {
 
+// Per-request and per-frame DCP tracing; disable with QT_LOGGING_RULES="pnconfig.dcp.debug=false"
+Q_DECLARE_LOGGING_CATEGORY(lcDcp)
+
 struct InterfaceInfo {
     QString name;
     QString description;
 };
 
+/**
+ * @brief Station found by DCP Identify.
+ *
+ * Addresses are kept in binary form; the string accessors are for display
+ * and for APIs that still take text.
+ */
 struct DiscoveredDevice {
     QString deviceName;
     QString deviceType;
-    QString macAddress;
-    QString ipAddress = "0.0.0.0";
-    QString subnetMask = "0.0.0.0";
-    QString gateway = "0.0.0.0";
+    quint64 mac = 0;    // 48-bit MAC, first octet in bits 47..40
+    quint32 ip = 0;     // IPv4 suite in host byte order
+    quint32 mask = 0;
+    quint32 gw = 0;
     uint16_t vendorId = 0;
     uint16_t deviceId = 0;
+
+    QString macAddress() const { return NetworkIdentity::formatMac(mac); }
+    QString ipAddress() const { return NetworkIdentity::formatIPv4(ip); }
+    QString subnetMask() const { return NetworkIdentity::formatIPv4(mask); }
+    QString gateway() const { return NetworkIdentity::formatIPv4(gw); }
+};
+
+/**
+ * @brief Discovered devices in arrival order with a MAC index for O(1) merging
+ */
+class DiscoveredDeviceList {
+public:
+    int size() const { return m_devices.size(); }
+    bool isEmpty() const { return m_devices.isEmpty(); }
+    const DiscoveredDevice &operator[](int index) const { return m_devices[index]; }
+    const DiscoveredDevice &at(int index) const { return m_devices.at(index); }
+    QList<DiscoveredDevice>::const_iterator begin() const { return m_devices.cbegin(); }
+    QList<DiscoveredDevice>::const_iterator end() const { return m_devices.cend(); }
+    const QList<DiscoveredDevice> &toList() const { return m_devices; }
+
+    int indexOf(quint64 mac) const { return m_index.value(mac, -1); }
+
+    /**
+     * @brief Append a device, or replace the entry with the same MAC.
+     * @return Index of the device
+     */
+    int insert(const DiscoveredDevice &device);
+
+    /**
+     * @brief Remove the device with this MAC; later devices move up by one.
+     * @return false if the MAC is not in the list
+     */
+    bool remove(quint64 mac);
+    void clear();
+
+private:
+    QList<DiscoveredDevice> m_devices;
+    QHash<quint64, int> m_index;
 };
 
 #pragma pack(push, 1)
@@ -48,6 +104,76 @@ struct DcpBlockHeader {
 };
 #pragma pack(pop)
 
+/**
+ * @brief Name and/or IP suite to assign to one device in a batch commissioning run
+ */
+struct DcpSetRequest {
+    quint64 mac = 0;
+    QString stationName;    // Empty: the name is not changed
+    quint32 ip = 0;         // 0: the IP suite is not changed; host byte order
+    quint32 mask = 0;
+    quint32 gw = 0;
+    bool permanent = true;
+};
+
+/**
+ * @brief Outcome of one DcpSetRequest
+ */
+struct DcpSetResult {
+    static constexpr int Timeout = -2;          // No response after all attempts
+    static constexpr int InvalidRequest = -3;   // Nothing to set or name too long
+    static constexpr int SendFailed = -4;
+    static constexpr int Conflict = -5;         // Name or IP already held by another MAC
+
+    quint64 mac = 0;
+    int result = Timeout;   // First non-zero DCP BlockError of the response, 0 on success
+    int attempts = 0;
+    qint64 elapsedMs = 0;   // First transmission -> response
+
+    /// Same acceptance as the single-device setters: some stacks answer Set with error 5
+    bool succeeded() const { return result == 0 || result == 5; }
+};
+
+/**
+ * @brief Pacing of DcpScanner::commission()
+ */
+struct DcpBatchOptions {
+    int maxOutstanding = 64;    // Requests in flight at once
+    int timeoutMs = 250;        // Response timeout of the first attempt, doubled for each retry
+    int maxAttempts = 4;
+};
+
+/**
+ * @brief Selects which stations answer a DCP Identify request and when a scan may finish early.
+ *
+ * Only stations matching the filter block respond. With a unique filter
+ * (name, alias, IP) the scan ends as soon as the responder has answered
+ * instead of waiting for the whole ResponseDelay window.
+ */
+struct DcpIdentifyFilter {
+    enum Kind { All, NameOfStation, AliasName, IpSuite, DeviceId };
+
+    Kind kind = All;
+    QString text;           // NameOfStation or AliasName
+    quint32 ip = 0;         // IP suite in host byte order
+    quint32 mask = 0;
+    quint32 gw = 0;
+    uint16_t vendorId = 0;
+    uint16_t deviceId = 0;
+
+    /// Finish after this many stations answered; 0 waits for the whole window
+    int expectedResponses = 0;
+    /// Finish as soon as this MAC answered, regardless of expectedResponses
+    quint64 expectedMac = 0;
+
+    static DcpIdentifyFilter byName(const QString &name);
+    static DcpIdentifyFilter byAlias(const QString &alias);
+    static DcpIdentifyFilter byIp(quint32 ip, quint32 mask, quint32 gw);
+    static DcpIdentifyFilter byDeviceId(uint16_t vendorId, uint16_t deviceId);
+};
+
+class DcpCaptureThread;
+
 class DcpScanner : public QObject {
     Q_OBJECT
 public:
@@ -59,28 +185,139 @@ public:
     bool connectToInterface(const QString &interfaceName);
     void disconnectFromInterface();
     bool isConnected() const { return m_isConnected; }
+
+    /**
+     * @brief Backend used by the next connectToInterface() and by scan threads,
+     * e.g. PacketBackend::Loopback to run against simulated devices.
+     */
+    void setPacketBackend(PacketBackend backend) { m_backend = backend; }
+    PacketBackend packetBackend() const { return m_backend; }
     const uint8_t* getSourceMac() const { return m_sourceMac; }
 
+    /// Default Identify ResponseDelayFactor; devices spread their replies over factor x 10 ms
+    static constexpr uint16_t DefaultResponseDelayFactor = 0x00FF;
+    /// Filtered requests reach at most a few stations, which may answer without delay
+    static constexpr uint16_t FilteredResponseDelayFactor = 0x0001;
+    /// Extra time after the ResponseDelay window for the last replies to arrive
+    static constexpr int ResponseWindowMarginMs = 500;
+    /// Margin for filtered requests; the few stations addressed answer within milliseconds
+    static constexpr int FilteredResponseWindowMarginMs = 50;
+    /// Time the blocking setters wait for the Set response
+    static constexpr int SetResponseTimeoutMs = 2000;
+
+    /**
+     * @brief Time a scan listens for Identify responses for the given ResponseDelayFactor.
+     */
+    static int responseWindowMs(uint16_t responseDelayFactor, bool filtered = false);
+
+    /**
+     * @brief Start a non-blocking Identify All scan on a dedicated capture thread.
+     *
+     * deviceDiscovered/deviceUpdated are emitted while responses arrive and
+     * scanFinished once the ResponseDelay window has elapsed.
+     * @return false if not connected or a scan is already running
+     */
+    bool startScan(uint16_t responseDelayFactor = DefaultResponseDelayFactor);
+
+    /**
+     * @brief Non-blocking filtered Identify; same signals as startScan().
+     * scanFinished is emitted early once the filter's expected responder(s) answered.
+     */
+    bool startIdentify(const DcpIdentifyFilter &filter,
+                       uint16_t responseDelayFactor = FilteredResponseDelayFactor);
+
+    /**
+     * @brief Stop a running scan. scanFinished is not emitted for it.
+     */
+    void cancelScan();
+    bool isScanning() const { return m_captureThread != nullptr; }
+
+    /**
+     * @brief Blocking scan; waits for the capture thread without spinning the event loop.
+     */
     QList<DiscoveredDevice> scan();
+
+    /**
+     * @brief Blocking filtered Identify, e.g. to locate one station by name in milliseconds.
+     */
+    QList<DiscoveredDevice> identify(const DcpIdentifyFilter &filter,
+                                     uint16_t responseDelayFactor = FilteredResponseDelayFactor);
+
+    /**
+     * @brief Repeat a filtered Identify until filter.expectedMac answers, e.g. after a name Set.
+     *
+     * Runs on the scanner's own capture handle, so polling opens no capture
+     * thread or handle per request.
+     * @return true if the station answered within timeoutMs
+     */
+    bool waitForIdentify(const DcpIdentifyFilter &filter, int timeoutMs);
     bool setDeviceIp(const QString &mac, const QString &ip, const QString &mask, const QString &gw, bool permanent = false);
     bool setDeviceName(const QString &mac, const QString &name, bool permanent = false);
     bool setDeviceNameAndIp(const QString &mac, const QString &name, const QString &ip, const QString &mask, const QString &gw, bool permanent = false);
     bool resetFactory(const QString &mac);
     bool flashLed(const QString &mac);
 
-private:
-    int waitForSetResponse(uint32_t xid, int timeoutMs = 1000);
+    /**
+     * @brief Commission many devices at once with DCP Set (name and/or IP suite).
+     *
+     * Up to maxOutstanding requests are in flight, each with its own XID;
+     * responses are matched by XID and source MAC, unanswered requests are
+     * resent with the same XID and a doubled timeout. Blocks until every
+     * request is answered or out of attempts.
+     *
+     * A request whose name or IP is already held by another MAC, in
+     * assigned or by an earlier request of the batch, is not sent and
+     * reports DcpSetResult::Conflict.
+     * @param assigned Names and IPs in use on the network; owners are packMac() values
+     * @return One result per request, in request order
+     */
+    QList<DcpSetResult> commission(const QList<DcpSetRequest> &requests,
+                                   const DcpBatchOptions &options = DcpBatchOptions(),
+                                   const UniquenessIndex &assigned = UniquenessIndex());
+
+    /**
+     * @brief Parse a received frame and add/merge a DCP Identify response into devices.
+     * Frames that are not Identify responses are ignored.
+     * @param changed Set to true if the device was added or any of its fields changed
+     * @return Index of the added/merged device, or -1 if the frame was ignored
+     */
+    static int parseDcpPacket(const uint8_t *data, int len, DiscoveredDeviceList &devices,
+                              bool *changed = nullptr);
+    static QString macToString(const uint8_t *mac);
+    static quint64 packMac(const uint8_t *mac);
+
+    /// Capture filter restricting a transport to PROFINET frames (EtherType 0x8892)
+    static constexpr const char *ProfinetFilter = "ether proto 0x8892";
+
+signals:
+    void deviceDiscovered(const PNConfigLib::DiscoveredDevice &device);
+    void deviceUpdated(const PNConfigLib::DiscoveredDevice &device);
+    void scanFinished(const QList<PNConfigLib::DiscoveredDevice> &devices);
 
 private:
-    void parseDcpPacket(const uint8_t *data, int len, QList<DiscoveredDevice> &devices);
-    QString macToString(const uint8_t *mac);
+    QByteArray identifyRequest(const DcpIdentifyFilter &filter, uint16_t responseDelayFactor, uint32_t xid);
+    DcpCaptureThread *createIdentifyThread(const DcpIdentifyFilter &filter, uint16_t responseDelayFactor,
+                                           QObject *parent);
+    int waitForSetResponse(uint32_t xid, int timeoutMs = SetResponseTimeoutMs);
+    uint32_t nextXid() { return m_nextXid++; }
+    QByteArray setRequest(const DcpSetRequest &request, uint32_t xid);
+    bool sendSetRequest(const char *what, uint32_t xid);
 
     bool m_isConnected = false;
     QString m_interfaceName;
     uint8_t m_sourceMac[6] = {0};
-    pcap_t *m_pcapHandle = nullptr;
+    PacketBackend m_backend = PacketBackend::Default;
+    std::unique_ptr<PacketTransport> m_transport;
+    uint32_t m_nextXid = 0;
+    DcpFrameBuilder m_frameBuilder;
+
+    DcpCaptureThread *m_captureThread = nullptr;
+    quint64 m_scanGeneration = 0;
 };
 
 } // namespace PNConfigLib
 
+Q_DECLARE_METATYPE(PNConfigLib::DiscoveredDevice)
+Q_DECLARE_METATYPE(QList<PNConfigLib::DiscoveredDevice>)
+
 #endif // DCPSCANNER_H
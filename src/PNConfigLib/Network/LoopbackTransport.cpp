@@ -0,0 +1,196 @@
+#include "LoopbackTransport.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <atomic>
+#include <cstring>
+
+namespace PNConfigLib {
+
+struct LoopbackSegment {
+    QMutex mutex;
+    QList<LoopbackTransport*> endpoints;
+};
+
+// Segments by interface name; a segment lives as long as one endpoint is open on it
+static QMutex s_segmentsMutex;
+static QHash<QString, std::weak_ptr<LoopbackSegment>> s_segments;
+static std::atomic<quint32> s_nextEndpoint{1};
+
+static std::shared_ptr<LoopbackSegment> attachSegment(const QString &name) {
+    QMutexLocker locker(&s_segmentsMutex);
+    std::shared_ptr<LoopbackSegment> segment = s_segments.value(name).lock();
+    if (!segment) {
+        segment = std::make_shared<LoopbackSegment>();
+        s_segments.insert(name, segment);
+    }
+    return segment;
+}
+
+static void releaseSegment(const QString &name) {
+    QMutexLocker locker(&s_segmentsMutex);
+    auto it = s_segments.find(name);
+    if (it != s_segments.end() && it.value().expired()) {
+        s_segments.erase(it);
+    }
+}
+
+LoopbackTransport::LoopbackTransport() {
+    // Locally administered unicast address, unique per endpoint in this process
+    const quint32 id = s_nextEndpoint.fetch_add(1);
+    m_mac[0] = 0x02;
+    m_mac[1] = 0x00;
+    m_mac[2] = (id >> 24) & 0xFF;
+    m_mac[3] = (id >> 16) & 0xFF;
+    m_mac[4] = (id >> 8) & 0xFF;
+    m_mac[5] = id & 0xFF;
+}
+
+LoopbackTransport::~LoopbackTransport() {
+    close();
+}
+
+bool LoopbackTransport::open(const QString &interfaceName, const QString &filter) {
+    close();
+
+    m_etherType = -1;
+    if (!filter.isEmpty()) {
+        static const QRegularExpression etherProto("^\\s*ether\\s+proto\\s+(0x[0-9A-Fa-f]+|\\d+)\\s*$");
+        QRegularExpressionMatch match = etherProto.match(filter);
+        bool ok = false;
+        const int type = match.hasMatch() ? match.captured(1).toInt(&ok, 0) : 0;
+        if (ok && type >= 0 && type <= 0xFFFF) {
+            m_etherType = type;
+        } else {
+            qWarning() << "Loopback transport ignores filter:" << filter;
+        }
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_frames.clear();
+        m_interrupted = false;
+        m_dropped = 0;
+    }
+
+    m_interfaceName = interfaceName;
+    m_segment = attachSegment(interfaceName);
+    QMutexLocker locker(&m_segment->mutex);
+    m_segment->endpoints.append(this);
+    return true;
+}
+
+void LoopbackTransport::close() {
+    if (!m_segment) return;
+    {
+        QMutexLocker locker(&m_segment->mutex);
+        m_segment->endpoints.removeOne(this);
+    }
+    m_segment.reset();
+    releaseSegment(m_interfaceName);
+}
+
+bool LoopbackTransport::hardwareAddress(uint8_t mac[6]) const {
+    memcpy(mac, m_mac, 6);
+    return true;
+}
+
+bool LoopbackTransport::accepts(const QByteArray &frame) const {
+    if (m_etherType < 0) return true;
+    if (frame.size() < 14) return false;
+    const uint8_t *data = reinterpret_cast<const uint8_t*>(frame.constData());
+    int type = (data[12] << 8) | data[13];
+    if (type == 0x8100 && frame.size() >= 18) {
+        type = (data[16] << 8) | data[17];
+    }
+    return type == m_etherType;
+}
+
+void LoopbackTransport::deliver(const QByteArray &frame) {
+    if (!accepts(frame)) return;
+    QMutexLocker locker(&m_mutex);
+    if ((int)m_frames.size() >= m_queueLimit) {
+        m_dropped++;
+        return;
+    }
+    m_frames.push_back(frame);
+    m_ready.wakeOne();
+}
+
+quint64 LoopbackTransport::droppedFrames() const {
+    QMutexLocker locker(&m_mutex);
+    return m_dropped;
+}
+
+bool LoopbackTransport::send(const uint8_t *frame, int length) {
+    if (!m_segment) {
+        m_lastError = "Loopback transport is not open";
+        return false;
+    }
+
+    // One copy shared by every receiver
+    const QByteArray data(reinterpret_cast<const char*>(frame), length);
+    QMutexLocker locker(&m_segment->mutex);
+    for (LoopbackTransport *endpoint : std::as_const(m_segment->endpoints)) {
+        if (endpoint != this) {
+            endpoint->deliver(data);
+        }
+    }
+    return true;
+}
+
+bool LoopbackTransport::waitForFrames(int timeoutMs) {
+    QElapsedTimer timer;
+    timer.start();
+    while (m_frames.empty()) {
+        if (m_interrupted) {
+            m_interrupted = false;
+            return false;
+        }
+        const qint64 remaining = timeoutMs - timer.elapsed();
+        if (remaining <= 0) return false;
+        m_ready.wait(&m_mutex, (unsigned long)remaining);
+    }
+    return true;
+}
+
+int LoopbackTransport::next(const uint8_t **data, int *length, int timeoutMs) {
+    if (!m_segment) return -1;
+
+    QMutexLocker locker(&m_mutex);
+    if (!waitForFrames(timeoutMs)) return 0;
+    m_current = std::move(m_frames.front());
+    m_frames.pop_front();
+    *data = reinterpret_cast<const uint8_t*>(m_current.constData());
+    *length = m_current.size();
+    return 1;
+}
+
+int LoopbackTransport::dispatch(const FrameHandler &handler, int timeoutMs) {
+    if (!m_segment) return -1;
+
+    // Take the whole queue under one lock, then run the handler without it so
+    // the handler may send (and thereby deliver to this segment) freely
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!waitForFrames(timeoutMs)) return 0;
+        m_batch.swap(m_frames);
+    }
+    const int count = (int)m_batch.size();
+    for (const QByteArray &frame : m_batch) {
+        handler(reinterpret_cast<const uint8_t*>(frame.constData()), frame.size());
+    }
+    m_batch.clear();
+    return count;
+}
+
+void LoopbackTransport::interrupt() {
+    QMutexLocker locker(&m_mutex);
+    m_interrupted = true;
+    m_ready.wakeAll();
+}
+
+} // namespace PNConfigLib
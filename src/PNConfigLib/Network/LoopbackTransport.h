@@ -0,0 +1,78 @@
+#ifndef LOOPBACKTRANSPORT_H
+#define LOOPBACKTRANSPORT_H
+
+#include "PacketTransport.h"
+#include <QByteArray>
+#include <QMutex>
+#include <QWaitCondition>
+#include <deque>
+#include <memory>
+
+namespace PNConfigLib {
+
+struct LoopbackSegment;
+
+/**
+ * @brief In-process backend: every transport opened on the same interface name
+ * shares one virtual Ethernet segment.
+ *
+ * A frame sent by one endpoint is queued to all other endpoints on the segment
+ * (promiscuous, like a hub), so a controller and simulated devices can talk
+ * without a NIC. Delivery happens inside send(); a single-threaded caller that
+ * sends and then receives always sees the same frames in the same order.
+ * Filters of the form "ether proto <type>" are honoured, other expressions
+ * are ignored.
+ */
+class LoopbackTransport : public PacketTransport {
+public:
+    /// Frames waiting in one endpoint before further frames are dropped
+    static constexpr int DefaultQueueLimit = 65536;
+
+    LoopbackTransport();
+    ~LoopbackTransport() override;
+
+    bool open(const QString &interfaceName, const QString &filter = QString()) override;
+    void close() override;
+    bool isOpen() const override { return m_segment != nullptr; }
+
+    bool send(const uint8_t *frame, int length) override;
+    int next(const uint8_t **data, int *length, int timeoutMs) override;
+    int dispatch(const FrameHandler &handler, int timeoutMs) override;
+    void interrupt() override;
+
+    PacketBackend backend() const override { return PacketBackend::Loopback; }
+    bool hardwareAddress(uint8_t mac[6]) const override;
+
+    void setQueueLimit(int frames) { m_queueLimit = frames; }
+    /// Frames discarded because this endpoint's queue was full
+    quint64 droppedFrames() const;
+
+    /**
+     * @brief Queue a frame to this endpoint as if it had arrived from the segment.
+     */
+    void deliver(const QByteArray &frame);
+
+private:
+    bool accepts(const QByteArray &frame) const;
+    /// Wait for queued frames; mutex held. False on timeout or interrupt
+    bool waitForFrames(int timeoutMs);
+
+    std::shared_ptr<LoopbackSegment> m_segment;
+    QString m_interfaceName;
+    uint8_t m_mac[6];
+    int m_etherType = -1;   // -1 accepts every frame
+    int m_queueLimit = DefaultQueueLimit;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_ready;
+    std::deque<QByteArray> m_frames;
+    bool m_interrupted = false;
+    quint64 m_dropped = 0;
+
+    QByteArray m_current;   // Keeps the frame returned by next() alive
+    std::deque<QByteArray> m_batch;
+};
+
+} // namespace PNConfigLib
+
+#endif // LOOPBACKTRANSPORT_H
@@ -0,0 +1,314 @@
+#include "PacketMmapTransport.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <cerrno>
+#include <cstring>
+#include <arpa/inet.h>
+#include <linux/filter.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <pcap.h>
+
+namespace PNConfigLib {
+
+// Upper bound for a single sleep; interrupt() wakes earlier through the eventfd
+static const int MaxWaitMs = 50;
+
+// TPACKET_V3 TX frames carry their payload right after the aligned header
+static const size_t TxDataOffset = TPACKET_ALIGN(sizeof(struct tpacket3_hdr));
+
+PacketMmapTransport::PacketMmapTransport() : m_config() {}
+
+PacketMmapTransport::PacketMmapTransport(const RingConfig &config) : m_config(config) {}
+
+PacketMmapTransport::~PacketMmapTransport() {
+    close();
+}
+
+bool PacketMmapTransport::fail(const QString &what) {
+    m_lastError = QString("%1: %2").arg(what, QString::fromLocal8Bit(strerror(errno)));
+    close();
+    return false;
+}
+
+bool PacketMmapTransport::open(const QString &interfaceName, const QString &filter) {
+    close();
+
+    const unsigned int ifIndex = if_nametoindex(interfaceName.toLocal8Bit().constData());
+    if (ifIndex == 0) {
+        m_lastError = QString("Unknown interface: %1").arg(interfaceName);
+        return false;
+    }
+
+    // Protocol 0: nothing is queued until bind(), so the filter is in place before the first frame
+    m_fd = socket(AF_PACKET, SOCK_RAW, 0);
+    if (m_fd < 0) return fail("socket(AF_PACKET)");
+
+    int version = TPACKET_V3;
+    if (setsockopt(m_fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
+        return fail("PACKET_VERSION");
+    }
+    if (!setupRings()) return false;
+    if (!filter.isEmpty() && !attachFilter(filter)) return false;
+
+    struct sockaddr_ll addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sll_family = AF_PACKET;
+    addr.sll_protocol = htons(ETH_P_ALL);
+    addr.sll_ifindex = (int)ifIndex;
+    if (bind(m_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) return fail("bind");
+
+    struct packet_mreq mreq;
+    memset(&mreq, 0, sizeof(mreq));
+    mreq.mr_ifindex = (int)ifIndex;
+    mreq.mr_type = PACKET_MR_PROMISC;
+    if (setsockopt(m_fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+        qWarning() << "Could not enable promiscuous mode on" << interfaceName << ":" << strerror(errno);
+    }
+
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wakeFd < 0) return fail("eventfd");
+
+    return true;
+}
+
+bool PacketMmapTransport::setupRings() {
+    struct tpacket_req3 rx;
+    memset(&rx, 0, sizeof(rx));
+    rx.tp_block_size = m_config.blockSize;
+    rx.tp_block_nr = m_config.blockCount;
+    rx.tp_frame_size = m_config.frameSize;
+    rx.tp_frame_nr = (m_config.blockSize / m_config.frameSize) * m_config.blockCount;
+    rx.tp_retire_blk_tov = m_config.blockTimeoutMs;
+    if (setsockopt(m_fd, SOL_PACKET, PACKET_RX_RING, &rx, sizeof(rx)) < 0) {
+        return fail("PACKET_RX_RING");
+    }
+    const size_t rxSize = (size_t)m_config.blockSize * m_config.blockCount;
+
+    // TX ring; the kernel rejects V3 TX rings with block timeout/private area set
+    const int framesPerBlock = m_config.blockSize / m_config.frameSize;
+    struct tpacket_req3 tx;
+    memset(&tx, 0, sizeof(tx));
+    tx.tp_block_size = m_config.blockSize;
+    tx.tp_block_nr = (m_config.txFrameCount + framesPerBlock - 1) / framesPerBlock;
+    tx.tp_frame_size = m_config.frameSize;
+    tx.tp_frame_nr = tx.tp_block_nr * framesPerBlock;
+    size_t txSize = 0;
+    if (setsockopt(m_fd, SOL_PACKET, PACKET_TX_RING, &tx, sizeof(tx)) == 0) {
+        txSize = (size_t)tx.tp_block_size * tx.tp_block_nr;
+        m_config.txFrameCount = (int)tx.tp_frame_nr;
+
+        // Drop malformed TX frames instead of stalling the ring on them
+        int loss = 1;
+        setsockopt(m_fd, SOL_PACKET, PACKET_LOSS, &loss, sizeof(loss));
+        int bypass = 1;
+        setsockopt(m_fd, SOL_PACKET, PACKET_QDISC_BYPASS, &bypass, sizeof(bypass));
+    } else {
+        qWarning() << "TPACKET_V3 TX ring unavailable, sending frame by frame:" << strerror(errno);
+    }
+
+    m_mapSize = rxSize + txSize;
+    void *map = mmap(nullptr, m_mapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, 0);
+    if (map == MAP_FAILED) {
+        m_mapSize = 0;
+        return fail("mmap");
+    }
+    m_map = (uint8_t*)map;
+    m_txRing = txSize ? m_map + rxSize : nullptr;
+    m_rxBlock = 0;
+    m_blockHeld = false;
+    m_rxRemaining = 0;
+    m_txSlot = 0;
+    m_txPending = 0;
+    return true;
+}
+
+bool PacketMmapTransport::attachFilter(const QString &filter) {
+    // libpcap compiles the expression; the classic BPF program is attached to the socket directly
+    pcap_t *dead = pcap_open_dead(DLT_EN10MB, 65535);
+    if (!dead) {
+        m_lastError = "pcap_open_dead failed";
+        close();
+        return false;
+    }
+    struct bpf_program program;
+    if (pcap_compile(dead, &program, filter.toLatin1().constData(), 1, PCAP_NETMASK_UNKNOWN) == -1) {
+        m_lastError = QString("Error compiling BPF filter: %1").arg(QString::fromLocal8Bit(pcap_geterr(dead)));
+        pcap_close(dead);
+        close();
+        return false;
+    }
+
+    struct sock_fprog fprog;
+    fprog.len = (unsigned short)program.bf_len;
+    fprog.filter = (struct sock_filter*)program.bf_insns;
+    int res = setsockopt(m_fd, SOL_SOCKET, SO_ATTACH_FILTER, &fprog, sizeof(fprog));
+    pcap_freecode(&program);
+    pcap_close(dead);
+    if (res < 0) return fail("SO_ATTACH_FILTER");
+    return true;
+}
+
+void PacketMmapTransport::close() {
+    if (m_map) {
+        munmap(m_map, m_mapSize);
+        m_map = nullptr;
+        m_mapSize = 0;
+        m_txRing = nullptr;
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    if (m_wakeFd >= 0) {
+        ::close(m_wakeFd);
+        m_wakeFd = -1;
+    }
+    m_blockHeld = false;
+    m_rxRemaining = 0;
+    m_txPending = 0;
+}
+
+tpacket_block_desc *PacketMmapTransport::rxBlock(int index) const {
+    return (tpacket_block_desc*)(m_map + (size_t)index * m_config.blockSize);
+}
+
+tpacket3_hdr *PacketMmapTransport::txSlot(int index) const {
+    return (tpacket3_hdr*)(m_txRing + (size_t)index * m_config.frameSize);
+}
+
+void PacketMmapTransport::releaseBlock() {
+    __atomic_store_n(&rxBlock(m_rxBlock)->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+    m_rxBlock = (m_rxBlock + 1) % m_config.blockCount;
+    m_blockHeld = false;
+}
+
+bool PacketMmapTransport::waitReadable(int timeoutMs, bool &interrupted) {
+    interrupted = false;
+    struct pollfd pfd[2];
+    pfd[0].fd = m_fd;
+    pfd[0].events = POLLIN | POLLERR;
+    pfd[0].revents = 0;
+    pfd[1].fd = m_wakeFd;
+    pfd[1].events = POLLIN;
+    pfd[1].revents = 0;
+    if (::poll(pfd, 2, timeoutMs) <= 0) return false;
+    if (pfd[1].revents & POLLIN) {
+        uint64_t value;
+        ssize_t unused = ::read(m_wakeFd, &value, sizeof(value));
+        (void)unused;
+        interrupted = true;
+        return false;
+    }
+    return true;
+}
+
+void PacketMmapTransport::interrupt() {
+    if (m_wakeFd >= 0) {
+        uint64_t one = 1;
+        ssize_t unused = ::write(m_wakeFd, &one, sizeof(one));
+        (void)unused;
+    }
+}
+
+int PacketMmapTransport::next(const uint8_t **data, int *length, int timeoutMs) {
+    if (m_fd < 0) return -1;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (;;) {
+        // The previous frame's data stays valid until this call, so the block is returned only now
+        if (m_blockHeld && m_rxRemaining == 0) {
+            releaseBlock();
+        }
+
+        if (!m_blockHeld) {
+            tpacket_block_desc *block = rxBlock(m_rxBlock);
+            uint32_t status = __atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE);
+            if (!(status & TP_STATUS_USER)) {
+                const qint64 remaining = timeoutMs - timer.elapsed();
+                if (remaining <= 0) return 0;
+                bool interrupted;
+                waitReadable((int)qMin<qint64>(remaining, MaxWaitMs), interrupted);
+                if (interrupted) return 0;
+                continue;
+            }
+            m_blockHeld = true;
+            m_rxRemaining = block->hdr.bh1.num_pkts;
+            m_rxFrame = (tpacket3_hdr*)((uint8_t*)block + block->hdr.bh1.offset_to_first_pkt);
+            if (m_rxRemaining == 0) continue;
+        }
+
+        *data = (const uint8_t*)m_rxFrame + m_rxFrame->tp_mac;
+        *length = (int)m_rxFrame->tp_snaplen;
+        m_rxFrame = (tpacket3_hdr*)((uint8_t*)m_rxFrame + m_rxFrame->tp_next_offset);
+        m_rxRemaining--;
+        return 1;
+    }
+}
+
+bool PacketMmapTransport::queue(const uint8_t *frame, int length) {
+    if (m_fd < 0) return false;
+    if (!m_txRing) return send(frame, length);
+    if ((size_t)length + TxDataOffset > (size_t)m_config.frameSize) {
+        m_lastError = QString("Frame of %1 bytes exceeds TX slot").arg(length);
+        return false;
+    }
+
+    tpacket3_hdr *slot = txSlot(m_txSlot);
+    if (__atomic_load_n(&slot->tp_status, __ATOMIC_ACQUIRE) != TP_STATUS_AVAILABLE) {
+        // Ring full: push what is pending and give the kernel a moment to drain it
+        flush();
+        struct pollfd pfd;
+        pfd.fd = m_fd;
+        pfd.events = POLLOUT;
+        pfd.revents = 0;
+        ::poll(&pfd, 1, 10);
+        if (__atomic_load_n(&slot->tp_status, __ATOMIC_ACQUIRE) != TP_STATUS_AVAILABLE) {
+            m_lastError = "TX ring full";
+            return false;
+        }
+    }
+
+    memcpy((uint8_t*)slot + TxDataOffset, frame, length);
+    slot->tp_len = length;
+    slot->tp_snaplen = length;
+    slot->tp_next_offset = 0;
+    __atomic_store_n(&slot->tp_status, TP_STATUS_SEND_REQUEST, __ATOMIC_RELEASE);
+
+    m_txSlot = (m_txSlot + 1) % m_config.txFrameCount;
+    m_txPending++;
+    return true;
+}
+
+bool PacketMmapTransport::flush() {
+    if (m_fd < 0) return false;
+    if (m_txPending == 0) return true;
+
+    m_txPending = 0;
+    if (::sendto(m_fd, nullptr, 0, 0, nullptr, 0) < 0) {
+        m_lastError = QString("TX ring flush: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+    return true;
+}
+
+bool PacketMmapTransport::send(const uint8_t *frame, int length) {
+    if (m_fd < 0) return false;
+    if (m_txRing) {
+        return queue(frame, length) && flush();
+    }
+    if (::send(m_fd, frame, length, 0) != length) {
+        m_lastError = QString("send: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+    return true;
+}
+
+} // namespace PNConfigLib
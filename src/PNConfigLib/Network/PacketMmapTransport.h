@@ -0,0 +1,77 @@
+#ifndef PACKETMMAPTRANSPORT_H
+#define PACKETMMAPTRANSPORT_H
+
+#include "PacketTransport.h"
+#include <cstddef>
+
+struct tpacket3_hdr;
+struct tpacket_block_desc;
+
+namespace PNConfigLib {
+
+/**
+ * @brief Linux AF_PACKET backend with memory-mapped TPACKET_V3 rings.
+ *
+ * The kernel fills whole RX blocks that are walked in user space without a
+ * system call per frame; a block is handed back once all of its frames have
+ * been consumed. Frames queued with queue() are written into the TX ring and
+ * sent together by flush(). Transmit bypasses the qdisc layer. Kernels
+ * without TPACKET_V3 TX support fall back to one send() per frame.
+ */
+class PacketMmapTransport : public PacketTransport {
+public:
+    struct RingConfig {
+        int blockSize = 1 << 17;   // Bytes per RX block, multiple of the page size
+        int blockCount = 32;
+        int frameSize = 2048;      // RX frame hint and TX slot size
+        int blockTimeoutMs = 1;    // Kernel retires a partly filled RX block after this
+        int txFrameCount = 256;
+    };
+
+    PacketMmapTransport();
+    explicit PacketMmapTransport(const RingConfig &config);
+    ~PacketMmapTransport() override;
+
+    bool open(const QString &interfaceName, const QString &filter = QString()) override;
+    void close() override;
+    bool isOpen() const override { return m_fd >= 0; }
+
+    bool send(const uint8_t *frame, int length) override;
+    bool queue(const uint8_t *frame, int length) override;
+    bool flush() override;
+
+    int next(const uint8_t **data, int *length, int timeoutMs) override;
+    void interrupt() override;
+
+    PacketBackend backend() const override { return PacketBackend::PacketMmap; }
+
+private:
+    bool fail(const QString &what);
+    bool setupRings();
+    bool attachFilter(const QString &filter);
+    /// Sleep until the socket is readable; false on timeout or interrupt
+    bool waitReadable(int timeoutMs, bool &interrupted);
+    tpacket_block_desc *rxBlock(int index) const;
+    tpacket3_hdr *txSlot(int index) const;
+    void releaseBlock();
+
+    RingConfig m_config;
+    int m_fd = -1;
+    int m_wakeFd = -1;
+
+    uint8_t *m_map = nullptr;
+    size_t m_mapSize = 0;
+    uint8_t *m_txRing = nullptr;
+
+    int m_rxBlock = 0;                  // Block currently owned by user space
+    bool m_blockHeld = false;
+    tpacket3_hdr *m_rxFrame = nullptr;  // Next frame within the held block
+    uint32_t m_rxRemaining = 0;
+
+    int m_txSlot = 0;
+    int m_txPending = 0;
+};
+
+} // namespace PNConfigLib
+
+#endif // PACKETMMAPTRANSPORT_H
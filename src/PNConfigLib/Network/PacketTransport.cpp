@@ -0,0 +1,62 @@
+#include "PacketTransport.h"
+#include "PcapTransport.h"
+#include "LoopbackTransport.h"
+#ifdef PNCONFIGLIB_ENABLE_PACKET_MMAP
+#include "PacketMmapTransport.h"
+#endif
+#include <QDebug>
+
+namespace PNConfigLib {
+
+int PacketTransport::dispatch(const FrameHandler &handler, int timeoutMs) {
+    const uint8_t *data = nullptr;
+    int length = 0;
+    int res = next(&data, &length, timeoutMs);
+    if (res <= 0) return res;
+
+    // Drain whatever else is already buffered without waiting again
+    int count = 0;
+    do {
+        handler(data, length);
+        count++;
+        res = next(&data, &length, 0);
+    } while (res == 1);
+    return res < 0 ? -1 : count;
+}
+
+static PacketBackend defaultBackend() {
+    // PNCONFIG_PACKET_BACKEND=pcap|mmap|loopback overrides the build default, e.g. to compare both on a veth pair
+    const QByteArray requested = qgetenv("PNCONFIG_PACKET_BACKEND").toLower();
+    if (requested == "pcap") return PacketBackend::Pcap;
+    if (requested == "mmap") return PacketBackend::PacketMmap;
+    if (requested == "loopback") return PacketBackend::Loopback;
+#ifdef PNCONFIGLIB_ENABLE_PACKET_MMAP
+    return PacketBackend::PacketMmap;
+#else
+    return PacketBackend::Pcap;
+#endif
+}
+
+std::unique_ptr<PacketTransport> PacketTransport::create(PacketBackend backend) {
+    if (backend == PacketBackend::Default) {
+        backend = defaultBackend();
+    }
+
+    switch (backend) {
+        case PacketBackend::PacketMmap:
+#ifdef PNCONFIGLIB_ENABLE_PACKET_MMAP
+            return std::make_unique<PacketMmapTransport>();
+#else
+            qWarning() << "AF_PACKET backend not compiled in, using pcap";
+            return std::make_unique<PcapTransport>();
+#endif
+        case PacketBackend::Loopback:
+            return std::make_unique<LoopbackTransport>();
+        case PacketBackend::Pcap:
+        case PacketBackend::Default:
+            break;
+    }
+    return std::make_unique<PcapTransport>();
+}
+
+} // namespace PNConfigLib
@@ -0,0 +1,87 @@
+#ifndef PACKETTRANSPORT_H
+#define PACKETTRANSPORT_H
+
+#include <QString>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace PNConfigLib {
+
+enum class PacketBackend {
+    Default,    // PacketMmap where compiled in, otherwise Pcap
+    Pcap,       // libpcap / Npcap
+    PacketMmap, // Linux AF_PACKET with TPACKET_V3 RX/TX rings
+    Loopback    // In-process segment shared by transports with the same interface name
+};
+
+/**
+ * @brief Raw Ethernet frame I/O on one interface.
+ *
+ * DcpScanner, DcpCaptureThread and ArExchangeManager only talk to the
+ * network through this interface so the capture backend can be chosen at
+ * runtime, including the in-memory Loopback backend for runs without a NIC. Received frame pointers stay valid until the next receive call.
+ */
+class PacketTransport {
+public:
+    using FrameHandler = std::function<void(const uint8_t *data, int length)>;
+
+    virtual ~PacketTransport() = default;
+
+    /**
+     * @brief Open the interface in promiscuous mode.
+     * @param filter Optional BPF expression (pcap syntax), e.g. "ether proto 0x8892"
+     */
+    virtual bool open(const QString &interfaceName, const QString &filter = QString()) = 0;
+    virtual void close() = 0;
+    virtual bool isOpen() const = 0;
+    QString lastError() const { return m_lastError; }
+
+    /**
+     * @brief Transmit one frame immediately.
+     */
+    virtual bool send(const uint8_t *frame, int length) = 0;
+
+    /**
+     * @brief Queue a frame for the next flush(); backends without a TX ring send at once.
+     */
+    virtual bool queue(const uint8_t *frame, int length) { return send(frame, length); }
+    virtual bool flush() { return true; }
+
+    /**
+     * @brief Wait up to timeoutMs for one frame.
+     * @return 1 with data/length set, 0 on timeout or interrupt, -1 on error
+     */
+    virtual int next(const uint8_t **data, int *length, int timeoutMs) = 0;
+
+    /**
+     * @brief Wait up to timeoutMs for frames, then hand every frame that is ready to handler.
+     * @return Number of frames delivered, or -1 on error
+     */
+    virtual int dispatch(const FrameHandler &handler, int timeoutMs);
+
+    /**
+     * @brief Wake a thread blocked in next()/dispatch(). Safe to call from any thread.
+     */
+    virtual void interrupt() = 0;
+
+    virtual PacketBackend backend() const = 0;
+
+    /**
+     * @brief MAC address frames from this endpoint should carry, if the backend knows it.
+     * @return false when the caller has to resolve the address from the OS
+     */
+    virtual bool hardwareAddress(uint8_t mac[6]) const { (void)mac; return false; }
+
+    /**
+     * @brief Create an unopened transport; Default resolves to the best compiled-in backend
+     */
+    static std::unique_ptr<PacketTransport> create(PacketBackend backend = PacketBackend::Default);
+
+protected:
+    QString m_lastError;
+};
+
+} // namespace PNConfigLib
+
+#endif // PACKETTRANSPORT_H
@@ -0,0 +1,150 @@
+#include "PcapTransport.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QThread>
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <poll.h>
+#endif
+
+namespace PNConfigLib {
+
+// Upper bound for a single sleep so interrupt() is noticed even on a quiet network
+static const int MaxWaitMs = 50;
+
+PcapTransport::~PcapTransport() {
+    close();
+}
+
+bool PcapTransport::open(const QString &interfaceName, const QString &filter) {
+    close();
+
+    char errbuf[PCAP_ERRBUF_SIZE];
+    pcap_t *handle = pcap_create(interfaceName.toLocal8Bit().constData(), errbuf);
+    if (!handle) {
+        m_lastError = QString::fromLocal8Bit(errbuf);
+        return false;
+    }
+
+    // Immediate mode delivers each frame on arrival instead of waiting for
+    // a kernel buffer to fill or the read timeout to expire
+    pcap_set_snaplen(handle, 65536);
+    pcap_set_promisc(handle, 1);
+    pcap_set_timeout(handle, 10);
+    pcap_set_immediate_mode(handle, 1);
+    if (pcap_activate(handle) < 0) {
+        m_lastError = QString::fromLocal8Bit(pcap_geterr(handle));
+        pcap_close(handle);
+        return false;
+    }
+    if (!filter.isEmpty()) {
+        setFilter(handle, filter);
+    }
+    if (pcap_setnonblock(handle, 1, errbuf) == -1) {
+        qWarning() << "Error switching capture handle to non-blocking mode:" << errbuf;
+    }
+
+    m_handle = handle;
+    m_interrupted = false;
+    return true;
+}
+
+void PcapTransport::close() {
+    if (m_handle) {
+        pcap_close(m_handle);
+        m_handle = nullptr;
+    }
+}
+
+bool PcapTransport::setFilter(pcap_t *handle, const QString &filter) {
+    struct bpf_program fcode;
+    if (pcap_compile(handle, &fcode, filter.toLatin1().constData(), 1, PCAP_NETMASK_UNKNOWN) == -1) {
+        qWarning() << "Error compiling BPF filter:" << pcap_geterr(handle);
+        return false;
+    }
+    bool ok = pcap_setfilter(handle, &fcode) != -1;
+    if (!ok) {
+        qWarning() << "Error setting BPF filter:" << pcap_geterr(handle);
+    }
+    pcap_freecode(&fcode);
+    return ok;
+}
+
+bool PcapTransport::send(const uint8_t *frame, int length) {
+    if (!m_handle) return false;
+    if (pcap_sendpacket(m_handle, frame, length) != 0) {
+        m_lastError = QString::fromLocal8Bit(pcap_geterr(m_handle));
+        return false;
+    }
+    return true;
+}
+
+bool PcapTransport::waitReadable(int timeoutMs) {
+#ifdef Q_OS_WIN
+    HANDLE event = pcap_getevent(m_handle);
+    return WaitForSingleObject(event, timeoutMs) == WAIT_OBJECT_0;
+#else
+    int fd = pcap_get_selectable_fd(m_handle);
+    if (fd < 0) {
+        // No pollable descriptor on this platform, fall back to periodic reads
+        QThread::msleep(qMin(timeoutMs, 10));
+        return true;
+    }
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return ::poll(&pfd, 1, timeoutMs) > 0;
+#endif
+}
+
+int PcapTransport::next(const uint8_t **data, int *length, int timeoutMs) {
+    if (!m_handle) return -1;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (;;) {
+        struct pcap_pkthdr *header;
+        int res = pcap_next_ex(m_handle, &header, data);
+        if (res == 1) {
+            *length = (int)header->caplen;
+            return 1;
+        }
+        if (res < 0) {
+            m_lastError = QString::fromLocal8Bit(pcap_geterr(m_handle));
+            return -1;
+        }
+
+        const qint64 remaining = timeoutMs - timer.elapsed();
+        if (remaining <= 0 || m_interrupted.exchange(false)) return 0;
+        waitReadable((int)qMin<qint64>(remaining, MaxWaitMs));
+    }
+}
+
+static void dispatchTrampoline(u_char *user, const struct pcap_pkthdr *header, const u_char *data) {
+    (*reinterpret_cast<const PacketTransport::FrameHandler*>(user))(data, (int)header->caplen);
+}
+
+int PcapTransport::dispatch(const FrameHandler &handler, int timeoutMs) {
+    if (!m_handle) return -1;
+
+    // Frames may already be buffered; only sleep while reads come back empty
+    QElapsedTimer timer;
+    timer.start();
+    int res = pcap_dispatch(m_handle, -1, dispatchTrampoline, (u_char*)&handler);
+    while (res == 0) {
+        const qint64 remaining = timeoutMs - timer.elapsed();
+        if (remaining <= 0 || m_interrupted.exchange(false)) break;
+        if (waitReadable((int)qMin<qint64>(remaining, MaxWaitMs))) {
+            res = pcap_dispatch(m_handle, -1, dispatchTrampoline, (u_char*)&handler);
+        }
+    }
+    if (res == PCAP_ERROR) {
+        m_lastError = QString::fromLocal8Bit(pcap_geterr(m_handle));
+        return -1;
+    }
+    return res < 0 ? 0 : res;
+}
+
+} // namespace PNConfigLib
@@ -0,0 +1,48 @@
+#ifndef PCAPTRANSPORT_H
+#define PCAPTRANSPORT_H
+
+#include "PacketTransport.h"
+#include <atomic>
+#include <pcap.h>
+
+namespace PNConfigLib {
+
+/**
+ * @brief libpcap / Npcap backend.
+ *
+ * The handle is opened in immediate, non-blocking mode; waits sleep on the
+ * selectable descriptor (Npcap event on Windows) instead of spinning on the
+ * read timeout.
+ */
+class PcapTransport : public PacketTransport {
+public:
+    PcapTransport() = default;
+    ~PcapTransport() override;
+
+    bool open(const QString &interfaceName, const QString &filter = QString()) override;
+    void close() override;
+    bool isOpen() const override { return m_handle != nullptr; }
+
+    bool send(const uint8_t *frame, int length) override;
+    int next(const uint8_t **data, int *length, int timeoutMs) override;
+    int dispatch(const FrameHandler &handler, int timeoutMs) override;
+    void interrupt() override { m_interrupted = true; }
+
+    PacketBackend backend() const override { return PacketBackend::Pcap; }
+
+    /**
+     * @brief Compile and install a BPF filter on a pcap handle.
+     */
+    static bool setFilter(pcap_t *handle, const QString &filter);
+
+private:
+    /// Sleep until the handle is readable; false on timeout
+    bool waitReadable(int timeoutMs);
+
+    pcap_t *m_handle = nullptr;
+    std::atomic<bool> m_interrupted{false};
+};
+
+} // namespace PNConfigLib
+
+#endif // PCAPTRANSPORT_H
@@ -0,0 +1,178 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include "ProjectLoader.h"
+#include "../ConfigReader/ConfigReader.h"
+#include "../Instrumentation/Instrumentation.h"
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+
+namespace PNConfigLib {
+
+namespace {
+
+/**
+ * @brief Unit of work that runs exactly once, either on the pool or in wait()
+ */
+class LoadTask {
+public:
+    explicit LoadTask(std::function<void()> work)
+        : m_work(std::move(work))
+    {
+    }
+
+    static void submit(const std::shared_ptr<LoadTask>& task, QThreadPool* pool)
+    {
+        pool->start(QRunnable::create([task]() { task->tryRun(); }));
+    }
+
+    /**
+     * @brief Run the work unless another thread already claimed it
+     */
+    void tryRun()
+    {
+        int expected = Pending;
+        if (!m_state.compare_exchange_strong(expected, Running)) {
+            return;
+        }
+
+        std::exception_ptr error;
+        try {
+            m_work();
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        QMutexLocker locker(&m_mutex);
+        m_error = error;
+        m_state = Done;
+        m_finished.wakeAll();
+    }
+
+    /**
+     * @brief Run inline if still queued, otherwise wait for the running thread
+     * @throws the exception thrown by the work, if any
+     */
+    void wait()
+    {
+        tryRun();
+
+        QMutexLocker locker(&m_mutex);
+        while (m_state != Done) {
+            m_finished.wait(&m_mutex);
+        }
+        if (m_error) {
+            std::rethrow_exception(m_error);
+        }
+    }
+
+private:
+    enum State { Pending, Running, Done };
+
+    std::function<void()> m_work;
+    std::atomic<int> m_state{Pending};
+    QMutex m_mutex;
+    QWaitCondition m_finished;
+    std::exception_ptr m_error;
+};
+
+/**
+ * @brief Parse result of one GSDML file, shared by all devices referencing it
+ */
+struct GsdmlJob {
+    std::shared_ptr<LoadTask> task;
+    std::shared_ptr<GsdmlInfo> info;
+};
+
+} // namespace
+
+LoadedProject ProjectLoader::load(
+    const QString& configPath,
+    const QString& listOfNodesPath,
+    QThreadPool* pool)
+{
+    PN_SCOPED_TIMER("ProjectLoader::load");
+
+    if (!pool) {
+        pool = QThreadPool::globalInstance();
+    }
+
+    LoadedProject project;
+
+    // GSDML jobs keyed by GSDPath; filled from the ListOfNodes task
+    QMutex jobsMutex;
+    QHash<QString, GsdmlJob> gsdmlJobs;
+
+    auto startGsdml = [&](const DecentralDeviceNode& device) {
+        if (device.gsdPath.isEmpty()) {
+            return;
+        }
+
+        QMutexLocker locker(&jobsMutex);
+        if (gsdmlJobs.contains(device.gsdPath)) {
+            return;
+        }
+
+        // Self-contained: captures nothing from this stack frame
+        GsdmlJob job;
+        job.info = std::make_shared<GsdmlInfo>();
+        job.task = std::make_shared<LoadTask>(
+            [path = device.gsdPath, info = job.info]() { *info = GsdmlParser::parseGSDML(path); });
+        gsdmlJobs.insert(device.gsdPath, job);
+        LoadTask::submit(job.task, pool);
+    };
+
+    auto nodesTask = std::make_shared<LoadTask>([&]() {
+        project.nodes = ConfigReader::parseListOfNodes(listOfNodesPath, startGsdml);
+    });
+    LoadTask::submit(nodesTask, pool);
+
+    // Configuration.xml on the calling thread. The ListOfNodes task references
+    // this frame, so it is always joined before any error propagates.
+    std::exception_ptr configError;
+    try {
+        project.config = ConfigReader::parseConfiguration(configPath, ConfigReadMode::Mapped);
+    } catch (...) {
+        configError = std::current_exception();
+    }
+
+    std::exception_ptr nodesError;
+    try {
+        nodesTask->wait();
+    } catch (...) {
+        nodesError = std::current_exception();
+    }
+
+    if (configError) {
+        std::rethrow_exception(configError);
+    }
+    if (nodesError) {
+        std::rethrow_exception(nodesError);
+    }
+
+    // Join GSDML parses in device order; failed files are skipped
+    for (const DecentralDeviceNode& device : project.nodes.decentralDevices) {
+        auto it = gsdmlJobs.find(device.gsdPath);
+        if (it == gsdmlJobs.end()) {
+            continue;
+        }
+        try {
+            it->task->wait();
+            project.gsdmlData.insert(device.deviceID, *it->info);
+        } catch (...) {
+            // Skip devices with parse errors
+        }
+    }
+
+    return project;
+}
+
+} // namespace PNConfigLib
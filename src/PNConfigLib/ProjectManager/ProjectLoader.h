@@ -0,0 +1,57 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#ifndef PROJECTLOADER_H
+#define PROJECTLOADER_H
+
+#include "../ConfigReader/ConfigurationSchema.h"
+#include "../GsdmlParser/GsdmlParser.h"
+#include <QHash>
+#include <QString>
+
+class QThreadPool;
+
+namespace PNConfigLib {
+
+/**
+ * @brief All inputs of a project, ready for Compiler::buildHardwareConfiguration
+ */
+struct LoadedProject {
+    Configuration config;
+    ListOfNodes nodes;
+    QHash<QString, GsdmlInfo> gsdmlData;   // DeviceID -> parsed GSDML
+};
+
+/**
+ * @brief Pipelined loader for Configuration.xml, ListOfNodes.xml and GSDML files
+ *
+ * ListOfNodes.xml is parsed on the pool while Configuration.xml is parsed on
+ * the calling thread. Each distinct GSDPath is handed to the pool as soon as
+ * its DecentralDevice has been read, so GSDML parsing overlaps with the rest
+ * of the XML reading and with each other.
+ *
+ * Tasks that have not been picked up by the pool when the caller joins are run
+ * inline, so load() may be called from a pool thread (e.g. a batch job running
+ * on the same pool) without deadlocking.
+ */
+class ProjectLoader {
+public:
+    /**
+     * @brief Load a project
+     * @param configPath Path to Configuration.xml
+     * @param listOfNodesPath Path to ListOfNodes.xml
+     * @param pool Pool to run the parses on; QThreadPool::globalInstance() if null
+     * @return Parsed project. GSDML files that fail to parse are left out of
+     *         gsdmlData, like Compiler::loadGsdmlData
+     * @throws std::runtime_error if Configuration.xml or ListOfNodes.xml fails to parse
+     */
+    static LoadedProject load(
+        const QString& configPath,
+        const QString& listOfNodesPath,
+        QThreadPool* pool = nullptr);
+};
+
+} // namespace PNConfigLib
+
+#endif // PROJECTLOADER_H
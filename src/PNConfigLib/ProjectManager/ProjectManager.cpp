@@ -3,63 +3,96 @@
 /*****************************************************************************/
 
 #include "ProjectManager.h"
-#include "../ConfigReader/ConfigReader.h"
+#include "ProjectLoader.h"
 #include "../Compiler/Compiler.h"
+#include "../Instrumentation/Instrumentation.h"
 #include <QFileInfo>
+#include <QElapsedTimer>
 
 namespace PNConfigLib {
 
-QString ProjectManager::s_lastError;
+thread_local QString ProjectManager::s_lastError;
 
 bool ProjectManager::runPNConfigLib(
     const QString& configPath,
     const QString& listOfNodesPath,
     const QString& outputPath)
 {
-    s_lastError.clear();
+    ProjectRunResult result = runProject(configPath, listOfNodesPath, outputPath);
+    s_lastError = result.error;
+    return result.success;
+}
+
+ProjectRunResult ProjectManager::runProject(
+    const QString& configPath,
+    const QString& listOfNodesPath,
+    const QString& outputPath)
+{
+    PN_SCOPED_TIMER("ProjectManager::runProject");
+    
+    ProjectRunResult result;
+    QElapsedTimer total;
+    QElapsedTimer stage;
+    total.start();
     
     try {
         // Validate input files exist
         if (!QFileInfo::exists(configPath)) {
-            s_lastError = QString("Configuration file not found: %1").arg(configPath);
-            return false;
+            result.error = QString("Configuration file not found: %1").arg(configPath);
+            return result;
         }
         
         if (!QFileInfo::exists(listOfNodesPath)) {
-            s_lastError = QString("ListOfNodes file not found: %1").arg(listOfNodesPath);
-            return false;
+            result.error = QString("ListOfNodes file not found: %1").arg(listOfNodesPath);
+            return result;
         }
         
-        // Parse Configuration.xml
-        Configuration config = ConfigReader::parseConfiguration(configPath);
-        
-        // Parse ListOfNodes.xml
-        ListOfNodes nodes = ConfigReader::parseListOfNodes(listOfNodesPath);
+        // Parse Configuration.xml, ListOfNodes.xml and referenced GSDML files concurrently
+        stage.start();
+        LoadedProject project = ProjectLoader::load(configPath, listOfNodesPath);
+        result.times.parseNs = stage.nsecsElapsed();
         
         // Validate consistency
-        if (config.listOfNodesRefID != nodes.listOfNodesID) {
-            s_lastError = QString("Configuration references ListOfNodesID '%1' but actual ID is '%2'")
-                .arg(config.listOfNodesRefID).arg(nodes.listOfNodesID);
-            return false;
+        if (project.config.listOfNodesRefID != project.nodes.listOfNodesID) {
+            result.error = QString("Configuration references ListOfNodesID '%1' but actual ID is '%2'")
+                .arg(project.config.listOfNodesRefID).arg(project.nodes.listOfNodesID);
+            result.times.totalNs = total.nsecsElapsed();
+            return result;
         }
         
-        // Compile to output
-        bool success = Compiler::compile(config, nodes, outputPath);
+        // Compile to object tree
+        stage.restart();
+        XmlObject root = Compiler::buildHardwareConfiguration(project.config, project.nodes, project.gsdmlData);
+        result.times.compileNs = stage.nsecsElapsed();
+        
+        // Serialize
+        stage.restart();
+        QByteArray xml = Compiler::serializeOutput(root);
+        result.times.serializeNs = stage.nsecsElapsed();
+        
+        // Write output
+        stage.restart();
+        bool success = Compiler::writeOutput(xml, outputPath);
+        result.times.writeNs = stage.nsecsElapsed();
+        result.times.totalNs = total.nsecsElapsed();
         
         if (!success) {
-            s_lastError = "Failed to write output file";
-            return false;
+            result.error = "Failed to write output file";
+            return result;
         }
         
-        return true;
+        result.outputBytes = xml.size();
+        result.success = true;
+        return result;
         
     } catch (const std::exception& e) {
-        s_lastError = QString("Error: %1").arg(e.what());
-        return false;
+        result.error = QString("Error: %1").arg(e.what());
     } catch (...) {
-        s_lastError = "Unknown error occurred";
-        return false;
+        result.error = "Unknown error occurred";
     }
+    
+    result.times.totalNs = total.nsecsElapsed();
+    return result;
 }
 
 QString ProjectManager::getLastError()
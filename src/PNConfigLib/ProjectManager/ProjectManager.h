@@ -6,9 +6,31 @@
 #define PROJECTMANAGER_H
 
 #include <QString>
+#include <QtGlobal>
 
 namespace PNConfigLib {
 
+/**
+ * @brief Per-stage timings of a project run, in nanoseconds
+ */
+struct ProjectStageTimes {
+    qint64 parseNs = 0;      // Configuration.xml, ListOfNodes.xml and GSDML files
+    qint64 compileNs = 0;    // HWConfiguration object tree
+    qint64 serializeNs = 0;  // Object tree to XML
+    qint64 writeNs = 0;      // Output file
+    qint64 totalNs = 0;      // Wall clock of the whole run
+};
+
+/**
+ * @brief Result of a single project run
+ */
+struct ProjectRunResult {
+    bool success = false;
+    QString error;
+    qint64 outputBytes = 0;
+    ProjectStageTimes times;
+};
+
 /**
  * @brief Project manager for orchestrating configuration workflow
  */
@@ -27,13 +49,28 @@ public:
         const QString& outputPath);
         
     /**
-     * @brief Get last error message
+     * @brief Run complete PNConfigLib workflow and report per-stage timings
+     *
+     * Reentrant: does not touch the shared last-error state, so several
+     * projects may be run concurrently from different threads.
+     * @param configPath Path to Configuration.xml
+     * @param listOfNodesPath Path to ListOfNodes.xml
+     * @param outputPath Output file path for compiled configuration
+     * @return Run result with error description and stage timings
+     */
+    static ProjectRunResult runProject(
+        const QString& configPath,
+        const QString& listOfNodesPath,
+        const QString& outputPath);
+        
+    /**
+     * @brief Get last error message (of the calling thread)
      * @return Error description
      */
     static QString getLastError();
     
 private:
-    static QString s_lastError;
+    static thread_local QString s_lastError;
 };
 
 } // namespace PNConfigLib
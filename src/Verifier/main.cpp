@@ -1,36 +1,357 @@
-#include <PNConfigLib/Compiler/Compiler.h>
-#include <PNConfigLib/ConfigReader/ConfigReader.h>
+#include <PNConfigLib/Compiler/ConfigDiff.h>
+#include <PNConfigLib/Compiler/OutputReader.h>
+#include <PNConfigLib/Instrumentation/Instrumentation.h>
+#include <PNConfigLib/ProjectManager/ProjectManager.h>
 #include <QCoreApplication>
+#include <QCommandLineParser>
 #include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
 #include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRunnable>
+#include <QSet>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
 
-int main(int argc, char *argv[])
+using PNConfigLib::Instrumentation;
+using PNConfigLib::ProjectManager;
+using PNConfigLib::ProjectRunResult;
+
+// Exit codes
+static const int ExitOk = 0;
+static const int ExitFailed = 1;   // At least one project failed / outputs differ
+static const int ExitUsage = 2;    // Invalid arguments or unreadable input
+
+struct ProjectJob {
+    QString projectDir;
+    QString configPath;
+    QString nodesPath;
+    QString outputPath;
+    ProjectRunResult result;
+};
+
+static double toMs(qint64 ns)
+{
+    return ns / 1000000.0;
+}
+
+// Verifier --diff <old.xml> <new.xml>
+// Exit code: 0 = identical, 1 = differences, 2 = error
+static int runDiff(const QString& oldPath, const QString& newPath)
 {
-    QCoreApplication app(argc, argv);
-    
-    // Hardcoded paths for verification in this specific environment
-    QString configPath = "f:/workspaces/PNConfigGenerator/example/config_files/01_Basic_Configuration/Configuration.xml";
-    QString listPath = "f:/workspaces/PNConfigGenerator/example/config_files/01_Basic_Configuration/ListOfNodes.xml";
-    QString outPath = "f:/workspaces/PNConfigGenerator/verifier_output.xml";
-    
-    // Check files
-    if (!QFileInfo::exists(configPath)) {
-        qDebug() << "Config not found at" << configPath;
-        return 1;
-    }
-    
-    qDebug() << "Loading config:" << configPath;
     try {
-        auto config = PNConfigLib::ConfigReader::parseConfiguration(configPath);
-        auto nodes = PNConfigLib::ConfigReader::parseListOfNodes(listPath);
-        
-        qDebug() << "Generating output to:" << outPath;
-        bool res = PNConfigLib::Compiler::compile(config, nodes, outPath);
-        
-        qDebug() << "Result:" << res;
-        return res ? 0 : 1;
+        auto oldRoot = PNConfigLib::OutputReader::readFile(oldPath);
+        auto newRoot = PNConfigLib::OutputReader::readFile(newPath);
+        auto result = PNConfigLib::ConfigDiff::compare(oldRoot, newRoot);
+
+        QTextStream out(stdout);
+        out << PNConfigLib::ConfigDiff::formatResult(result);
+        return result.isEmpty() ? ExitOk : ExitFailed;
     } catch (const std::exception& e) {
         qDebug() << "Exception:" << e.what();
-        return 1;
+        return ExitUsage;
+    }
+}
+
+// Manifest: one project directory per line, '#' starts a comment,
+// relative paths are resolved against the manifest location
+static bool readManifest(const QString& manifestPath, QStringList& projectDirs)
+{
+    QFile file(manifestPath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return false;
+    }
+
+    QDir baseDir = QFileInfo(manifestPath).absoluteDir();
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+        projectDirs.append(QDir::cleanPath(baseDir.absoluteFilePath(line)));
+    }
+    return true;
+}
+
+// A project listed twice (e.g. on the command line and in the manifest, or via
+// a symlink) would have two jobs writing the same output file concurrently;
+// keep its first occurrence and return the dropped entries
+static QStringList removeDuplicateProjects(QStringList& projectDirs)
+{
+    QStringList kept;
+    QStringList dropped;
+    QSet<QString> seen;
+    for (const QString& dir : projectDirs) {
+        const QString canonical = QFileInfo(dir).canonicalFilePath();
+        const QString key = canonical.isEmpty() ? dir : canonical;
+        if (seen.contains(key)) {
+            dropped.append(dir);
+            continue;
+        }
+        seen.insert(key);
+        kept.append(dir);
+    }
+    projectDirs = kept;
+    return dropped;
+}
+
+// Subdirectory per project below --output-dir: the project name, with "-2",
+// "-3", ... appended when projects from different directories share a name
+// (compared case-insensitively, as on Windows file systems)
+static QStringList uniqueOutputNames(const QStringList& projectDirs)
+{
+    QStringList names;
+    QSet<QString> used;
+    for (const QString& dir : projectDirs) {
+        const QString base = QFileInfo(dir).fileName();
+        QString name = base;
+        for (int n = 2; used.contains(name.toLower()); ++n) {
+            name = QString("%1-%2").arg(base).arg(n);
+        }
+        used.insert(name.toLower());
+        names.append(name);
+    }
+    return names;
+}
+
+static QJsonObject timesToJson(const PNConfigLib::ProjectStageTimes& times)
+{
+    QJsonObject obj;
+    obj["parseMs"] = toMs(times.parseNs);
+    obj["compileMs"] = toMs(times.compileNs);
+    obj["serializeMs"] = toMs(times.serializeNs);
+    obj["writeMs"] = toMs(times.writeNs);
+    obj["totalMs"] = toMs(times.totalNs);
+    return obj;
+}
+
+static bool writeReport(const QString& reportPath, const QVector<ProjectJob>& jobs, int threads, qint64 wallNs)
+{
+    QJsonArray projects;
+    PNConfigLib::ProjectStageTimes sum;
+    int failed = 0;
+
+    for (const ProjectJob& job : jobs) {
+        QJsonObject entry;
+        entry["project"] = job.projectDir;
+        entry["output"] = job.outputPath;
+        entry["exitStatus"] = job.result.success ? ExitOk : ExitFailed;
+        entry["outputBytes"] = job.result.outputBytes;
+        if (!job.result.success) {
+            entry["error"] = job.result.error;
+            ++failed;
+        }
+        entry["stages"] = timesToJson(job.result.times);
+        projects.append(entry);
+
+        sum.parseNs += job.result.times.parseNs;
+        sum.compileNs += job.result.times.compileNs;
+        sum.serializeNs += job.result.times.serializeNs;
+        sum.writeNs += job.result.times.writeNs;
+        sum.totalNs += job.result.times.totalNs;
+    }
+
+    QJsonObject summary;
+    summary["projects"] = static_cast<int>(jobs.size());
+    summary["failed"] = failed;
+    summary["threads"] = threads;
+    summary["wallMs"] = toMs(wallNs);
+    summary["projectsPerSecond"] = wallNs > 0 ? jobs.size() * 1e9 / wallNs : 0.0;
+    summary["stagesSum"] = timesToJson(sum);
+
+    QJsonObject root;
+    root["summary"] = summary;
+    root["projects"] = projects;
+
+    QFile file(reportPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
     }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("Verifier");
+    QCoreApplication::setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Batch compiler for PNConfigLib projects.\n"
+        "Each project directory must contain Configuration.xml and ListOfNodes.xml.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("projects", "Project directories to compile.", "[project-dir...]");
+
+    QCommandLineOption manifestOption(QStringList() << "m" << "manifest",
+        "Read project directories from <file> (one per line).", "file");
+    QCommandLineOption jobsOption(QStringList() << "j" << "jobs",
+        "Compile up to <n> projects in parallel (default: number of cores).", "n");
+    QCommandLineOption outputDirOption(QStringList() << "o" << "output-dir",
+        "Write outputs to <dir>/<project-name>/ instead of the project directory.\n"
+        "Projects sharing a name get <project-name>-2, -3, ... in argument order.", "dir");
+    QCommandLineOption configNameOption("config-name",
+        "Configuration file name inside a project (default: Configuration.xml).", "name", "Configuration.xml");
+    QCommandLineOption nodesNameOption("nodes-name",
+        "ListOfNodes file name inside a project (default: ListOfNodes.xml).", "name", "ListOfNodes.xml");
+    QCommandLineOption outputNameOption("output-name",
+        "Output file name (default: PROFINET_Driver_Output.xml).", "name", "PROFINET_Driver_Output.xml");
+    QCommandLineOption reportOption("report",
+        "Write a JSON report with per-project status and stage timings to <file>.", "file");
+    QCommandLineOption metricsOption("metrics",
+        "Write counters and stage histograms as JSON to <file>.", "file");
+    QCommandLineOption traceOption("trace",
+        "Write stage spans in Chrome trace format to <file>.", "file");
+    QCommandLineOption quietOption(QStringList() << "q" << "quiet",
+        "Only print failures and the summary.");
+    QCommandLineOption diffOption("diff",
+        "Compare two compiled outputs: --diff <old.xml> <new.xml>.");
+
+    parser.addOptions({ manifestOption, jobsOption, outputDirOption, configNameOption,
+                        nodesNameOption, outputNameOption, reportOption, metricsOption,
+                        traceOption, quietOption, diffOption });
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    if (parser.isSet(diffOption)) {
+        const QStringList files = parser.positionalArguments();
+        if (files.size() != 2) {
+            err << "--diff expects exactly two files\n";
+            return ExitUsage;
+        }
+        return runDiff(files[0], files[1]);
+    }
+
+    // Collect projects
+    QStringList projectDirs;
+    for (const QString& dir : parser.positionalArguments()) {
+        projectDirs.append(QDir::cleanPath(QDir(dir).absolutePath()));
+    }
+    if (parser.isSet(manifestOption) && !readManifest(parser.value(manifestOption), projectDirs)) {
+        err << "Cannot read manifest: " << parser.value(manifestOption) << "\n";
+        return ExitUsage;
+    }
+    if (projectDirs.isEmpty()) {
+        err << "No projects given\n\n" << parser.helpText();
+        return ExitUsage;
+    }
+    for (const QString& dir : removeDuplicateProjects(projectDirs)) {
+        err << "Skipping duplicate project: " << dir << "\n";
+    }
+
+    int jobCount = QThread::idealThreadCount();
+    if (parser.isSet(jobsOption)) {
+        bool ok = false;
+        jobCount = parser.value(jobsOption).toInt(&ok);
+        if (!ok || jobCount < 1) {
+            err << "Invalid --jobs value: " << parser.value(jobsOption) << "\n";
+            return ExitUsage;
+        }
+    }
+
+    const QString outputDir = parser.value(outputDirOption);
+    const QStringList outputSubdirs = uniqueOutputNames(projectDirs);
+    QVector<ProjectJob> jobs(projectDirs.size());
+    for (int i = 0; i < projectDirs.size(); ++i) {
+        ProjectJob& job = jobs[i];
+        QDir projectDir(projectDirs[i]);
+        job.projectDir = projectDirs[i];
+        job.configPath = projectDir.filePath(parser.value(configNameOption));
+        job.nodesPath = projectDir.filePath(parser.value(nodesNameOption));
+
+        if (outputDir.isEmpty()) {
+            job.outputPath = projectDir.filePath(parser.value(outputNameOption));
+        } else {
+            QDir target(QDir(outputDir).filePath(outputSubdirs[i]));
+            target.mkpath(".");
+            job.outputPath = target.filePath(parser.value(outputNameOption));
+        }
+    }
+
+    const bool instrument = parser.isSet(metricsOption) || parser.isSet(traceOption);
+    if (instrument) {
+        if (!Instrumentation::isCompiledIn()) {
+            err << "Warning: PNConfigLib was built without PNCONFIGLIB_ENABLE_INSTRUMENTATION, metrics will be empty\n";
+        }
+        Instrumentation::setEnabled(true);
+    }
+
+    // Compile in parallel; each runnable owns exactly one job slot
+    QThreadPool pool;
+    pool.setMaxThreadCount(jobCount);
+
+    QElapsedTimer wall;
+    wall.start();
+    for (ProjectJob& job : jobs) {
+        ProjectJob* slot = &job;
+        pool.start(QRunnable::create([slot]() {
+            slot->result = ProjectManager::runProject(slot->configPath, slot->nodesPath, slot->outputPath);
+        }));
+    }
+    pool.waitForDone();
+    const qint64 wallNs = wall.nsecsElapsed();
+
+    // Report
+    int failed = 0;
+    for (const ProjectJob& job : jobs) {
+        const auto& t = job.result.times;
+        if (job.result.success) {
+            if (!parser.isSet(quietOption)) {
+                out << QString("[OK]   %1  total %2 ms (parse %3, compile %4, serialize %5, write %6)\n")
+                    .arg(job.projectDir)
+                    .arg(toMs(t.totalNs), 0, 'f', 3)
+                    .arg(toMs(t.parseNs), 0, 'f', 3)
+                    .arg(toMs(t.compileNs), 0, 'f', 3)
+                    .arg(toMs(t.serializeNs), 0, 'f', 3)
+                    .arg(toMs(t.writeNs), 0, 'f', 3);
+            }
+        } else {
+            ++failed;
+            out << QString("[FAIL] %1  %2\n").arg(job.projectDir, job.result.error);
+        }
+    }
+
+    out << QString("\n%1 project(s), %2 failed, %3 thread(s), wall %4 ms, %5 projects/s\n")
+        .arg(jobs.size())
+        .arg(failed)
+        .arg(jobCount)
+        .arg(toMs(wallNs), 0, 'f', 3)
+        .arg(wallNs > 0 ? jobs.size() * 1e9 / wallNs : 0.0, 0, 'f', 1);
+    if (instrument) {
+        const qint64 hits = Instrumentation::counter("GsdmlParser.cacheHit");
+        const qint64 misses = Instrumentation::counter("GsdmlParser.cacheMiss");
+        out << QString("GSDML cache: %1 hit(s), %2 miss(es), hit rate %3%, %4 byte(s) written\n")
+            .arg(hits)
+            .arg(misses)
+            .arg(hits + misses > 0 ? 100.0 * hits / (hits + misses) : 0.0, 0, 'f', 1)
+            .arg(Instrumentation::counter("Compiler.bytesWritten"));
+    }
+    out.flush();
+
+    if (parser.isSet(metricsOption) && !Instrumentation::writeJson(parser.value(metricsOption))) {
+        err << "Cannot write metrics: " << parser.value(metricsOption) << "\n";
+        return ExitUsage;
+    }
+    if (parser.isSet(traceOption) && !Instrumentation::writeChromeTrace(parser.value(traceOption))) {
+        err << "Cannot write trace: " << parser.value(traceOption) << "\n";
+        return ExitUsage;
+    }
+
+    if (parser.isSet(reportOption) && !writeReport(parser.value(reportOption), jobs, jobCount, wallNs)) {
+        err << "Cannot write report: " << parser.value(reportOption) << "\n";
+        return ExitUsage;
+    }
+
+    return failed == 0 ? ExitOk : ExitFailed;
 }
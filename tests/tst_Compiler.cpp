@@ -0,0 +1,114 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include <PNConfigLib/Compiler/Compiler.h>
+#include <PNConfigLib/Compiler/RecordGenerators.h>
+#include <QtTest>
+
+using namespace PNConfigLib;
+
+class tst_Compiler : public QObject {
+    Q_OBJECT
+
+private slots:
+    void buildHardwareConfiguration_devices();
+    void buildHardwareConfiguration_modelMatchesStructs();
+};
+
+static DecentralDeviceType device(const QString& id, const QString& name, const QString& ip)
+{
+    DecentralDeviceType dev;
+    dev.deviceRefID = id;
+    dev.interfaceRefID = id + "_IF";
+    dev.ethernetAddresses.deviceName = name;
+    dev.ethernetAddresses.ipAddress = ip;
+    return dev;
+}
+
+static DecentralDeviceNode node(const QString& id, const QString& gsdPath)
+{
+    DecentralDeviceNode n;
+    n.deviceID = id;
+    n.deviceName = id;
+    n.gsdPath = gsdPath;
+    return n;
+}
+
+static void buildProject(Configuration& config, ListOfNodes& nodes)
+{
+    config.listOfNodesRefID = nodes.listOfNodesID = "LON";
+    config.centralDevice.deviceRefID = "PN_Driver";
+    config.centralDevice.ethernetAddresses.deviceName = "controller";
+    config.centralDevice.ethernetAddresses.ipAddress = "192.168.0.1";
+    config.decentralDevices.append(device("D1", "io-a", "192.168.0.10"));
+    config.decentralDevices.append(device("D2", "io-b", "192.168.0.11"));
+
+    // The first D1 node has no GSDPath; the next one with a path must be used
+    nodes.decentralDevices.append(node("D1", QString()));
+    nodes.decentralDevices.append(node("D2", "/gsd/GSDML-V2.4-B.xml"));
+    nodes.decentralDevices.append(node("D1", "/gsd/GSDML-V2.4-A.xml"));
+}
+
+static const XmlVariable* variable(const XmlObject& obj, const QString& name)
+{
+    for (const XmlVariable& var : obj.variables) {
+        if (var.name == name) {
+            return &var;
+        }
+    }
+    return nullptr;
+}
+
+void tst_Compiler::buildHardwareConfiguration_devices()
+{
+    Configuration config;
+    ListOfNodes nodes;
+    buildProject(config, nodes);
+
+    const ProjectModel model = ProjectModel::fromConfiguration(config, nodes);
+    const XmlObject root = Compiler::buildHardwareConfiguration(model, {});
+
+    QCOMPARE(root.children.size(), 2);
+    const XmlObject& ioSystem = root.children[1];
+    QCOMPARE(ioSystem.children.size(), 2);
+
+    const XmlObject& first = ioSystem.children[0];
+    const XmlObject& second = ioSystem.children[1];
+    QCOMPARE(first.gsdmlFile, QString("GSDML-V2.4-A.xml"));
+    QCOMPARE(second.gsdmlFile, QString("GSDML-V2.4-B.xml"));
+
+    // Each device takes five LADDRs: device, two sub-devices, interface, port
+    QVERIFY(variable(first, "LADDR"));
+    QVERIFY(variable(second, "LADDR"));
+    QCOMPARE(variable(first, "LADDR")->value.toInt(), 264);
+    QCOMPARE(variable(second, "LADDR")->value.toInt(), 269);
+
+    QVERIFY(!second.children.isEmpty());
+    const XmlVariable* netConfig = variable(second.children[0], "NetworkParamConfig");
+    QVERIFY(netConfig);
+    const QList<XmlField> expected =
+        RecordGenerators::generateNetworkParameters("192.168.0.11", "255.255.255.0", "io-b");
+    QCOMPARE(netConfig->fields.size(), expected.size());
+    for (int i = 0; i < expected.size(); ++i) {
+        QCOMPARE(netConfig->fields[i].key, expected[i].key);
+        QCOMPARE(netConfig->fields[i].value, expected[i].value);
+    }
+}
+
+void tst_Compiler::buildHardwareConfiguration_modelMatchesStructs()
+{
+    Configuration config;
+    ListOfNodes nodes;
+    buildProject(config, nodes);
+
+    const QByteArray fromStructs =
+        Compiler::serializeOutput(Compiler::buildHardwareConfiguration(config, nodes, {}));
+    const QByteArray fromModel = Compiler::serializeOutput(
+        Compiler::buildHardwareConfiguration(ProjectModel::fromConfiguration(config, nodes), {}));
+    QVERIFY(!fromModel.isEmpty());
+    QCOMPARE(fromModel, fromStructs);
+}
+
+QTEST_APPLESS_MAIN(tst_Compiler)
+#include "tst_Compiler.moc"
@@ -0,0 +1,77 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include <PNConfigLib/Compiler/ConfigDiff.h>
+#include <QtTest>
+
+using namespace PNConfigLib;
+
+class tst_ConfigDiff : public QObject {
+    Q_OBJECT
+
+private slots:
+    void compare_identical();
+    void compare_repeatedFieldKeyModified();
+    void compare_repeatedFieldKeyRemoved();
+};
+
+static XmlField field(uint32_t key, const QByteArray& value)
+{
+    return XmlField{key, static_cast<uint32_t>(value.size()), value};
+}
+
+static XmlObject device(const QList<XmlField>& fields)
+{
+    XmlObject obj;
+    obj.name = "PNet_Device";
+    obj.classRid = 3;
+    obj.addScalar("Key", 1, XmlDataType::UINT32, 1);
+    obj.addBlobVariable("Records", 2, fields);
+    return obj;
+}
+
+void tst_ConfigDiff::compare_identical()
+{
+    XmlObject obj = device({field(0x3001, "\x01\x02"), field(0x3001, "\x03\x04")});
+    QVERIFY(ConfigDiff::compare(obj, obj).isEmpty());
+}
+
+// Only the second of two fields sharing a key changes; the first one must
+// still be matched against its own counterpart, not reported as removed
+void tst_ConfigDiff::compare_repeatedFieldKeyModified()
+{
+    XmlObject oldObj = device({field(0x3001, "\xAA\xAA"), field(0x3001, "\xBB\xBB")});
+    XmlObject newObj = device({field(0x3001, "\xAA\xAA"), field(0x3001, "\xBB\xCC")});
+
+    ConfigDiffResult result = ConfigDiff::compare(oldObj, newObj);
+    QCOMPARE(result.objects.size(), 1);
+    QCOMPARE(result.objects[0].variables.size(), 1);
+
+    const QList<FieldDiff>& fields = result.objects[0].variables[0].fields;
+    QCOMPARE(fields.size(), 1);
+    QCOMPARE(fields[0].kind, DiffKind::Modified);
+    QCOMPARE(fields[0].key, 0x3001u);
+    QCOMPARE(fields[0].ranges.size(), 1);
+    QCOMPARE(fields[0].ranges[0].offset, 1);
+    QCOMPARE(fields[0].ranges[0].oldBytes, QByteArray("\xBB"));
+    QCOMPARE(fields[0].ranges[0].newBytes, QByteArray("\xCC"));
+}
+
+void tst_ConfigDiff::compare_repeatedFieldKeyRemoved()
+{
+    XmlObject oldObj = device({field(0x3001, "\xAA"), field(0x3001, "\xBB\xBB\xBB")});
+    XmlObject newObj = device({field(0x3001, "\xAA")});
+
+    ConfigDiffResult result = ConfigDiff::compare(oldObj, newObj);
+    QCOMPARE(result.objects.size(), 1);
+    QCOMPARE(result.objects[0].variables.size(), 1);
+
+    const QList<FieldDiff>& fields = result.objects[0].variables[0].fields;
+    QCOMPARE(fields.size(), 1);
+    QCOMPARE(fields[0].kind, DiffKind::Removed);
+    QCOMPARE(fields[0].oldLength, 3u);
+}
+
+QTEST_APPLESS_MAIN(tst_ConfigDiff)
+#include "tst_ConfigDiff.moc"
@@ -0,0 +1,94 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include <PNConfigLib/Consistency/ConsistencyManager.h>
+#include <QThreadPool>
+#include <QtTest>
+
+using namespace PNConfigLib;
+
+class tst_ConsistencyManager : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void validateInputs_messagesReachSinks();
+    void validateInputPaths_messagesReachSinks();
+
+private:
+    QList<ConsistencyLog> m_received;
+};
+
+void tst_ConsistencyManager::init()
+{
+    ConsistencyLogger::reset();
+    ConsistencyLogger::clearSinks();
+    m_received.clear();
+    ConsistencyLogger::addSink(std::make_shared<CallbackLogSink>([this](const ConsistencyLog& log) {
+        m_received.append(log);
+    }));
+}
+
+void tst_ConsistencyManager::cleanup()
+{
+    ConsistencyLogger::clearSinks();
+    ConsistencyLogger::reset();
+}
+
+static bool sameLogs(const QList<ConsistencyLog>& a, const QList<ConsistencyLog>& b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (int i = 0; i < a.size(); ++i) {
+        if (a[i].type != b[i].type || a[i].severity != b[i].severity || a[i].source != b[i].source
+                || a[i].message != b[i].message || a[i].field != b[i].field) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Rule findings from all partitions arrive at a registered sink in report order
+void tst_ConsistencyManager::validateInputs_messagesReachSinks()
+{
+    Configuration config;
+    config.centralDevice.ethernetAddresses.deviceName = "controller";
+    for (const char* name : {"IO_A", "io-b", "IO-C"}) {
+        DecentralDeviceType device;
+        device.deviceRefID = QString("D_%1").arg(config.decentralDevices.size());
+        device.ethernetAddresses.deviceName = QString::fromLatin1(name);
+        config.decentralDevices.append(device);
+    }
+
+    QThreadPool pool;
+    ConsistencyManager manager;
+    manager.setRules({std::make_shared<DeviceNameRule>()});
+    manager.setThreadPool(&pool);
+    manager.setPartitionSize(1);
+
+    QVERIFY(!manager.validateInputs(config, ListOfNodes()));
+    const QList<ConsistencyLog> messages = manager.getMessages();
+    QCOMPARE(messages.size(), 2);
+    QCOMPARE(messages[0].field, ConsistencyField::DeviceName);
+
+    QVERIFY(sameLogs(m_received, messages));
+    QCOMPARE(ConsistencyLogger::count(LogSeverity::Error), 2);
+}
+
+void tst_ConsistencyManager::validateInputPaths_messagesReachSinks()
+{
+    ConsistencyManager manager;
+    QVERIFY(!manager.validateInputPaths("/nonexistent/Configuration.xml", "/nonexistent/ListOfNodes.xml"));
+
+    const QList<ConsistencyLog> messages = manager.getMessages();
+    QCOMPARE(messages.size(), 2);
+    QVERIFY(sameLogs(m_received, messages));
+    QCOMPARE(m_received[0].source, QString("Configuration"));
+    QCOMPARE(m_received[1].source, QString("ListOfNodes"));
+}
+
+QTEST_APPLESS_MAIN(tst_ConsistencyManager)
+#include "tst_ConsistencyManager.moc"
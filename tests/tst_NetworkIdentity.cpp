@@ -0,0 +1,250 @@
+/*****************************************************************************/
+/*  PNConfigGenerator - PROFINET Device Configuration Tool                  */
+/*****************************************************************************/
+
+#include <PNConfigLib/DataModel/NetworkIdentity.h>
+#include <QtTest>
+
+using namespace PNConfigLib;
+
+class tst_NetworkIdentity : public QObject {
+    Q_OBJECT
+
+private slots:
+    void encodeStationName_rfc3492_data();
+    void encodeStationName_rfc3492();
+    void encodeStationName_ascii_data();
+    void encodeStationName_ascii();
+    void checkStationName_data();
+    void checkStationName();
+    void parseIPv4_data();
+    void parseIPv4();
+    void parseMac_data();
+    void parseMac();
+};
+
+// RFC 3492 section 7.1 samples that fit a 63 octet label. Names are lowered
+// before encoding, so the expected output is the sample's lower case form
+// (Punycode digits are case-insensitive; only the basic code points change).
+void tst_NetworkIdentity::encodeStationName_rfc3492_data()
+{
+    QTest::addColumn<QString>("name");
+    QTest::addColumn<QByteArray>("encoded");
+
+    QTest::newRow("A Arabic")
+        << QStringLiteral("ليهمابتكلموشعربي؟")
+        << QByteArray("xn--egbpdaj6bu4bxfgehfvwxn");
+    QTest::newRow("B Chinese (simplified)")
+        << QStringLiteral("他们为什么不说中文")
+        << QByteArray("xn--ihqwcrb4cv8a8dqg056pqjye");
+    QTest::newRow("C Chinese (traditional)")
+        << QStringLiteral("他們爲什麽不說中文")
+        << QByteArray("xn--ihqwctvzc91f659drss3x8bo0yb");
+    QTest::newRow("D Czech")
+        << QStringLiteral("Pročprostěnemluvíčesky")
+        << QByteArray("xn--proprostnemluvesky-uyb24dma41a");
+    QTest::newRow("E Hebrew")
+        << QStringLiteral("למההםפשוטלאמדבריםעברית")
+        << QByteArray("xn--4dbcagdahymbxekheh6e0a7fei0b");
+    QTest::newRow("F Hindi")
+        << QStringLiteral("यहलोगहिन्दीक्योंनहींबोलसकतेहैं")
+        << QByteArray("xn--i1baa7eci9glrd9b2ae1bj0hfcgg6iyaf8o0a1dig0cd");
+    QTest::newRow("G Japanese")
+        << QStringLiteral("なぜみんな日本語を話してくれないのか")
+        << QByteArray("xn--n8jok5ay5dzabd5bym9f0cm5685rrjetr6pdxa");
+    QTest::newRow("I Russian")
+        << QStringLiteral("почемужеонинеговорятпорусски")
+        << QByteArray("xn--b1abfaaepdrnnbgefbadotcwatmq2g4l");
+    QTest::newRow("J Spanish")
+        << QStringLiteral("PorquénopuedensimplementehablarenEspañol")
+        << QByteArray("xn--porqunopuedensimplementehablarenespaol-fmd56a");
+    QTest::newRow("K Vietnamese")
+        << QStringLiteral("TạisaohọkhôngthểchỉnóitiếngViệt")
+        << QByteArray("xn--tisaohkhngthchnitingvit-kjcr8268qyxafd2f1b9g");
+    QTest::newRow("L 3<nen>B<gumi><kinpachi><sensei>")
+        << QStringLiteral("3年B組金八先生")
+        << QByteArray("xn--3b-ww4c5e180e575a65lsy2b");
+    QTest::newRow("M <amuro><namie>-with-SUPER-MONKEYS")
+        << QStringLiteral("安室奈美恵-with-SUPER-MONKEYS")
+        << QByteArray("xn---with-super-monkeys-pc58ag80a8qai00g7n9n");
+    QTest::newRow("N Hello-Another-Way-<sorezore><no><basho>")
+        << QStringLiteral("Hello-Another-Way-それぞれの場所")
+        << QByteArray("xn--hello-another-way--fc4qua05auwb3674vfr0b");
+    QTest::newRow("O <hitotsu><yane><no><shita>2")
+        << QStringLiteral("ひとつ屋根の下2")
+        << QByteArray("xn--2-u9tlzr9756bt3uc0v");
+    QTest::newRow("P Maji<de>Koi<suru>5<byou><mae>")
+        << QStringLiteral("MajiでKoiする5秒前")
+        << QByteArray("xn--majikoi5-783gue6qz075azm5e");
+    QTest::newRow("Q <pafii>de<runba>")
+        << QStringLiteral("パフィーdeルンバ")
+        << QByteArray("xn--de-jg4avhby1noc0d");
+    QTest::newRow("R <sono><supiido><de>")
+        << QStringLiteral("そのスピードで")
+        << QByteArray("xn--d9juau41awczczp");
+}
+
+void tst_NetworkIdentity::encodeStationName_rfc3492()
+{
+    QFETCH(QString, name);
+    QFETCH(QByteArray, encoded);
+
+    QCOMPARE(NetworkIdentity::encodeStationName(name.toUtf8()), encoded);
+}
+
+void tst_NetworkIdentity::encodeStationName_ascii_data()
+{
+    QTest::addColumn<QByteArray>("name");
+    QTest::addColumn<QByteArray>("encoded");
+
+    QTest::newRow("valid") << QByteArray("plc-1.cell-a") << QByteArray("plc-1.cell-a");
+    QTest::newRow("upper case") << QByteArray("PLC-1") << QByteArray("plc-1");
+    QTest::newRow("underscore") << QByteArray("IO-Device_1") << QByteArray("io-device-1");
+    QTest::newRow("space") << QByteArray("Station 12.Hall B") << QByteArray("station-12.hall-b");
+    QTest::newRow("hyphens trimmed") << QByteArray("_io_.-x-") << QByteArray("io.x");
+    QTest::newRow("umlaut") << QByteArray("b\xC3\xBC" "cher") << QByteArray("xn--bcher-kva");
+    QTest::newRow("ip form") << QByteArray("1.2.3.4") << QByteArray();
+    QTest::newRow("port name") << QByteArray("PORT-001") << QByteArray();
+}
+
+void tst_NetworkIdentity::encodeStationName_ascii()
+{
+    QFETCH(QByteArray, name);
+    QFETCH(QByteArray, encoded);
+
+    QCOMPARE(NetworkIdentity::encodeStationName(name), encoded);
+}
+
+// One row per StationNameError; position is the offset checkStationName reports
+void tst_NetworkIdentity::checkStationName_data()
+{
+    QTest::addColumn<QByteArray>("name");
+    QTest::addColumn<int>("error");
+    QTest::addColumn<int>("position");
+
+    auto row = [](const char* tag, const QByteArray& name, StationNameError error, int position) {
+        QTest::newRow(tag) << name << static_cast<int>(error) << position;
+    };
+
+    row("valid", "plc-1.cell-a", StationNameError::None, 0);
+    row("valid 63 octet label", QByteArray(63, 'a'), StationNameError::None, 0);
+    row("valid port label not first", "x.port-001", StationNameError::None, 0);
+    row("valid five numeric labels", "1.2.3.4.5", StationNameError::None, 0);
+    row("empty", "", StationNameError::Empty, 0);
+    row("too long", QByteArray(241, 'a'), StationNameError::TooLong, 240);
+    row("leading dot", ".a", StationNameError::EmptyLabel, 0);
+    row("double dot", "a..b", StationNameError::EmptyLabel, 2);
+    row("trailing dot", "a.", StationNameError::EmptyLabel, 2);
+    row("label too long", "ok." + QByteArray(64, 'a'), StationNameError::LabelTooLong, 3);
+    row("upper case", "Plc", StationNameError::UppercaseCharacter, 0);
+    row("upper case later", "plc-A", StationNameError::UppercaseCharacter, 4);
+    row("underscore", "io_device", StationNameError::InvalidCharacter, 2);
+    row("space", "io device", StationNameError::InvalidCharacter, 2);
+    row("non-ASCII", "b\xC3\xBC" "cher", StationNameError::InvalidCharacter, 1);
+    row("hyphen at start", "-io", StationNameError::HyphenAtLabelStart, 0);
+    row("hyphen at label start", "a.-b", StationNameError::HyphenAtLabelStart, 2);
+    row("hyphen at end", "io-", StationNameError::HyphenAtLabelEnd, 2);
+    row("hyphen at label end", "io-.a", StationNameError::HyphenAtLabelEnd, 2);
+    row("port-xyz", "port-001", StationNameError::PortName, 0);
+    row("port-xyz-abcde", "port-001-00002", StationNameError::PortName, 0);
+    row("port first label", "port-001.x", StationNameError::PortName, 0);
+    row("ip form", "1.2.3.4", StationNameError::IpAddressForm, 0);
+}
+
+void tst_NetworkIdentity::checkStationName()
+{
+    QFETCH(QByteArray, name);
+    QFETCH(int, error);
+    QFETCH(int, position);
+
+    const StationNameCheck bytes = NetworkIdentity::checkStationName(QByteArrayView(name));
+    QCOMPARE(static_cast<int>(bytes.error), error);
+    QCOMPARE(bytes.position, static_cast<qsizetype>(position));
+
+    // The QString overload agrees; all rows are ASCII up to the reported position
+    const StationNameCheck text = NetworkIdentity::checkStationName(QString::fromUtf8(name));
+    QCOMPARE(static_cast<int>(text.error), error);
+    QCOMPARE(text.position, static_cast<qsizetype>(position));
+}
+
+void tst_NetworkIdentity::parseIPv4_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<bool>("ok");
+    QTest::addColumn<quint32>("address");
+
+    QTest::newRow("address") << "192.168.0.1" << true << 0xC0A80001u;
+    QTest::newRow("zero") << "0.0.0.0" << true << 0u;
+    QTest::newRow("broadcast") << "255.255.255.255" << true << 0xFFFFFFFFu;
+    QTest::newRow("leading zero") << "010.0.0.1" << false << 0u;
+    QTest::newRow("leading zero inner") << "1.02.3.4" << false << 0u;
+    QTest::newRow("octet 256") << "256.0.0.1" << false << 0u;
+    QTest::newRow("octet 999") << "1.2.3.999" << false << 0u;
+    QTest::newRow("four digits") << "1.2.3.1000" << false << 0u;
+    QTest::newRow("trailing dot") << "1.2.3.4." << false << 0u;
+    QTest::newRow("missing octet") << "1.2.3." << false << 0u;
+    QTest::newRow("three octets") << "1.2.3" << false << 0u;
+    QTest::newRow("five octets") << "1.2.3.4.5" << false << 0u;
+    QTest::newRow("empty octet") << "1..3.4" << false << 0u;
+    QTest::newRow("leading space") << " 1.2.3.4" << false << 0u;
+    QTest::newRow("trailing space") << "1.2.3.4 " << false << 0u;
+    QTest::newRow("letters") << "a.b.c.d" << false << 0u;
+    QTest::newRow("empty") << "" << false << 0u;
+}
+
+void tst_NetworkIdentity::parseIPv4()
+{
+    QFETCH(QString, text);
+    QFETCH(bool, ok);
+    QFETCH(quint32, address);
+
+    quint32 parsed = 0;
+    QCOMPARE(NetworkIdentity::parseIPv4(text, parsed), ok);
+    if (ok) {
+        QCOMPARE(parsed, address);
+        QCOMPARE(NetworkIdentity::formatIPv4(parsed), text);
+    }
+
+    const QByteArray utf8 = text.toUtf8();
+    parsed = 0;
+    QCOMPARE(NetworkIdentity::parseIPv4(QByteArrayView(utf8), parsed), ok);
+    if (ok) {
+        QCOMPARE(parsed, address);
+    }
+}
+
+void tst_NetworkIdentity::parseMac_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<bool>("ok");
+    QTest::addColumn<quint64>("mac");
+
+    QTest::newRow("colons") << "00:1B:1B:12:34:56" << true << Q_UINT64_C(0x001B1B123456);
+    QTest::newRow("hyphens lower case") << "00-1b-1b-12-34-56" << true << Q_UINT64_C(0x001B1B123456);
+    QTest::newRow("no separators") << "001B1B123456" << true << Q_UINT64_C(0x001B1B123456);
+    QTest::newRow("five octets") << "00:1B:1B:12:34" << false << Q_UINT64_C(0);
+    QTest::newRow("seven octets") << "00:1B:1B:12:34:56:78" << false << Q_UINT64_C(0);
+    QTest::newRow("mixed separators") << "00:1B-1B:12:34:56" << false << Q_UINT64_C(0);
+    QTest::newRow("separator inside octet") << "0:01B:1B:12:34:56" << false << Q_UINT64_C(0);
+    QTest::newRow("leading separator") << ":00:1B:1B:12:34:56" << false << Q_UINT64_C(0);
+    QTest::newRow("trailing separator") << "00:1B:1B:12:34:56:" << false << Q_UINT64_C(0);
+    QTest::newRow("not hex") << "00:1B:1B:12:34:5G" << false << Q_UINT64_C(0);
+    QTest::newRow("empty") << "" << false << Q_UINT64_C(0);
+}
+
+void tst_NetworkIdentity::parseMac()
+{
+    QFETCH(QString, text);
+    QFETCH(bool, ok);
+    QFETCH(quint64, mac);
+
+    quint64 parsed = 0;
+    QCOMPARE(NetworkIdentity::parseMac(text, parsed), ok);
+    if (ok) {
+        QCOMPARE(parsed, mac);
+        QCOMPARE(NetworkIdentity::formatMac(parsed), QString("00:1B:1B:12:34:56"));
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_NetworkIdentity)
+#include "tst_NetworkIdentity.moc"